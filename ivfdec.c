@@ -65,6 +65,7 @@ int file_is_ivf(struct VpxInputContext *input_ctx) {
     input_ctx->detect.buf_read = 0;
   } else {
     input_ctx->detect.position = 4;
+    input_ctx->map.pos = IVF_FILE_HDR_SZ;
   }
   return is_ivf;
 }
@@ -110,3 +111,27 @@ int ivf_read_frame(FILE *infile, uint8_t **buffer,
 
   return 1;
 }
+
+int ivf_read_frame_mapped(struct VpxInputMap *map, const uint8_t **buffer,
+                          size_t *bytes_read) {
+  const uint8_t *const raw_header = vpx_input_map_read(map, IVF_FRAME_HDR_SZ);
+  size_t frame_size;
+
+  if (raw_header == NULL)
+    return 1;
+
+  frame_size = mem_get_le32(raw_header);
+  if (frame_size > 256 * 1024 * 1024) {
+    warn("Read invalid frame size (%u)\n", (unsigned int)frame_size);
+    frame_size = 0;
+  }
+
+  *buffer = vpx_input_map_read(map, frame_size);
+  if (*buffer == NULL) {
+    warn("Failed to read full frame\n");
+    return 1;
+  }
+
+  *bytes_read = frame_size;
+  return 0;
+}
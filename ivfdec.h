@@ -21,6 +21,11 @@ int file_is_ivf(struct VpxInputContext *input);
 int ivf_read_frame(FILE *infile, uint8_t **buffer,
                    size_t *bytes_read, size_t *buffer_size);
 
+// Same as ivf_read_frame(), for inputs mapped with vpx_input_map() before
+// file_is_ivf(). |*buffer| is set to point into the mapping.
+int ivf_read_frame_mapped(struct VpxInputMap *map, const uint8_t **buffer,
+                          size_t *bytes_read);
+
 #ifdef __cplusplus
 }  /* extern "C" */
 #endif
@@ -111,6 +111,69 @@ TEST_P(DecodePerfTest, PerfTest) {
 INSTANTIATE_TEST_CASE_P(VP9, DecodePerfTest,
                         ::testing::ValuesIn(kVP9DecodePerfVectors));
 
+#if CONFIG_VP9_POSTPROC
+const DecodePerfParam kVP9PostProcPerfVectors[] = {
+  make_tuple("vp90-2-bbb_1280x720_tile_1x4_1310kbps.webm", 1),
+  make_tuple("vp90-2-bbb_1280x720_tile_1x4_1310kbps.webm", 4),
+  make_tuple("vp90-2-bbb_1920x1080_tile_1x4_2586kbps.webm", 1),
+  make_tuple("vp90-2-bbb_1920x1080_tile_1x4_2586kbps.webm", 4),
+  make_tuple("vp90-2-sintel_1280x546_tile_1x4_1257kbps.webm", 4),
+};
+
+/*
+ DecodePostProcPerfTest measures decoding with deblocking, demacroblocking and
+ MFQE. Postprocessing runs when the frames are fetched, so every frame is
+ pulled from the decoder.
+ */
+class DecodePostProcPerfTest
+    : public ::testing::TestWithParam<DecodePerfParam> {
+};
+
+TEST_P(DecodePostProcPerfTest, PerfTest) {
+  const char *const video_name = GET_PARAM(VIDEO_NAME);
+  const unsigned threads = GET_PARAM(THREADS);
+  vp8_postproc_cfg_t pp_cfg = { VP8_DEBLOCK | VP8_DEMACROBLOCK | VP8_MFQE, 4,
+                                0 };
+
+  libvpx_test::WebMVideoSource video(video_name);
+  video.Init();
+
+  vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+  cfg.threads = threads;
+  libvpx_test::VP9Decoder decoder(cfg, VPX_CODEC_USE_POSTPROC, 0);
+  decoder.Control(VP8_SET_POSTPROC, &pp_cfg);
+
+  vpx_usec_timer t;
+  vpx_usec_timer_start(&t);
+
+  for (video.Begin(); video.cxdata() != NULL; video.Next()) {
+    decoder.DecodeFrame(video.cxdata(), video.frame_size());
+    libvpx_test::DxDataIterator dec_iter = decoder.GetDxData();
+    while (dec_iter.Next() != NULL) {
+    }
+  }
+
+  vpx_usec_timer_mark(&t);
+  const double elapsed_secs = double(vpx_usec_timer_elapsed(&t))
+                              / kUsecsInSec;
+  const unsigned frames = video.frame_number();
+  const double fps = double(frames) / elapsed_secs;
+
+  printf("{\n");
+  printf("\t\"type\" : \"decode_postproc_perf_test\",\n");
+  printf("\t\"version\" : \"%s\",\n", VERSION_STRING_NOSP);
+  printf("\t\"videoName\" : \"%s\",\n", video_name);
+  printf("\t\"threadCount\" : %u,\n", threads);
+  printf("\t\"decodeTimeSecs\" : %f,\n", elapsed_secs);
+  printf("\t\"totalFrames\" : %u,\n", frames);
+  printf("\t\"framesPerSecond\" : %f\n", fps);
+  printf("}\n");
+}
+
+INSTANTIATE_TEST_CASE_P(VP9, DecodePostProcPerfTest,
+                        ::testing::ValuesIn(kVP9PostProcPerfVectors));
+#endif  // CONFIG_VP9_POSTPROC
+
 class VP9NewEncodeDecodePerfTest :
     public ::libvpx_test::EncoderTest,
     public ::libvpx_test::CodecTestWithParam<libvpx_test::TestMode> {
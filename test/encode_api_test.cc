@@ -8,11 +8,19 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <string.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
 #include "third_party/googletest/src/include/gtest/gtest.h"
 
 #include "./vpx_config.h"
+#include "test/md5_helper.h"
 #include "vpx/vp8cx.h"
 #include "vpx/vpx_encoder.h"
+#include "vpx_mem/vpx_mem.h"
 
 namespace {
 
@@ -65,4 +73,266 @@ TEST(EncodeAPI, InvalidParams) {
   }
 }
 
+#if CONFIG_VP9_ENCODER
+const int kWidth = 176;
+const int kHeight = 144;
+const int kNumFrames = 20;
+// kWidth + 2 * VP9E_SOURCE_BORDER, rounded up to a multiple of 32.
+const int kStride = (kWidth + 2 * VP9E_SOURCE_BORDER + 31) & ~31;
+const int kYSize = kStride * (kHeight + 2 * VP9E_SOURCE_BORDER);
+const int kUVSize = kStride / 2 * (kHeight / 2 + VP9E_SOURCE_BORDER);
+
+// Allocates an I420 frame with a border of VP9E_SOURCE_BORDER pixels around
+// its planes, and fills it with a moving pattern.
+uint8_t *AllocFrame(vpx_image_t *img, int frame) {
+  const int border = VP9E_SOURCE_BORDER;
+  uint8_t *const buffer =
+      static_cast<uint8_t *>(vpx_memalign(32, kYSize + 2 * kUVSize));
+  vpx_img_wrap(img, VPX_IMG_FMT_I420, kWidth, kHeight, 1, buffer);
+  img->planes[VPX_PLANE_Y] = buffer + border * kStride + border;
+  img->planes[VPX_PLANE_U] =
+      buffer + kYSize + border / 2 * kStride / 2 + border / 2;
+  img->planes[VPX_PLANE_V] = img->planes[VPX_PLANE_U] + kUVSize;
+  img->stride[VPX_PLANE_Y] = kStride;
+  img->stride[VPX_PLANE_U] = img->stride[VPX_PLANE_V] = kStride / 2;
+  img->user_priv = buffer;
+
+  for (int plane = 0; plane < 3; ++plane) {
+    const int w = plane ? kWidth / 2 : kWidth;
+    const int h = plane ? kHeight / 2 : kHeight;
+    for (int y = 0; y < h; ++y) {
+      for (int x = 0; x < w; ++x) {
+        img->planes[plane][y * img->stride[plane] + x] =
+            ((x + 3 * frame) * (y + plane) / 4 + frame) & 0xff;
+      }
+    }
+  }
+  return buffer;
+}
+
+// Frames handed over to the encoder and not released yet.
+typedef std::set<void *> FrameSet;
+
+void ReleaseFrame(void *release_state, void *user_priv) {
+  FrameSet *const frames = static_cast<FrameSet *>(release_state);
+  ASSERT_EQ(1u, frames->erase(user_priv)) << "Unknown or twice released frame";
+  // Catch reads after the release in the output.
+  memset(user_priv, 0xff, kYSize + 2 * kUVSize);
+  vpx_free(user_priv);
+}
+
+// Encodes num_frames test frames with the given lag, handing them over to the
+// encoder if frames is not NULL. Returns the md5 of each compressed frame.
+std::vector<std::string> EncodeFrames(FrameSet *frames, unsigned int lag,
+                                      int num_frames) {
+  vpx_codec_ctx_t enc;
+  vpx_codec_enc_cfg_t cfg;
+  std::vector<std::string> md5s;
+  size_t max_held_frames = 0;
+
+  EXPECT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_config_default(&vpx_codec_vp9_cx_algo, &cfg, 0));
+  cfg.g_w = kWidth;
+  cfg.g_h = kHeight;
+  cfg.g_lag_in_frames = lag;
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_enc_init(&enc, &vpx_codec_vp9_cx_algo,
+                                             &cfg, 0));
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc, VP8E_SET_CPUUSED, 4));
+  if (frames != NULL) {
+    vpx_source_release_init release_init = { ReleaseFrame, frames };
+    EXPECT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc, VP9E_SET_SOURCE_RELEASE_CB,
+                                              &release_init));
+  }
+
+  for (int i = 0; i <= num_frames; ++i) {
+    vpx_image_t img;
+    uint8_t *buffer = NULL;
+    if (i < num_frames) {
+      buffer = AllocFrame(&img, i);
+      if (frames != NULL)
+        frames->insert(buffer);
+    }
+    EXPECT_EQ(VPX_CODEC_OK, vpx_codec_encode(&enc, buffer ? &img : NULL, i,
+                                             1, 0, VPX_DL_GOOD_QUALITY));
+    if (frames == NULL) {
+      vpx_free(buffer);
+    } else {
+      // The lookahead holds at most lag_in_frames frames, and the frames
+      // being encoded.
+      EXPECT_LE(frames->size(), cfg.g_lag_in_frames + 2);
+      if (frames->size() > max_held_frames)
+        max_held_frames = frames->size();
+    }
+
+    vpx_codec_iter_t iter = NULL;
+    const vpx_codec_cx_pkt_t *pkt;
+    bool got_data = false;
+    while ((pkt = vpx_codec_get_cx_data(&enc, &iter)) != NULL) {
+      if (pkt->kind == VPX_CODEC_CX_FRAME_PKT) {
+        libvpx_test::MD5 md5;
+        md5.Add(static_cast<const uint8_t *>(pkt->data.frame.buf),
+                pkt->data.frame.sz);
+        md5s.push_back(md5.Get());
+        got_data = true;
+      }
+    }
+    // Flush until the encoder has no more data.
+    if (i == num_frames && got_data)
+      --i;
+  }
+
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&enc));
+  // Copied frames are released right away.
+  if (frames != NULL) {
+    EXPECT_GT(max_held_frames, 1u) << "The frames were copied";
+  }
+  return md5s;
+}
+
+// Encodes more frames than the lag, so that the lookahead entries are reused,
+// and compares the frames with those encoded from copies of the sources.
+TEST(EncodeAPI, SourceReleaseCallback) {
+  static const unsigned int kLags[] = { 1, 2, 3, 10, 25 };
+  const int num_frames = 40;
+
+  for (int i = 0; i < NELEMENTS(kLags); ++i) {
+    SCOPED_TRACE(kLags[i]);
+    FrameSet frames;
+    const std::vector<std::string> copied =
+        EncodeFrames(NULL, kLags[i], num_frames);
+    const std::vector<std::string> handed_over =
+        EncodeFrames(&frames, kLags[i], num_frames);
+    EXPECT_TRUE(frames.empty()) << frames.size() << " frames not released";
+    EXPECT_FALSE(copied.empty());
+    ASSERT_EQ(copied.size(), handed_over.size());
+    for (size_t j = 0; j < copied.size(); ++j) {
+      EXPECT_EQ(copied[j], handed_over[j]) << "frame " << j;
+    }
+  }
+}
+
+// Encodes the test frames in real time mode with the given target frame
+// encode time, and returns the frame time stats of the encoder.
+vpx_frame_time_stats_t EncodeWithTargetFrameTime(unsigned int target) {
+  vpx_codec_ctx_t enc;
+  vpx_codec_enc_cfg_t cfg;
+  vpx_frame_time_stats_t stats;
+
+  memset(&stats, 0, sizeof(stats));
+  EXPECT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_config_default(&vpx_codec_vp9_cx_algo, &cfg, 0));
+  cfg.g_w = kWidth;
+  cfg.g_h = kHeight;
+  cfg.g_lag_in_frames = 0;
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_enc_init(&enc, &vpx_codec_vp9_cx_algo,
+                                             &cfg, 0));
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc, VP8E_SET_CPUUSED, 5));
+  EXPECT_EQ(VPX_CODEC_OK,
+            vpx_codec_control(&enc, VP9E_SET_TARGET_FRAME_TIME, target));
+  EXPECT_EQ(VPX_CODEC_INVALID_PARAM,
+            vpx_codec_control(&enc, VP9E_GET_FRAME_TIME_STATS,
+                              static_cast<vpx_frame_time_stats_t *>(NULL)));
+
+  for (int i = 0; i < kNumFrames; ++i) {
+    vpx_image_t img;
+    uint8_t *const buffer = AllocFrame(&img, i);
+    EXPECT_EQ(VPX_CODEC_OK,
+              vpx_codec_encode(&enc, &img, i, 1, 0, VPX_DL_REALTIME));
+    vpx_free(buffer);
+
+    vpx_codec_iter_t iter = NULL;
+    while (vpx_codec_get_cx_data(&enc, &iter) != NULL) {
+    }
+  }
+
+  EXPECT_EQ(VPX_CODEC_OK,
+            vpx_codec_control(&enc, VP9E_GET_FRAME_TIME_STATS, &stats));
+  EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&enc));
+  return stats;
+}
+
+TEST(EncodeAPI, TargetFrameTime) {
+  // No frame can be encoded in 1 us, so the tuner goes up to its fastest
+  // level, one step every SPEED_TUNER_HOLD_UP + 1 frames.
+  const vpx_frame_time_stats_t fast = EncodeWithTargetFrameTime(1);
+  EXPECT_EQ(1u, fast.target_frame_time);
+  EXPECT_GT(fast.max_speed_level, 0);
+  EXPECT_EQ(fast.max_speed_level, fast.speed_level);
+  EXPECT_EQ(static_cast<unsigned int>(kNumFrames), fast.frames_over_target);
+  EXPECT_GT(fast.last_frame_time, 0u);
+  EXPECT_GT(fast.avg_frame_time, 0u);
+
+  // Without a target the speed features are left alone.
+  const vpx_frame_time_stats_t off = EncodeWithTargetFrameTime(0);
+  EXPECT_EQ(0u, off.target_frame_time);
+  EXPECT_EQ(0, off.speed_level);
+  EXPECT_EQ(0u, off.frames_over_target);
+}
+
+// Whether a thread blocks on the row above depends on the scheduling, so only
+// the properties that hold for any interleaving of the threads are checked.
+TEST(EncodeAPI, ThreadSyncStats) {
+  vpx_codec_ctx_t enc;
+  vpx_codec_enc_cfg_t cfg;
+  vpx_thread_sync_stats_t stats, last_stats;
+
+  EXPECT_EQ(VPX_CODEC_OK,
+            vpx_codec_enc_config_default(&vpx_codec_vp9_cx_algo, &cfg, 0));
+  cfg.g_w = kWidth;
+  cfg.g_h = kHeight;
+  cfg.g_lag_in_frames = 0;
+
+  for (int threads = 1; threads <= 4; threads += 3) {
+    SCOPED_TRACE(threads);
+    cfg.g_threads = threads;
+    EXPECT_EQ(VPX_CODEC_OK, vpx_codec_enc_init(&enc, &vpx_codec_vp9_cx_algo,
+                                               &cfg, 0));
+    EXPECT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc, VP8E_SET_CPUUSED, 5));
+    EXPECT_EQ(VPX_CODEC_OK, vpx_codec_control(&enc, VP9E_SET_ROW_MT, 1));
+    EXPECT_EQ(VPX_CODEC_INVALID_PARAM,
+              vpx_codec_control(&enc, VP9E_GET_THREAD_SYNC_STATS,
+                                static_cast<vpx_thread_sync_stats_t *>(NULL)));
+
+    // Nothing has been encoded yet.
+    memset(&last_stats, 0xff, sizeof(last_stats));
+    EXPECT_EQ(VPX_CODEC_OK,
+              vpx_codec_control(&enc, VP9E_GET_THREAD_SYNC_STATS,
+                                &last_stats));
+    EXPECT_EQ(0u, last_stats.wait_count);
+    EXPECT_EQ(0u, last_stats.wait_time);
+
+    for (int i = 0; i < kNumFrames; ++i) {
+      vpx_image_t img;
+      uint8_t *const buffer = AllocFrame(&img, i);
+      EXPECT_EQ(VPX_CODEC_OK,
+                vpx_codec_encode(&enc, &img, i, 1, 0, VPX_DL_REALTIME));
+      vpx_free(buffer);
+
+      vpx_codec_iter_t iter = NULL;
+      while (vpx_codec_get_cx_data(&enc, &iter) != NULL) {
+      }
+
+      // The statistics add up over the frames.
+      memset(&stats, 0xff, sizeof(stats));
+      EXPECT_EQ(VPX_CODEC_OK,
+                vpx_codec_control(&enc, VP9E_GET_THREAD_SYNC_STATS, &stats));
+      if (threads == 1) {
+        // A single thread never waits for another one.
+        EXPECT_EQ(0u, stats.wait_count);
+        EXPECT_EQ(0u, stats.wait_time);
+      } else {
+        // A thread blocks at most once per superblock it encodes.
+        const unsigned int kSuperblocks =
+            ((kWidth + 63) / 64) * ((kHeight + 63) / 64);
+        EXPECT_GE(stats.wait_count, last_stats.wait_count);
+        EXPECT_LE(stats.wait_count, last_stats.wait_count + kSuperblocks);
+        EXPECT_GE(stats.wait_time, last_stats.wait_time);
+      }
+      last_stats = stats;
+    }
+    EXPECT_EQ(VPX_CODEC_OK, vpx_codec_destroy(&enc));
+  }
+}
+#endif  // CONFIG_VP9_ENCODER
+
 }  // namespace
@@ -53,6 +53,8 @@ const EncodePerfTestVideo kVP9EncodePerfTestVectors[] = {
 
 const int kEncodePerfTestSpeeds[] = { 5, 6, 7, 8 };
 const int kEncodePerfTestThreads[] = { 1, 2, 4 };
+const int kFirstPassPerfTestSpeed = 2;
+const int kFirstPassPerfTestFrames = 100;
 
 #define NELEMENTS(x) (sizeof((x)) / sizeof((x)[0]))
 
@@ -66,7 +68,9 @@ class VP9EncodePerfTest
         nframes_(0),
         encoding_mode_(GET_PARAM(1)),
         speed_(0),
-        threads_(1) {}
+        threads_(1),
+        pass_(0),
+        first_pass_secs_(0) {}
 
   virtual ~VP9EncodePerfTest() {}
 
@@ -100,9 +104,17 @@ class VP9EncodePerfTest
     }
   }
 
-  virtual void BeginPassHook(unsigned int /*pass*/) {
+  virtual void BeginPassHook(unsigned int pass) {
     min_psnr_ = kMaxPsnr;
     nframes_ = 0;
+    pass_ = pass;
+    vpx_usec_timer_start(&pass_timer_);
+  }
+
+  virtual void EndPassHook() {
+    vpx_usec_timer_mark(&pass_timer_);
+    if (pass_ == 0)
+      first_pass_secs_ = vpx_usec_timer_elapsed(&pass_timer_) / kUsecsInSec;
   }
 
   virtual void PSNRPktHook(const vpx_codec_cx_pkt_t *pkt) {
@@ -118,6 +130,11 @@ class VP9EncodePerfTest
     return min_psnr_;
   }
 
+  // Time spent in the first of the passes of the last RunLoop().
+  double first_pass_secs() const {
+    return first_pass_secs_;
+  }
+
   void set_speed(unsigned int speed) {
     speed_ = speed;
   }
@@ -132,6 +149,9 @@ class VP9EncodePerfTest
   libvpx_test::TestMode encoding_mode_;
   unsigned speed_;
   unsigned int threads_;
+  unsigned int pass_;
+  vpx_usec_timer pass_timer_;
+  double first_pass_secs_;
 };
 
 TEST_P(VP9EncodePerfTest, PerfTest) {
@@ -197,6 +217,69 @@ TEST_P(VP9EncodePerfTest, PerfTest) {
   }
 }
 
+class VP9FirstPassPerfTest : public VP9EncodePerfTest {};
+
+// Times the first pass, which encodes the macroblock rows on the encoding
+// threads, and reports the speedup over a single thread.
+TEST_P(VP9FirstPassPerfTest, PerfTest) {
+  for (size_t i = 0; i < NELEMENTS(kVP9EncodePerfTestVectors); ++i) {
+    double single_thread_secs = 0;
+
+    if (kVP9EncodePerfTestVectors[i].width < 1024)
+      continue;
+
+    for (size_t k = 0; k < NELEMENTS(kEncodePerfTestThreads); ++k) {
+      set_threads(kEncodePerfTestThreads[k]);
+      SetUp();
+
+      const vpx_rational timebase = { 33333333, 1000000000 };
+      cfg_.g_timebase = timebase;
+      cfg_.rc_target_bitrate = kVP9EncodePerfTestVectors[i].bitrate;
+      cfg_.rc_end_usage = VPX_VBR;
+      cfg_.g_error_resilient = 0;
+
+      init_flags_ = VPX_CODEC_USE_PSNR;
+
+      const unsigned frames = kFirstPassPerfTestFrames;
+      const char *video_name = kVP9EncodePerfTestVectors[i].name;
+      libvpx_test::I420VideoSource video(
+          video_name,
+          kVP9EncodePerfTestVectors[i].width,
+          kVP9EncodePerfTestVectors[i].height,
+          timebase.den, timebase.num, 0, frames);
+      set_speed(kFirstPassPerfTestSpeed);
+
+      ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+
+      const double elapsed_secs = first_pass_secs();
+      if (kEncodePerfTestThreads[k] == 1)
+        single_thread_secs = elapsed_secs;
+      std::string display_name(video_name);
+      if (kEncodePerfTestThreads[k] > 1) {
+        char thread_count[32];
+        snprintf(thread_count, sizeof(thread_count), "_t-%d",
+                 kEncodePerfTestThreads[k]);
+        display_name += thread_count;
+      }
+
+      printf("{\n");
+      printf("\t\"type\" : \"first_pass_perf_test\",\n");
+      printf("\t\"version\" : \"%s\",\n", VERSION_STRING_NOSP);
+      printf("\t\"videoName\" : \"%s\",\n", display_name.c_str());
+      printf("\t\"firstPassTimeSecs\" : %f,\n", elapsed_secs);
+      printf("\t\"totalFrames\" : %u,\n", frames);
+      printf("\t\"framesPerSecond\" : %f,\n", frames / elapsed_secs);
+      printf("\t\"speedup\" : %f,\n", single_thread_secs / elapsed_secs);
+      printf("\t\"speed\" : %d,\n", kFirstPassPerfTestSpeed);
+      printf("\t\"threads\" : %d\n", kEncodePerfTestThreads[k]);
+      printf("}\n");
+    }
+  }
+}
+
 VP9_INSTANTIATE_TEST_CASE(
     VP9EncodePerfTest, ::testing::Values(::libvpx_test::kRealTime));
+
+VP9_INSTANTIATE_TEST_CASE(
+    VP9FirstPassPerfTest, ::testing::Values(::libvpx_test::kTwoPassGood));
 }  // namespace
@@ -8,6 +8,7 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <cstdio>
 #include <cstdlib>
 #include <new>
 
@@ -22,6 +23,7 @@
 #include "vpx/vpx_integer.h"
 #include "vpx_mem/vpx_mem.h"
 #include "vpx_ports/mem.h"
+#include "vpx_ports/vpx_timer.h"
 
 namespace {
 
@@ -601,6 +603,8 @@ class SubpelVarianceTest
  protected:
   void RefTest();
   void ExtremeRefTest();
+  void SpeedTest();
+  void FillRandom();
 
   ACMRandom rnd_;
   uint8_t *src_;
@@ -685,6 +689,63 @@ void SubpelVarianceTest<SubpelVarianceFunctionType>::ExtremeRefTest() {
   }
 }
 
+template<typename SubpelVarianceFunctionType>
+void SubpelVarianceTest<SubpelVarianceFunctionType>::FillRandom() {
+  if (!use_high_bit_depth_) {
+    for (int j = 0; j < block_size_; j++) {
+      src_[j] = rnd_.Rand8();
+      sec_[j] = rnd_.Rand8();
+    }
+    for (int j = 0; j < block_size_ + width_ + height_ + 1; j++) {
+      ref_[j] = rnd_.Rand8();
+    }
+#if CONFIG_VP9_HIGHBITDEPTH
+  } else {
+    for (int j = 0; j < block_size_; j++) {
+      CONVERT_TO_SHORTPTR(src_)[j] = rnd_.Rand16() & mask_;
+      CONVERT_TO_SHORTPTR(sec_)[j] = rnd_.Rand16() & mask_;
+    }
+    for (int j = 0; j < block_size_ + width_ + height_ + 1; j++) {
+      CONVERT_TO_SHORTPTR(ref_)[j] = rnd_.Rand16() & mask_;
+    }
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+  }
+}
+
+// Times every sub-pixel position over about the same number of pixels for
+// all the block sizes.
+template<typename SubpelVarianceFunctionType>
+void SubpelVarianceTest<SubpelVarianceFunctionType>::SpeedTest() {
+  const int kNumTests = (1 << 22) / block_size_;
+  unsigned int sse;
+  FillRandom();
+  vpx_usec_timer timer;
+  vpx_usec_timer_start(&timer);
+  for (int i = 0; i < kNumTests; ++i) {
+    subpel_variance_(ref_, width_ + 1, i & 7, (i >> 3) & 7,
+                     src_, width_, &sse);
+  }
+  vpx_usec_timer_mark(&timer);
+  const int elapsed_time = static_cast<int>(vpx_usec_timer_elapsed(&timer));
+  printf("Variance %dx%d: %d us\n", width_, height_, elapsed_time);
+}
+
+template<>
+void SubpelVarianceTest<SubpixAvgVarMxNFunc>::SpeedTest() {
+  const int kNumTests = (1 << 22) / block_size_;
+  unsigned int sse;
+  FillRandom();
+  vpx_usec_timer timer;
+  vpx_usec_timer_start(&timer);
+  for (int i = 0; i < kNumTests; ++i) {
+    subpel_variance_(ref_, width_ + 1, i & 7, (i >> 3) & 7,
+                     src_, width_, &sse, sec_);
+  }
+  vpx_usec_timer_mark(&timer);
+  const int elapsed_time = static_cast<int>(vpx_usec_timer_elapsed(&timer));
+  printf("Avg variance %dx%d: %d us\n", width_, height_, elapsed_time);
+}
+
 template<>
 void SubpelVarianceTest<SubpixAvgVarMxNFunc>::RefTest() {
   for (int x = 0; x < 8; ++x) {
@@ -742,7 +803,9 @@ TEST_P(SumOfSquaresTest, Const) { ConstTest(); }
 TEST_P(SumOfSquaresTest, Ref) { RefTest(); }
 TEST_P(VpxSubpelVarianceTest, Ref) { RefTest(); }
 TEST_P(VpxSubpelVarianceTest, ExtremeRef) { ExtremeRefTest(); }
+TEST_P(VpxSubpelVarianceTest, DISABLED_Speed) { SpeedTest(); }
 TEST_P(VpxSubpelAvgVarianceTest, Ref) { RefTest(); }
+TEST_P(VpxSubpelAvgVarianceTest, DISABLED_Speed) { SpeedTest(); }
 
 INSTANTIATE_TEST_CASE_P(C, SumOfSquaresTest,
                         ::testing::Values(vpx_get_mb_ss_c));
@@ -1235,13 +1298,123 @@ INSTANTIATE_TEST_CASE_P(
 INSTANTIATE_TEST_CASE_P(
     AVX2, VpxSubpelVarianceTest,
     ::testing::Values(make_tuple(6, 6, &vpx_sub_pixel_variance64x64_avx2, 0),
-                      make_tuple(5, 5, &vpx_sub_pixel_variance32x32_avx2, 0)));
+                      make_tuple(6, 5, &vpx_sub_pixel_variance64x32_avx2, 0),
+                      make_tuple(5, 6, &vpx_sub_pixel_variance32x64_avx2, 0),
+                      make_tuple(5, 5, &vpx_sub_pixel_variance32x32_avx2, 0),
+                      make_tuple(5, 4, &vpx_sub_pixel_variance32x16_avx2, 0),
+                      make_tuple(4, 5, &vpx_sub_pixel_variance16x32_avx2, 0),
+                      make_tuple(4, 4, &vpx_sub_pixel_variance16x16_avx2, 0),
+                      make_tuple(4, 3, &vpx_sub_pixel_variance16x8_avx2, 0),
+                      make_tuple(3, 4, &vpx_sub_pixel_variance8x16_avx2, 0),
+                      make_tuple(3, 3, &vpx_sub_pixel_variance8x8_avx2, 0),
+                      make_tuple(3, 2, &vpx_sub_pixel_variance8x4_avx2, 0),
+                      make_tuple(2, 3, &vpx_sub_pixel_variance4x8_avx2, 0),
+                      make_tuple(2, 2, &vpx_sub_pixel_variance4x4_avx2, 0)));
 
 INSTANTIATE_TEST_CASE_P(
     AVX2, VpxSubpelAvgVarianceTest,
     ::testing::Values(
         make_tuple(6, 6, &vpx_sub_pixel_avg_variance64x64_avx2, 0),
-        make_tuple(5, 5, &vpx_sub_pixel_avg_variance32x32_avx2, 0)));
+        make_tuple(6, 5, &vpx_sub_pixel_avg_variance64x32_avx2, 0),
+        make_tuple(5, 6, &vpx_sub_pixel_avg_variance32x64_avx2, 0),
+        make_tuple(5, 5, &vpx_sub_pixel_avg_variance32x32_avx2, 0),
+        make_tuple(5, 4, &vpx_sub_pixel_avg_variance32x16_avx2, 0),
+        make_tuple(4, 5, &vpx_sub_pixel_avg_variance16x32_avx2, 0),
+        make_tuple(4, 4, &vpx_sub_pixel_avg_variance16x16_avx2, 0),
+        make_tuple(4, 3, &vpx_sub_pixel_avg_variance16x8_avx2, 0),
+        make_tuple(3, 4, &vpx_sub_pixel_avg_variance8x16_avx2, 0),
+        make_tuple(3, 3, &vpx_sub_pixel_avg_variance8x8_avx2, 0),
+        make_tuple(3, 2, &vpx_sub_pixel_avg_variance8x4_avx2, 0),
+        make_tuple(2, 3, &vpx_sub_pixel_avg_variance4x8_avx2, 0),
+        make_tuple(2, 2, &vpx_sub_pixel_avg_variance4x4_avx2, 0)));
+
+#if CONFIG_VP9_HIGHBITDEPTH
+INSTANTIATE_TEST_CASE_P(
+    AVX2, VpxHBDSubpelVarianceTest,
+    ::testing::Values(
+        make_tuple(6, 6, &vpx_highbd_12_sub_pixel_variance64x64_avx2, 12),
+        make_tuple(6, 5, &vpx_highbd_12_sub_pixel_variance64x32_avx2, 12),
+        make_tuple(5, 6, &vpx_highbd_12_sub_pixel_variance32x64_avx2, 12),
+        make_tuple(5, 5, &vpx_highbd_12_sub_pixel_variance32x32_avx2, 12),
+        make_tuple(5, 4, &vpx_highbd_12_sub_pixel_variance32x16_avx2, 12),
+        make_tuple(4, 5, &vpx_highbd_12_sub_pixel_variance16x32_avx2, 12),
+        make_tuple(4, 4, &vpx_highbd_12_sub_pixel_variance16x16_avx2, 12),
+        make_tuple(4, 3, &vpx_highbd_12_sub_pixel_variance16x8_avx2, 12),
+        make_tuple(3, 4, &vpx_highbd_12_sub_pixel_variance8x16_avx2, 12),
+        make_tuple(3, 3, &vpx_highbd_12_sub_pixel_variance8x8_avx2, 12),
+        make_tuple(3, 2, &vpx_highbd_12_sub_pixel_variance8x4_avx2, 12),
+        make_tuple(2, 3, &vpx_highbd_12_sub_pixel_variance4x8_avx2, 12),
+        make_tuple(2, 2, &vpx_highbd_12_sub_pixel_variance4x4_avx2, 12),
+        make_tuple(6, 6, &vpx_highbd_10_sub_pixel_variance64x64_avx2, 10),
+        make_tuple(6, 5, &vpx_highbd_10_sub_pixel_variance64x32_avx2, 10),
+        make_tuple(5, 6, &vpx_highbd_10_sub_pixel_variance32x64_avx2, 10),
+        make_tuple(5, 5, &vpx_highbd_10_sub_pixel_variance32x32_avx2, 10),
+        make_tuple(5, 4, &vpx_highbd_10_sub_pixel_variance32x16_avx2, 10),
+        make_tuple(4, 5, &vpx_highbd_10_sub_pixel_variance16x32_avx2, 10),
+        make_tuple(4, 4, &vpx_highbd_10_sub_pixel_variance16x16_avx2, 10),
+        make_tuple(4, 3, &vpx_highbd_10_sub_pixel_variance16x8_avx2, 10),
+        make_tuple(3, 4, &vpx_highbd_10_sub_pixel_variance8x16_avx2, 10),
+        make_tuple(3, 3, &vpx_highbd_10_sub_pixel_variance8x8_avx2, 10),
+        make_tuple(3, 2, &vpx_highbd_10_sub_pixel_variance8x4_avx2, 10),
+        make_tuple(2, 3, &vpx_highbd_10_sub_pixel_variance4x8_avx2, 10),
+        make_tuple(2, 2, &vpx_highbd_10_sub_pixel_variance4x4_avx2, 10),
+        make_tuple(6, 6, &vpx_highbd_8_sub_pixel_variance64x64_avx2, 8),
+        make_tuple(6, 5, &vpx_highbd_8_sub_pixel_variance64x32_avx2, 8),
+        make_tuple(5, 6, &vpx_highbd_8_sub_pixel_variance32x64_avx2, 8),
+        make_tuple(5, 5, &vpx_highbd_8_sub_pixel_variance32x32_avx2, 8),
+        make_tuple(5, 4, &vpx_highbd_8_sub_pixel_variance32x16_avx2, 8),
+        make_tuple(4, 5, &vpx_highbd_8_sub_pixel_variance16x32_avx2, 8),
+        make_tuple(4, 4, &vpx_highbd_8_sub_pixel_variance16x16_avx2, 8),
+        make_tuple(4, 3, &vpx_highbd_8_sub_pixel_variance16x8_avx2, 8),
+        make_tuple(3, 4, &vpx_highbd_8_sub_pixel_variance8x16_avx2, 8),
+        make_tuple(3, 3, &vpx_highbd_8_sub_pixel_variance8x8_avx2, 8),
+        make_tuple(3, 2, &vpx_highbd_8_sub_pixel_variance8x4_avx2, 8),
+        make_tuple(2, 3, &vpx_highbd_8_sub_pixel_variance4x8_avx2, 8),
+        make_tuple(2, 2, &vpx_highbd_8_sub_pixel_variance4x4_avx2, 8)));
+
+INSTANTIATE_TEST_CASE_P(
+    AVX2, VpxHBDSubpelAvgVarianceTest,
+    ::testing::Values(
+        make_tuple(6, 6, &vpx_highbd_12_sub_pixel_avg_variance64x64_avx2, 12),
+        make_tuple(6, 5, &vpx_highbd_12_sub_pixel_avg_variance64x32_avx2, 12),
+        make_tuple(5, 6, &vpx_highbd_12_sub_pixel_avg_variance32x64_avx2, 12),
+        make_tuple(5, 5, &vpx_highbd_12_sub_pixel_avg_variance32x32_avx2, 12),
+        make_tuple(5, 4, &vpx_highbd_12_sub_pixel_avg_variance32x16_avx2, 12),
+        make_tuple(4, 5, &vpx_highbd_12_sub_pixel_avg_variance16x32_avx2, 12),
+        make_tuple(4, 4, &vpx_highbd_12_sub_pixel_avg_variance16x16_avx2, 12),
+        make_tuple(4, 3, &vpx_highbd_12_sub_pixel_avg_variance16x8_avx2, 12),
+        make_tuple(3, 4, &vpx_highbd_12_sub_pixel_avg_variance8x16_avx2, 12),
+        make_tuple(3, 3, &vpx_highbd_12_sub_pixel_avg_variance8x8_avx2, 12),
+        make_tuple(3, 2, &vpx_highbd_12_sub_pixel_avg_variance8x4_avx2, 12),
+        make_tuple(2, 3, &vpx_highbd_12_sub_pixel_avg_variance4x8_avx2, 12),
+        make_tuple(2, 2, &vpx_highbd_12_sub_pixel_avg_variance4x4_avx2, 12),
+        make_tuple(6, 6, &vpx_highbd_10_sub_pixel_avg_variance64x64_avx2, 10),
+        make_tuple(6, 5, &vpx_highbd_10_sub_pixel_avg_variance64x32_avx2, 10),
+        make_tuple(5, 6, &vpx_highbd_10_sub_pixel_avg_variance32x64_avx2, 10),
+        make_tuple(5, 5, &vpx_highbd_10_sub_pixel_avg_variance32x32_avx2, 10),
+        make_tuple(5, 4, &vpx_highbd_10_sub_pixel_avg_variance32x16_avx2, 10),
+        make_tuple(4, 5, &vpx_highbd_10_sub_pixel_avg_variance16x32_avx2, 10),
+        make_tuple(4, 4, &vpx_highbd_10_sub_pixel_avg_variance16x16_avx2, 10),
+        make_tuple(4, 3, &vpx_highbd_10_sub_pixel_avg_variance16x8_avx2, 10),
+        make_tuple(3, 4, &vpx_highbd_10_sub_pixel_avg_variance8x16_avx2, 10),
+        make_tuple(3, 3, &vpx_highbd_10_sub_pixel_avg_variance8x8_avx2, 10),
+        make_tuple(3, 2, &vpx_highbd_10_sub_pixel_avg_variance8x4_avx2, 10),
+        make_tuple(2, 3, &vpx_highbd_10_sub_pixel_avg_variance4x8_avx2, 10),
+        make_tuple(2, 2, &vpx_highbd_10_sub_pixel_avg_variance4x4_avx2, 10),
+        make_tuple(6, 6, &vpx_highbd_8_sub_pixel_avg_variance64x64_avx2, 8),
+        make_tuple(6, 5, &vpx_highbd_8_sub_pixel_avg_variance64x32_avx2, 8),
+        make_tuple(5, 6, &vpx_highbd_8_sub_pixel_avg_variance32x64_avx2, 8),
+        make_tuple(5, 5, &vpx_highbd_8_sub_pixel_avg_variance32x32_avx2, 8),
+        make_tuple(5, 4, &vpx_highbd_8_sub_pixel_avg_variance32x16_avx2, 8),
+        make_tuple(4, 5, &vpx_highbd_8_sub_pixel_avg_variance16x32_avx2, 8),
+        make_tuple(4, 4, &vpx_highbd_8_sub_pixel_avg_variance16x16_avx2, 8),
+        make_tuple(4, 3, &vpx_highbd_8_sub_pixel_avg_variance16x8_avx2, 8),
+        make_tuple(3, 4, &vpx_highbd_8_sub_pixel_avg_variance8x16_avx2, 8),
+        make_tuple(3, 3, &vpx_highbd_8_sub_pixel_avg_variance8x8_avx2, 8),
+        make_tuple(3, 2, &vpx_highbd_8_sub_pixel_avg_variance8x4_avx2, 8),
+        make_tuple(2, 3, &vpx_highbd_8_sub_pixel_avg_variance4x8_avx2, 8),
+        make_tuple(2, 2, &vpx_highbd_8_sub_pixel_avg_variance4x4_avx2, 8)));
+#endif  // CONFIG_VP9_HIGHBITDEPTH
 #endif  // HAVE_AVX2
 
 #if HAVE_MEDIA
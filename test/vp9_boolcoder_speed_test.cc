@@ -0,0 +1,149 @@
+/*
+ *  Copyright (c) 2016 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+//  Test and time the VP9 bool decoder.
+
+#include <stdio.h>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "test/acm_random.h"
+#include "vpx/vpx_integer.h"
+#include "vpx_dsp/bitreader.h"
+#include "vpx_dsp/bitwriter.h"
+#include "vpx_ports/vpx_timer.h"
+
+using libvpx_test::ACMRandom;
+
+namespace {
+
+const int kNumBools = 1 << 20;
+// The bools are drawn from their probabilities, so they cost less than a bit
+// each on average; the slack covers the writer's final flush.
+const int kBufferSize = kNumBools / 8 * 2 + 1024;
+
+class BoolDecoderSpeedTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    ACMRandom rnd(ACMRandom::DeterministicSeed());
+    vpx_writer bw;
+
+    probas_ = new uint8_t[kNumBools];
+    bits_ = new uint8_t[kNumBools];
+    buffer_ = new uint8_t[kBufferSize];
+    ASSERT_TRUE(probas_ != NULL);
+    ASSERT_TRUE(bits_ != NULL);
+    ASSERT_TRUE(buffer_ != NULL);
+
+    // Mostly skewed probabilities, as in the coefficient token trees, with
+    // a share of even ones, as in the sign and extra bits.
+    for (int i = 0; i < kNumBools; ++i) {
+      const int skewed = rnd(4) != 0;
+      probas_[i] = skewed ? (rnd(2) ? 1 + rnd(32) : 255 - rnd(32))
+                          : 1 + rnd(255);
+      bits_[i] = static_cast<int>(rnd(256)) >= probas_[i];
+    }
+
+    vpx_start_encode(&bw, buffer_);
+    for (int i = 0; i < kNumBools; ++i)
+      vpx_write(&bw, bits_[i], probas_[i]);
+    vpx_stop_encode(&bw);
+    ASSERT_LT(bw.pos, static_cast<unsigned int>(kBufferSize));
+    size_ = bw.pos;
+  }
+
+  virtual void TearDown() {
+    delete[] probas_;
+    delete[] bits_;
+    delete[] buffer_;
+  }
+
+  // Decodes all the bools with vpx_read() and returns their sum.
+  int DecodeRead() const {
+    vpx_reader br;
+    int sum = 0;
+    vpx_reader_init(&br, buffer_, size_, NULL, NULL);
+    for (int i = 0; i < kNumBools; ++i)
+      sum += vpx_read(&br, probas_[i]);
+    return sum;
+  }
+
+  // Decodes all the bools with vpx_read_bool() on local reader state and
+  // returns their sum.
+  int DecodeReadBool() const {
+    vpx_reader br;
+    int sum = 0;
+    vpx_reader_init(&br, buffer_, size_, NULL, NULL);
+    {
+      BD_VALUE value = br.value;
+      int count = br.count;
+      unsigned int range = br.range;
+      for (int i = 0; i < kNumBools; ++i)
+        sum += vpx_read_bool(&br, probas_[i], &value, &count, &range);
+    }
+    return sum;
+  }
+
+  uint8_t *probas_;
+  uint8_t *bits_;
+  uint8_t *buffer_;
+  size_t size_;
+};
+
+TEST_F(BoolDecoderSpeedTest, ReadBoolMatchesRead) {
+  vpx_reader br;
+  vpx_reader br_bool;
+  vpx_reader_init(&br, buffer_, size_, NULL, NULL);
+  vpx_reader_init(&br_bool, buffer_, size_, NULL, NULL);
+
+  BD_VALUE value = br_bool.value;
+  int count = br_bool.count;
+  unsigned int range = br_bool.range;
+  for (int i = 0; i < kNumBools; ++i) {
+    ASSERT_EQ(bits_[i], vpx_read(&br, probas_[i])) << "pos: " << i;
+    ASSERT_EQ(bits_[i],
+              vpx_read_bool(&br_bool, probas_[i], &value, &count, &range))
+        << "pos: " << i;
+    ASSERT_EQ(br.value, value) << "pos: " << i;
+    ASSERT_EQ(br.count, count) << "pos: " << i;
+    ASSERT_EQ(br.range, range) << "pos: " << i;
+  }
+  br_bool.value = value;
+  br_bool.count = count;
+  br_bool.range = range;
+  EXPECT_EQ(vpx_reader_find_end(&br), vpx_reader_find_end(&br_bool));
+  EXPECT_EQ(0, vpx_reader_has_error(&br_bool));
+}
+
+TEST_F(BoolDecoderSpeedTest, DISABLED_Speed) {
+  const int kNumPasses = 20;
+  int sum_read = 0;
+  int sum_read_bool = 0;
+  vpx_usec_timer timer;
+
+  vpx_usec_timer_start(&timer);
+  for (int i = 0; i < kNumPasses; ++i)
+    sum_read += DecodeRead();
+  vpx_usec_timer_mark(&timer);
+  const int read_time = static_cast<int>(vpx_usec_timer_elapsed(&timer));
+
+  vpx_usec_timer_start(&timer);
+  for (int i = 0; i < kNumPasses; ++i)
+    sum_read_bool += DecodeReadBool();
+  vpx_usec_timer_mark(&timer);
+  const int read_bool_time = static_cast<int>(vpx_usec_timer_elapsed(&timer));
+
+  EXPECT_EQ(sum_read, sum_read_bool);
+  printf("vpx_read:      %7d us (%.2f Mbool/s)\n", read_time,
+         kNumPasses * (double)kNumBools / read_time);
+  printf("vpx_read_bool: %7d us (%.2f Mbool/s)\n", read_bool_time,
+         kNumPasses * (double)kNumBools / read_bool_time);
+}
+
+}  // namespace
@@ -16,6 +16,8 @@
 #include "test/md5_helper.h"
 #include "test/util.h"
 #include "test/y4m_video_source.h"
+#include "vpx_util/vpx_thread.h"
+#include "vpx_util/vpx_thread_pool.h"
 
 namespace {
 class VPxEncoderThreadTest
@@ -26,6 +28,7 @@ class VPxEncoderThreadTest
       : EncoderTest(GET_PARAM(0)),
         encoder_initialized_(false),
         tiles_(2),
+        row_mt_(0),
         encoding_mode_(GET_PARAM(1)),
         set_cpu_used_(GET_PARAM(2)) {
     init_flags_ = VPX_CODEC_USE_PSNR;
@@ -68,6 +71,8 @@ class VPxEncoderThreadTest
       // Encode 4 column tiles.
       encoder->Control(VP9E_SET_TILE_COLUMNS, tiles_);
       encoder->Control(VP8E_SET_CPUUSED, set_cpu_used_);
+      if (row_mt_)
+        encoder->Control(VP9E_SET_ROW_MT, row_mt_);
       if (encoding_mode_ != ::libvpx_test::kRealTime) {
         encoder->Control(VP8E_SET_ENABLEAUTOALTREF, 1);
         encoder->Control(VP8E_SET_ARNR_MAXFRAMES, 7);
@@ -99,6 +104,7 @@ class VPxEncoderThreadTest
 
   bool encoder_initialized_;
   int tiles_;
+  int row_mt_;
   ::libvpx_test::TestMode encoding_mode_;
   int set_cpu_used_;
   ::libvpx_test::Decoder *decoder_;
@@ -129,6 +135,95 @@ TEST_P(VPxEncoderThreadTest, EncoderResultTest) {
   ASSERT_EQ(single_thr_md5, multi_thr_md5);
 }
 
+class VP9EncoderRowMTTest : public VPxEncoderThreadTest {};
+
+TEST_P(VP9EncoderRowMTTest, EncoderResultTest) {
+  std::vector<std::string> single_thr_md5, multi_thr_md5;
+
+  ::libvpx_test::Y4mVideoSource video("niklas_1280_720_30.y4m", 15, 20);
+
+  cfg_.rc_target_bitrate = 1000;
+  row_mt_ = 1;
+
+  // Encode using single thread.
+  cfg_.g_threads = 1;
+  init_flags_ = VPX_CODEC_USE_PSNR;
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  single_thr_md5 = md5_;
+  md5_.clear();
+
+  // Encode using more threads than tile columns.
+  cfg_.g_threads = 6;
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  multi_thr_md5 = md5_;
+  md5_.clear();
+
+  // Row based multi-threading is deterministic for any number of threads.
+  ASSERT_EQ(single_thr_md5, multi_thr_md5);
+}
+
+class VP9EncoderThreadPoolTest : public VPxEncoderThreadTest {
+ protected:
+  // Encode using a thread per worker, then using more workers than there are
+  // pool threads, and compare the results.
+  void RunPoolTest() {
+    std::vector<std::string> thread_md5, pool_md5;
+    const VPxWorkerInterface default_interface = *vpx_get_worker_interface();
+
+    ::libvpx_test::Y4mVideoSource video("niklas_1280_720_30.y4m", 15, 20);
+
+    cfg_.rc_target_bitrate = 1000;
+
+    // Encode using a thread per worker.
+    cfg_.g_threads = 8;
+    init_flags_ = VPX_CODEC_USE_PSNR;
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    thread_md5 = md5_;
+    md5_.clear();
+
+    // Encode using more workers than there are pool threads. The SB rows wait
+    // on the row above, whichever of the hooks the pool runs first.
+    ASSERT_EQ(CONFIG_MULTITHREAD, vpx_thread_pool_init(2));
+    EXPECT_NE(vpx_set_worker_interface(vpx_get_thread_pool_interface()), 0);
+    RunLoop(&video);
+    pool_md5 = md5_;
+    md5_.clear();
+
+    // Reset the interface.
+    EXPECT_NE(vpx_set_worker_interface(&default_interface), 0);
+    vpx_thread_pool_end();
+    ASSERT_FALSE(HasFatalFailure());
+
+    // The rows are encoded with the same thread data wherever they run.
+    ASSERT_EQ(thread_md5, pool_md5);
+  }
+};
+
+TEST_P(VP9EncoderThreadPoolTest, EncoderResultTest) {
+  RunPoolTest();
+}
+
+// The data parallel pre-pass of the SB rows runs on the encoding threads,
+// ahead of the encoding of the rows.
+TEST_P(VP9EncoderThreadPoolTest, DataParallelPrePassTest) {
+  if (encoding_mode_ != ::libvpx_test::kRealTime)
+    return;
+  cfg_.use_gpu = 1;
+  RunPoolTest();
+}
+
+VP9_INSTANTIATE_TEST_CASE(
+    VP9EncoderThreadPoolTest,
+    ::testing::Values(::libvpx_test::kTwoPassGood, ::libvpx_test::kOnePassGood,
+                      ::libvpx_test::kRealTime),
+    ::testing::Values(2, 6));
+
+VP9_INSTANTIATE_TEST_CASE(
+    VP9EncoderRowMTTest,
+    ::testing::Values(::libvpx_test::kTwoPassGood, ::libvpx_test::kOnePassGood,
+                      ::libvpx_test::kRealTime),
+    ::testing::Range(1, 9));
+
 VP9_INSTANTIATE_TEST_CASE(
     VPxEncoderThreadTest,
     ::testing::Values(::libvpx_test::kTwoPassGood, ::libvpx_test::kOnePassGood,
@@ -10,6 +10,8 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <map>
 #include <string>
 #include "third_party/googletest/src/include/gtest/gtest.h"
 #include "./vpx_config.h"
@@ -216,5 +218,78 @@ TEST(VP9MultiThreadedFrameParallel, ValidFileTest) {
   };
   DecodeFiles(files);
 }
+
+// Input buffers handed over to the decoder, by address, with their sizes.
+typedef std::map<const unsigned char *, size_t> InputBufferMap;
+
+// Poisons and frees an input buffer released by the decoder, so that a read
+// after the release shows in the output.
+void ReleaseInputBuffer(void *release_state, const unsigned char *data) {
+  InputBufferMap *const buffers = static_cast<InputBufferMap *>(release_state);
+  InputBufferMap::iterator it = buffers->find(data);
+  ASSERT_TRUE(it != buffers->end()) << "Unknown or twice released buffer";
+  unsigned char *const buffer = const_cast<unsigned char *>(data);
+  memset(buffer, 0xff, it->second);
+  free(buffer);
+  buffers->erase(it);
+}
+
+// Decodes |filename| with |num_threads|, handing over a copy of each frame
+// to the decoder instead of having it copied. Returns the md5 of the decoded
+// frames.
+string DecodeFileWithInputRelease(const string &filename, int num_threads) {
+  libvpx_test::WebMVideoSource video(filename);
+  video.Init();
+  InputBufferMap buffers;
+  libvpx_test::MD5 md5;
+
+  {
+    vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
+    cfg.threads = num_threads;
+    const vpx_codec_flags_t flags = VPX_CODEC_USE_FRAME_THREADING;
+    libvpx_test::VP9Decoder decoder(cfg, flags, 0);
+    vpx_input_release_init release_init = { ReleaseInputBuffer, &buffers };
+    decoder.Control(VP9D_SET_INPUT_RELEASE_CB, &release_init);
+
+    for (video.Begin(); video.cxdata() != NULL; video.Next()) {
+      unsigned char *const buffer =
+          static_cast<unsigned char *>(malloc(video.frame_size()));
+      memcpy(buffer, video.cxdata(), video.frame_size());
+      buffers[buffer] = video.frame_size();
+      const vpx_codec_err_t res = decoder.DecodeFrame(buffer,
+                                                      video.frame_size());
+      if (res != VPX_CODEC_OK) {
+        EXPECT_EQ(VPX_CODEC_OK, res) << decoder.DecodeError();
+        break;
+      }
+      EXPECT_LE(buffers.size(), static_cast<size_t>(num_threads));
+
+      libvpx_test::DxDataIterator dec_iter = decoder.GetDxData();
+      const vpx_image_t *img;
+      while ((img = dec_iter.Next()))
+        md5.Add(img);
+    }
+
+    decoder.DecodeFrame(NULL, 0);
+    libvpx_test::DxDataIterator dec_iter = decoder.GetDxData();
+    const vpx_image_t *img;
+    while ((img = dec_iter.Next()))
+      md5.Add(img);
+  }
+
+  EXPECT_TRUE(buffers.empty()) << buffers.size() << " buffers not released";
+  return string(md5.Get());
+}
+
+TEST(VP9MultiThreadedFrameParallel, InputReleaseTest) {
+  // vp90-2-07-frame_parallel-1.webm is a 40 frame video file with
+  // one key frame for every ten frames.
+  const string filename = "vp90-2-07-frame_parallel-1.webm";
+  for (int t = 2; t <= 8; ++t) {
+    EXPECT_EQ(DecodeFile(filename, t, 40),
+              DecodeFileWithInputRelease(filename, t))
+        << "threads = " << t;
+  }
+}
 #endif  // CONFIG_WEBM_IO
 }  // namespace
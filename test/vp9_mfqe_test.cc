@@ -0,0 +1,112 @@
+/*
+ *  Copyright (c) 2016 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "./vpx_config.h"
+#include "./vp9_rtcd.h"
+#include "test/acm_random.h"
+#include "test/clear_system_state.h"
+#include "test/register_state_check.h"
+#include "test/util.h"
+#include "vpx/vpx_integer.h"
+#include "vpx_ports/mem.h"
+
+using libvpx_test::ACMRandom;
+
+namespace {
+
+const int kNumIterations = 1000;
+const int kStride = 80;
+
+typedef void (*FilterByWeightFunc)(const uint8_t *src, int src_stride,
+                                   uint8_t *dst, int dst_stride,
+                                   int src_weight);
+// Function to test, C reference and block size.
+typedef std::tr1::tuple<FilterByWeightFunc, FilterByWeightFunc, int>
+    FilterByWeightParam;
+
+class FilterByWeightTest
+    : public ::testing::TestWithParam<FilterByWeightParam> {
+ public:
+  virtual ~FilterByWeightTest() {}
+  virtual void SetUp() {
+    filter_func_ = GET_PARAM(0);
+    ref_func_ = GET_PARAM(1);
+    size_ = GET_PARAM(2);
+  }
+  virtual void TearDown() { libvpx_test::ClearSystemState(); }
+
+ protected:
+  FilterByWeightFunc filter_func_;
+  FilterByWeightFunc ref_func_;
+  int size_;
+};
+
+TEST_P(FilterByWeightTest, MatchesC) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  DECLARE_ALIGNED(32, uint8_t, src[kStride * 64]);
+  DECLARE_ALIGNED(32, uint8_t, dst[kStride * 64]);
+  DECLARE_ALIGNED(32, uint8_t, ref_dst[kStride * 64]);
+
+  for (int i = 0; i < kNumIterations; ++i) {
+    // Weights cover both ends: 0 keeps dst and 16 copies src.
+    const int weight = i % 17;
+    for (int j = 0; j < kStride * 64; ++j) {
+      src[j] = rnd.Rand8();
+      dst[j] = ref_dst[j] = rnd.Rand8();
+    }
+
+    ref_func_(src, kStride, ref_dst, kStride, weight);
+    ASM_REGISTER_STATE_CHECK(filter_func_(src, kStride, dst, kStride,
+                                          weight));
+
+    ASSERT_EQ(0, memcmp(ref_dst, dst, sizeof(dst)))
+        << size_ << "x" << size_ << " weight " << weight;
+  }
+}
+
+using std::tr1::make_tuple;
+
+#if HAVE_SSE2
+INSTANTIATE_TEST_CASE_P(
+    SSE2, FilterByWeightTest,
+    ::testing::Values(
+        make_tuple(&vp9_filter_by_weight8x8_sse2,
+                   &vp9_filter_by_weight8x8_c, 8),
+        make_tuple(&vp9_filter_by_weight16x16_sse2,
+                   &vp9_filter_by_weight16x16_c, 16)));
+#endif  // HAVE_SSE2
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(
+    AVX2, FilterByWeightTest,
+    ::testing::Values(
+        make_tuple(&vp9_filter_by_weight16x16_avx2,
+                   &vp9_filter_by_weight16x16_c, 16),
+        make_tuple(&vp9_filter_by_weight32x32_avx2,
+                   &vp9_filter_by_weight32x32_c, 32),
+        make_tuple(&vp9_filter_by_weight64x64_avx2,
+                   &vp9_filter_by_weight64x64_c, 64)));
+#endif  // HAVE_AVX2
+
+#if HAVE_MSA
+INSTANTIATE_TEST_CASE_P(
+    MSA, FilterByWeightTest,
+    ::testing::Values(
+        make_tuple(&vp9_filter_by_weight8x8_msa,
+                   &vp9_filter_by_weight8x8_c, 8),
+        make_tuple(&vp9_filter_by_weight16x16_msa,
+                   &vp9_filter_by_weight16x16_c, 16)));
+#endif  // HAVE_MSA
+
+}  // namespace
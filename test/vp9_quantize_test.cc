@@ -15,6 +15,7 @@
 #include "third_party/googletest/src/include/gtest/gtest.h"
 
 #include "./vpx_config.h"
+#include "./vp9_rtcd.h"
 #include "./vpx_dsp_rtcd.h"
 #include "test/acm_random.h"
 #include "test/clear_system_state.h"
@@ -24,6 +25,7 @@
 #include "vp9/common/vp9_scan.h"
 #include "vpx/vpx_codec.h"
 #include "vpx/vpx_integer.h"
+#include "vpx_ports/mem.h"
 
 using libvpx_test::ACMRandom;
 
@@ -348,4 +350,92 @@ INSTANTIATE_TEST_CASE_P(
                    &vpx_highbd_quantize_b_32x32_c, VPX_BITS_12)));
 #endif  // HAVE_SSE2
 #endif  // CONFIG_VP9_HIGHBITDEPTH
+
+typedef void (*TrellisCandidatesFunc)(const tran_low_t *coeff,
+                                      const tran_low_t *qcoeff,
+                                      const tran_low_t *dqcoeff,
+                                      intptr_t n_coeffs,
+                                      const int16_t *dequant, int mul,
+                                      int shift, int *dist, int *dist_down,
+                                      tran_low_t *qcoeff_down);
+
+class VP9TrellisCandidatesTest
+    : public ::testing::TestWithParam<TrellisCandidatesFunc> {
+ public:
+  virtual ~VP9TrellisCandidatesTest() {}
+  virtual void SetUp() { candidates_op_ = GetParam(); }
+  virtual void TearDown() { libvpx_test::ClearSystemState(); }
+
+ protected:
+  TrellisCandidatesFunc candidates_op_;
+};
+
+TEST_P(VP9TrellisCandidatesTest, MatchesC) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  DECLARE_ALIGNED(16, tran_low_t, coeff[1024]);
+  DECLARE_ALIGNED(16, tran_low_t, qcoeff[1024]);
+  DECLARE_ALIGNED(16, tran_low_t, dqcoeff[1024]);
+  DECLARE_ALIGNED(16, int, ref_dist[1024]);
+  DECLARE_ALIGNED(16, int, dist[1024]);
+  DECLARE_ALIGNED(16, int, ref_dist_down[1024]);
+  DECLARE_ALIGNED(16, int, dist_down[1024]);
+  DECLARE_ALIGNED(16, tran_low_t, ref_qcoeff_down[1024]);
+  DECLARE_ALIGNED(16, tran_low_t, qcoeff_down[1024]);
+
+  for (int i = 0; i < 1000; ++i) {
+    const TX_SIZE tx_size = static_cast<TX_SIZE>(i % TX_SIZES);
+    // The trellis passes the coefficients up to the last one in the scan,
+    // rounded up to 16.
+    const int n_coeffs = 16 * (1 + rnd(1 << (2 * tx_size)));
+    const int mul = 1 + (tx_size == TX_32X32);
+#if CONFIG_VP9_HIGHBITDEPTH
+    const int shift = 2 * ((i / TX_SIZES) % 3);
+#else
+    const int shift = 0;
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+    int16_t dequant[2];
+    dequant[0] = static_cast<int16_t>((4 + rnd(1825)) << shift);
+    dequant[1] = static_cast<int16_t>((4 + rnd(1825)) << shift);
+
+    for (int j = 0; j < n_coeffs; ++j) {
+      const int dq = dequant[j != 0];
+      // Mostly levels of a few steps, some large ones.
+      const int max_abs = rnd(4) ? 4 * dq : (1 << (14 + shift)) / mul;
+      const int abs_coeff = rnd(max_abs);
+      // Quantize with a random rounding offset, so that the levels are
+      // either side of the coefficients.
+      const int level = (abs_coeff * mul + rnd(dq)) / dq;
+      const int sign = rnd(2) ? -1 : 1;
+      coeff[j] = sign * abs_coeff;
+      qcoeff[j] = sign * level;
+      dqcoeff[j] = sign * (level * dq / mul);
+    }
+
+    vp9_trellis_candidates_c(coeff, qcoeff, dqcoeff, n_coeffs, dequant, mul,
+                             shift, ref_dist, ref_dist_down, ref_qcoeff_down);
+    ASM_REGISTER_STATE_CHECK(candidates_op_(coeff, qcoeff, dqcoeff, n_coeffs,
+                                            dequant, mul, shift, dist,
+                                            dist_down, qcoeff_down));
+
+    for (int j = 0; j < n_coeffs; ++j) {
+      ASSERT_EQ(ref_dist[j], dist[j]) << "i: " << i << " j: " << j;
+      ASSERT_EQ(ref_dist_down[j], dist_down[j]) << "i: " << i << " j: " << j;
+      ASSERT_EQ(ref_qcoeff_down[j], qcoeff_down[j])
+          << "i: " << i << " j: " << j;
+    }
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(C, VP9TrellisCandidatesTest,
+                        ::testing::Values(&vp9_trellis_candidates_c));
+
+#if HAVE_SSE4_1
+INSTANTIATE_TEST_CASE_P(SSE4_1, VP9TrellisCandidatesTest,
+                        ::testing::Values(&vp9_trellis_candidates_sse4_1));
+#endif  // HAVE_SSE4_1
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(AVX2, VP9TrellisCandidatesTest,
+                        ::testing::Values(&vp9_trellis_candidates_avx2));
+#endif  // HAVE_AVX2
 }  // namespace
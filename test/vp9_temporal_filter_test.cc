@@ -0,0 +1,107 @@
+/*
+ *  Copyright (c) 2016 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include "third_party/googletest/src/include/gtest/gtest.h"
+
+#include "./vpx_config.h"
+#include "./vp9_rtcd.h"
+#include "test/acm_random.h"
+#include "test/clear_system_state.h"
+#include "test/register_state_check.h"
+#include "vpx/vpx_integer.h"
+#include "vpx_ports/mem.h"
+
+using libvpx_test::ACMRandom;
+
+namespace {
+
+const int kNumIterations = 10000;
+const int kStride = 48;
+
+typedef void (*TemporalFilterFunc)(uint8_t *frame1, unsigned int stride,
+                                   uint8_t *frame2, unsigned int block_width,
+                                   unsigned int block_height, int strength,
+                                   int filter_weight,
+                                   unsigned int *accumulator,
+                                   uint16_t *count);
+
+class TemporalFilterTest
+    : public ::testing::TestWithParam<TemporalFilterFunc> {
+ public:
+  virtual ~TemporalFilterTest() {}
+  virtual void SetUp() { filter_func_ = GetParam(); }
+  virtual void TearDown() { libvpx_test::ClearSystemState(); }
+
+ protected:
+  // Runs the filter on a block and compares with the C code. 'max_diff'
+  // bounds the difference between the source and the predictor.
+  void CheckBlock(ACMRandom *rnd, int width, int height, int strength,
+                  int filter_weight, int max_diff) {
+    DECLARE_ALIGNED(16, uint8_t, src[kStride * 16]);
+    DECLARE_ALIGNED(16, uint8_t, pred[16 * 16]);
+    DECLARE_ALIGNED(16, unsigned int, accumulator[16 * 16]);
+    DECLARE_ALIGNED(16, unsigned int, ref_accumulator[16 * 16]);
+    DECLARE_ALIGNED(16, uint16_t, count[16 * 16]);
+    DECLARE_ALIGNED(16, uint16_t, ref_count[16 * 16]);
+
+    for (int i = 0; i < kStride * 16; ++i)
+      src[i] = rnd->Rand8();
+    for (int i = 0; i < height; ++i) {
+      for (int j = 0; j < width; ++j) {
+        const int diff = rnd->PseudoUniform(2 * max_diff + 1) - max_diff;
+        const int value = src[i * kStride + j] + diff;
+        pred[i * width + j] = value < 0 ? 0 : value > 255 ? 255 : value;
+      }
+    }
+    for (int i = 0; i < 16 * 16; ++i) {
+      accumulator[i] = ref_accumulator[i] = rnd->Rand16();
+      count[i] = ref_count[i] = rnd->Rand8();
+    }
+
+    vp9_temporal_filter_apply_c(src, kStride, pred, width, height, strength,
+                                filter_weight, ref_accumulator, ref_count);
+    ASM_REGISTER_STATE_CHECK(filter_func_(src, kStride, pred, width, height,
+                                          strength, filter_weight,
+                                          accumulator, count));
+
+    ASSERT_EQ(0, memcmp(ref_accumulator, accumulator, sizeof(accumulator)))
+        << "accumulator mismatch, " << width << "x" << height
+        << " strength " << strength << " weight " << filter_weight;
+    ASSERT_EQ(0, memcmp(ref_count, count, sizeof(count)))
+        << "count mismatch, " << width << "x" << height
+        << " strength " << strength << " weight " << filter_weight;
+  }
+
+  TemporalFilterFunc filter_func_;
+};
+
+TEST_P(TemporalFilterTest, MatchesC) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  static const int kSizes[][2] = { { 16, 16 }, { 8, 8 }, { 16, 8 }, { 8, 16 } };
+  static const int kMaxDiffs[] = { 2, 8, 32, 255 };
+
+  for (int i = 0; i < kNumIterations; ++i) {
+    const int size = i % 4;
+    CheckBlock(&rnd, kSizes[size][0], kSizes[size][1], rnd.PseudoUniform(7),
+               rnd.PseudoUniform(3), kMaxDiffs[(i / 4) % 4]);
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(C, TemporalFilterTest,
+                        ::testing::Values(&vp9_temporal_filter_apply_c));
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(AVX2, TemporalFilterTest,
+                        ::testing::Values(&vp9_temporal_filter_apply_avx2));
+#endif  // HAVE_AVX2
+
+}  // namespace
@@ -19,6 +19,7 @@
 #include "test/webm_video_source.h"
 #endif
 #include "vpx_util/vpx_thread.h"
+#include "vpx_util/vpx_thread_pool.h"
 
 namespace {
 
@@ -149,6 +150,47 @@ TEST(VPxWorkerThreadTest, TestInterfaceAPI) {
   }
 }
 
+TEST(VPxWorkerThreadTest, TestThreadPool) {
+  // Run more workers than there are pool threads.
+  static const int kNumWorkers = 16;
+  const VPxWorkerInterface *const winterface = vpx_get_thread_pool_interface();
+  VPxWorker workers[kNumWorkers];
+  int hook_data[kNumWorkers];
+  int return_value[kNumWorkers];
+
+  ASSERT_EQ(CONFIG_MULTITHREAD, vpx_thread_pool_init(2));
+
+  for (int n = 0; n < kNumWorkers; ++n) {
+    winterface->init(&workers[n]);
+    return_value[n] = n & 1;  // odd workers return successfully
+    workers[n].hook = ThreadHook;
+    workers[n].data1 = &hook_data[n];
+    workers[n].data2 = &return_value[n];
+  }
+
+  for (int i = 0; i < 2; ++i) {
+    for (int n = 0; n < kNumWorkers; ++n) {
+      EXPECT_NE(winterface->reset(&workers[n]), 0);
+      hook_data[n] = 0;
+    }
+
+    for (int n = 0; n < kNumWorkers; ++n) {
+      winterface->launch(&workers[n]);
+    }
+
+    for (int n = kNumWorkers - 1; n >= 0; --n) {
+      EXPECT_EQ(n & 1, winterface->sync(&workers[n]));
+      EXPECT_EQ(5, hook_data[n]);
+    }
+  }
+
+  for (int n = 0; n < kNumWorkers; ++n) {
+    winterface->end(&workers[n]);
+  }
+  vpx_thread_pool_end();
+  EXPECT_EQ(0, vpx_thread_pool_get_num_threads());
+}
+
 // -----------------------------------------------------------------------------
 // Multi-threaded decode tests
 
@@ -158,14 +200,16 @@ struct FileList {
   const char *expected_md5;
 };
 
-// Decodes |filename| with |num_threads|. Returns the md5 of the decoded frames.
-string DecodeFile(const string& filename, int num_threads) {
+// Decodes |filename| with |num_threads|, using row based multi-threading if
+// |row_mt| is set. Returns the md5 of the decoded frames.
+string DecodeFile(const string& filename, int num_threads, int row_mt = 0) {
   libvpx_test::WebMVideoSource video(filename);
   video.Init();
 
   vpx_codec_dec_cfg_t cfg = vpx_codec_dec_cfg_t();
   cfg.threads = num_threads;
   libvpx_test::VP9Decoder decoder(cfg, 0);
+  if (row_mt) decoder.Control(VP9D_SET_ROW_MT, row_mt);
 
   libvpx_test::MD5 md5;
   for (video.Begin(); video.cxdata(); video.Next()) {
@@ -187,11 +231,11 @@ string DecodeFile(const string& filename, int num_threads) {
   return string(md5.Get());
 }
 
-void DecodeFiles(const FileList files[]) {
+void DecodeFiles(const FileList files[], int row_mt = 0) {
   for (const FileList *iter = files; iter->name != NULL; ++iter) {
     SCOPED_TRACE(iter->name);
     for (int t = 1; t <= 8; ++t) {
-      EXPECT_EQ(iter->expected_md5, DecodeFile(iter->name, t))
+      EXPECT_EQ(iter->expected_md5, DecodeFile(iter->name, t, row_mt))
           << "threads = " << t;
     }
   }
@@ -235,6 +279,26 @@ TEST(VPxWorkerThreadTest, TestSerialInterface) {
   EXPECT_EQ(expected_md5, DecodeFile(filename, 2));
 }
 
+TEST(VPxWorkerThreadTest, TestThreadPoolInterface) {
+  static const char expected_md5[] = "b35a1b707b28e82be025d960aba039bc";
+  static const char filename[] = "vp90-2-03-size-226x226.webm";
+  VPxWorkerInterface default_interface = *vpx_get_worker_interface();
+
+  // The loop filter and row based multi-threading hooks wait on each other;
+  // run them with more workers than there are pool threads.
+  ASSERT_EQ(CONFIG_MULTITHREAD, vpx_thread_pool_init(2));
+  EXPECT_NE(vpx_set_worker_interface(vpx_get_thread_pool_interface()), 0);
+  EXPECT_EQ(expected_md5, DecodeFile(filename, 4));
+  EXPECT_EQ(expected_md5, DecodeFile(filename, 4, 1));
+  EXPECT_EQ("988d86049e884c66909d2d163a09841a",
+            DecodeFile("vp90-2-08-tile_1x4.webm", 8));
+
+  // Reset the interface.
+  EXPECT_NE(vpx_set_worker_interface(&default_interface), 0);
+  vpx_thread_pool_end();
+  EXPECT_EQ(expected_md5, DecodeFile(filename, 4));
+}
+
 TEST(VP9DecodeMultiThreadedTest, NoTilesNonFrameParallel) {
   // no tiles or frame parallel; this exercises loop filter threading.
   EXPECT_EQ("b35a1b707b28e82be025d960aba039bc",
@@ -319,6 +383,19 @@ TEST(VP9DecodeMultiThreadedTest, NonFrameParallel) {
 
   DecodeFiles(files);
 }
+
+TEST(VP9DecodeMultiThreadedTest, RowMT) {
+  static const FileList files[] = {
+    { "vp90-2-03-size-226x226.webm", "b35a1b707b28e82be025d960aba039bc" },
+    { "vp90-2-08-tile_1x2.webm", "570b4a5d5a70d58b5359671668328a16" },
+    { "vp90-2-08-tile_1x4.webm", "988d86049e884c66909d2d163a09841a" },
+    { "vp90-2-08-tile-4x1.webm", "06505aade6647c583c8e00a2f582266f" },
+    { "vp90-2-08-tile-4x4.webm", "85c2299892460d76e2c600502d52bfe2" },
+    { NULL, NULL }
+  };
+
+  DecodeFiles(files, 1);
+}
 #endif  // CONFIG_WEBM_IO
 
 INSTANTIATE_TEST_CASE_P(Synchronous, VPxWorkerThreadTest, ::testing::Bool());
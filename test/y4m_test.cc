@@ -9,6 +9,7 @@
  */
 
 #include <string>
+#include <vector>
 
 #include "third_party/googletest/src/include/gtest/gtest.h"
 
@@ -134,6 +135,31 @@ TEST_P(Y4mVideoSourceTest, SourceTest) {
   Md5Check(t.md5raw);
 }
 
+// Reads the frames with y4m_input_fetch_frame_mapped() from a copy of the
+// file in memory, as vpxenc does from the mapping of the file.
+TEST_P(Y4mVideoSourceTest, MappedSourceTest) {
+  const Y4mTestParam t = GetParam();
+  file_name_ = t.filename;
+  OpenSource();
+  ASSERT_FALSE(y4m_input_open(&y4m_, input_file_, NULL, 0, 0));
+
+  std::vector<unsigned char> data;
+  unsigned char buf[4096];
+  size_t len;
+  while ((len = fread(buf, 1, sizeof(buf), input_file_)) > 0)
+    data.insert(data.end(), buf, buf + len);
+  ASSERT_FALSE(data.empty());
+
+  const unsigned char *pos = &data[0];
+  const unsigned char *const end = pos + data.size();
+  libvpx_test::MD5 md5;
+  for (unsigned int i = 0; i < kFrames; i++) {
+    ASSERT_EQ(1, y4m_input_fetch_frame_mapped(&y4m_, &pos, end, img_.get()));
+    md5.Add(img_.get());
+  }
+  ASSERT_EQ(string(md5.Get()), t.md5raw);
+}
+
 INSTANTIATE_TEST_CASE_P(C, Y4mVideoSourceTest,
                         ::testing::ValuesIn(kY4mTestVectors));
 
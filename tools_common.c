@@ -24,6 +24,14 @@
 #include "vpx/vp8dx.h"
 #endif
 
+#if CONFIG_OS_SUPPORT && !defined(_WIN32) && !defined(__OS2__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define HAVE_INPUT_MAP 1
+#else
+#define HAVE_INPUT_MAP 0
+#endif
+
 #if defined(_WIN32) || defined(__OS2__)
 #include <io.h>
 #include <fcntl.h>
@@ -130,6 +138,60 @@ int read_yuv_frame(struct VpxInputContext *input_ctx, vpx_image_t *yuv_frame) {
   return shortread;
 }
 
+int vpx_input_map(struct VpxInputContext *input_ctx) {
+#if HAVE_INPUT_MAP
+  struct VpxInputMap *const map = &input_ctx->map;
+  const int fd = fileno(input_ctx->file);
+  const int64_t pos = ftello(input_ctx->file);
+  struct stat st;
+  void *data;
+
+  if (fstat(fd, &st) || !S_ISREG(st.st_mode) || st.st_size <= 0 ||
+      (off_t)(size_t)st.st_size != st.st_size || pos < 0 || pos > st.st_size)
+    return 0;
+
+  data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (data == MAP_FAILED)
+    return 0;
+
+  map->data = (const uint8_t *)data;
+  map->size = (size_t)st.st_size;
+  map->pos = (size_t)pos;
+  return 1;
+#else
+  (void)input_ctx;
+  return 0;
+#endif
+}
+
+void vpx_input_unmap(struct VpxInputContext *input_ctx) {
+  struct VpxInputMap *const map = &input_ctx->map;
+#if HAVE_INPUT_MAP
+  if (map->data)
+    munmap((void *)(uintptr_t)map->data, map->size);
+#endif
+  map->data = NULL;
+  map->size = 0;
+  map->pos = 0;
+}
+
+const uint8_t *vpx_input_map_read(struct VpxInputMap *map, size_t size) {
+  const uint8_t *data;
+
+  if (size > map->size - map->pos)
+    return NULL;
+
+  data = map->data + map->pos;
+  map->pos += size;
+  return data;
+}
+
+int64_t vpx_input_tell(struct VpxInputContext *input_ctx) {
+  if (input_ctx->map.data)
+    return (int64_t)input_ctx->map.pos;
+  return ftello(input_ctx->file);
+}
+
 #if CONFIG_ENCODERS
 
 static const VpxInterface vpx_encoders[] = {
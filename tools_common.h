@@ -82,6 +82,16 @@ struct VpxRational {
   int denominator;
 };
 
+/* A read-only memory mapping of the whole input file. The readers that
+ * support it hand out pointers into |data| from |pos| onwards instead of
+ * reading the file with stdio. |data| is NULL when the input isn't mapped.
+ */
+struct VpxInputMap {
+  const uint8_t *data;
+  size_t size;
+  size_t pos;
+};
+
 struct VpxInputContext {
   const char *filename;
   FILE *file;
@@ -96,6 +106,7 @@ struct VpxInputContext {
   int only_i420;
   uint32_t fourcc;
   struct VpxRational framerate;
+  struct VpxInputMap map;
 #if CONFIG_ENCODERS
   y4m_input y4m;
 #endif
@@ -127,6 +138,21 @@ void usage_exit(void) VPX_NO_RETURN;
 
 int read_yuv_frame(struct VpxInputContext *input_ctx, vpx_image_t *yuv_frame);
 
+/* Memory maps the input file when it is a regular file, with reading starting
+ * at the current position of |input_ctx->file|. Returns 0 if the file can't
+ * be mapped, e.g. for pipes, in which case the readers keep using stdio.
+ */
+int vpx_input_map(struct VpxInputContext *input_ctx);
+void vpx_input_unmap(struct VpxInputContext *input_ctx);
+
+/* Returns a pointer to the next |size| bytes of the mapping and skips over
+ * them, or NULL if fewer than |size| bytes are left.
+ */
+const uint8_t *vpx_input_map_read(struct VpxInputMap *map, size_t size);
+
+/* Returns how far the input file has been read. */
+int64_t vpx_input_tell(struct VpxInputContext *input_ctx);
+
 typedef struct VpxInterface {
   const char *const name;
   const uint32_t fourcc;
@@ -32,6 +32,8 @@ void vp8_de_alloc_frame_buffers(VP8_COMMON *oci)
 
     vpx_free(oci->pp_limits_buffer);
     oci->pp_limits_buffer = NULL;
+    vpx_free(oci->pp_noise_offsets);
+    oci->pp_noise_offsets = NULL;
 #endif
 
     vpx_free(oci->above_context);
@@ -108,13 +110,23 @@ int vp8_alloc_frame_buffers(VP8_COMMON *oci, int width, int height)
     memset(oci->post_proc_buffer.buffer_alloc, 128,
            oci->post_proc_buffer.frame_size);
 
-    /* Allocate buffer to store post-processing filter coefficients.
+    /* Allocate buffer to store post-processing filter coefficients, one
+     * per band of vp8_post_proc_frame_mt().
      *
      * Note: Round up mb_cols to support SIMD reads
      */
-    oci->pp_limits_buffer = vpx_memalign(16, 24 * ((oci->mb_cols + 1) & ~1));
+    oci->pp_limits_buffer =
+        vpx_memalign(16, VP8_PP_MAX_BANDS * VP8_PP_LIMITS_SIZE(oci->mb_cols));
     if (!oci->pp_limits_buffer)
         goto allocation_fail;
+
+    /* The rand() drawn noise offset of each line of post_proc_buffer, drawn
+     * in line order before the noise is added in bands.
+     */
+    oci->pp_noise_offsets =
+        vpx_malloc(sizeof(*oci->pp_noise_offsets) * height);
+    if (!oci->pp_noise_offsets)
+        goto allocation_fail;
 #endif
 
     return 0;
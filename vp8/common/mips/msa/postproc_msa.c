@@ -682,10 +682,10 @@ void vp8_mbpost_proc_across_ip_msa(uint8_t *src_ptr, int32_t pitch,
 }
 
 void vp8_mbpost_proc_down_msa(uint8_t *dst_ptr, int32_t pitch, int32_t rows,
-                              int32_t cols, int32_t flimit)
+                              int32_t cols, int32_t flimit, int32_t rv_offset)
 {
     int32_t row, col, cnt, i;
-    const int16_t *rv3 = &vp8_rv_msa[63 & rand()];
+    const int16_t *rv3 = &vp8_rv_msa[rv_offset];
     v4i32 flimit_vec;
     v16u8 dst7, dst8, dst_r_b, dst_l_b;
     v16i8 mask;
@@ -803,16 +803,16 @@ void vp8_plane_add_noise_msa(uint8_t *start_ptr, char *noise,
                              char blackclamp[16], char whiteclamp[16],
                              char bothclamp[16],
                              uint32_t width, uint32_t height,
-                             int32_t pitch)
+                             int32_t pitch, const int32_t *noise_offsets)
 {
     uint32_t i, j;
 
     for (i = 0; i < height / 2; ++i)
     {
         uint8_t *pos0_ptr = start_ptr + (2 * i) * pitch;
-        int8_t *ref0_ptr = (int8_t *) (noise + (rand() & 0xff));
+        int8_t *ref0_ptr = (int8_t *) (noise + noise_offsets[2 * i]);
         uint8_t *pos1_ptr = start_ptr + (2 * i + 1) * pitch;
-        int8_t *ref1_ptr = (int8_t *) (noise + (rand() & 0xff));
+        int8_t *ref1_ptr = (int8_t *) (noise + noise_offsets[2 * i + 1]);
         for (j = width / 16; j--;)
         {
             v16i8 temp00_s, temp01_s;
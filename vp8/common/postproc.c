@@ -265,10 +265,10 @@ void vp8_mbpost_proc_across_ip_c(unsigned char *src, int pitch, int rows, int co
     }
 }
 
-void vp8_mbpost_proc_down_c(unsigned char *dst, int pitch, int rows, int cols, int flimit)
+void vp8_mbpost_proc_down_c(unsigned char *dst, int pitch, int rows, int cols, int flimit, int rv_offset)
 {
     int r, c, i;
-    const short *rv3 = &vp8_rv[63&rand()];
+    const short *rv3 = &vp8_rv[rv_offset];
 
     for (c = 0; c < cols; c++ )
     {
@@ -311,73 +311,87 @@ void vp8_mbpost_proc_down_c(unsigned char *dst, int pitch, int rows, int cols, i
 }
 
 #if CONFIG_POSTPROC
-static void vp8_de_mblock(YV12_BUFFER_CONFIG         *post,
-                          int                         q)
+static int q2ppl(int q)
 {
-    vp8_mbpost_proc_across_ip(post->y_buffer, post->y_stride, post->y_height,
-                              post->y_width, q2mbl(q));
-    vp8_mbpost_proc_down(post->y_buffer, post->y_stride, post->y_height,
-                         post->y_width, q2mbl(q));
+    double level = 6.0e-05 * q * q * q - .0067 * q * q + .306 * q + .0065;
+    return (int)(level + .5);
 }
 
-void vp8_deblock(VP8_COMMON                 *cm,
-                 YV12_BUFFER_CONFIG         *source,
-                 YV12_BUFFER_CONFIG         *post,
-                 int                         q,
-                 int                         low_var_thresh,
-                 int                         flag)
+/* Deblocks the macroblock rows [start_mb_row, end_mb_row) of source into
+ * post. 'limits' holds VP8_PP_LIMITS_SIZE(mb_cols) bytes of scratch for the
+ * per pixel thresholds, so that row bands running in parallel each need their
+ * own.
+ */
+static void deblock_mb_rows(VP8_COMMON                 *cm,
+                            YV12_BUFFER_CONFIG         *source,
+                            YV12_BUFFER_CONFIG         *post,
+                            int                         ppl,
+                            unsigned char              *limits,
+                            int                         start_mb_row,
+                            int                         end_mb_row)
 {
-    double level = 6.0e-05 * q * q * q - .0067 * q * q + .306 * q + .0065;
-    int ppl = (int)(level + .5);
-
-    const MODE_INFO *mode_info_context = cm->show_frame_mi;
+    const MODE_INFO *mode_info_context =
+        cm->show_frame_mi + start_mb_row * (cm->mb_cols + 1);
     int mbr, mbc;
 
     /* The pixel thresholds are adjusted according to if or not the macroblock
      * is a skipped block.  */
-    unsigned char *ylimits = cm->pp_limits_buffer;
-    unsigned char *uvlimits = cm->pp_limits_buffer + 16 * cm->mb_cols;
-    (void) low_var_thresh;
-    (void) flag;
+    unsigned char *ylimits = limits;
+    unsigned char *uvlimits = limits + 16 * cm->mb_cols;
 
-    if (ppl > 0)
+    for (mbr = start_mb_row; mbr < end_mb_row; mbr++)
     {
-        for (mbr = 0; mbr < cm->mb_rows; mbr++)
+        unsigned char *ylptr = ylimits;
+        unsigned char *uvlptr = uvlimits;
+        for (mbc = 0; mbc < cm->mb_cols; mbc++)
         {
-            unsigned char *ylptr = ylimits;
-            unsigned char *uvlptr = uvlimits;
-            for (mbc = 0; mbc < cm->mb_cols; mbc++)
-            {
-                unsigned char mb_ppl;
+            unsigned char mb_ppl;
 
-                if (mode_info_context->mbmi.mb_skip_coeff)
-                    mb_ppl = (unsigned char)ppl >> 1;
-                else
-                    mb_ppl = (unsigned char)ppl;
+            if (mode_info_context->mbmi.mb_skip_coeff)
+                mb_ppl = (unsigned char)ppl >> 1;
+            else
+                mb_ppl = (unsigned char)ppl;
 
-                memset(ylptr, mb_ppl, 16);
-                memset(uvlptr, mb_ppl, 8);
+            memset(ylptr, mb_ppl, 16);
+            memset(uvlptr, mb_ppl, 8);
 
-                ylptr += 16;
-                uvlptr += 8;
-                mode_info_context++;
-            }
+            ylptr += 16;
+            uvlptr += 8;
             mode_info_context++;
-
-            vp8_post_proc_down_and_across_mb_row(
-                source->y_buffer + 16 * mbr * source->y_stride,
-                post->y_buffer + 16 * mbr * post->y_stride, source->y_stride,
-                post->y_stride, source->y_width, ylimits, 16);
-
-            vp8_post_proc_down_and_across_mb_row(
-                source->u_buffer + 8 * mbr * source->uv_stride,
-                post->u_buffer + 8 * mbr * post->uv_stride, source->uv_stride,
-                post->uv_stride, source->uv_width, uvlimits, 8);
-            vp8_post_proc_down_and_across_mb_row(
-                source->v_buffer + 8 * mbr * source->uv_stride,
-                post->v_buffer + 8 * mbr * post->uv_stride, source->uv_stride,
-                post->uv_stride, source->uv_width, uvlimits, 8);
         }
+        mode_info_context++;
+
+        vp8_post_proc_down_and_across_mb_row(
+            source->y_buffer + 16 * mbr * source->y_stride,
+            post->y_buffer + 16 * mbr * post->y_stride, source->y_stride,
+            post->y_stride, source->y_width, ylimits, 16);
+
+        vp8_post_proc_down_and_across_mb_row(
+            source->u_buffer + 8 * mbr * source->uv_stride,
+            post->u_buffer + 8 * mbr * post->uv_stride, source->uv_stride,
+            post->uv_stride, source->uv_width, uvlimits, 8);
+        vp8_post_proc_down_and_across_mb_row(
+            source->v_buffer + 8 * mbr * source->uv_stride,
+            post->v_buffer + 8 * mbr * post->uv_stride, source->uv_stride,
+            post->uv_stride, source->uv_width, uvlimits, 8);
+    }
+}
+
+void vp8_deblock(VP8_COMMON                 *cm,
+                 YV12_BUFFER_CONFIG         *source,
+                 YV12_BUFFER_CONFIG         *post,
+                 int                         q,
+                 int                         low_var_thresh,
+                 int                         flag)
+{
+    int ppl = q2ppl(q);
+    (void) low_var_thresh;
+    (void) flag;
+
+    if (ppl > 0)
+    {
+        deblock_mb_rows(cm, source, post, ppl, cm->pp_limits_buffer, 0,
+                        cm->mb_rows);
     } else
     {
         vp8_yv12_copy_frame(source, post);
@@ -499,8 +513,8 @@ static void fillrd(struct postproc_state *state, int q, int a)
  *                  unsigned int Width    width of plane
  *                  unsigned int Height   height of plane
  *                  int  Pitch    distance between subsequent lines of frame
- *                  int  q        quantizer used to determine amount of noise
- *                                  to add
+ *                  const int *noise_offsets  offset into noise of the noise
+ *                                  added to each line, drawn by the caller
  *
  *  OUTPUTS       : None.
  *
@@ -515,7 +529,8 @@ void vp8_plane_add_noise_c(unsigned char *Start, char *noise,
                            char blackclamp[16],
                            char whiteclamp[16],
                            char bothclamp[16],
-                           unsigned int Width, unsigned int Height, int Pitch)
+                           unsigned int Width, unsigned int Height, int Pitch,
+                           const int *noise_offsets)
 {
     unsigned int i, j;
     (void)bothclamp;
@@ -523,7 +538,7 @@ void vp8_plane_add_noise_c(unsigned char *Start, char *noise,
     for (i = 0; i < Height; i++)
     {
         unsigned char *Pos = Start + i * Pitch;
-        char  *Ref = (char *)(noise + (rand() & 0xff));
+        char  *Ref = (char *)(noise + noise_offsets[i]);
 
         for (j = 0; j < Width; j++)
         {
@@ -721,8 +736,129 @@ static void constrain_line (int x_0, int *x_1, int y_0, int *y_1, int width, int
 #endif  // CONFIG_POSTPROC_VISUALIZER
 
 #if CONFIG_POSTPROC
+/* State shared by the bands of the passes of vp8_post_proc_frame_mt(). */
+typedef struct
+{
+    VP8_COMMON         *cm;
+    YV12_BUFFER_CONFIG *source;
+    YV12_BUFFER_CONFIG *post;
+    int                 ppl;          /* 0 when post already holds source */
+    int                 demacroblock;
+    int                 flimit;
+    int                 rv_offset;    /* dither offset of the down filter */
+
+    vp8_pp_execute_fn   execute;
+    void               *executor;
+    int                 num_bands;
+} PP_BANDS;
+
+static void run_bands(PP_BANDS *pp, vp8_pp_band_fn fn)
+{
+    if (pp->num_bands > 1)
+        pp->execute(pp->executor, fn, pp, pp->num_bands);
+    else
+        fn(pp, 0, 1);
+}
+
+/* Deblocks a band of macroblock rows and runs the horizontal demacroblocking
+ * filter over the same rows, which only reads the band's own pixels.
+ */
+static void deblock_band(void *arg, int band, int num_bands)
+{
+    PP_BANDS *const pp = (PP_BANDS *)arg;
+    VP8_COMMON *const cm = pp->cm;
+    YV12_BUFFER_CONFIG *const post = pp->post;
+    const int start = band * cm->mb_rows / num_bands;
+    const int end = (band + 1) * cm->mb_rows / num_bands;
+
+    if (end <= start)
+        return;
+
+    if (pp->ppl > 0)
+        deblock_mb_rows(cm, pp->source, post, pp->ppl,
+                        cm->pp_limits_buffer +
+                            band * VP8_PP_LIMITS_SIZE(cm->mb_cols),
+                        start, end);
+
+    if (pp->demacroblock)
+        vp8_mbpost_proc_across_ip(post->y_buffer + 16 * start * post->y_stride,
+                                  post->y_stride, 16 * (end - start),
+                                  post->y_width, pp->flimit);
+}
+
+/* The vertical demacroblocking filter runs down whole columns, so it is split
+ * into column bands. Bands start on multiples of 128 columns, the period of
+ * the dither pattern within a call, and share the dither offset drawn for the
+ * frame.
+ */
+static void mbpost_proc_down_band(void *arg, int band, int num_bands)
+{
+    PP_BANDS *const pp = (PP_BANDS *)arg;
+    YV12_BUFFER_CONFIG *const post = pp->post;
+    const int units = (post->y_width + 127) >> 7;
+    const int start = (band * units / num_bands) << 7;
+    int end = ((band + 1) * units / num_bands) << 7;
+
+    if (end > post->y_width)
+        end = post->y_width;
+
+    if (end > start)
+        vp8_mbpost_proc_down(post->y_buffer + start, post->y_stride,
+                             post->y_height, end - start, pp->flimit,
+                             pp->rv_offset);
+}
+
+/* Adds the noise to a band of lines, at the offsets drawn for the frame. */
+static void add_noise_band(void *arg, int band, int num_bands)
+{
+    PP_BANDS *const pp = (PP_BANDS *)arg;
+    YV12_BUFFER_CONFIG *const post = pp->post;
+    struct postproc_state *const state = &pp->cm->postproc_state;
+    const int start = band * post->y_height / num_bands;
+    const int end = (band + 1) * post->y_height / num_bands;
+
+    if (end > start)
+        vp8_plane_add_noise(post->y_buffer + start * post->y_stride,
+                            state->noise, state->blackclamp,
+                            state->whiteclamp, state->bothclamp,
+                            post->y_width, end - start, post->y_stride,
+                            pp->cm->pp_noise_offsets + start);
+}
+
+static void deblock_frame(PP_BANDS *pp, YV12_BUFFER_CONFIG *source, int q,
+                          int demacroblock)
+{
+    pp->source = source;
+    pp->ppl = q2ppl(q);
+    pp->demacroblock = demacroblock;
+    pp->flimit = q2mbl(q);
+
+    if (pp->ppl <= 0)
+        vp8_yv12_copy_frame(source, pp->post);
+
+    if (pp->ppl > 0 || demacroblock)
+        run_bands(pp, deblock_band);
+
+    if (demacroblock)
+    {
+        /* rand() is drawn here rather than in the bands, in the order of the
+         * serial filter, so that the output does not depend on the bands.
+         */
+        pp->rv_offset = 63 & rand();
+        run_bands(pp, mbpost_proc_down_band);
+    }
+}
+
 int vp8_post_proc_frame(VP8_COMMON *oci, YV12_BUFFER_CONFIG *dest, vp8_ppflags_t *ppflags)
 {
+    return vp8_post_proc_frame_mt(oci, dest, ppflags, NULL, NULL, 1);
+}
+
+int vp8_post_proc_frame_mt(VP8_COMMON *oci, YV12_BUFFER_CONFIG *dest,
+                           vp8_ppflags_t *ppflags, vp8_pp_execute_fn execute,
+                           void *executor, int num_bands)
+{
+    PP_BANDS pp;
     int q = oci->filter_level * 10 / 6;
     int flags = ppflags->post_proc_flag;
     int deblock_level = ppflags->deblocking_level;
@@ -772,6 +908,14 @@ int vp8_post_proc_frame(VP8_COMMON *oci, YV12_BUFFER_CONFIG *dest, vp8_ppflags_t
 
     vp8_clear_system_state();
 
+    pp.cm = oci;
+    pp.post = &oci->post_proc_buffer;
+    pp.execute = execute;
+    pp.executor = executor;
+    pp.num_bands = execute ? num_bands : 1;
+    if (pp.num_bands > VP8_PP_MAX_BANDS)
+        pp.num_bands = VP8_PP_MAX_BANDS;
+
     if ((flags & VP8D_MFQE) &&
          oci->postproc_state.last_frame_valid &&
          oci->current_video_frame >= 2 &&
@@ -785,15 +929,12 @@ int vp8_post_proc_frame(VP8_COMMON *oci, YV12_BUFFER_CONFIG *dest, vp8_ppflags_t
             vp8_yv12_copy_frame(&oci->post_proc_buffer, &oci->post_proc_buffer_int);
             if (flags & VP8D_DEMACROBLOCK)
             {
-                vp8_deblock(oci, &oci->post_proc_buffer_int, &oci->post_proc_buffer,
-                                               q + (deblock_level - 5) * 10, 1, 0);
-                vp8_de_mblock(&oci->post_proc_buffer,
-                              q + (deblock_level - 5) * 10);
+                deblock_frame(&pp, &oci->post_proc_buffer_int,
+                              q + (deblock_level - 5) * 10, 1);
             }
             else if (flags & VP8D_DEBLOCK)
             {
-                vp8_deblock(oci, &oci->post_proc_buffer_int, &oci->post_proc_buffer,
-                            q, 1, 0);
+                deblock_frame(&pp, &oci->post_proc_buffer_int, q, 0);
             }
         }
         /* Move partially towards the base q of the previous frame */
@@ -801,16 +942,14 @@ int vp8_post_proc_frame(VP8_COMMON *oci, YV12_BUFFER_CONFIG *dest, vp8_ppflags_t
     }
     else if (flags & VP8D_DEMACROBLOCK)
     {
-        vp8_deblock(oci, oci->frame_to_show, &oci->post_proc_buffer,
-                                     q + (deblock_level - 5) * 10, 1, 0);
-        vp8_de_mblock(&oci->post_proc_buffer, q + (deblock_level - 5) * 10);
+        deblock_frame(&pp, oci->frame_to_show, q + (deblock_level - 5) * 10,
+                      1);
 
         oci->postproc_state.last_base_qindex = oci->base_qindex;
     }
     else if (flags & VP8D_DEBLOCK)
     {
-        vp8_deblock(oci, oci->frame_to_show, &oci->post_proc_buffer,
-                    q, 1, 0);
+        deblock_frame(&pp, oci->frame_to_show, q, 0);
         oci->postproc_state.last_base_qindex = oci->base_qindex;
     }
     else
@@ -822,20 +961,18 @@ int vp8_post_proc_frame(VP8_COMMON *oci, YV12_BUFFER_CONFIG *dest, vp8_ppflags_t
 
     if (flags & VP8D_ADDNOISE)
     {
+        int i;
+
         if (oci->postproc_state.last_q != q
             || oci->postproc_state.last_noise != noise_level)
         {
             fillrd(&oci->postproc_state, 63 - q, noise_level);
         }
 
-        vp8_plane_add_noise
-        (oci->post_proc_buffer.y_buffer,
-         oci->postproc_state.noise,
-         oci->postproc_state.blackclamp,
-         oci->postproc_state.whiteclamp,
-         oci->postproc_state.bothclamp,
-         oci->post_proc_buffer.y_width, oci->post_proc_buffer.y_height,
-         oci->post_proc_buffer.y_stride);
+        for (i = 0; i < pp.post->y_height; i++)
+            oci->pp_noise_offsets[i] = rand() & 0xff;
+
+        run_bands(&pp, add_noise_band);
     }
 
 #if CONFIG_POSTPROC_VISUALIZER
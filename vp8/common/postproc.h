@@ -33,6 +33,31 @@ extern "C" {
 int vp8_post_proc_frame(struct VP8Common *oci, YV12_BUFFER_CONFIG *dest,
                         vp8_ppflags_t *flags);
 
+/* Maximum number of bands the passes of vp8_post_proc_frame_mt() are split
+ * into, and the size of the deblocking thresholds scratch each band owns in
+ * pp_limits_buffer.
+ */
+#define VP8_PP_MAX_BANDS 8
+#define VP8_PP_LIMITS_SIZE(mb_cols) (24 * (((mb_cols) + 1) & ~1))
+
+/* Processes band 'band' of 'num_bands' of a postprocessing pass. */
+typedef void (*vp8_pp_band_fn)(void *arg, int band, int num_bands);
+
+/* Runs fn(arg, band, num_bands) for every band, possibly in parallel, and
+ * returns once all of them are done.
+ */
+typedef void (*vp8_pp_execute_fn)(void *executor, vp8_pp_band_fn fn,
+                                  void *arg, int num_bands);
+
+/* Same as vp8_post_proc_frame(), with the deblocking, demacroblocking and
+ * noise passes split into num_bands bands run by execute. The rand() drawn
+ * dither and noise offsets are drawn on the calling thread, in the order of
+ * vp8_post_proc_frame(), so the output is the same for any num_bands.
+ */
+int vp8_post_proc_frame_mt(struct VP8Common *oci, YV12_BUFFER_CONFIG *dest,
+                           vp8_ppflags_t *flags, vp8_pp_execute_fn execute,
+                           void *executor, int num_bands);
+
 
 void vp8_de_noise(struct VP8Common           *oci,
                   YV12_BUFFER_CONFIG         *source,
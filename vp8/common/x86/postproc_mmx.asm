@@ -15,7 +15,9 @@
 %define VP8_FILTER_SHIFT  7
 
 ;void vp8_mbpost_proc_down_mmx(unsigned char *dst,
-;                             int pitch, int rows, int cols,int flimit)
+;                             int pitch, int rows, int cols,int flimit,
+;                             int rv_offset)
+; rv_offset is not used, the dither starts at vp8_rv.
 extern sym(vp8_rv)
 global sym(vp8_mbpost_proc_down_mmx) PRIVATE
 sym(vp8_mbpost_proc_down_mmx):
@@ -245,26 +247,28 @@ sym(vp8_mbpost_proc_down_mmx):
 ;                            unsigned char blackclamp[16],
 ;                            unsigned char whiteclamp[16],
 ;                            unsigned char bothclamp[16],
-;                            unsigned int Width, unsigned int Height, int Pitch)
+;                            unsigned int Width, unsigned int Height, int Pitch,
+;                            const int *noise_offsets)
 global sym(vp8_plane_add_noise_mmx) PRIVATE
 sym(vp8_plane_add_noise_mmx):
     push        rbp
     mov         rbp, rsp
-    SHADOW_ARGS_TO_STACK 8
+    SHADOW_ARGS_TO_STACK 9
     GET_GOT     rbx
     push        rsi
     push        rdi
     ; end prolog
 
 .addnoise_loop:
-    call sym(LIBVPX_RAND) WRT_PLT
+    mov     rcx, arg(8) ;noise_offsets
+    mov     eax, dword ptr [rcx]
+    add     rcx, 4
+    mov     arg(8), rcx
     mov     rcx, arg(1) ;noise
-    and     rax, 0xff
     add     rcx, rax
 
     ; we rely on the fact that the clamping vectors are stored contiguously
-    ; in black/white/both order. Note that we have to reload this here because
-    ; rdx could be trashed by rand()
+    ; in black/white/both order.
     mov     rdx, arg(2) ; blackclamp
 
 
@@ -424,6 +424,13 @@ int vp8dx_get_raw_frame(VP8D_COMP *pbi, YV12_BUFFER_CONFIG *sd, int64_t *time_st
     *time_end_stamp = 0;
 
 #if CONFIG_POSTPROC
+#if CONFIG_MULTITHREAD
+    if (pbi->b_multithreaded_rd)
+        ret = vp8_post_proc_frame_mt(&pbi->common, sd, flags,
+                                     vp8mt_post_proc_execute, pbi,
+                                     pbi->decoding_thread_count + 1);
+    else
+#endif
     ret = vp8_post_proc_frame(&pbi->common, sd, flags);
 #else
     (void)flags;
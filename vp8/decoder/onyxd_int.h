@@ -106,6 +106,14 @@ typedef struct VP8D_COMP
     pthread_t           *h_decoding_thread;
     sem_t               *h_event_start_decoding;
     sem_t                h_event_end_decoding;
+
+#if CONFIG_POSTPROC
+    /* postprocessing band pass run by the decoding threads */
+    vp8_pp_band_fn       pp_band_fn;
+    void                *pp_band_arg;
+    int                  pp_num_bands;
+    sem_t                h_event_end_postproc;
+#endif
     /* end of threading data */
 #endif
 
@@ -11,6 +11,7 @@
 
 #include "vpx_config.h"
 #include "vp8_rtcd.h"
+#include <assert.h>
 #if !defined(WIN32) && CONFIG_OS_SUPPORT == 1
 # include <unistd.h>
 #endif
@@ -634,6 +635,14 @@ static THREAD_FUNCTION thread_decoding_proc(void *p_data)
         {
             if (protected_read(&pbi->mt_mutex, &pbi->b_multithreaded_rd) == 0)
                 break;
+#if CONFIG_POSTPROC
+            else if (pbi->pp_band_fn)
+            {
+                pbi->pp_band_fn(pbi->pp_band_arg, ithread + 1,
+                                pbi->pp_num_bands);
+                sem_post(&pbi->h_event_end_postproc);
+            }
+#endif
             else
             {
                 MACROBLOCKD *xd = &mbrd->mbd;
@@ -688,6 +697,10 @@ void vp8_decoder_create_threads(VP8D_COMP *pbi)
         }
 
         sem_init(&pbi->h_event_end_decoding, 0, 0);
+#if CONFIG_POSTPROC
+        sem_init(&pbi->h_event_end_postproc, 0, 0);
+        pbi->pp_band_fn = NULL;
+#endif
 
         pbi->allocated_decoding_thread_count = pbi->decoding_thread_count;
     }
@@ -867,6 +880,9 @@ void vp8_decoder_remove_threads(VP8D_COMP *pbi)
         }
 
         sem_destroy(&pbi->h_event_end_decoding);
+#if CONFIG_POSTPROC
+        sem_destroy(&pbi->h_event_end_postproc);
+#endif
 
             vpx_free(pbi->h_decoding_thread);
             pbi->h_decoding_thread = NULL;
@@ -929,3 +945,31 @@ void vp8mt_decode_mb_rows( VP8D_COMP *pbi, MACROBLOCKD *xd)
 
     sem_wait(&pbi->h_event_end_decoding);   /* add back for each frame */
 }
+
+#if CONFIG_POSTPROC
+/* vp8_pp_execute_fn running the bands on the decoding threads, which are idle
+ * between frames. Band 0 runs on the calling thread.
+ */
+void vp8mt_post_proc_execute(void *executor, vp8_pp_band_fn fn, void *arg,
+                             int num_bands)
+{
+    VP8D_COMP *pbi = (VP8D_COMP *)executor;
+    int i;
+
+    assert(num_bands <= (int)pbi->decoding_thread_count + 1);
+
+    pbi->pp_band_fn = fn;
+    pbi->pp_band_arg = arg;
+    pbi->pp_num_bands = num_bands;
+
+    for (i = 0; i < num_bands - 1; i++)
+        sem_post(&pbi->h_event_start_decoding[i]);
+
+    fn(arg, 0, num_bands);
+
+    for (i = 0; i < num_bands - 1; i++)
+        sem_wait(&pbi->h_event_end_postproc);
+
+    pbi->pp_band_fn = NULL;
+}
+#endif
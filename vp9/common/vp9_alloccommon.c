@@ -113,6 +113,9 @@ void vp9_free_postproc_buffers(VP9_COMMON *cm) {
 #if CONFIG_VP9_POSTPROC
   vpx_free_frame_buffer(&cm->post_proc_buffer);
   vpx_free_frame_buffer(&cm->post_proc_buffer_int);
+  vpx_free(cm->postproc_state.noise_offsets);
+  cm->postproc_state.noise_offsets = NULL;
+  cm->postproc_state.noise_offsets_rows = 0;
 #else
   (void)cm;
 #endif
@@ -47,8 +47,10 @@ void vp9_filter_by_weight16x16_c(const uint8_t *src, int src_stride,
   filter_by_weight(src, src_stride, dst, dst_stride, 16, src_weight);
 }
 
-static void filter_by_weight32x32(const uint8_t *src, int src_stride,
-                                  uint8_t *dst, int dst_stride, int weight) {
+// The C versions of the larger blocks are made of 16x16 calls, so that they
+// still use the SIMD 16x16 filter on targets without a wider one.
+void vp9_filter_by_weight32x32_c(const uint8_t *src, int src_stride,
+                                 uint8_t *dst, int dst_stride, int weight) {
   vp9_filter_by_weight16x16(src, src_stride, dst, dst_stride, weight);
   vp9_filter_by_weight16x16(src + 16, src_stride, dst + 16, dst_stride,
                             weight);
@@ -58,15 +60,15 @@ static void filter_by_weight32x32(const uint8_t *src, int src_stride,
                             dst + dst_stride * 16 + 16, dst_stride, weight);
 }
 
-static void filter_by_weight64x64(const uint8_t *src, int src_stride,
-                                  uint8_t *dst, int dst_stride, int weight) {
-  filter_by_weight32x32(src, src_stride, dst, dst_stride, weight);
-  filter_by_weight32x32(src + 32, src_stride, dst + 32,
-                        dst_stride, weight);
-  filter_by_weight32x32(src + src_stride * 32, src_stride,
-                        dst + dst_stride * 32, dst_stride, weight);
-  filter_by_weight32x32(src + src_stride * 32 + 32, src_stride,
-                        dst + dst_stride * 32 + 32, dst_stride, weight);
+void vp9_filter_by_weight64x64_c(const uint8_t *src, int src_stride,
+                                 uint8_t *dst, int dst_stride, int weight) {
+  vp9_filter_by_weight32x32(src, src_stride, dst, dst_stride, weight);
+  vp9_filter_by_weight32x32(src + 32, src_stride, dst + 32,
+                            dst_stride, weight);
+  vp9_filter_by_weight32x32(src + src_stride * 32, src_stride,
+                            dst + dst_stride * 32, dst_stride, weight);
+  vp9_filter_by_weight32x32(src + src_stride * 32 + 32, src_stride,
+                            dst + dst_stride * 32 + 32, dst_stride, weight);
 }
 
 static void apply_ifactor(const uint8_t *y, int y_stride, uint8_t *yd,
@@ -79,13 +81,13 @@ static void apply_ifactor(const uint8_t *y, int y_stride, uint8_t *yd,
     vp9_filter_by_weight8x8(u, uv_stride, ud, uvd_stride, weight);
     vp9_filter_by_weight8x8(v, uv_stride, vd, uvd_stride, weight);
   } else if (block_size == BLOCK_32X32) {
-    filter_by_weight32x32(y, y_stride, yd, yd_stride, weight);
+    vp9_filter_by_weight32x32(y, y_stride, yd, yd_stride, weight);
     vp9_filter_by_weight16x16(u, uv_stride, ud, uvd_stride, weight);
     vp9_filter_by_weight16x16(v, uv_stride, vd, uvd_stride, weight);
   } else if (block_size == BLOCK_64X64) {
-    filter_by_weight64x64(y, y_stride, yd, yd_stride, weight);
-    filter_by_weight32x32(u, uv_stride, ud, uvd_stride, weight);
-    filter_by_weight32x32(v, uv_stride, vd, uvd_stride, weight);
+    vp9_filter_by_weight64x64(y, y_stride, yd, yd_stride, weight);
+    vp9_filter_by_weight32x32(u, uv_stride, ud, uvd_stride, weight);
+    vp9_filter_by_weight32x32(v, uv_stride, vd, uvd_stride, weight);
   }
 }
 
@@ -349,14 +351,14 @@ static void mfqe_partition(VP9_COMMON *cm, MODE_INFO *mi, BLOCK_SIZE bs,
   }
 }
 
-void vp9_mfqe(VP9_COMMON *cm) {
+void vp9_mfqe(VP9_COMMON *cm, int start_mi_row, int end_mi_row) {
   int mi_row, mi_col;
   // Current decoded frame.
   const YV12_BUFFER_CONFIG *show = cm->frame_to_show;
   // Last decoded frame and will store the MFQE result.
   YV12_BUFFER_CONFIG *dest = &cm->post_proc_buffer;
   // Loop through each super block.
-  for (mi_row = 0; mi_row < cm->mi_rows; mi_row += MI_BLOCK_SIZE) {
+  for (mi_row = start_mi_row; mi_row < end_mi_row; mi_row += MI_BLOCK_SIZE) {
     for (mi_col = 0; mi_col < cm->mi_cols; mi_col += MI_BLOCK_SIZE) {
       MODE_INFO *mi;
       MODE_INFO *mi_local = cm->mi + (mi_row * cm->mi_stride + mi_col);
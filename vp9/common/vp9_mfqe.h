@@ -22,7 +22,10 @@ extern "C" {
 // the motion of the blocks and other conditions such as the SAD of
 // the current block and correlated block, the variance of the block
 // difference, etc.
-void vp9_mfqe(struct VP9Common *cm);
+// Processes the superblock rows in [start_mi_row, end_mi_row), which must be
+// multiples of MI_BLOCK_SIZE unless end_mi_row is cm->mi_rows. Superblock
+// rows are independent, so disjoint ranges can run in parallel.
+void vp9_mfqe(struct VP9Common *cm, int start_mi_row, int end_mi_row);
 
 #ifdef __cplusplus
 }  // extern "C"
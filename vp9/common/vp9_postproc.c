@@ -93,7 +93,6 @@ void vp9_post_proc_down_and_across_c(const uint8_t *src_ptr,
   int row, col, i, v, kernel;
   int pitch = src_pixels_per_line;
   uint8_t d[8];
-  (void)dst_pixels_per_line;
 
   for (row = 0; row < rows; row++) {
     /* post_proc_down for one row */
@@ -150,7 +149,7 @@ void vp9_post_proc_down_and_across_c(const uint8_t *src_ptr,
 
     /* next row */
     src_ptr += pitch;
-    dst_ptr += pitch;
+    dst_ptr += dst_pixels_per_line;
   }
 }
 
@@ -265,7 +264,8 @@ void vp9_mbpost_proc_across_ip_c(uint8_t *src, int pitch,
         d[c & 15] = (8 + sum + s[c]) >> 4;
       }
 
-      s[c - 8] = d[(c - 8) & 15];
+      if (c >= 8)
+        s[c - 8] = d[(c - 8) & 15];
     }
     s += pitch;
   }
@@ -303,7 +303,8 @@ void vp9_highbd_mbpost_proc_across_ip_c(uint16_t *src, int pitch,
         d[c & 15] = (8 + sum + s[c]) >> 4;
       }
 
-      s[c - 8] = d[(c - 8) & 15];
+      if (c >= 8)
+        s[c - 8] = d[(c - 8) & 15];
     }
 
     s += pitch;
@@ -312,9 +313,9 @@ void vp9_highbd_mbpost_proc_across_ip_c(uint16_t *src, int pitch,
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
 void vp9_mbpost_proc_down_c(uint8_t *dst, int pitch,
-                            int rows, int cols, int flimit) {
+                            int rows, int cols, int flimit, int rv_offset) {
   int r, c, i;
-  const short *rv3 = &vp9_rv[63 & rand()]; // NOLINT
+  const short *rv3 = &vp9_rv[rv_offset];
 
   for (c = 0; c < cols; c++) {
     uint8_t *s = &dst[c];
@@ -337,7 +338,8 @@ void vp9_mbpost_proc_down_c(uint8_t *dst, int pitch,
         d[r & 15] = (rv2[r & 127] + sum + s[0]) >> 4;
       }
 
-      s[-8 * pitch] = d[(r - 8) & 15];
+      if (r >= 8)
+        s[-8 * pitch] = d[(r - 8) & 15];
       s += pitch;
     }
   }
@@ -345,9 +347,10 @@ void vp9_mbpost_proc_down_c(uint8_t *dst, int pitch,
 
 #if CONFIG_VP9_HIGHBITDEPTH
 void vp9_highbd_mbpost_proc_down_c(uint16_t *dst, int pitch,
-                                   int rows, int cols, int flimit) {
+                                   int rows, int cols, int flimit,
+                                   int rv_offset) {
   int r, c, i;
-  const int16_t *rv3 = &vp9_rv[63 & rand()];  // NOLINT
+  const int16_t *rv3 = &vp9_rv[rv_offset];
 
   for (c = 0; c < cols; c++) {
     uint16_t *s = &dst[c];
@@ -370,85 +373,189 @@ void vp9_highbd_mbpost_proc_down_c(uint16_t *dst, int pitch,
         d[r & 15] = (rv2[r & 127] + sum + s[0]) >> 4;
       }
 
-      s[-8 * pitch] = d[(r - 8) & 15];
+      if (r >= 8)
+        s[-8 * pitch] = d[(r - 8) & 15];
       s += pitch;
     }
   }
 }
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
-static void deblock_and_de_macro_block(YV12_BUFFER_CONFIG   *source,
-                                       YV12_BUFFER_CONFIG   *post,
-                                       int                   q,
-                                       int                   low_var_thresh,
-                                       int                   flag) {
-  double level = 6.0e-05 * q * q * q - .0067 * q * q + .306 * q + .0065;
-  int ppl = (int)(level + .5);
-  (void) low_var_thresh;
-  (void) flag;
+// Maximum number of bands the passes of vp9_post_proc_frame_mt() are split
+// into.
+#define MAX_POSTPROC_BANDS 16
+
+// State shared by the bands of the passes of vp9_post_proc_frame_mt().
+typedef struct PostProcBands {
+  VP9_COMMON *cm;
+  const YV12_BUFFER_CONFIG *src;
+  YV12_BUFFER_CONFIG *post;
+  int ppl;
+  int flimit;
+  int demacroblock;
+  int rv_offset;  // Dither offset of the vertical demacroblocking filter.
+  VPxWorker *workers;
+  int num_bands;
+  int band_index[MAX_POSTPROC_BANDS];
+} PostProcBands;
+
+// Runs hook(pp, &band) for every band, on the workers when there are several.
+static void run_bands(PostProcBands *pp, VPxWorkerHook hook) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  int i;
+
+  if (pp->num_bands == 1) {
+    hook(pp, &pp->band_index[0]);
+    return;
+  }
+
+  for (i = 0; i < pp->num_bands; ++i) {
+    VPxWorker *const worker = &pp->workers[i];
+    worker->hook = hook;
+    worker->data1 = pp;
+    worker->data2 = &pp->band_index[i];
+    if (i == pp->num_bands - 1) {
+      winterface->execute(worker);
+    } else {
+      winterface->launch(worker);
+    }
+  }
+
+  for (i = 0; i < pp->num_bands; ++i) {
+    winterface->sync(&pp->workers[i]);
+  }
+}
+
+static int mfqe_band_hook(void *arg1, void *arg2) {
+  const PostProcBands *const pp = (const PostProcBands *)arg1;
+  const int band = *(const int *)arg2;
+  VP9_COMMON *const cm = pp->cm;
+  const int sb_rows = mi_cols_aligned_to_sb(cm->mi_rows) >> MI_BLOCK_SIZE_LOG2;
+  const int start = band * sb_rows / pp->num_bands;
+  const int end = (band + 1) * sb_rows / pp->num_bands;
+
+  vp9_mfqe(cm, start << MI_BLOCK_SIZE_LOG2,
+           VPXMIN(end << MI_BLOCK_SIZE_LOG2, cm->mi_rows));
+  return 1;
+}
+
+// Deblocks a band of rows of every plane, and runs the horizontal
+// demacroblocking filter over the same luma rows, which only reads pixels of
+// its own row.
+static int deblock_band_hook(void *arg1, void *arg2) {
+  const PostProcBands *const pp = (const PostProcBands *)arg1;
+  const int band = *(const int *)arg2;
+  const YV12_BUFFER_CONFIG *const src = pp->src;
+  YV12_BUFFER_CONFIG *const post = pp->post;
+  int i;
+
+  const uint8_t *const srcs[3] = {src->y_buffer, src->u_buffer, src->v_buffer};
+  const int src_strides[3] = {src->y_stride, src->uv_stride, src->uv_stride};
+  const int src_widths[3] = {src->y_width, src->uv_width, src->uv_width};
+  const int src_heights[3] = {src->y_height, src->uv_height, src->uv_height};
+
+  uint8_t *const dsts[3] = {post->y_buffer, post->u_buffer, post->v_buffer};
+  const int dst_strides[3] = {post->y_stride, post->uv_stride,
+                              post->uv_stride};
+
+  for (i = 0; i < MAX_MB_PLANE; ++i) {
+    const int start = band * src_heights[i] / pp->num_bands;
+    const int end = (band + 1) * src_heights[i] / pp->num_bands;
+    // The source may be taller than post, whose extra rows are not
+    // demacroblocked.
+    const int mbl_rows = VPXMIN(end, post->y_height) - start;
+    const uint8_t *const src_band = srcs[i] + start * src_strides[i];
+    uint8_t *const dst_band = dsts[i] + start * dst_strides[i];
+
+    if (end <= start)
+      continue;
 
 #if CONFIG_VP9_HIGHBITDEPTH
-  if (source->flags & YV12_FLAG_HIGHBITDEPTH) {
-    vp9_highbd_post_proc_down_and_across(CONVERT_TO_SHORTPTR(source->y_buffer),
-                                         CONVERT_TO_SHORTPTR(post->y_buffer),
-                                         source->y_stride, post->y_stride,
-                                         source->y_height, source->y_width,
-                                         ppl);
-
-    vp9_highbd_mbpost_proc_across_ip(CONVERT_TO_SHORTPTR(post->y_buffer),
-                                     post->y_stride, post->y_height,
-                                     post->y_width, q2mbl(q));
-
-    vp9_highbd_mbpost_proc_down(CONVERT_TO_SHORTPTR(post->y_buffer),
-                                post->y_stride, post->y_height,
-                                post->y_width, q2mbl(q));
-
-    vp9_highbd_post_proc_down_and_across(CONVERT_TO_SHORTPTR(source->u_buffer),
-                                         CONVERT_TO_SHORTPTR(post->u_buffer),
-                                         source->uv_stride, post->uv_stride,
-                                         source->uv_height, source->uv_width,
-                                         ppl);
-    vp9_highbd_post_proc_down_and_across(CONVERT_TO_SHORTPTR(source->v_buffer),
-                                         CONVERT_TO_SHORTPTR(post->v_buffer),
-                                         source->uv_stride, post->uv_stride,
-                                         source->uv_height, source->uv_width,
-                                         ppl);
-  } else {
-    vp9_post_proc_down_and_across(source->y_buffer, post->y_buffer,
-                                  source->y_stride, post->y_stride,
-                                  source->y_height, source->y_width, ppl);
-
-    vp9_mbpost_proc_across_ip(post->y_buffer, post->y_stride, post->y_height,
-                              post->y_width, q2mbl(q));
-
-    vp9_mbpost_proc_down(post->y_buffer, post->y_stride, post->y_height,
-                         post->y_width, q2mbl(q));
-
-    vp9_post_proc_down_and_across(source->u_buffer, post->u_buffer,
-                                  source->uv_stride, post->uv_stride,
-                                  source->uv_height, source->uv_width, ppl);
-    vp9_post_proc_down_and_across(source->v_buffer, post->v_buffer,
-                                  source->uv_stride, post->uv_stride,
-                                  source->uv_height, source->uv_width, ppl);
+    if (src->flags & YV12_FLAG_HIGHBITDEPTH) {
+      vp9_highbd_post_proc_down_and_across(CONVERT_TO_SHORTPTR(src_band),
+                                           CONVERT_TO_SHORTPTR(dst_band),
+                                           src_strides[i], dst_strides[i],
+                                           end - start, src_widths[i],
+                                           pp->ppl);
+      if (i == 0 && pp->demacroblock && mbl_rows > 0)
+        vp9_highbd_mbpost_proc_across_ip(CONVERT_TO_SHORTPTR(dst_band),
+                                         dst_strides[i], mbl_rows,
+                                         post->y_width, pp->flimit);
+      continue;
+    }
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+    vp9_post_proc_down_and_across(src_band, dst_band, src_strides[i],
+                                  dst_strides[i], end - start, src_widths[i],
+                                  pp->ppl);
+    if (i == 0 && pp->demacroblock && mbl_rows > 0)
+      vp9_mbpost_proc_across_ip(dst_band, dst_strides[i], mbl_rows,
+                                post->y_width, pp->flimit);
+  }
+  return 1;
+}
+
+// The vertical demacroblocking filter runs down whole columns, so it is split
+// into column bands. Bands start on multiples of 128 columns, the period of
+// the dither pattern within a call, and share the dither offset of the frame.
+static int mbpost_proc_down_band_hook(void *arg1, void *arg2) {
+  const PostProcBands *const pp = (const PostProcBands *)arg1;
+  const int band = *(const int *)arg2;
+  YV12_BUFFER_CONFIG *const post = pp->post;
+  const int units = (post->y_width + 127) >> 7;
+  const int start = (band * units / pp->num_bands) << 7;
+  const int end = VPXMIN(((band + 1) * units / pp->num_bands) << 7,
+                         post->y_width);
+
+  if (end <= start)
+    return 1;
+
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (post->flags & YV12_FLAG_HIGHBITDEPTH) {
+    vp9_highbd_mbpost_proc_down(CONVERT_TO_SHORTPTR(post->y_buffer) + start,
+                                post->y_stride, post->y_height, end - start,
+                                pp->flimit, pp->rv_offset);
+    return 1;
   }
-#else
-  vp9_post_proc_down_and_across(source->y_buffer, post->y_buffer,
-                                source->y_stride, post->y_stride,
-                                source->y_height, source->y_width, ppl);
-
-  vp9_mbpost_proc_across_ip(post->y_buffer, post->y_stride, post->y_height,
-                            post->y_width, q2mbl(q));
-
-  vp9_mbpost_proc_down(post->y_buffer, post->y_stride, post->y_height,
-                       post->y_width, q2mbl(q));
-
-  vp9_post_proc_down_and_across(source->u_buffer, post->u_buffer,
-                                source->uv_stride, post->uv_stride,
-                                source->uv_height, source->uv_width, ppl);
-  vp9_post_proc_down_and_across(source->v_buffer, post->v_buffer,
-                                source->uv_stride, post->uv_stride,
-                                source->uv_height, source->uv_width, ppl);
 #endif  // CONFIG_VP9_HIGHBITDEPTH
+  vp9_mbpost_proc_down(post->y_buffer + start, post->y_stride,
+                       post->y_height, end - start, pp->flimit, pp->rv_offset);
+  return 1;
+}
+
+// Adds the noise to a band of rows, at the offsets drawn for the frame.
+static int add_noise_band_hook(void *arg1, void *arg2) {
+  const PostProcBands *const pp = (const PostProcBands *)arg1;
+  const int band = *(const int *)arg2;
+  YV12_BUFFER_CONFIG *const post = pp->post;
+  struct postproc_state *const ppstate = &pp->cm->postproc_state;
+  const int start = band * post->y_height / pp->num_bands;
+  const int end = (band + 1) * post->y_height / pp->num_bands;
+
+  if (end > start)
+    vp9_plane_add_noise(post->y_buffer + start * post->y_stride,
+                        ppstate->noise, ppstate->blackclamp,
+                        ppstate->whiteclamp, ppstate->bothclamp,
+                        post->y_width, end - start, post->y_stride,
+                        ppstate->noise_offsets + start);
+  return 1;
+}
+
+static void deblock_frame(PostProcBands *pp, const YV12_BUFFER_CONFIG *src,
+                          int q, int demacroblock) {
+  const double level = 6.0e-05 * q * q * q - .0067 * q * q + .306 * q + .0065;
+
+  pp->src = src;
+  pp->ppl = (int)(level + .5);
+  pp->flimit = q2mbl(q);
+  pp->demacroblock = demacroblock;
+
+  run_bands(pp, deblock_band_hook);
+  if (demacroblock) {
+    // Drawn here rather than by the bands, so that the frame is the same for
+    // any number of bands.
+    pp->rv_offset = 63 & rand();  // NOLINT
+    run_bands(pp, mbpost_proc_down_band_hook);
+  }
 }
 
 void vp9_deblock(const YV12_BUFFER_CONFIG *src, YV12_BUFFER_CONFIG *dst,
@@ -591,7 +698,8 @@ void vp9_plane_add_noise_c(uint8_t *start, char *noise,
                            char blackclamp[16],
                            char whiteclamp[16],
                            char bothclamp[16],
-                           unsigned int width, unsigned int height, int pitch) {
+                           unsigned int width, unsigned int height, int pitch,
+                           const int *noise_offsets) {
   unsigned int i, j;
 
   // TODO(jbb): why does simd code use both but c doesn't,  normalize and
@@ -599,7 +707,7 @@ void vp9_plane_add_noise_c(uint8_t *start, char *noise,
   (void) bothclamp;
   for (i = 0; i < height; i++) {
     uint8_t *pos = start + i * pitch;
-    char  *ref = (char *)(noise + (rand() & 0xff));  // NOLINT
+    char  *ref = (char *)(noise + noise_offsets[i]);
 
     for (j = 0; j < width; j++) {
       if (pos[j] < blackclamp[0])
@@ -626,10 +734,18 @@ static void swap_mi_and_prev_mi(VP9_COMMON *cm) {
 
 int vp9_post_proc_frame(struct VP9Common *cm,
                         YV12_BUFFER_CONFIG *dest, vp9_ppflags_t *ppflags) {
+  return vp9_post_proc_frame_mt(cm, dest, ppflags, NULL, 0);
+}
+
+int vp9_post_proc_frame_mt(struct VP9Common *cm, YV12_BUFFER_CONFIG *dest,
+                           vp9_ppflags_t *ppflags, VPxWorker *workers,
+                           int num_workers) {
   const int q = VPXMIN(105, cm->lf.filter_level * 2);
   const int flags = ppflags->post_proc_flag;
   YV12_BUFFER_CONFIG *const ppbuf = &cm->post_proc_buffer;
   struct postproc_state *const ppstate = &cm->postproc_state;
+  PostProcBands pp;
+  int i;
 
   if (!cm->frame_to_show)
     return -1;
@@ -688,11 +804,28 @@ int vp9_post_proc_frame(struct VP9Common *cm,
     vpx_internal_error(&cm->error, VPX_CODEC_MEM_ERROR,
                        "Failed to allocate post-processing buffer");
 
+  if ((flags & VP9D_ADDNOISE) &&
+      ppstate->noise_offsets_rows < ppbuf->y_height) {
+    vpx_free(ppstate->noise_offsets);
+    ppstate->noise_offsets_rows = 0;
+    CHECK_MEM_ERROR(cm, ppstate->noise_offsets,
+                    vpx_malloc(ppbuf->y_height *
+                               sizeof(*ppstate->noise_offsets)));
+    ppstate->noise_offsets_rows = ppbuf->y_height;
+  }
+
+  pp.cm = cm;
+  pp.post = ppbuf;
+  pp.workers = workers;
+  pp.num_bands = workers ? VPXMIN(num_workers, MAX_POSTPROC_BANDS) : 1;
+  for (i = 0; i < pp.num_bands; ++i)
+    pp.band_index[i] = i;
+
   if ((flags & VP9D_MFQE) && cm->current_video_frame >= 2 &&
       cm->postproc_state.last_frame_valid && cm->bit_depth == 8 &&
       cm->postproc_state.last_base_qindex <= last_q_thresh &&
       cm->base_qindex - cm->postproc_state.last_base_qindex >= q_diff_thresh) {
-    vp9_mfqe(cm);
+    run_bands(&pp, mfqe_band_hook);
     // TODO(jackychen): Consider whether enable deblocking by default
     // if mfqe is enabled. Need to take both the quality and the speed
     // into consideration.
@@ -700,19 +833,18 @@ int vp9_post_proc_frame(struct VP9Common *cm,
       vp8_yv12_copy_frame(ppbuf, &cm->post_proc_buffer_int);
     }
     if ((flags & VP9D_DEMACROBLOCK) && cm->post_proc_buffer_int.buffer_alloc) {
-      deblock_and_de_macro_block(&cm->post_proc_buffer_int, ppbuf,
-                                 q + (ppflags->deblocking_level - 5) * 10,
-                                 1, 0);
+      deblock_frame(&pp, &cm->post_proc_buffer_int,
+                    q + (ppflags->deblocking_level - 5) * 10, 1);
     } else if (flags & VP9D_DEBLOCK) {
-      vp9_deblock(&cm->post_proc_buffer_int, ppbuf, q);
+      deblock_frame(&pp, &cm->post_proc_buffer_int, q, 0);
     } else {
       vp8_yv12_copy_frame(&cm->post_proc_buffer_int, ppbuf);
     }
   } else if (flags & VP9D_DEMACROBLOCK) {
-    deblock_and_de_macro_block(cm->frame_to_show, ppbuf,
-                               q + (ppflags->deblocking_level - 5) * 10, 1, 0);
+    deblock_frame(&pp, cm->frame_to_show,
+                  q + (ppflags->deblocking_level - 5) * 10, 1);
   } else if (flags & VP9D_DEBLOCK) {
-    vp9_deblock(cm->frame_to_show, ppbuf, q);
+    deblock_frame(&pp, cm->frame_to_show, q, 0);
   } else {
     vp8_yv12_copy_frame(cm->frame_to_show, ppbuf);
   }
@@ -727,9 +859,10 @@ int vp9_post_proc_frame(struct VP9Common *cm,
       fillrd(ppstate, 63 - q, noise_level);
     }
 
-    vp9_plane_add_noise(ppbuf->y_buffer, ppstate->noise, ppstate->blackclamp,
-                        ppstate->whiteclamp, ppstate->bothclamp,
-                        ppbuf->y_width, ppbuf->y_height, ppbuf->y_stride);
+    for (i = 0; i < ppbuf->y_height; ++i)
+      ppstate->noise_offsets[i] = rand() & 0xff;  // NOLINT
+
+    run_bands(&pp, add_noise_band_hook);
   }
 
   *dest = *ppbuf;
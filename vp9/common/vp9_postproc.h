@@ -14,6 +14,7 @@
 
 #include "vpx_ports/mem.h"
 #include "vpx_scale/yv12config.h"
+#include "vpx_util/vpx_thread.h"
 #include "vp9/common/vp9_blockd.h"
 #include "vp9/common/vp9_mfqe.h"
 #include "vp9/common/vp9_ppflags.h"
@@ -33,6 +34,8 @@ struct postproc_state {
   DECLARE_ALIGNED(16, char, blackclamp[16]);
   DECLARE_ALIGNED(16, char, whiteclamp[16]);
   DECLARE_ALIGNED(16, char, bothclamp[16]);
+  int *noise_offsets;  // Noise offset of each row of the post_proc_buffer.
+  int noise_offsets_rows;
 };
 
 struct VP9Common;
@@ -42,6 +45,14 @@ struct VP9Common;
 int vp9_post_proc_frame(struct VP9Common *cm,
                         YV12_BUFFER_CONFIG *dest, vp9_ppflags_t *flags);
 
+// Same as vp9_post_proc_frame(), with MFQE, deblocking, demacroblocking and
+// noise split into bands run on the idle workers. The rand() drawn dither and
+// noise offsets are drawn on the calling thread in serial order, so the output
+// is the same for any number of workers.
+int vp9_post_proc_frame_mt(struct VP9Common *cm, YV12_BUFFER_CONFIG *dest,
+                           vp9_ppflags_t *flags, VPxWorker *workers,
+                           int num_workers);
+
 void vp9_denoise(const YV12_BUFFER_CONFIG *src, YV12_BUFFER_CONFIG *dst, int q);
 
 void vp9_deblock(const YV12_BUFFER_CONFIG *src, YV12_BUFFER_CONFIG *dst, int q);
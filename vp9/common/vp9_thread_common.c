@@ -86,13 +86,30 @@ static INLINE void sync_write(VP9LfSync *const lf_sync, int r, int c,
 #endif  // CONFIG_MULTITHREAD
 }
 
+// Returns the next superblock row to filter, in mi units, or -1 when all the
+// rows have been handed out. The rows are handed out in order, so a row only
+// waits on rows that a running worker has already picked up.
+static INLINE int get_next_row(VP9LfSync *const lf_sync, int stop) {
+  int mi_row = -1;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(lf_sync->job_mutex_);
+#endif  // CONFIG_MULTITHREAD
+  if (lf_sync->next_mi_row < stop) {
+    mi_row = lf_sync->next_mi_row;
+    lf_sync->next_mi_row += MI_BLOCK_SIZE;
+  }
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(lf_sync->job_mutex_);
+#endif  // CONFIG_MULTITHREAD
+  return mi_row;
+}
+
 // Implement row loopfiltering for each thread.
 static INLINE
 void thread_loop_filter_rows(const YV12_BUFFER_CONFIG *const frame_buffer,
                              VP9_COMMON *const cm,
                              struct macroblockd_plane planes[MAX_MB_PLANE],
-                             int start, int stop, int y_only,
-                             VP9LfSync *const lf_sync) {
+                             int stop, int y_only, VP9LfSync *const lf_sync) {
   const int num_planes = y_only ? 1 : MAX_MB_PLANE;
   const int sb_cols = mi_cols_aligned_to_sb(cm->mi_cols) >> MI_BLOCK_SIZE_LOG2;
   int mi_row, mi_col;
@@ -106,8 +123,7 @@ void thread_loop_filter_rows(const YV12_BUFFER_CONFIG *const frame_buffer,
   else
     path = LF_PATH_SLOW;
 
-  for (mi_row = start; mi_row < stop;
-       mi_row += lf_sync->num_workers * MI_BLOCK_SIZE) {
+  while ((mi_row = get_next_row(lf_sync, stop)) >= 0) {
     MODE_INFO **const mi = cm->mi_grid_visible + mi_row * cm->mi_stride;
 
     for (mi_col = 0; mi_col < cm->mi_cols; mi_col += MI_BLOCK_SIZE) {
@@ -149,8 +165,7 @@ void thread_loop_filter_rows(const YV12_BUFFER_CONFIG *const frame_buffer,
 static int loop_filter_row_worker(VP9LfSync *const lf_sync,
                                   LFWorkerData *const lf_data) {
   thread_loop_filter_rows(lf_data->frame_buffer, lf_data->cm, lf_data->planes,
-                          lf_data->start, lf_data->stop, lf_data->y_only,
-                          lf_sync);
+                          lf_data->stop, lf_data->y_only, lf_sync);
   return 1;
 }
 
@@ -177,6 +192,7 @@ static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame,
 
   // Initialize cur_sb_col to -1 for all SB rows.
   memset(lf_sync->cur_sb_col, -1, sizeof(*lf_sync->cur_sb_col) * sb_rows);
+  lf_sync->next_mi_row = start;
 
   // Set up loopfilter thread data.
   // The decoder is capping num_workers because it has been observed that using
@@ -196,7 +212,7 @@ static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame,
 
     // Loopfilter data
     vp9_loop_filter_data_reset(lf_data, frame, cm, planes);
-    lf_data->start = start + i * MI_BLOCK_SIZE;
+    lf_data->start = start;
     lf_data->stop = stop;
     lf_data->y_only = y_only;
 
@@ -276,6 +292,12 @@ void vp9_loop_filter_alloc(VP9LfSync *lf_sync, VP9_COMMON *cm, int rows,
         pthread_cond_init(&lf_sync->cond_[i], NULL);
       }
     }
+
+    CHECK_MEM_ERROR(cm, lf_sync->job_mutex_,
+                    vpx_malloc(sizeof(*lf_sync->job_mutex_)));
+    if (lf_sync->job_mutex_) {
+      pthread_mutex_init(lf_sync->job_mutex_, NULL);
+    }
   }
 #endif  // CONFIG_MULTITHREAD
 
@@ -308,6 +330,10 @@ void vp9_loop_filter_dealloc(VP9LfSync *lf_sync) {
       }
       vpx_free(lf_sync->cond_);
     }
+    if (lf_sync->job_mutex_ != NULL) {
+      pthread_mutex_destroy(lf_sync->job_mutex_);
+      vpx_free(lf_sync->job_mutex_);
+    }
 #endif  // CONFIG_MULTITHREAD
     vpx_free(lf_sync->lfdata);
     vpx_free(lf_sync->cur_sb_col);
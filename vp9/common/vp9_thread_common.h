@@ -26,9 +26,13 @@ typedef struct VP9LfSyncData {
 #if CONFIG_MULTITHREAD
   pthread_mutex_t *mutex_;
   pthread_cond_t *cond_;
+  // Protects next_mi_row.
+  pthread_mutex_t *job_mutex_;
 #endif
   // Allocate memory to store the loop-filtered superblock index in each row.
   int *cur_sb_col;
+  // The next superblock row, in mi units, to be handed out to a worker.
+  int next_mi_row;
   // The optimal sync_range for different resolution and platform should be
   // determined by testing. Currently, it is chosen to be a power-of-2 number.
   int sync_range;
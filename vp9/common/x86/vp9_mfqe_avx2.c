@@ -0,0 +1,88 @@
+/*
+ *  Copyright (c) 2016 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>  // AVX2
+
+#include "./vp9_rtcd.h"
+#include "vp9/common/vp9_postproc.h"
+#include "vpx/vpx_integer.h"
+
+// Blends 32 pixels: (src * src_weight + dst * dst_weight + rounding) >> 4.
+// 'weights' holds the (src_weight, dst_weight) byte pairs, which are at most
+// 16, so the unsigned by signed byte multiply-adds cannot saturate.
+static INLINE __m256i filter_32(__m256i src, __m256i dst, __m256i weights,
+                                __m256i rounding) {
+  __m256i lo = _mm256_maddubs_epi16(_mm256_unpacklo_epi8(src, dst), weights);
+  __m256i hi = _mm256_maddubs_epi16(_mm256_unpackhi_epi8(src, dst), weights);
+  lo = _mm256_srli_epi16(_mm256_add_epi16(lo, rounding), MFQE_PRECISION);
+  hi = _mm256_srli_epi16(_mm256_add_epi16(hi, rounding), MFQE_PRECISION);
+  return _mm256_packus_epi16(lo, hi);
+}
+
+static INLINE __m256i get_weights(int src_weight) {
+  const int dst_weight = (1 << MFQE_PRECISION) - src_weight;
+  return _mm256_set1_epi16((int16_t)((dst_weight << 8) | src_weight));
+}
+
+static INLINE void filter_by_weight_32xh(const uint8_t *src, int src_stride,
+                                         uint8_t *dst, int dst_stride,
+                                         int width, int height,
+                                         int src_weight) {
+  const __m256i weights = get_weights(src_weight);
+  const __m256i rounding = _mm256_set1_epi16(1 << (MFQE_PRECISION - 1));
+  int r, c;
+
+  for (r = 0; r < height; ++r) {
+    for (c = 0; c < width; c += 32) {
+      const __m256i s = _mm256_loadu_si256((const __m256i *)(src + c));
+      const __m256i d = _mm256_loadu_si256((const __m256i *)(dst + c));
+      _mm256_storeu_si256((__m256i *)(dst + c),
+                          filter_32(s, d, weights, rounding));
+    }
+    src += src_stride;
+    dst += dst_stride;
+  }
+}
+
+void vp9_filter_by_weight16x16_avx2(const uint8_t *src, int src_stride,
+                                    uint8_t *dst, int dst_stride,
+                                    int src_weight) {
+  const __m256i weights = get_weights(src_weight);
+  const __m256i rounding = _mm256_set1_epi16(1 << (MFQE_PRECISION - 1));
+  int r;
+
+  // Two rows at a time, one in each lane.
+  for (r = 0; r < 16; r += 2) {
+    const __m256i s = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)src)),
+        _mm_loadu_si128((const __m128i *)(src + src_stride)), 1);
+    const __m256i d = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)dst)),
+        _mm_loadu_si128((const __m128i *)(dst + dst_stride)), 1);
+    const __m256i out = filter_32(s, d, weights, rounding);
+    _mm_storeu_si128((__m128i *)dst, _mm256_castsi256_si128(out));
+    _mm_storeu_si128((__m128i *)(dst + dst_stride),
+                     _mm256_extracti128_si256(out, 1));
+    src += 2 * src_stride;
+    dst += 2 * dst_stride;
+  }
+}
+
+void vp9_filter_by_weight32x32_avx2(const uint8_t *src, int src_stride,
+                                    uint8_t *dst, int dst_stride,
+                                    int src_weight) {
+  filter_by_weight_32xh(src, src_stride, dst, dst_stride, 32, 32, src_weight);
+}
+
+void vp9_filter_by_weight64x64_avx2(const uint8_t *src, int src_stride,
+                                    uint8_t *dst, int dst_stride,
+                                    int src_weight) {
+  filter_by_weight_32xh(src, src_stride, dst, dst_stride, 64, 64, src_weight);
+}
@@ -931,6 +931,190 @@ static void decode_block(VP9Decoder *const pbi, MACROBLOCKD *const xd,
   xd->corrupted |= vpx_reader_has_error(r);
 }
 
+static INLINE void dec_get_max_blocks(const MACROBLOCKD *xd,
+                                      const struct macroblockd_plane *pd,
+                                      int *max_blocks_wide,
+                                      int *max_blocks_high) {
+  *max_blocks_wide = pd->n4_w + (xd->mb_to_right_edge >= 0 ?
+      0 : xd->mb_to_right_edge >> (5 + pd->subsampling_x));
+  *max_blocks_high = pd->n4_h + (xd->mb_to_bottom_edge >= 0 ?
+      0 : xd->mb_to_bottom_edge >> (5 + pd->subsampling_y));
+}
+
+// Row based multi-threading: reads the modes and coefficients of a block into
+// 'sb'. Prediction and reconstruction are left to recon_block().
+static void parse_block(VP9Decoder *const pbi, MACROBLOCKD *const xd,
+                        RowMTSuperblock *const sb,
+                        int mi_row, int mi_col,
+                        vpx_reader *r, BLOCK_SIZE bsize,
+                        int bwl, int bhl) {
+  VP9_COMMON *const cm = &pbi->common;
+  const int less8x8 = bsize < BLOCK_8X8;
+  const int bw = 1 << (bwl - 1);
+  const int bh = 1 << (bhl - 1);
+  const int x_mis = VPXMIN(bw, cm->mi_cols - mi_col);
+  const int y_mis = VPXMIN(bh, cm->mi_rows - mi_row);
+  RowMTBlock *const blk = &sb->blocks[sb->num_blocks++];
+
+  MODE_INFO *mi = set_offsets(cm, xd, bsize, mi_row, mi_col,
+                              bw, bh, x_mis, y_mis, bwl, bhl);
+
+  if (bsize >= BLOCK_8X8 && (cm->subsampling_x || cm->subsampling_y)) {
+    const BLOCK_SIZE uv_subsize =
+        ss_size_lookup[bsize][cm->subsampling_x][cm->subsampling_y];
+    if (uv_subsize == BLOCK_INVALID)
+      vpx_internal_error(xd->error_info,
+                         VPX_CODEC_CORRUPT_FRAME, "Invalid block size.");
+  }
+
+  vp9_read_mode_info(pbi, xd, mi_row, mi_col, r, x_mis, y_mis);
+
+  blk->mi_row = mi_row;
+  blk->mi_col = mi_col;
+  blk->bsize = bsize;
+  blk->bwl = bwl;
+  blk->bhl = bhl;
+  blk->has_residual = !mi->skip;
+
+  if (mi->skip) {
+    dec_reset_skip_context(xd);
+  } else {
+    const int is_inter = is_inter_block(mi);
+    int eobtotal = 0;
+    int plane;
+
+    for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
+      struct macroblockd_plane *const pd = &xd->plane[plane];
+      const TX_SIZE tx_size =
+          plane ? dec_get_uv_tx_size(mi, pd->n4_wl, pd->n4_hl)
+                  : mi->tx_size;
+      const int step = (1 << tx_size);
+      int row, col;
+      int max_blocks_wide, max_blocks_high;
+
+      dec_get_max_blocks(xd, pd, &max_blocks_wide, &max_blocks_high);
+      xd->max_blocks_wide = xd->mb_to_right_edge >= 0 ? 0 : max_blocks_wide;
+      xd->max_blocks_high = xd->mb_to_bottom_edge >= 0 ? 0 : max_blocks_high;
+
+      for (row = 0; row < max_blocks_high; row += step) {
+        for (col = 0; col < max_blocks_wide; col += step) {
+          const scan_order *sc = &vp9_default_scan_orders[tx_size];
+          int eob;
+
+          if (!is_inter && !plane && !xd->lossless) {
+            const PREDICTION_MODE mode = mi->sb_type < BLOCK_8X8 ?
+                mi->bmi[(row << 1) + col].as_mode : mi->mode;
+            sc = &vp9_scan_orders[tx_size][intra_mode_to_tx_type_lookup[mode]];
+          }
+
+          pd->dqcoeff = sb->dqcoeff + sb->dqcoeff_size;
+          eob = vp9_decode_block_tokens(xd, plane, sc, col, row, tx_size, r,
+                                        mi->segment_id);
+          sb->eobs[sb->num_eobs++] = eob;
+          if (eob > 0)
+            sb->dqcoeff_size += 16 << (tx_size << 1);
+          eobtotal += eob;
+        }
+      }
+    }
+
+    if (is_inter && !less8x8 && eobtotal == 0)
+      mi->skip = 1;  // skip loopfilter
+  }
+
+  xd->corrupted |= vpx_reader_has_error(r);
+}
+
+// Row based multi-threading: predicts and reconstructs a block parsed by
+// parse_block(), consuming its eobs and coefficients from the superblock.
+static void recon_block(VP9Decoder *const pbi, MACROBLOCKD *const xd,
+                        const RowMTBlock *const blk,
+                        const uint16_t **eobs, tran_low_t **dqcoeff) {
+  VP9_COMMON *const cm = &pbi->common;
+  const int mi_row = blk->mi_row;
+  const int mi_col = blk->mi_col;
+  const int bw = 1 << (blk->bwl - 1);
+  const int bh = 1 << (blk->bhl - 1);
+  const MODE_INFO *mi;
+  int plane;
+
+  // The mode info grid has been filled in by the parser.
+  xd->mi = cm->mi_grid_visible + mi_row * cm->mi_stride + mi_col;
+  mi = xd->mi[0];
+  set_plane_n4(xd, bw, bh, blk->bwl, blk->bhl);
+  set_mi_row_col(xd, &xd->tile, mi_row, bh, mi_col, bw,
+                 cm->mi_rows, cm->mi_cols);
+  vp9_setup_dst_planes(xd->plane, get_frame_new_buffer(cm), mi_row, mi_col);
+
+  if (!is_inter_block(mi)) {
+    for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
+      struct macroblockd_plane *const pd = &xd->plane[plane];
+      const TX_SIZE tx_size =
+          plane ? dec_get_uv_tx_size(mi, pd->n4_wl, pd->n4_hl)
+                  : mi->tx_size;
+      const int step = (1 << tx_size);
+      int row, col;
+      int max_blocks_wide, max_blocks_high;
+
+      dec_get_max_blocks(xd, pd, &max_blocks_wide, &max_blocks_high);
+      for (row = 0; row < max_blocks_high; row += step) {
+        for (col = 0; col < max_blocks_wide; col += step) {
+          uint8_t *const dst = &pd->dst.buf[4 * row * pd->dst.stride + 4 * col];
+          PREDICTION_MODE mode = (plane == 0) ? mi->mode : mi->uv_mode;
+
+          if (mi->sb_type < BLOCK_8X8 && plane == 0)
+            mode = mi->bmi[(row << 1) + col].as_mode;
+
+          vp9_predict_intra_block(xd, pd->n4_wl, tx_size, mode,
+                                  dst, pd->dst.stride, dst, pd->dst.stride,
+                                  col, row, plane);
+
+          if (blk->has_residual) {
+            const int eob = *(*eobs)++;
+            if (eob > 0) {
+              const TX_TYPE tx_type = (plane || xd->lossless) ?
+                  DCT_DCT : intra_mode_to_tx_type_lookup[mode];
+              pd->dqcoeff = *dqcoeff;
+              inverse_transform_block_intra(xd, plane, tx_type, tx_size,
+                                            dst, pd->dst.stride, eob);
+              *dqcoeff += 16 << (tx_size << 1);
+            }
+          }
+        }
+      }
+    }
+  } else {
+    dec_build_inter_predictors_sb(pbi, xd, mi_row, mi_col);
+
+    if (blk->has_residual) {
+      for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
+        struct macroblockd_plane *const pd = &xd->plane[plane];
+        const TX_SIZE tx_size =
+            plane ? dec_get_uv_tx_size(mi, pd->n4_wl, pd->n4_hl)
+                    : mi->tx_size;
+        const int step = (1 << tx_size);
+        int row, col;
+        int max_blocks_wide, max_blocks_high;
+
+        dec_get_max_blocks(xd, pd, &max_blocks_wide, &max_blocks_high);
+        for (row = 0; row < max_blocks_high; row += step) {
+          for (col = 0; col < max_blocks_wide; col += step) {
+            const int eob = *(*eobs)++;
+            if (eob > 0) {
+              pd->dqcoeff = *dqcoeff;
+              inverse_transform_block_inter(
+                  xd, plane, tx_size,
+                  &pd->dst.buf[4 * row * pd->dst.stride + 4 * col],
+                  pd->dst.stride, eob);
+              *dqcoeff += 16 << (tx_size << 1);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
 static INLINE int dec_partition_plane_context(const MACROBLOCKD *xd,
                                               int mi_row, int mi_col,
                                               int bsl) {
@@ -980,8 +1164,23 @@ static PARTITION_TYPE read_partition(MACROBLOCKD *xd, int mi_row, int mi_col,
   return p;
 }
 
+// Decodes a block, or only parses it when 'sb' is set for row based
+// multi-threading.
+static INLINE void decode_or_parse_block(VP9Decoder *const pbi,
+                                         MACROBLOCKD *const xd,
+                                         RowMTSuperblock *const sb,
+                                         int mi_row, int mi_col,
+                                         vpx_reader *r, BLOCK_SIZE bsize,
+                                         int bwl, int bhl) {
+  if (sb)
+    parse_block(pbi, xd, sb, mi_row, mi_col, r, bsize, bwl, bhl);
+  else
+    decode_block(pbi, xd, mi_row, mi_col, r, bsize, bwl, bhl);
+}
+
 // TODO(slavarnway): eliminate bsize and subsize in future commits
 static void decode_partition(VP9Decoder *const pbi, MACROBLOCKD *const xd,
+                             RowMTSuperblock *const sb,
                              int mi_row, int mi_col,
                              vpx_reader* r, BLOCK_SIZE bsize, int n4x4_l2) {
   VP9_COMMON *const cm = &pbi->common;
@@ -1003,29 +1202,34 @@ static void decode_partition(VP9Decoder *const pbi, MACROBLOCKD *const xd,
     // calculate bmode block dimensions (log 2)
     xd->bmode_blocks_wl = 1 >> !!(partition & PARTITION_VERT);
     xd->bmode_blocks_hl = 1 >> !!(partition & PARTITION_HORZ);
-    decode_block(pbi, xd, mi_row, mi_col, r, subsize, 1, 1);
+    decode_or_parse_block(pbi, xd, sb, mi_row, mi_col, r, subsize, 1, 1);
   } else {
     switch (partition) {
       case PARTITION_NONE:
-        decode_block(pbi, xd, mi_row, mi_col, r, subsize, n4x4_l2, n4x4_l2);
+        decode_or_parse_block(pbi, xd, sb, mi_row, mi_col, r, subsize,
+                              n4x4_l2, n4x4_l2);
         break;
       case PARTITION_HORZ:
-        decode_block(pbi, xd, mi_row, mi_col, r, subsize, n4x4_l2, n8x8_l2);
+        decode_or_parse_block(pbi, xd, sb, mi_row, mi_col, r, subsize,
+                              n4x4_l2, n8x8_l2);
         if (has_rows)
-          decode_block(pbi, xd, mi_row + hbs, mi_col, r, subsize, n4x4_l2,
-                       n8x8_l2);
+          decode_or_parse_block(pbi, xd, sb, mi_row + hbs, mi_col, r, subsize,
+                                n4x4_l2, n8x8_l2);
         break;
       case PARTITION_VERT:
-        decode_block(pbi, xd, mi_row, mi_col, r, subsize, n8x8_l2, n4x4_l2);
+        decode_or_parse_block(pbi, xd, sb, mi_row, mi_col, r, subsize,
+                              n8x8_l2, n4x4_l2);
         if (has_cols)
-          decode_block(pbi, xd, mi_row, mi_col + hbs, r, subsize, n8x8_l2,
-                       n4x4_l2);
+          decode_or_parse_block(pbi, xd, sb, mi_row, mi_col + hbs, r, subsize,
+                                n8x8_l2, n4x4_l2);
         break;
       case PARTITION_SPLIT:
-        decode_partition(pbi, xd, mi_row, mi_col, r, subsize, n8x8_l2);
-        decode_partition(pbi, xd, mi_row, mi_col + hbs, r, subsize, n8x8_l2);
-        decode_partition(pbi, xd, mi_row + hbs, mi_col, r, subsize, n8x8_l2);
-        decode_partition(pbi, xd, mi_row + hbs, mi_col + hbs, r, subsize,
+        decode_partition(pbi, xd, sb, mi_row, mi_col, r, subsize, n8x8_l2);
+        decode_partition(pbi, xd, sb, mi_row, mi_col + hbs, r, subsize,
+                         n8x8_l2);
+        decode_partition(pbi, xd, sb, mi_row + hbs, mi_col, r, subsize,
+                         n8x8_l2);
+        decode_partition(pbi, xd, sb, mi_row + hbs, mi_col + hbs, r, subsize,
                          n8x8_l2);
         break;
       default:
@@ -1453,18 +1657,9 @@ static void get_tile_buffers(VP9Decoder *pbi,
   }
 }
 
-static const uint8_t *decode_tiles(VP9Decoder *pbi,
-                                   const uint8_t *data,
-                                   const uint8_t *data_end) {
+static void setup_lf_worker(VP9Decoder *pbi) {
   VP9_COMMON *const cm = &pbi->common;
   const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
-  const int aligned_cols = mi_cols_aligned_to_sb(cm->mi_cols);
-  const int tile_cols = 1 << cm->log2_tile_cols;
-  const int tile_rows = 1 << cm->log2_tile_rows;
-  TileBuffer tile_buffers[4][1 << 6];
-  int tile_row, tile_col;
-  int mi_row, mi_col;
-  TileData *tile_data = NULL;
 
   if (cm->lf.filter_level && !cm->skip_loop_filter &&
       pbi->lf_worker.data1 == NULL) {
@@ -1484,19 +1679,16 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi,
     vp9_loop_filter_data_reset(lf_data, get_frame_new_buffer(cm), cm,
                                pbi->mb.plane);
   }
+}
 
-  assert(tile_rows <= 4);
-  assert(tile_cols <= (1 << 6));
-
-  // Note: this memset assumes above_context[0], [1] and [2]
-  // are allocated as part of the same buffer.
-  memset(cm->above_context, 0,
-         sizeof(*cm->above_context) * MAX_MB_PLANE * 2 * aligned_cols);
-
-  memset(cm->above_seg_context, 0,
-         sizeof(*cm->above_seg_context) * aligned_cols);
-
-  get_tile_buffers(pbi, data, data_end, tile_cols, tile_rows, tile_buffers);
+// Load all tile information into pbi->tile_data.
+static void init_tile_data(VP9Decoder *pbi,
+                           TileBuffer (*tile_buffers)[1 << 6],
+                           const uint8_t *data_end) {
+  VP9_COMMON *const cm = &pbi->common;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  const int tile_rows = 1 << cm->log2_tile_rows;
+  int tile_row, tile_col;
 
   if (pbi->tile_data == NULL ||
       (tile_cols * tile_rows) != pbi->total_tiles) {
@@ -1508,11 +1700,11 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi,
     pbi->total_tiles = tile_rows * tile_cols;
   }
 
-  // Load all tile information into tile_data.
   for (tile_row = 0; tile_row < tile_rows; ++tile_row) {
     for (tile_col = 0; tile_col < tile_cols; ++tile_col) {
       const TileBuffer *const buf = &tile_buffers[tile_row][tile_col];
-      tile_data = pbi->tile_data + tile_cols * tile_row + tile_col;
+      TileData *const tile_data = pbi->tile_data + tile_cols * tile_row +
+                                  tile_col;
       tile_data->cm = cm;
       tile_data->xd = pbi->mb;
       tile_data->xd.corrupted = 0;
@@ -1526,6 +1718,37 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi,
       vp9_init_macroblockd(cm, &tile_data->xd, tile_data->dqcoeff);
     }
   }
+}
+
+static const uint8_t *decode_tiles(VP9Decoder *pbi,
+                                   const uint8_t *data,
+                                   const uint8_t *data_end) {
+  VP9_COMMON *const cm = &pbi->common;
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  const int aligned_cols = mi_cols_aligned_to_sb(cm->mi_cols);
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  const int tile_rows = 1 << cm->log2_tile_rows;
+  TileBuffer tile_buffers[4][1 << 6];
+  int tile_row, tile_col;
+  int mi_row, mi_col;
+  TileData *tile_data = NULL;
+
+  setup_lf_worker(pbi);
+
+  assert(tile_rows <= 4);
+  assert(tile_cols <= (1 << 6));
+
+  // Note: this memset assumes above_context[0], [1] and [2]
+  // are allocated as part of the same buffer.
+  memset(cm->above_context, 0,
+         sizeof(*cm->above_context) * MAX_MB_PLANE * 2 * aligned_cols);
+
+  memset(cm->above_seg_context, 0,
+         sizeof(*cm->above_seg_context) * aligned_cols);
+
+  get_tile_buffers(pbi, data, data_end, tile_cols, tile_rows, tile_buffers);
+
+  init_tile_data(pbi, tile_buffers, data_end);
 
   for (tile_row = 0; tile_row < tile_rows; ++tile_row) {
     TileInfo tile;
@@ -1541,7 +1764,7 @@ static const uint8_t *decode_tiles(VP9Decoder *pbi,
         vp9_zero(tile_data->xd.left_seg_context);
         for (mi_col = tile.mi_col_start; mi_col < tile.mi_col_end;
              mi_col += MI_BLOCK_SIZE) {
-          decode_partition(pbi, &tile_data->xd, mi_row,
+          decode_partition(pbi, &tile_data->xd, NULL, mi_row,
                            mi_col, &tile_data->bit_reader, BLOCK_64X64, 4);
         }
         pbi->mb.corrupted |= tile_data->xd.corrupted;
@@ -1632,7 +1855,7 @@ static int tile_worker_hook(TileWorkerData *const tile_data,
       vp9_zero(tile_data->xd.left_seg_context);
       for (mi_col = tile->mi_col_start; mi_col < tile->mi_col_end;
            mi_col += MI_BLOCK_SIZE) {
-        decode_partition(pbi, &tile_data->xd, mi_row, mi_col,
+        decode_partition(pbi, &tile_data->xd, NULL, mi_row, mi_col,
                          &tile_data->bit_reader, BLOCK_64X64, 4);
       }
     }
@@ -1653,22 +1876,11 @@ static int compare_tile_buffers(const void *a, const void *b) {
   return (int)(buf2->size - buf1->size);
 }
 
-static const uint8_t *decode_tiles_mt(VP9Decoder *pbi,
-                                      const uint8_t *data,
-                                      const uint8_t *data_end) {
+static void create_tile_workers(VP9Decoder *pbi) {
   VP9_COMMON *const cm = &pbi->common;
   const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
-  const uint8_t *bit_reader_end = NULL;
-  const int aligned_mi_cols = mi_cols_aligned_to_sb(cm->mi_cols);
-  const int tile_cols = 1 << cm->log2_tile_cols;
-  const int tile_rows = 1 << cm->log2_tile_rows;
-  const int num_workers = VPXMIN(pbi->max_threads, tile_cols);
   int n;
 
-  assert(tile_cols <= (1 << 6));
-  assert(tile_rows == 1);
-  (void)tile_rows;
-
   if (pbi->num_tile_workers == 0) {
     const int num_threads = pbi->max_threads;
     CHECK_MEM_ERROR(cm, pbi->tile_workers,
@@ -1690,6 +1902,25 @@ static const uint8_t *decode_tiles_mt(VP9Decoder *pbi,
       }
     }
   }
+}
+
+static const uint8_t *decode_tiles_mt(VP9Decoder *pbi,
+                                      const uint8_t *data,
+                                      const uint8_t *data_end) {
+  VP9_COMMON *const cm = &pbi->common;
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  const uint8_t *bit_reader_end = NULL;
+  const int aligned_mi_cols = mi_cols_aligned_to_sb(cm->mi_cols);
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  const int tile_rows = 1 << cm->log2_tile_rows;
+  const int num_workers = VPXMIN(pbi->max_threads, tile_cols);
+  int n;
+
+  assert(tile_cols <= (1 << 6));
+  assert(tile_rows == 1);
+  (void)tile_rows;
+
+  create_tile_workers(pbi);
 
   // Reset tile decoding hook
   for (n = 0; n < num_workers; ++n) {
@@ -1801,6 +2032,357 @@ static const uint8_t *decode_tiles_mt(VP9Decoder *pbi,
   return bit_reader_end;
 }
 
+// Row based multi-threading synchronization. Everything in VP9RowMTSync other
+// than the superblock ring itself is protected by its mutex.
+static INLINE void row_mt_broadcast(VP9RowMTSync *const row_mt) {
+#if CONFIG_MULTITHREAD
+#if defined(_WIN32) && !HAVE_PTHREAD_H
+  // The win32 condition variable wrapper lacks a broadcast; signal each thread
+  // that may be waiting.
+  int i;
+  for (i = 0; i < row_mt->num_threads; ++i)
+    pthread_cond_signal(row_mt->cond_);
+#else
+  pthread_cond_broadcast(row_mt->cond_);
+#endif
+#else
+  (void)row_mt;
+#endif  // CONFIG_MULTITHREAD
+}
+
+// Returns the next superblock row to reconstruct once it has been parsed, or
+// -1 when all rows have been handed out.
+static int row_mt_get_recon_row(VP9RowMTSync *const row_mt) {
+  int sb_row = -1;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(row_mt->mutex_);
+  if (row_mt->next_recon_row < row_mt->sb_rows) {
+    sb_row = row_mt->next_recon_row++;
+    while (row_mt->rows_parsed <= sb_row)
+      pthread_cond_wait(row_mt->cond_, row_mt->mutex_);
+  }
+  pthread_mutex_unlock(row_mt->mutex_);
+#else
+  (void)row_mt;
+#endif  // CONFIG_MULTITHREAD
+  return sb_row;
+}
+
+// Waits until the superblock above and to the right of (sb_row, sb_col) has
+// been reconstructed. Returns nonzero if the frame is corrupted.
+static int row_mt_sync_read(VP9RowMTSync *const row_mt, int sb_row,
+                            int sb_col) {
+  int corrupted = 0;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(row_mt->mutex_);
+  if (sb_row > 0) {
+    const int above_sb_col = VPXMIN(sb_col + 1, row_mt->sb_cols - 1);
+    while (row_mt->recon_sb_col[sb_row - 1] < above_sb_col)
+      pthread_cond_wait(row_mt->cond_, row_mt->mutex_);
+  }
+  corrupted = row_mt->corrupted;
+  pthread_mutex_unlock(row_mt->mutex_);
+#else
+  (void)row_mt;
+  (void)sb_row;
+  (void)sb_col;
+#endif  // CONFIG_MULTITHREAD
+  return corrupted;
+}
+
+static void row_mt_sync_write(VP9RowMTSync *const row_mt, int sb_row,
+                              int sb_col, int corrupted) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(row_mt->mutex_);
+  row_mt->recon_sb_col[sb_row] = sb_col;
+  row_mt->corrupted |= corrupted;
+  while (row_mt->rows_reconstructed < row_mt->sb_rows &&
+         row_mt->recon_sb_col[row_mt->rows_reconstructed] ==
+             row_mt->sb_cols - 1)
+    ++row_mt->rows_reconstructed;
+  row_mt_broadcast(row_mt);
+  pthread_mutex_unlock(row_mt->mutex_);
+#else
+  (void)row_mt;
+  (void)sb_row;
+  (void)sb_col;
+  (void)corrupted;
+#endif  // CONFIG_MULTITHREAD
+}
+
+static void row_mt_set_parsed(VP9RowMTSync *const row_mt, int rows,
+                              int corrupted) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(row_mt->mutex_);
+  row_mt->rows_parsed = rows;
+  row_mt->corrupted |= corrupted;
+  row_mt_broadcast(row_mt);
+  pthread_mutex_unlock(row_mt->mutex_);
+#else
+  (void)row_mt;
+  (void)rows;
+  (void)corrupted;
+#endif  // CONFIG_MULTITHREAD
+}
+
+// Waits until at least 'rows' superblock rows have been reconstructed and
+// returns the number of rows reconstructed so far.
+static int row_mt_wait_reconstructed(VP9RowMTSync *const row_mt, int rows) {
+  int rows_reconstructed = 0;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(row_mt->mutex_);
+  while (row_mt->rows_reconstructed < rows)
+    pthread_cond_wait(row_mt->cond_, row_mt->mutex_);
+  rows_reconstructed = row_mt->rows_reconstructed;
+  pthread_mutex_unlock(row_mt->mutex_);
+#else
+  (void)row_mt;
+  (void)rows;
+#endif  // CONFIG_MULTITHREAD
+  return rows_reconstructed;
+}
+
+static void recon_superblock(VP9Decoder *const pbi, MACROBLOCKD *const xd,
+                             RowMTSuperblock *const sb) {
+  const uint16_t *eobs = sb->eobs;
+  tran_low_t *dqcoeff = sb->dqcoeff;
+  int i;
+
+  for (i = 0; i < sb->num_blocks; ++i)
+    recon_block(pbi, xd, &sb->blocks[i], &eobs, &dqcoeff);
+}
+
+// Reconstructs superblock rows as they are parsed. A superblock is predicted
+// once the superblock above and to the right of it is complete, so the rows
+// progress as a wavefront.
+static int row_mt_worker_hook(TileWorkerData *const tile_data,
+                              VP9Decoder *const pbi) {
+  VP9_COMMON *const cm = &pbi->common;
+  VP9RowMTSync *const row_mt = &pbi->row_mt_sync;
+  MACROBLOCKD *const xd = &tile_data->xd;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  const int tile_rows = 1 << cm->log2_tile_rows;
+  volatile int sb_row = -1;
+  volatile int ok = 1;
+  tile_data->error_info.setjmp = 1;
+
+  if (setjmp(tile_data->error_info.jmp)) {
+    // Release anything waiting on this row. The superblocks that are left
+    // are skipped once the frame is marked as corrupted.
+    ok = 0;
+    row_mt_sync_write(row_mt, sb_row, row_mt->sb_cols - 1, 1);
+  }
+
+  xd->error_info = &tile_data->error_info;
+
+  while ((sb_row = row_mt_get_recon_row(row_mt)) >= 0) {
+    const int mi_row = sb_row << MI_BLOCK_SIZE_LOG2;
+    RowMTSuperblock *const sb_ring_row =
+        row_mt->sb + (sb_row % row_mt->ring_rows) * row_mt->sb_cols;
+    int tile_row, tile_col, mi_col;
+
+    for (tile_row = 0; tile_row < tile_rows; ++tile_row) {
+      vp9_tile_set_row(&xd->tile, cm, tile_row);
+      if (mi_row < xd->tile.mi_row_end)
+        break;
+    }
+
+    for (tile_col = 0; tile_col < tile_cols; ++tile_col) {
+      vp9_tile_set_col(&xd->tile, cm, tile_col);
+      for (mi_col = xd->tile.mi_col_start; mi_col < xd->tile.mi_col_end;
+           mi_col += MI_BLOCK_SIZE) {
+        const int sb_col = mi_col >> MI_BLOCK_SIZE_LOG2;
+        if (!row_mt_sync_read(row_mt, sb_row, sb_col))
+          recon_superblock(pbi, xd, &sb_ring_row[sb_col]);
+        row_mt_sync_write(row_mt, sb_row, sb_col, 0);
+      }
+    }
+  }
+
+  tile_data->error_info.setjmp = 0;
+  return ok;
+}
+
+// Loop filters the superblock rows whose neighbors below have been
+// reconstructed, as filtering a row modifies the pixels the row below is
+// predicted from. Returns the next row to filter.
+static int row_mt_loop_filter_rows(VP9Decoder *const pbi, int lf_row,
+                                   int rows_reconstructed) {
+  VP9_COMMON *const cm = &pbi->common;
+  const int sb_rows = pbi->row_mt_sync.sb_rows;
+  const int stop = rows_reconstructed == sb_rows ? sb_rows
+                                                 : rows_reconstructed - 1;
+
+  if (stop > lf_row) {
+    LFWorkerData *const lf_data = (LFWorkerData*)pbi->lf_worker.data1;
+    lf_data->start = lf_row << MI_BLOCK_SIZE_LOG2;
+    lf_data->stop = VPXMIN(stop << MI_BLOCK_SIZE_LOG2, cm->mi_rows);
+    vpx_get_worker_interface()->execute(&pbi->lf_worker);
+    return stop;
+  }
+  return lf_row;
+}
+
+// Stops the reconstruction of a corrupted frame and resets the superblock
+// ring, whose coefficient buffers may not have been consumed.
+static void row_mt_abort(VP9Decoder *const pbi, int num_workers) {
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  VP9RowMTSync *const row_mt = &pbi->row_mt_sync;
+  int n;
+
+  row_mt_set_parsed(row_mt, row_mt->sb_rows, 1);
+  for (n = 0; n < num_workers; ++n)
+    winterface->sync(&pbi->tile_workers[n]);
+  memset(row_mt->sb, 0,
+         row_mt->ring_rows * row_mt->sb_cols * sizeof(*row_mt->sb));
+}
+
+// Decodes a frame with the entropy decoding of each superblock row done
+// serially in this thread, while the tile workers reconstruct the parsed rows
+// and the loop filter follows behind the reconstruction.
+static const uint8_t *decode_tiles_row_mt(VP9Decoder *pbi,
+                                          const uint8_t *data,
+                                          const uint8_t *data_end) {
+  VP9_COMMON *const cm = &pbi->common;
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  VP9RowMTSync *const row_mt = &pbi->row_mt_sync;
+  const int aligned_cols = mi_cols_aligned_to_sb(cm->mi_cols);
+  const int sb_cols = aligned_cols >> MI_BLOCK_SIZE_LOG2;
+  const int sb_rows = mi_cols_aligned_to_sb(cm->mi_rows) >> MI_BLOCK_SIZE_LOG2;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  const int tile_rows = 1 << cm->log2_tile_rows;
+  const int num_workers = pbi->max_threads - 1;
+  // Enough parsed rows to keep every worker busy while this thread parses
+  // ahead.
+  const int ring_rows = pbi->max_threads + 1;
+  const int do_lf = cm->lf.filter_level && !cm->skip_loop_filter;
+  TileBuffer tile_buffers[4][1 << 6];
+  TileData *tile_data = NULL;
+  int tile_row, tile_col;
+  int mi_row, mi_col;
+  int lf_row = 0;
+  int n;
+
+  assert(tile_rows <= 4);
+  assert(tile_cols <= (1 << 6));
+  assert(num_workers > 0);
+
+  setup_lf_worker(pbi);
+  create_tile_workers(pbi);
+
+  // Note: this memset assumes above_context[0], [1] and [2]
+  // are allocated as part of the same buffer.
+  memset(cm->above_context, 0,
+         sizeof(*cm->above_context) * MAX_MB_PLANE * 2 * aligned_cols);
+
+  memset(cm->above_seg_context, 0,
+         sizeof(*cm->above_seg_context) * aligned_cols);
+
+  get_tile_buffers(pbi, data, data_end, tile_cols, tile_rows, tile_buffers);
+
+  init_tile_data(pbi, tile_buffers, data_end);
+
+  if (row_mt->sb == NULL || row_mt->sb_rows != sb_rows ||
+      row_mt->sb_cols != sb_cols || row_mt->ring_rows != ring_rows) {
+    vp9_dec_row_mt_dealloc(row_mt);
+    vp9_dec_row_mt_alloc(row_mt, cm, sb_rows, sb_cols, ring_rows);
+  }
+
+  memset(row_mt->recon_sb_col, -1, sizeof(*row_mt->recon_sb_col) * sb_rows);
+  row_mt->rows_parsed = 0;
+  row_mt->rows_reconstructed = 0;
+  row_mt->next_recon_row = 0;
+  row_mt->corrupted = 0;
+  row_mt->num_threads = pbi->max_threads;
+
+  row_mt->error_info.setjmp = 1;
+  if (setjmp(row_mt->error_info.jmp)) {
+    row_mt->error_info.setjmp = 0;
+    row_mt_abort(pbi, num_workers);
+    vpx_internal_error(&cm->error, VPX_CODEC_CORRUPT_FRAME,
+                       "Failed to decode tile data");
+  }
+
+  for (n = 0; n < tile_cols * tile_rows; ++n)
+    pbi->tile_data[n].xd.error_info = &row_mt->error_info;
+
+  for (n = 0; n < num_workers; ++n) {
+    VPxWorker *const worker = &pbi->tile_workers[n];
+    TileWorkerData *const worker_data = &pbi->tile_worker_data[n];
+    winterface->sync(worker);
+    worker_data->xd = pbi->mb;
+    worker_data->xd.counts = NULL;
+    worker->hook = (VPxWorkerHook)row_mt_worker_hook;
+    worker->data1 = worker_data;
+    worker->data2 = pbi;
+    worker->had_error = 0;
+    winterface->launch(worker);
+  }
+
+  for (tile_row = 0; tile_row < tile_rows; ++tile_row) {
+    TileInfo tile;
+    vp9_tile_set_row(&tile, cm, tile_row);
+    for (mi_row = tile.mi_row_start; mi_row < tile.mi_row_end;
+         mi_row += MI_BLOCK_SIZE) {
+      const int sb_row = mi_row >> MI_BLOCK_SIZE_LOG2;
+      RowMTSuperblock *const sb_ring_row =
+          row_mt->sb + (sb_row % ring_rows) * sb_cols;
+      // Wait for the ring slot to be released, filtering the rows that are
+      // ready in the meantime.
+      const int rows_reconstructed =
+          row_mt_wait_reconstructed(row_mt, sb_row - ring_rows + 1);
+      if (do_lf)
+        lf_row = row_mt_loop_filter_rows(pbi, lf_row, rows_reconstructed);
+
+      for (tile_col = 0; tile_col < tile_cols; ++tile_col) {
+        const int col = pbi->inv_tile_order ?
+                        tile_cols - tile_col - 1 : tile_col;
+        tile_data = pbi->tile_data + tile_cols * tile_row + col;
+        vp9_tile_set_col(&tile, tile_data->cm, col);
+        vp9_zero(tile_data->xd.left_context);
+        vp9_zero(tile_data->xd.left_seg_context);
+        for (mi_col = tile.mi_col_start; mi_col < tile.mi_col_end;
+             mi_col += MI_BLOCK_SIZE) {
+          RowMTSuperblock *const sb =
+              &sb_ring_row[mi_col >> MI_BLOCK_SIZE_LOG2];
+          sb->num_blocks = 0;
+          sb->num_eobs = 0;
+          sb->dqcoeff_size = 0;
+          decode_partition(pbi, &tile_data->xd, sb, mi_row, mi_col,
+                           &tile_data->bit_reader, BLOCK_64X64, 4);
+        }
+        pbi->mb.corrupted |= tile_data->xd.corrupted;
+        if (pbi->mb.corrupted)
+          vpx_internal_error(&row_mt->error_info, VPX_CODEC_CORRUPT_FRAME,
+                             "Failed to decode tile data");
+      }
+      row_mt_set_parsed(row_mt, sb_row + 1, 0);
+    }
+  }
+  row_mt->error_info.setjmp = 0;
+
+  // Loopfilter remaining rows in the frame.
+  if (do_lf) {
+    while (lf_row < sb_rows) {
+      const int rows_reconstructed =
+          row_mt_wait_reconstructed(row_mt, VPXMIN(lf_row + 2, sb_rows));
+      lf_row = row_mt_loop_filter_rows(pbi, lf_row, rows_reconstructed);
+    }
+  }
+
+  for (n = 0; n < num_workers; ++n)
+    pbi->mb.corrupted |= !winterface->sync(&pbi->tile_workers[n]);
+  if (pbi->mb.corrupted) {
+    row_mt_abort(pbi, num_workers);
+    vpx_internal_error(&cm->error, VPX_CODEC_CORRUPT_FRAME,
+                       "Failed to decode tile data");
+  }
+
+  // Get last tile data.
+  tile_data = pbi->tile_data + tile_cols * tile_rows - 1;
+  return vpx_reader_find_end(&tile_data->bit_reader);
+}
+
 static void error_handler(void *data) {
   VP9_COMMON *const cm = (VP9_COMMON *)data;
   vpx_internal_error(&cm->error, VPX_CODEC_CORRUPT_FRAME, "Truncated packet");
@@ -2221,7 +2803,11 @@ void vp9_decode_frame(VP9Decoder *pbi,
     vp9_frameworker_unlock_stats(worker);
   }
 
-  if (pbi->max_threads > 1 && tile_rows == 1 && tile_cols > 1) {
+  if (CONFIG_MULTITHREAD && pbi->row_mt && pbi->max_threads > 1) {
+    // Row based multi-threaded decoder, which also runs the loop filter.
+    *p_data_end = decode_tiles_row_mt(pbi, data + first_partition_size,
+                                      data_end);
+  } else if (pbi->max_threads > 1 && tile_rows == 1 && tile_cols > 1) {
     // Multi-threaded tile decoder
     *p_data_end = decode_tiles_mt(pbi, data + first_partition_size, data_end);
     if (!xd->corrupted) {
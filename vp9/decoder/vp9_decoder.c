@@ -142,6 +142,7 @@ void vp9_decoder_remove(VP9Decoder *pbi) {
   if (pbi->num_tile_workers > 0) {
     vp9_loop_filter_dealloc(&pbi->lf_row_sync);
   }
+  vp9_dec_row_mt_dealloc(&pbi->row_mt_sync);
 
   vpx_free(pbi);
 }
@@ -439,7 +440,12 @@ int vp9_get_raw_frame(VP9Decoder *pbi, YV12_BUFFER_CONFIG *sd,
 
 #if CONFIG_VP9_POSTPROC
   if (!cm->show_existing_frame) {
-    ret = vp9_post_proc_frame(cm, sd, flags);
+    // The tile workers are idle between frames.
+    if (!pbi->frame_parallel_decode && pbi->num_tile_workers > 1)
+      ret = vp9_post_proc_frame_mt(cm, sd, flags, pbi->tile_workers,
+                                   pbi->num_tile_workers);
+    else
+      ret = vp9_post_proc_frame(cm, sd, flags);
   } else {
     *sd = *cm->frame_to_show;
     ret = 0;
@@ -53,6 +53,50 @@ typedef struct TileWorkerData {
   struct vpx_internal_error_info error_info;
 } TileWorkerData;
 
+// A block whose modes and coefficients have been parsed ahead of its
+// reconstruction by the row based multi-threaded decoder.
+typedef struct RowMTBlock {
+  int mi_row;
+  int mi_col;
+  BLOCK_SIZE bsize;
+  int bwl, bhl;
+  int has_residual;  // coefficients were read for this block
+} RowMTBlock;
+
+// Parsed data of one superblock. The eobs of all transform blocks of the
+// blocks with a residual are stored in decoding order, and the dequantized
+// coefficients of those with a nonzero eob are packed into dqcoeff.
+typedef struct RowMTSuperblock {
+  DECLARE_ALIGNED(16, tran_low_t, dqcoeff[MAX_MB_PLANE * 64 * 64]);
+  uint16_t eobs[MAX_MB_PLANE * 16 * 16];
+  RowMTBlock blocks[64];
+  int num_blocks;
+  int num_eobs;
+  int dqcoeff_size;
+} RowMTSuperblock;
+
+// Row based multi-threading synchronization. Superblock rows are parsed
+// serially into a ring of 'ring_rows' rows and reconstructed as a wavefront
+// by the tile workers.
+typedef struct VP9RowMTSync {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t *mutex_;
+  pthread_cond_t *cond_;
+#endif
+  RowMTSuperblock *sb;
+  int ring_rows;
+  int sb_cols;
+  // The last reconstructed superblock column in each superblock row.
+  int *recon_sb_col;
+  int sb_rows;
+  int rows_parsed;
+  int rows_reconstructed;
+  int next_recon_row;
+  int corrupted;
+  int num_threads;  // upper bound on the number of waiting threads
+  struct vpx_internal_error_info error_info;
+} VP9RowMTSync;
+
 typedef struct VP9Decoder {
   DECLARE_ALIGNED(16, MACROBLOCKD, mb);
 
@@ -79,11 +123,13 @@ typedef struct VP9Decoder {
   int total_tiles;
 
   VP9LfSync lf_row_sync;
+  VP9RowMTSync row_mt_sync;
 
   vpx_decrypt_cb decrypt_cb;
   void *decrypt_state;
 
   int max_threads;
+  int row_mt;
   int inv_tile_order;
   int need_resync;  // wait for key/intra-only frame.
   int hold_ref_buf;  // hold the reference buffer.
@@ -30,13 +30,19 @@
        ++coef_counts[band][ctx][token];                     \
   } while (0)
 
-static INLINE int read_coeff(const vpx_prob *probs, int n, vpx_reader *r) {
+static INLINE int read_coeff(vpx_reader *r, const vpx_prob *probs, int n,
+                             BD_VALUE *value, int *count,
+                             unsigned int *range) {
   int i, val = 0;
   for (i = 0; i < n; ++i)
-    val = (val << 1) | vpx_read(r, probs[i]);
+    val = (val << 1) | vpx_read_bool(r, probs[i], value, count, range);
   return val;
 }
 
+// The bool decoder state is kept in locals for the whole block, and the
+// coefficient token tree and extra bits are decoded with vpx_read_bool(), so
+// that consecutive bools do not go through memory. It is written back to 'r'
+// before returning.
 static int decode_coefs(const MACROBLOCKD *xd,
                         PLANE_TYPE type,
                         tran_low_t *dqcoeff, TX_SIZE tx_size, const int16_t *dq,
@@ -69,6 +75,9 @@ static int decode_coefs(const MACROBLOCKD *xd,
       (xd->bd == VPX_BITS_10) ? 16 :
 #endif  // CONFIG_VP9_HIGHBITDEPTH
       14;
+  BD_VALUE value = r->value;
+  int count = r->count;
+  unsigned int range = r->range;
 
   if (counts) {
     coef_counts = counts->coef[tx_size][type][ref];
@@ -81,67 +90,88 @@ static int decode_coefs(const MACROBLOCKD *xd,
     prob = coef_probs[band][ctx];
     if (counts)
       ++eob_branch_count[band][ctx];
-    if (!vpx_read(r, prob[EOB_CONTEXT_NODE])) {
+    if (!vpx_read_bool(r, prob[EOB_CONTEXT_NODE], &value, &count, &range)) {
       INCREMENT_COUNT(EOB_MODEL_TOKEN);
       break;
     }
 
-    while (!vpx_read(r, prob[ZERO_CONTEXT_NODE])) {
+    while (!vpx_read_bool(r, prob[ZERO_CONTEXT_NODE], &value, &count,
+                          &range)) {
       INCREMENT_COUNT(ZERO_TOKEN);
       dqv = dq[1];
       token_cache[scan[c]] = 0;
       ++c;
-      if (c >= max_eob)
+      if (c >= max_eob) {
+        r->value = value;
+        r->count = count;
+        r->range = range;
         return c;  // zero tokens at the end (no eob token)
+      }
       ctx = get_coef_context(nb, token_cache, c);
       band = *band_translate++;
       prob = coef_probs[band][ctx];
     }
 
-    if (!vpx_read(r, prob[ONE_CONTEXT_NODE])) {
+    if (!vpx_read_bool(r, prob[ONE_CONTEXT_NODE], &value, &count, &range)) {
       INCREMENT_COUNT(ONE_TOKEN);
       token = ONE_TOKEN;
       val = 1;
     } else {
+      // The nodes of vp9_coef_con_tree, with the probabilities of the
+      // Pareto model.
+      const vpx_prob *const p = vp9_pareto8_full[prob[PIVOT_NODE] - 1];
       INCREMENT_COUNT(TWO_TOKEN);
-      token = vpx_read_tree(r, vp9_coef_con_tree,
-                            vp9_pareto8_full[prob[PIVOT_NODE] - 1]);
-      switch (token) {
-        case TWO_TOKEN:
-        case THREE_TOKEN:
-        case FOUR_TOKEN:
-          val = token;
-          break;
-        case CATEGORY1_TOKEN:
-          val = CAT1_MIN_VAL + read_coeff(vp9_cat1_prob, 1, r);
-          break;
-        case CATEGORY2_TOKEN:
-          val = CAT2_MIN_VAL + read_coeff(vp9_cat2_prob, 2, r);
-          break;
-        case CATEGORY3_TOKEN:
-          val = CAT3_MIN_VAL + read_coeff(vp9_cat3_prob, 3, r);
-          break;
-        case CATEGORY4_TOKEN:
-          val = CAT4_MIN_VAL + read_coeff(vp9_cat4_prob, 4, r);
-          break;
-        case CATEGORY5_TOKEN:
-          val = CAT5_MIN_VAL + read_coeff(vp9_cat5_prob, 5, r);
-          break;
-        case CATEGORY6_TOKEN:
-          val = CAT6_MIN_VAL + read_coeff(cat6_prob, cat6_bits, r);
-          break;
+      if (!vpx_read_bool(r, p[0], &value, &count, &range)) {
+        if (!vpx_read_bool(r, p[1], &value, &count, &range)) {
+          token = TWO_TOKEN;
+        } else {
+          token = vpx_read_bool(r, p[2], &value, &count, &range) ?
+              FOUR_TOKEN : THREE_TOKEN;
+        }
+        val = token;
+      } else if (!vpx_read_bool(r, p[3], &value, &count, &range)) {
+        if (!vpx_read_bool(r, p[4], &value, &count, &range)) {
+          token = CATEGORY1_TOKEN;
+          val = CAT1_MIN_VAL + read_coeff(r, vp9_cat1_prob, 1, &value, &count,
+                                          &range);
+        } else {
+          token = CATEGORY2_TOKEN;
+          val = CAT2_MIN_VAL + read_coeff(r, vp9_cat2_prob, 2, &value, &count,
+                                          &range);
+        }
+      } else if (!vpx_read_bool(r, p[5], &value, &count, &range)) {
+        if (!vpx_read_bool(r, p[6], &value, &count, &range)) {
+          token = CATEGORY3_TOKEN;
+          val = CAT3_MIN_VAL + read_coeff(r, vp9_cat3_prob, 3, &value, &count,
+                                          &range);
+        } else {
+          token = CATEGORY4_TOKEN;
+          val = CAT4_MIN_VAL + read_coeff(r, vp9_cat4_prob, 4, &value, &count,
+                                          &range);
+        }
+      } else if (!vpx_read_bool(r, p[7], &value, &count, &range)) {
+        token = CATEGORY5_TOKEN;
+        val = CAT5_MIN_VAL + read_coeff(r, vp9_cat5_prob, 5, &value, &count,
+                                        &range);
+      } else {
+        token = CATEGORY6_TOKEN;
+        val = CAT6_MIN_VAL + read_coeff(r, cat6_prob, cat6_bits, &value,
+                                        &count, &range);
       }
     }
     v = (val * dqv) >> dq_shift;
 #if CONFIG_COEFFICIENT_RANGE_CHECKING
 #if CONFIG_VP9_HIGHBITDEPTH
-    dqcoeff[scan[c]] = highbd_check_range((vpx_read_bit(r) ? -v : v),
-                                          xd->bd);
+    dqcoeff[scan[c]] = highbd_check_range(
+        (vpx_read_bool(r, vpx_prob_half, &value, &count, &range) ? -v : v),
+        xd->bd);
 #else
-    dqcoeff[scan[c]] = check_range(vpx_read_bit(r) ? -v : v);
+    dqcoeff[scan[c]] = check_range(
+        vpx_read_bool(r, vpx_prob_half, &value, &count, &range) ? -v : v);
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 #else
-    dqcoeff[scan[c]] = vpx_read_bit(r) ? -v : v;
+    dqcoeff[scan[c]] =
+        vpx_read_bool(r, vpx_prob_half, &value, &count, &range) ? -v : v;
 #endif  // CONFIG_COEFFICIENT_RANGE_CHECKING
     token_cache[scan[c]] = vp9_pt_energy_class[token];
     ++c;
@@ -149,6 +179,9 @@ static int decode_coefs(const MACROBLOCKD *xd,
     dqv = dq[1];
   }
 
+  r->value = value;
+  r->count = count;
+  r->range = range;
   return c;
 }
 
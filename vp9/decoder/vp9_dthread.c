@@ -187,3 +187,48 @@ void vp9_frameworker_copy_context(VPxWorker *const dst_worker,
   (void) src_worker;
 #endif  // CONFIG_MULTITHREAD
 }
+
+void vp9_dec_row_mt_alloc(VP9RowMTSync *row_mt, VP9_COMMON *cm,
+                          int sb_rows, int sb_cols, int ring_rows) {
+#if CONFIG_MULTITHREAD
+  CHECK_MEM_ERROR(cm, row_mt->mutex_, vpx_malloc(sizeof(*row_mt->mutex_)));
+  if (row_mt->mutex_)
+    pthread_mutex_init(row_mt->mutex_, NULL);
+
+  CHECK_MEM_ERROR(cm, row_mt->cond_, vpx_malloc(sizeof(*row_mt->cond_)));
+  if (row_mt->cond_)
+    pthread_cond_init(row_mt->cond_, NULL);
+#endif  // CONFIG_MULTITHREAD
+
+  // The coefficient buffers must start out zeroed; reconstruction clears
+  // them again as it consumes them.
+  CHECK_MEM_ERROR(cm, row_mt->sb,
+                  vpx_memalign(32, ring_rows * sb_cols * sizeof(*row_mt->sb)));
+  memset(row_mt->sb, 0, ring_rows * sb_cols * sizeof(*row_mt->sb));
+  row_mt->ring_rows = ring_rows;
+  row_mt->sb_cols = sb_cols;
+
+  CHECK_MEM_ERROR(cm, row_mt->recon_sb_col,
+                  vpx_malloc(sb_rows * sizeof(*row_mt->recon_sb_col)));
+  row_mt->sb_rows = sb_rows;
+}
+
+void vp9_dec_row_mt_dealloc(VP9RowMTSync *row_mt) {
+  if (row_mt != NULL) {
+#if CONFIG_MULTITHREAD
+    if (row_mt->mutex_ != NULL) {
+      pthread_mutex_destroy(row_mt->mutex_);
+      vpx_free(row_mt->mutex_);
+    }
+    if (row_mt->cond_ != NULL) {
+      pthread_cond_destroy(row_mt->cond_);
+      vpx_free(row_mt->cond_);
+    }
+#endif  // CONFIG_MULTITHREAD
+    vpx_free(row_mt->sb);
+    vpx_free(row_mt->recon_sb_col);
+    // clear the structure as the source of this call may be a resize in which
+    // case this call will be followed by an _alloc() which may fail.
+    vp9_zero(*row_mt);
+  }
+}
@@ -21,6 +21,7 @@ extern "C" {
 
 struct VP9Common;
 struct VP9Decoder;
+struct VP9RowMTSync;
 
 // WorkerData for the FrameWorker thread. It contains all the information of
 // the worker and decode structures for decoding a frame.
@@ -38,6 +39,8 @@ typedef struct FrameWorkerData {
   // It is used to make a copy of the compressed data.
   uint8_t *scratch_buffer;
   size_t scratch_buffer_size;
+  // Index of the input buffer reference held instead of a copy, or -1.
+  int input_ref;
 
 #if CONFIG_MULTITHREAD
   pthread_mutex_t stats_mutex;
@@ -67,6 +70,14 @@ void vp9_frameworker_broadcast(RefCntBuffer *const buf, int row);
 void vp9_frameworker_copy_context(VPxWorker *const dst_worker,
                                   VPxWorker *const src_worker);
 
+// Allocate the superblock ring and synchronization data used by row based
+// multi-threaded decoding.
+void vp9_dec_row_mt_alloc(struct VP9RowMTSync *row_mt, struct VP9Common *cm,
+                          int sb_rows, int sb_cols, int ring_rows);
+
+// Deallocate row based multi-threading data.
+void vp9_dec_row_mt_dealloc(struct VP9RowMTSync *row_mt);
+
 #ifdef __cplusplus
 }    // extern "C"
 #endif
@@ -120,9 +120,10 @@ static void update_switchable_interp_probs(VP9_COMMON *cm, vpx_writer *w,
                      counts->switchable_interp[j], SWITCHABLE_FILTERS, w);
 }
 
-static void pack_mb_tokens(vpx_writer *w,
+static void pack_mb_tokens(vpx_writer *w, const FRAME_CONTEXT *fc,
                            TOKENEXTRA **tp, const TOKENEXTRA *const stop,
                            vpx_bit_depth_t bit_depth) {
+  const vpx_prob *const coef_probs = &fc->coef_probs[0][0][0][0][0][0];
   const TOKENEXTRA *p;
   const vp9_extra_bit *const extra_bits =
 #if CONFIG_VP9_HIGHBITDEPTH
@@ -136,12 +137,12 @@ static void pack_mb_tokens(vpx_writer *w,
 
   for (p = *tp; p < stop && p->token != EOSB_TOKEN; ++p) {
     if (p->token == EOB_TOKEN) {
-      vpx_write(w, 0, p->context_tree[0]);
+      vpx_write(w, 0, coef_probs[p->context * UNCONSTRAINED_NODES]);
       continue;
     }
-    vpx_write(w, 1, p->context_tree[0]);
+    vpx_write(w, 1, coef_probs[p->context * UNCONSTRAINED_NODES]);
     while (p->token == ZERO_TOKEN) {
-      vpx_write(w, 0, p->context_tree[1]);
+      vpx_write(w, 0, coef_probs[p->context * UNCONSTRAINED_NODES + 1]);
       ++p;
       if (p == stop || p->token == EOSB_TOKEN) {
         *tp = (TOKENEXTRA*)(uintptr_t)p + (p->token == EOSB_TOKEN);
@@ -151,7 +152,8 @@ static void pack_mb_tokens(vpx_writer *w,
 
     {
       const int t = p->token;
-      const vpx_prob *const context_tree = p->context_tree;
+      const vpx_prob *const context_tree =
+          &coef_probs[p->context * UNCONSTRAINED_NODES];
       assert(t != ZERO_TOKEN);
       assert(t != EOB_TOKEN);
       assert(t != EOSB_TOKEN);
@@ -390,7 +392,7 @@ static void write_modes_b(VP9_COMP *cpi, ThreadData *td,
   }
 
   assert(*tok < tok_end);
-  pack_mb_tokens(w, tok, tok_end, cm->bit_depth);
+  pack_mb_tokens(w, cm->fc, tok, tok_end, cm->bit_depth);
 }
 
 static void write_partition(const VP9_COMMON *const cm,
@@ -910,71 +912,127 @@ static int get_refresh_mask(VP9_COMP *cpi) {
   }
 }
 
-static int get_next_tilecol(VP9_COMP *cpi) {
+// Replays the partition context updates of write_modes_sb().
+static void update_partition_context_sb(const VP9_COMMON *const cm,
+                                        MACROBLOCKD *const xd,
+                                        int mi_row, int mi_col,
+                                        BLOCK_SIZE bsize) {
+  const int bsl = b_width_log2_lookup[bsize];
+  const int bs = (1 << bsl) / 4;
+  PARTITION_TYPE partition;
+  BLOCK_SIZE subsize;
+
+  if (mi_row >= cm->mi_rows || mi_col >= cm->mi_cols)
+    return;
+
+  partition = partition_lookup[bsl]
+      [cm->mi_grid_visible[mi_row * cm->mi_stride + mi_col]->sb_type];
+  subsize = get_subsize(bsize, partition);
+  if (subsize >= BLOCK_8X8 && partition == PARTITION_SPLIT) {
+    update_partition_context_sb(cm, xd, mi_row, mi_col, subsize);
+    update_partition_context_sb(cm, xd, mi_row, mi_col + bs, subsize);
+    update_partition_context_sb(cm, xd, mi_row + bs, mi_col, subsize);
+    update_partition_context_sb(cm, xd, mi_row + bs, mi_col + bs, subsize);
+  }
+
+  if (bsize >= BLOCK_8X8 &&
+      (bsize == BLOCK_8X8 || partition != PARTITION_SPLIT))
+    update_partition_context(xd, mi_row, mi_col, subsize, bsize);
+}
+
+// Sets up the above partition context of a tile as encode_tiles() leaves it
+// when it gets to the tile. The tiles above only contribute their last
+// superblock row, which overwrites every context within the frame.
+static void init_tile_partition_context(const VP9_COMMON *const cm,
+                                        MACROBLOCKD *const xd,
+                                        const TileInfo *const tile) {
+  const int mi_row = tile->mi_row_start - MI_BLOCK_SIZE;
+  int mi_col;
+
+  memset(xd->above_seg_context + tile->mi_col_start, 0,
+         sizeof(*xd->above_seg_context) *
+         mi_cols_aligned_to_sb(tile->mi_col_end - tile->mi_col_start));
+  if (mi_row < 0)
+    return;
+
+  vp9_zero(xd->left_seg_context);
+  for (mi_col = tile->mi_col_start; mi_col < tile->mi_col_end;
+       mi_col += MI_BLOCK_SIZE)
+    update_partition_context_sb(cm, xd, mi_row, mi_col, BLOCK_64X64);
+}
+
+static int get_next_tile(VP9_COMP *cpi) {
   VP9_COMMON *const cm = &cpi->common;
   int return_val = -1;
-  const int tile_cols = 1 << cm->log2_tile_cols;
+  const int num_tiles = 1 << (cm->log2_tile_cols + cm->log2_tile_rows);
 
   pthread_mutex_lock(&cpi->entropy_mutex);
-  if (cpi->entropy_tilecol < tile_cols) {
-    return_val = cpi->entropy_tilecol;
-    cpi->entropy_tilecol ++;
+  if (cpi->entropy_tile < num_tiles) {
+    return_val = cpi->entropy_tile;
+    cpi->entropy_tile++;
   }
   pthread_mutex_unlock(&cpi->entropy_mutex);
   return return_val;
 }
 
 static void vp9_entropy_thread_process(thread_context *const thread_ctxt,
-                                       void* data2) {
+                                       void *data2) {
   VP9_COMP *cpi = thread_ctxt->cpi;
   VP9_COMMON *const cm = &cpi->common;
   ThreadData *const td = &thread_ctxt->td;
   MACROBLOCKD *const xd = &td->mb.e_mbd;
+  PARTITION_CONTEXT *const above_seg_context = xd->above_seg_context;
+  uint8_t *const dest = (uint8_t *)data2;
   vpx_writer residual_bc;
-  int tile_row;
   const int tile_cols = 1 << cm->log2_tile_cols;
   const int tile_rows = 1 << cm->log2_tile_rows;
 
-  (void)data2;
   while (1) {
-    int tile_col = get_next_tilecol(cpi);
+    const int tile_idx = get_next_tile(cpi);
+    int tile_row, tile_col, mi_row;
+    uint8_t *data_ptr;
+    TileInfo tile;
 
-    if (tile_col == -1) {
+    if (tile_idx == -1) {
       break;
     }
-    for (tile_row = 0; tile_row < tile_rows; tile_row++) {
-      uint8_t *data_ptr = cpi->out_buffer_tiles[tile_row][tile_col];
-      TileInfo tile;
-      int mi_row;
+    tile_row = tile_idx >> cm->log2_tile_cols;
+    tile_col = tile_idx & (tile_cols - 1);
+    data_ptr = tile_idx == 0 ? dest : cpi->out_buffer_tiles[tile_row][tile_col];
 
-      vp9_tile_init(&tile, cm, tile_row, tile_col);
-      cpi->out_bitstream_size[tile_row][tile_col] = 0;
+    vp9_tile_init(&tile, cm, tile_row, tile_col);
+    cpi->out_bitstream_size[tile_row][tile_col] = 0;
 
-      if (tile_col < tile_cols - 1 || tile_row < tile_rows - 1)
-        vpx_start_encode(&residual_bc, data_ptr + 4);
-      else
-        vpx_start_encode(&residual_bc, data_ptr);
+    // Tiles in the same tile column but in different tile rows are packed
+    // concurrently, so each tile row has its own above context.
+    xd->above_seg_context = cpi->tile_above_seg_context[tile_row];
+    init_tile_partition_context(cm, xd, &tile);
 
-      set_partition_probs(cm, xd);
+    if (tile_col < tile_cols - 1 || tile_row < tile_rows - 1)
+      vpx_start_encode(&residual_bc, data_ptr + 4);
+    else
+      vpx_start_encode(&residual_bc, data_ptr);
 
-      for (mi_row = tile.mi_row_start; mi_row < tile.mi_row_end;
-          mi_row += MI_BLOCK_SIZE) {
-        TOKENEXTRA *tok_start, *tok_end;
-        const int sb_row = mi_row >> MI_BLOCK_SIZE_LOG2;
+    set_partition_probs(cm, xd);
 
-        tok_start = cpi->tplist[sb_row][tile_row][tile_col].start;
-        tok_end = cpi->tplist[sb_row][tile_row][tile_col].stop;
-        write_modes(cpi, td, &tile, &residual_bc, &tok_start, tok_end, mi_row);
-      }
-      vpx_stop_encode(&residual_bc);
-      if (tile_col < tile_cols - 1 || tile_row < tile_rows - 1) {
-        // size of this tile
-        mem_put_be32(data_ptr, residual_bc.pos);
-        cpi->out_bitstream_size[tile_row][tile_col] += 4;
-      }
-      cpi->out_bitstream_size[tile_row][tile_col] += residual_bc.pos;
+    for (mi_row = tile.mi_row_start; mi_row < tile.mi_row_end;
+        mi_row += MI_BLOCK_SIZE) {
+      TOKENEXTRA *tok_start, *tok_end;
+      const int sb_row = mi_row >> MI_BLOCK_SIZE_LOG2;
+
+      tok_start = cpi->tplist[sb_row][tile_row][tile_col].start;
+      tok_end = cpi->tplist[sb_row][tile_row][tile_col].stop;
+      write_modes(cpi, td, &tile, &residual_bc, &tok_start, tok_end, mi_row);
+    }
+    vpx_stop_encode(&residual_bc);
+    if (tile_col < tile_cols - 1 || tile_row < tile_rows - 1) {
+      // size of this tile
+      mem_put_be32(data_ptr, residual_bc.pos);
+      cpi->out_bitstream_size[tile_row][tile_col] += 4;
     }
+    cpi->out_bitstream_size[tile_row][tile_col] += residual_bc.pos;
   }
+  xd->above_seg_context = above_seg_context;
 }
 
 static size_t encode_tiles_mt(VP9_COMP *cpi, uint8_t *data_ptr) {
@@ -983,31 +1041,30 @@ static size_t encode_tiles_mt(VP9_COMP *cpi, uint8_t *data_ptr) {
   size_t total_size = 0;
   const int tile_cols = 1 << cm->log2_tile_cols;
   const int tile_rows = 1 << cm->log2_tile_rows;
+  const int num_workers = VPXMIN(cpi->max_threads, tile_cols * tile_rows);
   const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
   int thread_id;
 
-  // Initialize row encoding hook
-  for (thread_id = 0; thread_id < cpi->max_threads; ++thread_id) {
+  // Initialize tile packing hook
+  for (thread_id = 0; thread_id < num_workers; ++thread_id) {
     winterface->sync(&cpi->enc_thread_hndl[thread_id]);
     cpi->enc_thread_hndl[thread_id].hook =
         (VPxWorkerHook) vp9_entropy_thread_process;
     cpi->enc_thread_hndl[thread_id].data1 = cpi->enc_thread_ctxt[thread_id];
-    cpi->enc_thread_hndl[thread_id].data2 = NULL;
+    cpi->enc_thread_hndl[thread_id].data2 = data_ptr;
   }
 
-  memset(cm->above_seg_context, 0,
-         sizeof(*cm->above_seg_context) * mi_cols_aligned_to_sb(cm->mi_cols));
-  cpi->entropy_tilecol = 0;
+  cpi->entropy_tile = 0;
 
-  for (thread_id = 0; thread_id < cpi->max_threads ; ++thread_id) {
+  for (thread_id = 0; thread_id < num_workers; ++thread_id) {
     VPxWorker *const worker = &cpi->enc_thread_hndl[thread_id];
     thread_context *const thread_ctxt = (thread_context *)worker->data1;
 
     // initialize thread context
     thread_ctxt->cpi = cpi;
 
-    // start encoding
-    if (thread_id == cpi->max_threads - 1) {
+    // start packing
+    if (thread_id == num_workers - 1) {
       winterface->execute(worker);
     } else {
       winterface->launch(worker);
@@ -1015,16 +1072,18 @@ static size_t encode_tiles_mt(VP9_COMP *cpi, uint8_t *data_ptr) {
   }
 
   // Wait till all threads are finished
-  for (thread_id = 0; thread_id < cpi->max_threads; ++thread_id) {
+  for (thread_id = 0; thread_id < num_workers; ++thread_id) {
     VPxWorker *const worker = &cpi->enc_thread_hndl[thread_id];
 
     winterface->sync(worker);
   }
 
+  // The first tile is already in place, move the others after it.
   for (tile_row = 0; tile_row < tile_rows; tile_row++) {
     for (tile_col = 0; tile_col < tile_cols; tile_col++) {
-      memcpy(data_ptr + total_size, cpi->out_buffer_tiles[tile_row][tile_col],
-             cpi->out_bitstream_size[tile_row][tile_col] * sizeof(*data_ptr));
+      if (tile_row != 0 || tile_col != 0)
+        memcpy(data_ptr + total_size, cpi->out_buffer_tiles[tile_row][tile_col],
+               cpi->out_bitstream_size[tile_row][tile_col] * sizeof(*data_ptr));
       total_size += cpi->out_bitstream_size[tile_row][tile_col];
     }
   }
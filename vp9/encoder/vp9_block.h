@@ -41,6 +41,7 @@ struct macroblock_plane {
   int16_t *quant_shift;
   int16_t *zbin;
   int16_t *round;
+  const MODEL_RD_QUANT *model_rd;
 
   int64_t quant_thred[2];
 };
@@ -25,6 +25,11 @@
  * choosing the motion vectors / reference frames, the denoiser is run, and if
  * it did not modify the signal to much, the denoised block is copied to the
  * signal.
+ *
+ * Blocks are denoised from the thread encoding them: the per block state is
+ * kept in the PICK_MODE_CONTEXT and MACROBLOCK of that thread, and only the
+ * block's own pixels of the running average buffers are written, so tile and
+ * row based multi-threaded encoding need no locking here.
  */
 
 #ifdef OUTPUT_YUV_DENOISED
@@ -326,6 +331,7 @@ void vp9_denoiser_denoise(VP9_COMP *cpi, MACROBLOCK *mb,
   int zeromv_filter = 0;
   VP9_DENOISER *denoiser = &cpi->denoiser;
   VP9_DENOISER_DECISION decision = COPY_BLOCK;
+  int increase_denoising = 0;
   YV12_BUFFER_CONFIG avg = denoiser->running_avg_y[INTRA_FRAME];
   YV12_BUFFER_CONFIG mc_avg = denoiser->mc_running_avg_y;
   uint8_t *avg_start = block_start(avg.y_buffer, avg.y_stride, mi_row, mi_col);
@@ -384,14 +390,12 @@ void vp9_denoiser_denoise(VP9_COMP *cpi, MACROBLOCK *mb,
   if (!is_skin &&
       denoiser->denoising_level == kDenHigh &&
       motion_magnitude < 16) {
-    denoiser->increase_denoising = 1;
-  } else {
-    denoiser->increase_denoising = 0;
+    increase_denoising = 1;
   }
 
   if (denoiser->denoising_level >= kDenLow)
     decision = perform_motion_compensation(denoiser, mb, bs,
-                                           denoiser->increase_denoising,
+                                           increase_denoising,
                                            mi_row, mi_col, ctx,
                                            motion_magnitude,
                                            is_skin,
@@ -402,7 +406,7 @@ void vp9_denoiser_denoise(VP9_COMP *cpi, MACROBLOCK *mb,
     decision = vp9_denoiser_filter(src.buf, src.stride,
                                  mc_avg_start, mc_avg.y_stride,
                                  avg_start, avg.y_stride,
-                                 denoiser->increase_denoising,
+                                 increase_denoising,
                                  bs, motion_magnitude);
   }
 
@@ -438,13 +442,23 @@ static void copy_frame(YV12_BUFFER_CONFIG * const dest,
   }
 }
 
-static void swap_frame_buffer(YV12_BUFFER_CONFIG * const dest,
-                              YV12_BUFFER_CONFIG * const src) {
-  uint8_t *tmp_buf = dest->y_buffer;
-  assert(dest->y_width == src->y_width);
-  assert(dest->y_height == src->y_height);
-  dest->y_buffer = src->y_buffer;
-  src->y_buffer = tmp_buf;
+// Points running_avg_y[INTRA_FRAME] at a buffer that no reference uses. There
+// are MAX_REF_FRAMES buffers and at most MAX_REF_FRAMES - 1 references, so
+// one is always free.
+static void assign_free_buffer(VP9_DENOISER *denoiser) {
+  int i, ref;
+  for (i = 0; i < MAX_REF_FRAMES; ++i) {
+    const uint8_t *const buf = denoiser->running_avg_buf[i].y_buffer;
+    for (ref = LAST_FRAME; ref < MAX_REF_FRAMES; ++ref) {
+      if (denoiser->running_avg_y[ref].y_buffer == buf)
+        break;
+    }
+    if (ref == MAX_REF_FRAMES) {
+      denoiser->running_avg_y[INTRA_FRAME] = denoiser->running_avg_buf[i];
+      return;
+    }
+  }
+  assert(0 && "No free denoiser buffer");
 }
 
 void vp9_denoiser_update_frame_info(VP9_DENOISER *denoiser,
@@ -454,45 +468,24 @@ void vp9_denoiser_update_frame_info(VP9_DENOISER *denoiser,
                                     int refresh_golden_frame,
                                     int refresh_last_frame,
                                     int resized) {
+  YV12_BUFFER_CONFIG *const avg = denoiser->running_avg_y;
+
   // Copy source into denoised reference buffers on KEY_FRAME or
-  // if the just encoded frame was resized.
+  // if the just encoded frame was resized. A single copy is shared by all
+  // the references.
   if (frame_type == KEY_FRAME || resized != 0) {
-    int i;
-    // Start at 1 so as not to overwrite the INTRA_FRAME
-    for (i = 1; i < MAX_REF_FRAMES; ++i)
-      copy_frame(&denoiser->running_avg_y[i], &src);
-    return;
+    copy_frame(&avg[INTRA_FRAME], &src);
+    refresh_alt_ref_frame = refresh_golden_frame = refresh_last_frame = 1;
   }
 
-  // If more than one refresh occurs, must copy frame buffer.
-  if ((refresh_alt_ref_frame + refresh_golden_frame + refresh_last_frame)
-      > 1) {
-    if (refresh_alt_ref_frame) {
-      copy_frame(&denoiser->running_avg_y[ALTREF_FRAME],
-                 &denoiser->running_avg_y[INTRA_FRAME]);
-    }
-    if (refresh_golden_frame) {
-      copy_frame(&denoiser->running_avg_y[GOLDEN_FRAME],
-                 &denoiser->running_avg_y[INTRA_FRAME]);
-    }
-    if (refresh_last_frame) {
-      copy_frame(&denoiser->running_avg_y[LAST_FRAME],
-                 &denoiser->running_avg_y[INTRA_FRAME]);
-    }
-  } else {
-    if (refresh_alt_ref_frame) {
-      swap_frame_buffer(&denoiser->running_avg_y[ALTREF_FRAME],
-                        &denoiser->running_avg_y[INTRA_FRAME]);
-    }
-    if (refresh_golden_frame) {
-      swap_frame_buffer(&denoiser->running_avg_y[GOLDEN_FRAME],
-                        &denoiser->running_avg_y[INTRA_FRAME]);
-    }
-    if (refresh_last_frame) {
-      swap_frame_buffer(&denoiser->running_avg_y[LAST_FRAME],
-                        &denoiser->running_avg_y[INTRA_FRAME]);
-    }
-  }
+  if (refresh_alt_ref_frame)
+    avg[ALTREF_FRAME] = avg[INTRA_FRAME];
+  if (refresh_golden_frame)
+    avg[GOLDEN_FRAME] = avg[INTRA_FRAME];
+  if (refresh_last_frame)
+    avg[LAST_FRAME] = avg[INTRA_FRAME];
+  if (refresh_alt_ref_frame || refresh_golden_frame || refresh_last_frame)
+    assign_free_buffer(denoiser);
 }
 
 void vp9_denoiser_reset_frame_stats(PICK_MODE_CONTEXT *ctx) {
@@ -531,7 +524,7 @@ int vp9_denoiser_alloc(VP9_DENOISER *denoiser, int width, int height,
   assert(denoiser != NULL);
 
   for (i = 0; i < MAX_REF_FRAMES; ++i) {
-    fail = vpx_alloc_frame_buffer(&denoiser->running_avg_y[i], width, height,
+    fail = vpx_alloc_frame_buffer(&denoiser->running_avg_buf[i], width, height,
                                   ssx, ssy,
 #if CONFIG_VP9_HIGHBITDEPTH
                                   use_highbitdepth,
@@ -542,8 +535,9 @@ int vp9_denoiser_alloc(VP9_DENOISER *denoiser, int width, int height,
       return 1;
     }
 #ifdef OUTPUT_YUV_DENOISED
-    make_grayscale(&denoiser->running_avg_y[i]);
+    make_grayscale(&denoiser->running_avg_buf[i]);
 #endif
+    denoiser->running_avg_y[i] = denoiser->running_avg_buf[i];
   }
 
   fail = vpx_alloc_frame_buffer(&denoiser->mc_running_avg_y, width, height,
@@ -570,7 +564,6 @@ int vp9_denoiser_alloc(VP9_DENOISER *denoiser, int width, int height,
 #ifdef OUTPUT_YUV_DENOISED
   make_grayscale(&denoiser->running_avg_y[i]);
 #endif
-  denoiser->increase_denoising = 0;
   denoiser->frame_buffer_initialized = 1;
   denoiser->denoising_level = kDenLow;
   return 0;
@@ -583,8 +576,9 @@ void vp9_denoiser_free(VP9_DENOISER *denoiser) {
     return;
   }
   for (i = 0; i < MAX_REF_FRAMES; ++i) {
-    vpx_free_frame_buffer(&denoiser->running_avg_y[i]);
+    vpx_free_frame_buffer(&denoiser->running_avg_buf[i]);
   }
+  memset(denoiser->running_avg_y, 0, sizeof(denoiser->running_avg_y));
   vpx_free_frame_buffer(&denoiser->mc_running_avg_y);
   vpx_free_frame_buffer(&denoiser->last_source);
 }
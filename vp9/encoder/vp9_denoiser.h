@@ -35,10 +35,15 @@ typedef enum vp9_denoiser_level {
 } VP9_DENOISER_LEVEL;
 
 typedef struct vp9_denoiser {
+  // Denoised running average of each reference, and of the frame being
+  // encoded in running_avg_y[INTRA_FRAME]. These are shallow copies of the
+  // buffers in running_avg_buf: refreshing a reference makes it share the
+  // buffer of the encoded frame instead of copying it, and several
+  // references may share one buffer.
   YV12_BUFFER_CONFIG running_avg_y[MAX_REF_FRAMES];
+  YV12_BUFFER_CONFIG running_avg_buf[MAX_REF_FRAMES];
   YV12_BUFFER_CONFIG mc_running_avg_y;
   YV12_BUFFER_CONFIG last_source;
-  int increase_denoising;
   int frame_buffer_initialized;
   VP9_DENOISER_LEVEL denoising_level;
 } VP9_DENOISER;
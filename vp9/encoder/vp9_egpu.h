@@ -129,7 +129,7 @@ static INLINE BLOCK_SIZE get_actual_block_size(GPU_BLOCK_SIZE bsize) {
 }
 
 static INLINE GPU_BLOCK_SIZE get_gpu_block_size(BLOCK_SIZE bsize) {
-  return vp9_gpu_block_size_lookup[bsize];
+  return (GPU_BLOCK_SIZE)vp9_gpu_block_size_lookup[bsize];
 }
 
 static INLINE int mi_width_log2(BLOCK_SIZE bsize) {
@@ -182,16 +182,28 @@ static INLINE void set_mode_info_offsets(VP9_COMMON *const cm,
   x->mbmi_ext = x->mbmi_ext_base + (mi_row * cm->mi_cols + mi_col);
 }
 
-static INLINE void get_start_tok(VP9_COMP *cpi, int tile_row, int tile_col,
-                                int mi_row, TOKENEXTRA **tok) {
+// Each tile of an SB row gets a fixed part of the token buffer, so that the
+// tiles of a row can be tokenized independently of each other.
+static INLINE void get_start_tok(VP9_COMP *cpi, const TileInfo *const tile,
+                                 int mi_row, TOKENEXTRA **tok) {
   VP9_COMMON *const cm = &cpi->common;
-  const int sb_row = mi_row >> MI_BLOCK_SIZE_LOG2;
-  if (!tile_col) {
-    const int mb_row = (mi_row >> 1);
-    *tok = cpi->tok + get_token_alloc(mb_row, cm->mb_cols);
-  } else {
-    *tok = cpi->tplist[sb_row][tile_row][tile_col - 1].stop;
-  }
+  const int mb_row = mi_row >> 1;
+  const int sb_mb_rows = VPXMIN(cm->mb_rows - mb_row, MI_BLOCK_SIZE >> 1);
+  const int tile_mb_col = tile->mi_col_start >> 1;
+
+  *tok = cpi->tok + get_token_alloc(mb_row, cm->mb_cols) +
+         get_token_alloc(sb_mb_rows, tile_mb_col);
+}
+
+// Upper bound of the tokens of an SB row of a tile.
+static INLINE int get_sb_row_token_alloc(const VP9_COMMON *const cm,
+                                         const TileInfo *const tile,
+                                         int mi_row) {
+  const int mb_row = mi_row >> 1;
+  const int sb_mb_rows = VPXMIN(cm->mb_rows - mb_row, MI_BLOCK_SIZE >> 1);
+  const int tile_mb_cols = (tile->mi_col_end - tile->mi_col_start + 1) >> 1;
+
+  return get_token_alloc(sb_mb_rows, tile_mb_cols);
 }
 
 int get_sb_index(VP9_COMMON *const cm,
@@ -2971,6 +2983,7 @@ static void rd_pick_partition(VP9_COMP *cpi, ThreadData *td,
 static void encode_rd_sb_row(VP9_COMP *cpi,
                              ThreadData *td,
                              const TileInfo *const tile_info,
+                             int tile_col,
                              int mi_row,
                              TOKENEXTRA **tp) {
   VP9_COMMON *const cm = &cpi->common;
@@ -2998,23 +3011,20 @@ static void encode_rd_sb_row(VP9_COMP *cpi,
 
     // In multi-threading, before encoding the current SB, make sure the
     // necessary dependencies to encode the current SB are met.
-    if (cpi->max_threads > 1) {
-      const int sb_row = mi_row >> MI_BLOCK_SIZE_LOG2;
-      const int sb_col = mi_col >> MI_BLOCK_SIZE_LOG2;
+    if (cpi->max_threads > 1)
+      vp9_enc_sync_read(cpi, td, tile_info, tile_col, mi_row, mi_col);
 
-      vp9_enc_sync_read(cpi, sb_row, sb_col);
-    }
+    if (is_row_mt_enabled(cpi) && mi_col == tile_info->mi_col_start)
+      vp9_row_mt_load_rd_state(cpi, &x->rd, tile_col, mi_row);
 
     if (sf->adaptive_pred_interp_filter) {
       const int leaf_nodes = 64;
       const int tree_nodes = 64 + 16 + 4 + 1;
 
-      int offset = leaf_nodes;
-      for (i = offset; i < leaf_nodes + offset; ++i)
+      for (i = 0; i < leaf_nodes; ++i)
         td->leaf_tree[i].pred_interp_filter = SWITCHABLE;
 
-      offset = tree_nodes;
-      for (i = offset; i < tree_nodes + offset; ++i) {
+      for (i = 0; i < tree_nodes; ++i) {
         td->pc_tree[i].vertical[0].pred_interp_filter = SWITCHABLE;
         td->pc_tree[i].vertical[1].pred_interp_filter = SWITCHABLE;
         td->pc_tree[i].horizontal[0].pred_interp_filter = SWITCHABLE;
@@ -3064,12 +3074,13 @@ static void encode_rd_sb_row(VP9_COMP *cpi,
                         &dummy_rdc, INT64_MAX, td->pc_root);
     }
 
+    if (is_row_mt_enabled(cpi) && mi_col == tile_info->mi_col_start)
+      vp9_row_mt_save_rd_state(cpi, &x->rd, tile_col, mi_row);
+
     // In multi-threading, after encoding the SB, make sure this is updated
     // in the cur_sb_col count
-    if (cpi->max_threads > 1) {
-      const int sb_row = mi_row >> MI_BLOCK_SIZE_LOG2;
-      vp9_enc_sync_write(cpi, sb_row);
-    }
+    if (cpi->max_threads > 1)
+      vp9_enc_sync_write(cpi, tile_info, tile_col, mi_row, mi_col);
   }
 }
 
@@ -3173,7 +3184,11 @@ static void nonrd_pick_sb_modes(VP9_COMP *cpi, const TileInfo *const tile_info,
     bsize_cp = mi->sb_type;
   mi->sb_type = bsize;
 
-  for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
+  // The data parallel pre-pass does not touch the entropy contexts. It must
+  // not restore them either: the above context is shared with the encoding
+  // of the SB rows above when the pre-pass is pipelined.
+  for (plane = 0; plane < MAX_MB_PLANE && !x->data_parallel_processing;
+       ++plane) {
     struct macroblockd_plane *pd = &xd->plane[plane];
     memcpy(a + num_4x4_blocks_wide * plane, pd->above_context,
            (sizeof(a[0]) * num_4x4_blocks_wide) >> pd->subsampling_x);
@@ -3205,7 +3220,8 @@ static void nonrd_pick_sb_modes(VP9_COMP *cpi, const TileInfo *const tile_info,
   if (x->data_parallel_processing)
     mi->sb_type = bsize_cp;
 
-  for (plane = 0; plane < MAX_MB_PLANE; ++plane) {
+  for (plane = 0; plane < MAX_MB_PLANE && !x->data_parallel_processing;
+       ++plane) {
     struct macroblockd_plane *pd = &xd->plane[plane];
     memcpy(pd->above_context, a + num_4x4_blocks_wide * plane,
            (sizeof(a[0]) * num_4x4_blocks_wide) >> pd->subsampling_x);
@@ -3834,8 +3850,11 @@ static void loopfilter_extend_onfly(VP9_COMP *cpi, ThreadData *td,
   MACROBLOCK *const x = &td->mb;
   MACROBLOCKD *const xd = &x->e_mbd;
 
+  if (!is_lpf_onfly(cpi) || is_row_mt_enabled(cpi))
+    return;
+
   if (!x->data_parallel_processing && mi_row >= MI_BLOCK_SIZE
-      && mi_col >= MI_BLOCK_SIZE && cpi->sf.lpf_pick >= LPF_PICK_FROM_Q) {
+      && mi_col >= MI_BLOCK_SIZE) {
     // Do a loopfilter of the top-left SB
     if (cm->lf.filter_level > 0) {
       vp9_loop_filter_sb(cm->frame_to_show, cm, x->e_mbd.plane,
@@ -3882,8 +3901,7 @@ static void loopfilter_extend_onfly(VP9_COMP *cpi, ThreadData *td,
 
   if (!x->data_parallel_processing &&
       mi_row + MI_BLOCK_SIZE >= cm->mi_rows &&
-      mi_col + MI_BLOCK_SIZE >= cm->mi_cols &&
-      cpi->sf.lpf_pick >= LPF_PICK_FROM_Q) {
+      mi_col + MI_BLOCK_SIZE >= cm->mi_cols) {
     YV12_BUFFER_CONFIG *rec_buff = cm->frame_to_show;
     const int inner_bw = (rec_buff->border > VP9INNERBORDERINPIXELS) ?
         VP9INNERBORDERINPIXELS : rec_buff->border;
@@ -3915,9 +3933,52 @@ static void loopfilter_extend_onfly(VP9_COMP *cpi, ThreadData *td,
   }
 }
 
+// Loop filters the SB row at mi_row once all its neighbours are encoded, and
+// extends the borders of the rows that the filter will not change anymore.
+// Used with row based multi-threading, where the SB rows of the tile columns
+// are encoded out of order.
+static void loopfilter_extend_sb_row(VP9_COMP *cpi, ThreadData *td,
+                                     int mi_row) {
+  VP9_COMMON *const cm = &cpi->common;
+  MACROBLOCKD *const xd = &td->mb.e_mbd;
+  YV12_BUFFER_CONFIG *rec_buff = cm->frame_to_show;
+  const int inner_bw = (rec_buff->border > VP9INNERBORDERINPIXELS) ?
+      VP9INNERBORDERINPIXELS : rec_buff->border;
+  const int last_row = mi_row + MI_BLOCK_SIZE >= cm->mi_rows;
+  int ext_mi_row;
+
+  if (cm->lf.filter_level > 0) {
+    vp9_loop_filter_rows(rec_buff, cm, xd->plane, mi_row,
+                         mi_row + MI_BLOCK_SIZE, 0);
+  }
+
+  // The filter changes the bottom pixels of the row above, which is final
+  // now. The last row is final once it is filtered.
+  for (ext_mi_row = VPXMAX(mi_row - MI_BLOCK_SIZE, 0);
+       ext_mi_row <= (last_row ? mi_row : mi_row - MI_BLOCK_SIZE);
+       ext_mi_row += MI_BLOCK_SIZE) {
+    vp9_setup_dst_planes(xd->plane, rec_buff, ext_mi_row, 0);
+    vp9_extend_sb(rec_buff, xd->plane[0].dst.buf, xd->plane[1].dst.buf,
+                  xd->plane[2].dst.buf, inner_bw, LEFT);
+    vp9_extend_sb(rec_buff, xd->plane[0].dst.buf, xd->plane[1].dst.buf,
+                  xd->plane[2].dst.buf, inner_bw, RIGHT);
+    if (ext_mi_row == 0) {
+      vp9_extend_sb(rec_buff, xd->plane[0].dst.buf, xd->plane[1].dst.buf,
+                    xd->plane[2].dst.buf, inner_bw, TOP);
+    }
+  }
+
+  if (last_row) {
+    vp9_setup_dst_planes(xd->plane, rec_buff, 0, 0);
+    vp9_extend_sb(rec_buff, xd->plane[0].dst.buf, xd->plane[1].dst.buf,
+                  xd->plane[2].dst.buf, inner_bw, BOTTOM);
+  }
+}
+
 static void encode_nonrd_sb_row(VP9_COMP *cpi,
                                 ThreadData *td,
                                 const TileInfo *const tile_info,
+                                int tile_col,
                                 int mi_row,
                                 TOKENEXTRA **tp) {
   SPEED_FEATURES *const sf = &cpi->sf;
@@ -3931,7 +3992,8 @@ static void encode_nonrd_sb_row(VP9_COMP *cpi,
   memset(xd->left_seg_context, 0, sizeof(xd->left_seg_context));
 
   if (!x->data_parallel_processing && mi_row == 0 &&
-      tile_info->mi_col_start == 0 && cpi->sf.lpf_pick >= LPF_PICK_FROM_Q) {
+      tile_info->mi_col_start == 0 && is_lpf_onfly(cpi) &&
+      !is_row_mt_enabled(cpi)) {
     vp9_pre_loopfilter(cpi);
   }
 
@@ -3949,12 +4011,11 @@ static void encode_nonrd_sb_row(VP9_COMP *cpi,
 
     // In multi-threading, before encoding the current SB, make sure the
     // necessary dependencies to encode the current SB are met.
-    if (cpi->max_threads > 1 && !x->data_parallel_processing) {
-      const int sb_row = mi_row >> MI_BLOCK_SIZE_LOG2;
-      const int sb_col = mi_col >> MI_BLOCK_SIZE_LOG2;
+    if (cpi->max_threads > 1 && !x->data_parallel_processing)
+      vp9_enc_sync_read(cpi, td, tile_info, tile_col, mi_row, mi_col);
 
-      vp9_enc_sync_read(cpi, sb_row, sb_col);
-    }
+    if (is_row_mt_enabled(cpi) && mi_col == tile_info->mi_col_start)
+      vp9_row_mt_load_rd_state(cpi, &x->rd, tile_col, mi_row);
 
     x->source_variance = UINT_MAX;
     vp9_zero(x->pred_mv);
@@ -4034,12 +4095,13 @@ static void encode_nonrd_sb_row(VP9_COMP *cpi,
     // perform loop filter and extend borders
     loopfilter_extend_onfly(cpi, td, mi_row, mi_col);
 
+    if (is_row_mt_enabled(cpi) && mi_col == tile_info->mi_col_start)
+      vp9_row_mt_save_rd_state(cpi, &x->rd, tile_col, mi_row);
+
     // In multi-threading, after encoding the SB, make sure this is updated
     // in the cur_sb_col count
-    if (cpi->max_threads > 1 && !x->data_parallel_processing) {
-      const int sb_row = mi_row >> MI_BLOCK_SIZE_LOG2;
-      vp9_enc_sync_write(cpi, sb_row);
-    }
+    if (cpi->max_threads > 1 && !x->data_parallel_processing)
+      vp9_enc_sync_write(cpi, tile_info, tile_col, mi_row, mi_col);
   }
 }
 // end RTC play code
@@ -4192,15 +4254,15 @@ static void encode_sb_rows(VP9_COMP *cpi, ThreadData *const td,
 #endif
     for (tile_col = 0; tile_col < tile_cols; ++tile_col) {
       vp9_tile_set_col(&tile, cm, tile_col);
-      get_start_tok(cpi, tile_row, tile_col, mi_row, &tok);
+      get_start_tok(cpi, &tile, mi_row, &tok);
       cpi->tplist[sb_row][tile_row][tile_col].start = tok;
       if (cpi->sf.use_nonrd_pick_mode)
-        encode_nonrd_sb_row(cpi, td, &tile, mi_row, &tok);
+        encode_nonrd_sb_row(cpi, td, &tile, tile_col, mi_row, &tok);
       else
-        encode_rd_sb_row(cpi, td, &tile, mi_row, &tok);
+        encode_rd_sb_row(cpi, td, &tile, tile_col, mi_row, &tok);
       cpi->tplist[sb_row][tile_row][tile_col].stop = tok;
-      assert(tok - cpi->tplist[sb_row][tile_row][0].start <=
-             get_token_alloc(MI_BLOCK_SIZE >> 1, cm->mb_cols));
+      assert(tok - cpi->tplist[sb_row][tile_row][tile_col].start <=
+             get_sb_row_token_alloc(cm, &tile, mi_row));
     }
 #if CONFIG_GPU_COMPUTE
       vp9_enc_enqueue_jobs_gpu(cpi, td, mi_row);
@@ -4208,13 +4270,125 @@ static void encode_sb_rows(VP9_COMP *cpi, ThreadData *const td,
   }
 }
 
-static void vp9_gpu_compute(VP9_COMP *cpi, ThreadData *td) {
+// Encode (SB row, tile column) jobs from the shared job list until it is
+// empty. Used for row based multi-threading.
+static void encode_sb_row_jobs(VP9_COMP *cpi, ThreadData *const td) {
+  VP9_COMMON *const cm = &cpi->common;
+  VP9RowMTInfo *const row_mt_info = &cpi->row_mt_info;
+  int mi_row, tile_col;
+
+  // Set up pointers to per thread motion search counters.
+  td->mb.m_search_count_ptr = &td->rd_counts.m_search_count;
+  td->mb.ex_search_count_ptr = &td->rd_counts.ex_search_count;
+
+  while (vp9_row_mt_get_next_job(cpi, &mi_row, &tile_col)) {
+    const int sb_row = mi_row >> MI_BLOCK_SIZE_LOG2;
+    const int m_search_count = td->rd_counts.m_search_count;
+    const int ex_search_count = td->rd_counts.ex_search_count;
+    TileInfo tile;
+    int tile_row;
+    TOKENEXTRA *tok;
+
+    tile_row = vp9_get_tile_row_index(&tile, cm, mi_row);
+    vp9_tile_set_col(&tile, cm, tile_col);
+
+    // The exhaustive search limits depend on the number of searches done so
+    // far, count them per job so that the result does not depend on which
+    // rows were encoded by the same thread before.
+    td->rd_counts.m_search_count = 0;
+    td->rd_counts.ex_search_count = 0;
+
+    get_start_tok(cpi, &tile, mi_row, &tok);
+    cpi->tplist[sb_row][tile_row][tile_col].start = tok;
+    if (cpi->sf.use_nonrd_pick_mode)
+      encode_nonrd_sb_row(cpi, td, &tile, tile_col, mi_row, &tok);
+    else
+      encode_rd_sb_row(cpi, td, &tile, tile_col, mi_row, &tok);
+    cpi->tplist[sb_row][tile_row][tile_col].stop = tok;
+    assert(tok - cpi->tplist[sb_row][tile_row][tile_col].start <=
+           get_sb_row_token_alloc(cm, &tile, mi_row));
+
+    td->rd_counts.m_search_count += m_search_count;
+    td->rd_counts.ex_search_count += ex_search_count;
+
+    if (tile_col == 0 && mi_row + MI_BLOCK_SIZE >= cm->mi_rows) {
+      RD_ROW_STATE *const next_base = &row_mt_info->next_base_rd_state;
+      memcpy(next_base->thresh_freq_fact, td->mb.rd.thresh_freq_fact,
+             sizeof(next_base->thresh_freq_fact));
+      memcpy(next_base->mode_map, td->mb.rd.mode_map,
+             sizeof(next_base->mode_map));
+    }
+
+    if (is_lpf_onfly(cpi)) {
+      int lf_mi_row;
+      if (vp9_row_mt_job_done(cpi, mi_row, &lf_mi_row)) {
+        do {
+          loopfilter_extend_sb_row(cpi, td, lf_mi_row);
+        } while (vp9_row_mt_lf_row_done(cpi, &lf_mi_row));
+      }
+    }
+  }
+}
+
+// Encodes the SB rows of the frame on the encoding threads, then accumulates
+// the stats of the thread contexts. The worker hooks must have been set up by
+// encode_tiles_mt(). With pipeline_dp set, the threads also run the data
+// parallel pre-pass of the SB rows ahead of their encoding.
+static void encode_sb_rows_launch_mt(VP9_COMP *cpi, int pipeline_dp) {
+  VP9_COMMON *const cm = &cpi->common;
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  const int num_lanes = VPXMIN(cpi->max_threads, cm->sb_rows);
+  int thread_id;
+
+  if (pipeline_dp)
+    vp9_dp_thread_data_alloc(cpi);
+  vp9_enc_sync_frame_init(cpi, pipeline_dp);
+
+  for (thread_id = 0; thread_id < cpi->max_threads; ++thread_id) {
+    VPxWorker *const worker = &cpi->enc_thread_hndl[thread_id];
+
+    // start encoding
+    if (thread_id == cpi->max_threads - 1) {
+      winterface->execute(worker);
+    } else {
+      winterface->launch(worker);
+    }
+  }
+
+  // Wait till all rows are finished
+  for (thread_id = 0; thread_id < cpi->max_threads; ++thread_id)
+    winterface->sync(&cpi->enc_thread_hndl[thread_id]);
+
+  // After encoding the frame, accumulate the stats across all threads,
+  // for updating probability and rd thresh tables for the next frame. The
+  // data parallel pre-pass keeps its stats as the single threaded encoder
+  // does, the encoding pass clears the thread stats.
+  for (thread_id = 0; thread_id < num_lanes; ++thread_id) {
+    ThreadData *const td = &cpi->enc_thread_ctxt[thread_id]->td;
+
+    if (pipeline_dp) {
+      ThreadData *const dp_td = &cpi->dp_thread_data[thread_id];
+
+      vp9_accumulate_frame_counts(&cm->counts, dp_td->counts, 0);
+      vp9_accumulate_rd_opt(&cpi->td, dp_td);
+    }
+    vp9_accumulate_frame_counts(&cm->counts, td->counts, 0);
+    vp9_accumulate_rd_opt(&cpi->td, td);
+  }
+}
+
+// Runs the data parallel pre-pass of the frame. With can_pipeline set and the
+// pre-pass at the quantizer of the frame, the pre-pass is left to the encoding
+// threads, which run it row by row ahead of the encoding: returns 1 then.
+static int vp9_gpu_compute(VP9_COMP *cpi, ThreadData *td, int can_pipeline) {
   VP9_COMMON *const cm = &cpi->common;
+  int pipeline_dp = 0;
 
   if (cpi->td.mb.use_gpu && cpi->sf.use_nonrd_pick_mode) {
     vp9_gpu_predict_inter_qp(cpi);
     if (!frame_is_intra_only(cm)) {
 #if CONFIG_GPU_COMPUTE
+      (void)can_pipeline;
       if (!cpi->b_async) {
         thread_context_gpu egpu_thread_ctxt;
 
@@ -4226,21 +4400,32 @@ static void vp9_gpu_compute(VP9_COMP *cpi, ThreadData *td) {
 #else
       int base_qindex = cm->base_qindex;
 
-      td->mb.data_parallel_processing = 1;
-      if (cpi->b_async) {
-        int q = cpi->rc.q_prediction_curr;
+      // The quantizer state the pre-pass runs with is global to the frame,
+      // so a pre-pass at the predicted quantizer has to be done before the
+      // encoding starts.
+      if (can_pipeline && cpi->max_threads > 1 &&
+          (!cpi->b_async || cpi->rc.q_prediction_curr == base_qindex)) {
+        pipeline_dp = 1;
+      } else {
+        td->mb.data_parallel_processing = 1;
+        if (cpi->b_async) {
+          int q = cpi->rc.q_prediction_curr;
 
-        if (cm->base_qindex != q) {
-          vp9_gpu_rewrite_quant_info(cpi, &td->mb, q);
+          if (cm->base_qindex != q) {
+            vp9_gpu_rewrite_quant_info(cpi, &td->mb, q);
+          }
         }
-      }
-      encode_sb_rows(cpi, td, 0, cm->mi_rows, MI_BLOCK_SIZE);
-      if (cpi->b_async) {
-        if (cm->base_qindex != base_qindex) {
-          vp9_gpu_rewrite_quant_info(cpi, &td->mb, base_qindex);
+        if (cpi->max_threads > 1)
+          encode_sb_rows_launch_mt(cpi, 0);
+        else
+          encode_sb_rows(cpi, td, 0, cm->mi_rows, MI_BLOCK_SIZE);
+        if (cpi->b_async) {
+          if (cm->base_qindex != base_qindex) {
+            vp9_gpu_rewrite_quant_info(cpi, &td->mb, base_qindex);
+          }
         }
+        td->mb.data_parallel_processing = 0;
       }
-      td->mb.data_parallel_processing = 0;
 #endif
     }
     if (cm->current_video_frame >= ASYNC_FRAME_COUNT_WAIT &&
@@ -4266,6 +4451,7 @@ static void vp9_gpu_compute(VP9_COMP *cpi, ThreadData *td) {
       cpi->b_async = 1;
     }
   }
+  return pipeline_dp;
 }
 
 static void encode_tiles(VP9_COMP *cpi) {
@@ -4273,81 +4459,94 @@ static void encode_tiles(VP9_COMP *cpi) {
   ThreadData *const td = &cpi->td;
 
   // enable gpu processing
-  vp9_gpu_compute(cpi, td);
+  vp9_gpu_compute(cpi, td, 0);
 
   // encode superblock rows
   encode_sb_rows(cpi, td, 0, cm->mi_rows, MI_BLOCK_SIZE);
 }
 
-static void encode_tiles_mt(VP9_COMP *cpi) {
+static void encode_tiles_row_mt(VP9_COMP *cpi) {
   VP9_COMMON *const cm = &cpi->common;
-  ThreadData *const td = &cpi->td;
   const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
   int thread_id;
 
-  // Initialize row encoding hook
-  for (thread_id = 0; thread_id < cpi->max_threads; ++thread_id) {
-    winterface->sync(&cpi->enc_thread_hndl[thread_id]);
-    cpi->enc_thread_hndl[thread_id].hook =
-        (VPxWorkerHook) vp9_encoding_thread_process;
-    cpi->enc_thread_hndl[thread_id].data1 = cpi->enc_thread_ctxt[thread_id];
-    cpi->enc_thread_hndl[thread_id].data2 = NULL;
-  }
+  vp9_row_mt_frame_init(cpi);
 
-  // Initialize cur_sb_col to -1 for all SB rows.
-  memset(cpi->cur_sb_col, -1, (sizeof(*cpi->cur_sb_col) * cm->sb_rows));
+  // The SB rows are loop filtered by the encoding threads.
+  if (is_lpf_onfly(cpi))
+    vp9_pre_loopfilter(cpi);
 
-  // enable gpu processing
-  vp9_gpu_compute(cpi, td);
+  if (cpi->max_threads > 1) {
+    for (thread_id = 0; thread_id < cpi->max_threads; ++thread_id) {
+      VPxWorker *const worker = &cpi->enc_thread_hndl[thread_id];
+      thread_context *const thread_ctxt = (thread_context *)worker->data1;
 
-  for (thread_id = 0; thread_id < cpi->max_threads ; ++thread_id) {
-    VPxWorker *const worker = &cpi->enc_thread_hndl[thread_id];
-    thread_context *const thread_ctxt = (thread_context *)worker->data1;
+      winterface->sync(worker);
+      worker->hook = (VPxWorkerHook) vp9_encoding_thread_process;
+      worker->data2 = NULL;
+      thread_ctxt->cpi = cpi;
+    }
 
-    // initialize thread context
-    thread_ctxt->cpi = cpi;
+    for (thread_id = 0; thread_id < cpi->max_threads; ++thread_id) {
+      VPxWorker *const worker = &cpi->enc_thread_hndl[thread_id];
 
-    // thread start sb row
-    thread_ctxt->mi_row_start = MI_BLOCK_SIZE * thread_id;
-    // thread end sb row
-    thread_ctxt->mi_row_end = cm->mi_rows;
-    // thread step sb row
-    thread_ctxt->mi_row_step = MI_BLOCK_SIZE * cpi->max_threads;
+      // start encoding
+      if (thread_id == cpi->max_threads - 1) {
+        winterface->execute(worker);
+      } else {
+        winterface->launch(worker);
+      }
+    }
 
-    // start encoding
-    if (thread_id == cpi->max_threads - 1) {
-      winterface->execute(worker);
-    } else {
-      winterface->launch(worker);
+    // Wait till all rows are finished
+    for (thread_id = 0; thread_id < cpi->max_threads; ++thread_id) {
+      VPxWorker *const worker = &cpi->enc_thread_hndl[thread_id];
+      thread_context *const row_data = (thread_context*)worker->data1;
+      ThreadData *const td = &row_data->td;
+
+      winterface->sync(worker);
+
+      vp9_accumulate_frame_counts(&cm->counts, td->counts, 0);
+      vp9_accumulate_rd_opt(&cpi->td, td);
     }
+  } else {
+    encode_sb_row_jobs(cpi, &cpi->td);
   }
 
-  // Wait till all rows are finished
+  cpi->row_mt_info.base_rd_state = cpi->row_mt_info.next_base_rd_state;
+}
+
+static void encode_tiles_mt(VP9_COMP *cpi) {
+  ThreadData *const td = &cpi->td;
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  int thread_id;
+
+  // Initialize row encoding hook
   for (thread_id = 0; thread_id < cpi->max_threads; ++thread_id) {
     VPxWorker *const worker = &cpi->enc_thread_hndl[thread_id];
-    thread_context *const row_data = (thread_context*)worker->data1;
-    ThreadData *const td = &row_data->td;
+    thread_context *const thread_ctxt = cpi->enc_thread_ctxt[thread_id];
 
     winterface->sync(worker);
+    worker->hook = (VPxWorkerHook) vp9_encoding_thread_process;
+    worker->data1 = thread_ctxt;
+    worker->data2 = NULL;
 
-    // After encoding the frame, accumulate the stats across all threads,
-    // for updating probability and rd thresh tables for the next frame.
-    vp9_accumulate_frame_counts(&cm->counts, td->counts, 0);
-    vp9_accumulate_rd_opt(&cpi->td, td);
+    // initialize thread context
+    thread_ctxt->cpi = cpi;
   }
+
+  // enable gpu processing
+  encode_sb_rows_launch_mt(cpi, vp9_gpu_compute(cpi, td, 1));
 }
 
-int vp9_encoding_thread_process(thread_context *const thread_ctxt,
-                                void* data2) {
-  VP9_COMP *cpi = thread_ctxt->cpi;
-  ThreadData *const td = &thread_ctxt->td;
+// Set up the thread data of an encoding thread for the current frame.
+static void init_thread_data(VP9_COMP *cpi, ThreadData *td) {
   MACROBLOCK *const x = &td->mb;
   MACROBLOCKD *const xd = &x->e_mbd;
   SPEED_FEATURES *const sf = &cpi->sf;
 
-  (void)data2;
   // initialize mb in thread context
-  vp9_mb_copy(cpi, &thread_ctxt->td.mb, &cpi->td.mb);
+  vp9_mb_copy(cpi, &td->mb, &cpi->td.mb);
   vp9_zero(*td->counts);
   vp9_zero(td->rd_counts);
   if (sf->use_nonrd_pick_mode) {
@@ -4369,10 +4568,60 @@ int vp9_encoding_thread_process(thread_context *const thread_ctxt,
     }
     vp9_zero(x->zcoeff_blk);
   }
+}
+
+// Encode SB rows taken in raster order from the shared row counter until all
+// the rows of the frame are handed out, so that whichever threads actually run
+// always have the row above done or in progress. SB row r is encoded with the
+// thread data of thread r % max_threads: every thread data encodes the same
+// rows in the same order, and so ends up with the same stats and adaptive
+// search state, whatever worker runs them. A row waits for the previous row of
+// its thread data to be done before taking the thread data over.
+// The pipelined data parallel pre-pass of the SB rows is handed out the same
+// way, with thread data of its own, and the encoding of an SB row waits for
+// its pre-pass. The pre-pass of an SB row only reads the reference frames and
+// only writes the mode info and the pre-pass outputs of its own SBs, so it
+// may run alongside the encoding of the rows above.
+static void encode_sb_rows_mt(VP9_COMP *cpi) {
+  VP9EncSync *const enc_sync = &cpi->enc_row_sync;
+  int sb_row, dp;
+
+  while (vp9_enc_sync_get_next_job(enc_sync, &sb_row, &dp)) {
+    const int lane = sb_row % cpi->max_threads;
+    const int slot = dp ? enc_sync->dp_slot + sb_row : sb_row;
+    ThreadData *const td = dp ? &cpi->dp_thread_data[lane]
+                              : &cpi->enc_thread_ctxt[lane]->td;
+    const int mi_row = sb_row << MI_BLOCK_SIZE_LOG2;
+
+    if (sb_row < cpi->max_threads) {
+      init_thread_data(cpi, td);
+      if (dp)
+        td->mb.data_parallel_processing = 1;
+    } else {
+      vp9_enc_sync_wait_row_done(enc_sync, slot - cpi->max_threads);
+    }
+    if (!dp && enc_sync->num_dp_rows)
+      vp9_enc_sync_wait_row_done(enc_sync, enc_sync->dp_slot + sb_row);
+
+    encode_sb_rows(cpi, td, mi_row, mi_row + MI_BLOCK_SIZE, MI_BLOCK_SIZE);
+
+    vp9_enc_sync_row_done(enc_sync, slot);
+  }
+}
+
+int vp9_encoding_thread_process(thread_context *const thread_ctxt,
+                                void* data2) {
+  VP9_COMP *cpi = thread_ctxt->cpi;
+
+  (void)data2;
 
   // encode superblock rows
-  encode_sb_rows(cpi, td, thread_ctxt->mi_row_start, thread_ctxt->mi_row_end,
-                 thread_ctxt->mi_row_step);
+  if (is_row_mt_enabled(cpi)) {
+    init_thread_data(cpi, &thread_ctxt->td);
+    encode_sb_row_jobs(cpi, &thread_ctxt->td);
+  } else {
+    encode_sb_rows_mt(cpi);
+  }
 
   return 0;
 }
@@ -4483,7 +4732,9 @@ static void encode_frame_internal(VP9_COMP *cpi) {
   }
 #endif
 
-    if (cpi->max_threads > 1) {
+    if (is_row_mt_enabled(cpi)) {
+      encode_tiles_row_mt(cpi);
+    } else if (cpi->max_threads > 1) {
       encode_tiles_mt(cpi);
     } else {
       encode_tiles(cpi);
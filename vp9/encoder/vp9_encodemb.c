@@ -75,6 +75,33 @@ static const int plane_rd_mult[PLANE_TYPES] = { 4, 2 };
   }\
 }
 
+void vp9_trellis_candidates_c(const tran_low_t *coeff, const tran_low_t *qcoeff,
+                              const tran_low_t *dqcoeff, intptr_t n_coeffs,
+                              const int16_t *dequant, int mul, int shift,
+                              int *dist, int *dist_down,
+                              tran_low_t *qcoeff_down) {
+  int i;
+
+  for (i = 0; i < n_coeffs; ++i) {
+    const int x = qcoeff[i];
+    const int dq = dequant[i != 0];
+    int dx = (mul * (dqcoeff[i] - coeff[i])) >> shift;
+    dist[i] = dx * dx;
+    // Rounding down is only tried when it brings the coefficient closer to,
+    // or past, its unquantized value.
+    if (abs(x) * dq > abs(coeff[i]) * mul &&
+        abs(x) * dq < abs(coeff[i]) * mul + dq) {
+      const int sz = -(x < 0);
+      dx -= ((dq >> shift) + sz) ^ sz;
+      dist_down[i] = dx * dx;
+      qcoeff_down[i] = x - 2 * sz - 1;
+    } else {
+      dist_down[i] = dist[i];
+      qcoeff_down[i] = x;
+    }
+  }
+}
+
 // This function is a place holder for now but may ultimately need
 // to scan previous tokens to work out the correct context.
 static int trellis_get_coeff_context(const int16_t *scan,
@@ -97,6 +124,11 @@ static int optimize_b(MACROBLOCK *mb, int plane, int block,
   vp9_token_state tokens[1025][2];
   unsigned best_index[1025][2];
   uint8_t token_cache[1024];
+  // The distortions of the quantized and rounded down coefficients and the
+  // rounded down coefficients, in raster order.
+  int dist[1024];
+  int dist_down[1024];
+  tran_low_t qcoeff_down[1024];
   const tran_low_t *const coeff = BLOCK_OFFSET(mb->plane[plane].coeff, block);
   tran_low_t *const qcoeff = BLOCK_OFFSET(p->qcoeff, block);
   tran_low_t *const dqcoeff = BLOCK_OFFSET(pd->dqcoeff, block);
@@ -109,7 +141,15 @@ static int optimize_b(MACROBLOCK *mb, int plane, int block,
   const scan_order *const so = get_scan(xd, tx_size, type, block);
   const int16_t *const scan = so->scan;
   const int16_t *const nb = so->neighbors;
-  int next = eob, sz = 0;
+  unsigned int (*const token_costs)[2][COEFF_CONTEXTS][ENTROPY_TOKENS] =
+      mb->token_costs[tx_size][type][ref];
+#if CONFIG_VP9_HIGHBITDEPTH
+  const int shift = (xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH) ?
+      xd->bd - 8 : 0;
+#else
+  const int shift = 0;
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+  int next = eob, max_rc = 0;
   int64_t rdmult = mb->rdmult * plane_rd_mult[type], rddiv = mb->rddiv;
   int64_t rd_cost0, rd_cost1;
   int rate0, rate1, error0, error1;
@@ -137,17 +177,25 @@ static int optimize_b(MACROBLOCK *mb, int plane, int block,
   tokens[eob][0].qc = 0;
   tokens[eob][1] = tokens[eob][0];
 
-  for (i = 0; i < eob; i++)
+  for (i = 0; i < eob; i++) {
     token_cache[scan[i]] =
         vp9_pt_energy_class[vp9_get_token(qcoeff[scan[i]])];
+    max_rc = VPXMAX(max_rc, scan[i]);
+  }
+
+  // The candidates only depend on their own coefficient, so they are
+  // evaluated up front for all the coefficients up to the last one in the
+  // scan, leaving the rates to the trellis below.
+  vp9_trellis_candidates(coeff, qcoeff, dqcoeff,
+                         ALIGN_POWER_OF_TWO(max_rc + 1, 4), dequant_ptr, mul,
+                         shift, dist, dist_down, qcoeff_down);
 
   for (i = eob; i-- > 0;) {
-    int base_bits, d2, dx;
+    int base_bits;
     const int rc = scan[i];
     int x = qcoeff[rc];
     /* Only add a trellis state for non-zero coefficients. */
     if (x) {
-      int shortcut = 0;
       error0 = tokens[next][0].error;
       error1 = tokens[next][1].error;
       /* Evaluate the first possibility for this state. */
@@ -158,24 +206,15 @@ static int optimize_b(MACROBLOCK *mb, int plane, int block,
       if (next < default_eob) {
         band = band_translate[i + 1];
         pt = trellis_get_coeff_context(scan, nb, i, t0, token_cache);
-        rate0 += mb->token_costs[tx_size][type][ref][band][0][pt]
-                                [tokens[next][0].token];
-        rate1 += mb->token_costs[tx_size][type][ref][band][0][pt]
-                                [tokens[next][1].token];
+        rate0 += token_costs[band][0][pt][tokens[next][0].token];
+        rate1 += token_costs[band][0][pt][tokens[next][1].token];
       }
       UPDATE_RD_COST();
       /* And pick the best. */
       best = rd_cost1 < rd_cost0;
       base_bits = vp9_get_cost(t0, e0, cat6_high_cost);
-      dx = mul * (dqcoeff[rc] - coeff[rc]);
-#if CONFIG_VP9_HIGHBITDEPTH
-      if (xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH) {
-        dx >>= xd->bd - 8;
-      }
-#endif  // CONFIG_VP9_HIGHBITDEPTH
-      d2 = dx * dx;
       tokens[i][0].rate = base_bits + (best ? rate1 : rate0);
-      tokens[i][0].error = d2 + (best ? error1 : error0);
+      tokens[i][0].error = dist[rc] + (best ? error1 : error0);
       tokens[i][0].next = next;
       tokens[i][0].token = t0;
       tokens[i][0].qc = x;
@@ -184,18 +223,7 @@ static int optimize_b(MACROBLOCK *mb, int plane, int block,
       /* Evaluate the second possibility for this state. */
       rate0 = tokens[next][0].rate;
       rate1 = tokens[next][1].rate;
-
-      if ((abs(x) * dequant_ptr[rc != 0] > abs(coeff[rc]) * mul) &&
-          (abs(x) * dequant_ptr[rc != 0] < abs(coeff[rc]) * mul +
-                                               dequant_ptr[rc != 0]))
-        shortcut = 1;
-      else
-        shortcut = 0;
-
-      if (shortcut) {
-        sz = -(x < 0);
-        x -= 2 * sz + 1;
-      }
+      x = qcoeff_down[rc];
 
       /* Consider both possible successor states. */
       if (!x) {
@@ -213,13 +241,11 @@ static int optimize_b(MACROBLOCK *mb, int plane, int block,
         band = band_translate[i + 1];
         if (t0 != EOB_TOKEN) {
           pt = trellis_get_coeff_context(scan, nb, i, t0, token_cache);
-          rate0 += mb->token_costs[tx_size][type][ref][band][!x][pt]
-                                  [tokens[next][0].token];
+          rate0 += token_costs[band][!x][pt][tokens[next][0].token];
         }
         if (t1 != EOB_TOKEN) {
           pt = trellis_get_coeff_context(scan, nb, i, t1, token_cache);
-          rate1 += mb->token_costs[tx_size][type][ref][band][!x][pt]
-                                  [tokens[next][1].token];
+          rate1 += token_costs[band][!x][pt][tokens[next][1].token];
         }
       }
 
@@ -227,21 +253,8 @@ static int optimize_b(MACROBLOCK *mb, int plane, int block,
       /* And pick the best. */
       best = rd_cost1 < rd_cost0;
       base_bits = vp9_get_cost(t0, e0, cat6_high_cost);
-
-      if (shortcut) {
-#if CONFIG_VP9_HIGHBITDEPTH
-        if (xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH) {
-          dx -= ((dequant_ptr[rc != 0] >> (xd->bd - 8)) + sz) ^ sz;
-        } else {
-          dx -= (dequant_ptr[rc != 0] + sz) ^ sz;
-        }
-#else
-        dx -= (dequant_ptr[rc != 0] + sz) ^ sz;
-#endif  // CONFIG_VP9_HIGHBITDEPTH
-        d2 = dx * dx;
-      }
       tokens[i][1].rate = base_bits + (best ? rate1 : rate0);
-      tokens[i][1].error = d2 + (best ? error1 : error0);
+      tokens[i][1].error = dist_down[rc] + (best ? error1 : error0);
       tokens[i][1].next = next;
       tokens[i][1].token = best ? t1 : t0;
       tokens[i][1].qc = x;
@@ -257,13 +270,11 @@ static int optimize_b(MACROBLOCK *mb, int plane, int block,
       t1 = tokens[next][1].token;
       /* Update the cost of each path if we're past the EOB token. */
       if (t0 != EOB_TOKEN) {
-        tokens[next][0].rate +=
-            mb->token_costs[tx_size][type][ref][band][1][0][t0];
+        tokens[next][0].rate += token_costs[band][1][0][t0];
         tokens[next][0].token = ZERO_TOKEN;
       }
       if (t1 != EOB_TOKEN) {
-        tokens[next][1].rate +=
-            mb->token_costs[tx_size][type][ref][band][1][0][t1];
+        tokens[next][1].rate += token_costs[band][1][0][t1];
         tokens[next][1].token = ZERO_TOKEN;
       }
       best_index[i][0] = best_index[i][1] = 0;
@@ -279,8 +290,8 @@ static int optimize_b(MACROBLOCK *mb, int plane, int block,
   error1 = tokens[next][1].error;
   t0 = tokens[next][0].token;
   t1 = tokens[next][1].token;
-  rate0 += mb->token_costs[tx_size][type][ref][band][0][ctx][t0];
-  rate1 += mb->token_costs[tx_size][type][ref][band][0][ctx][t1];
+  rate0 += token_costs[band][0][ctx][t0];
+  rate1 += token_costs[band][0][ctx][t1];
   UPDATE_RD_COST();
   best = rd_cost1 < rd_cost0;
   final_eob = -1;
@@ -395,6 +395,9 @@ static void dealloc_compressor_data(VP9_COMP *cpi) {
   vpx_free(cpi->tplist);
   cpi->tplist = NULL;
 
+  vpx_free(cpi->tile_above_seg_context[0]);
+  vp9_zero(cpi->tile_above_seg_context);
+
   if (cm->use_gpu) {
     vp9_free_gpu_interface_buffers(cpi);
 #if CONFIG_GPU_COMPUTE
@@ -725,6 +728,18 @@ static void alloc_compressor_data(VP9_COMP *cpi) {
   CHECK_MEM_ERROR(cm, cpi->tplist,
                   vpx_calloc(cm->sb_rows, sizeof(*cpi->tplist)));
 
+  vpx_free(cpi->tile_above_seg_context[0]);
+  {
+    const int aligned_mi_cols = mi_cols_aligned_to_sb(cm->mi_cols);
+    int tile_row;
+    CHECK_MEM_ERROR(cm, cpi->tile_above_seg_context[0],
+                    vpx_calloc(4 * aligned_mi_cols,
+                               sizeof(*cpi->tile_above_seg_context[0])));
+    for (tile_row = 1; tile_row < 4; ++tile_row)
+      cpi->tile_above_seg_context[tile_row] =
+          cpi->tile_above_seg_context[0] + tile_row * aligned_mi_cols;
+  }
+
   // don't create more threads than rows available
   cpi->max_threads = VPXMIN(cpi->max_threads, cm->sb_rows);
 
@@ -753,20 +768,26 @@ static void set_tile_limits(VP9_COMP *cpi) {
     cm->log2_tile_rows = cpi->oxcf.tile_rows;
   }
 
-  // Set the output buffer pointer for each tile
+  // Set the output buffer pointer for each tile. The first tile is written
+  // straight into the frame's output, the others get a share of the scratch
+  // buffer proportional to their area.
   if (cpi->max_threads > 1) {
     const int tile_rows = 1 << cm->log2_tile_rows;
     const int tile_cols = 1 << cm->log2_tile_cols;
-    const int num_tiles = tile_rows * tile_cols;
-    const int out_buffer_size_per_tile = cpi->out_buffer_size / num_tiles;
+    const int64_t frame_area = (int64_t)cm->mi_rows * cm->mi_cols;
     uint8_t *data = cpi->out_buffer_tiles[0][0];
     int tile_row, tile_col;
 
     for (tile_row = 0; tile_row < tile_rows; tile_row++) {
       for (tile_col = 0; tile_col < tile_cols; tile_col++) {
-        const int idx = tile_row * tile_cols + tile_col;
-        cpi->out_buffer_tiles[tile_row][tile_col] =
-            data + (idx * out_buffer_size_per_tile);
+        TileInfo tile;
+        vp9_tile_init(&tile, cm, tile_row, tile_col);
+        cpi->out_buffer_tiles[tile_row][tile_col] = data;
+        if (tile_row == 0 && tile_col == 0)
+          continue;
+        data += (int64_t)cpi->out_buffer_size *
+                (tile.mi_row_end - tile.mi_row_start) *
+                (tile.mi_col_end - tile.mi_col_start) / frame_area;
       }
     }
   }
@@ -1555,6 +1576,9 @@ void vp9_change_config(struct VP9_COMP *cpi, const VP9EncoderConfig *oxcf) {
   else
     assert(cm->bit_depth > VPX_BITS_8);
 
+  if (oxcf->target_frame_time != cpi->oxcf.target_frame_time)
+    vp9_zero(cpi->speed_tuner);
+
   cpi->oxcf = *oxcf;
 #if CONFIG_VP9_HIGHBITDEPTH
   cpi->td.mb.e_mbd.bd = (int)cm->bit_depth;
@@ -1993,6 +2017,11 @@ VP9_COMP *vp9_create_compressor(VP9EncoderConfig *oxcf,
   memcpy(cpi->td.mb.rd.mode_map, cpi->rd.mode_map,
          sizeof(cpi->rd.mode_map));
 
+  // The main thread data is used outside of the SB row encoding (e.g. by the
+  // temporal filter) even when the rows are encoded by worker threads.
+  cpi->td.mb.m_search_count_ptr = &cpi->td.rd_counts.m_search_count;
+  cpi->td.mb.ex_search_count_ptr = &cpi->td.rd_counts.ex_search_count;
+
   // allocate space for encoder thread handles and create threads
   if (cpi->max_threads > 1)
     vp9_create_encoding_threads(cpi);
@@ -2212,10 +2241,11 @@ void vp9_remove_compressor(VP9_COMP *cpi) {
     cpi->enc_thread_hndl = NULL;
     vpx_free(cpi->enc_thread_ctxt);
     cpi->enc_thread_ctxt = NULL;
-    vpx_free(cpi->cur_sb_col);
-    cpi->cur_sb_col = NULL;
+    vp9_dp_thread_data_dealloc(cpi);
     vp9_entropy_dealloc(cpi);
   }
+  vp9_enc_sync_dealloc(&cpi->enc_row_sync);
+  vp9_row_mt_dealloc(cpi);
 
   dealloc_compressor_data(cpi);
 
@@ -4184,7 +4214,7 @@ static void encode_frame_to_data_rate(VP9_COMP *cpi,
     cpi->refresh_last_frame = 1;
 
   // perform loop filter
-  if (!cpi->sf.use_nonrd_pick_mode || cpi->sf.lpf_pick < LPF_PICK_FROM_Q) {
+  if (!is_lpf_onfly(cpi)) {
     loopfilter_frame(cpi);
   }
 
@@ -4355,7 +4385,7 @@ static void check_initial_width(VP9_COMP *cpi,
 
 int vp9_receive_raw_frame(VP9_COMP *cpi, unsigned int frame_flags,
                           YV12_BUFFER_CONFIG *sd, int64_t time_stamp,
-                          int64_t end_time) {
+                          int64_t end_time, void *user_priv) {
   VP9_COMMON *const cm = &cpi->common;
   struct vpx_usec_timer timer;
   int res = 0;
@@ -4376,11 +4406,22 @@ int vp9_receive_raw_frame(VP9_COMP *cpi, unsigned int frame_flags,
 #endif
   vpx_usec_timer_start(&timer);
 
+  // The pyramid only serves the temporal filtering of the alt-ref frames.
+  cpi->lookahead->use_pyramid = cpi->sf.mv.use_lookahead_pyramid &&
+                                cpi->oxcf.pass != 1 &&
+                                is_altref_enabled(cpi) &&
+                                cpi->oxcf.arnr_max_frames > 0 &&
+                                cpi->oxcf.arnr_strength > 0;
+  cpi->lookahead->release_cb = cpi->release_source_cb;
+  cpi->lookahead->release_state = cpi->release_source_state;
+  // The GPU reads the sources from the buffers allocated for it.
+  cpi->lookahead->ref_ext_frames = !cm->use_gpu;
+
   if (vp9_lookahead_push(cpi->lookahead, sd, time_stamp, end_time,
 #if CONFIG_VP9_HIGHBITDEPTH
                          use_highbitdepth,
 #endif  // CONFIG_VP9_HIGHBITDEPTH
-                         frame_flags))
+                         frame_flags, user_priv))
     res = -1;
   vpx_usec_timer_mark(&timer);
   cpi->time_receive_data += vpx_usec_timer_elapsed(&timer);
@@ -4777,6 +4818,9 @@ int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
   vpx_usec_timer_mark(&cmptimer);
   cpi->time_compress_data += vpx_usec_timer_elapsed(&cmptimer);
 
+  if (oxcf->target_frame_time > 0 && oxcf->pass != 1)
+    vp9_speed_tuner_update(cpi, vpx_usec_timer_elapsed(&cmptimer));
+
   if (cpi->b_calculate_psnr && oxcf->pass != 1 && cm->show_frame)
     generate_psnr_packet(cpi);
 
@@ -5082,6 +5126,16 @@ int64_t vp9_get_y_sse(const YV12_BUFFER_CONFIG *a,
                  a->y_crop_width, a->y_crop_height);
 }
 
+int64_t vp9_get_y_sse_rows(const YV12_BUFFER_CONFIG *a,
+                           const YV12_BUFFER_CONFIG *b, int row, int rows) {
+  assert(a->y_crop_width == b->y_crop_width);
+  assert(row >= 0 && row + rows <= a->y_crop_height);
+
+  return get_sse(a->y_buffer + row * a->y_stride, a->y_stride,
+                 b->y_buffer + row * b->y_stride, b->y_stride,
+                 a->y_crop_width, rows);
+}
+
 #if CONFIG_VP9_HIGHBITDEPTH
 int64_t vp9_highbd_get_y_sse(const YV12_BUFFER_CONFIG *a,
                              const YV12_BUFFER_CONFIG *b) {
@@ -5093,6 +5147,21 @@ int64_t vp9_highbd_get_y_sse(const YV12_BUFFER_CONFIG *a,
   return highbd_get_sse(a->y_buffer, a->y_stride, b->y_buffer, b->y_stride,
                         a->y_crop_width, a->y_crop_height);
 }
+
+int64_t vp9_highbd_get_y_sse_rows(const YV12_BUFFER_CONFIG *a,
+                                  const YV12_BUFFER_CONFIG *b,
+                                  int row, int rows) {
+  assert(a->y_crop_width == b->y_crop_width);
+  assert(row >= 0 && row + rows <= a->y_crop_height);
+  assert((a->flags & YV12_FLAG_HIGHBITDEPTH) != 0);
+  assert((b->flags & YV12_FLAG_HIGHBITDEPTH) != 0);
+
+  return highbd_get_sse(
+      CONVERT_TO_BYTEPTR(CONVERT_TO_SHORTPTR(a->y_buffer) + row * a->y_stride),
+      a->y_stride,
+      CONVERT_TO_BYTEPTR(CONVERT_TO_SHORTPTR(b->y_buffer) + row * b->y_stride),
+      b->y_stride, a->y_crop_width, rows);
+}
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
 int vp9_get_quantizer(VP9_COMP *cpi) {
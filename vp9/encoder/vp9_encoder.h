@@ -135,6 +135,9 @@ typedef struct VP9EncoderConfig {
   int noise_sensitivity;  // pre processing blur: recommendation 0
   int sharpness;  // sharpening output: recommendation 0:
   int speed;
+  // Encode time to hold the frames to, in microseconds, by tuning the speed
+  // features on top of speed. 0 disables the tuning.
+  unsigned int target_frame_time;
   // maximum allowed bitrate for any intra frame in % of bitrate target.
   unsigned int rc_max_intra_bitrate_pct;
   // maximum allowed bitrate for any inter frame in % of bitrate target.
@@ -227,6 +230,9 @@ typedef struct VP9EncoderConfig {
   int tile_rows;
 
   int max_threads;
+  // Distribute SB rows of all tiles to the threads instead of assigning
+  // whole SB rows (across all tile columns) to a thread.
+  unsigned int row_mt;
 
   vpx_fixed_buf_t two_pass_stats_in;
   struct vpx_codec_pkt_list *output_pkt_list;
@@ -281,6 +287,9 @@ typedef struct VP9_COMP {
   VP9EncoderConfig oxcf;
   struct lookahead_ctx    *lookahead;
   struct lookahead_entry  *alt_ref_source;
+  // Releases the source frames, when the application hands them over.
+  vpx_release_source_cb   release_source_cb;
+  void                    *release_source_state;
 
   YV12_BUFFER_CONFIG *Source;
   YV12_BUFFER_CONFIG *Last_Source;  // NULL for first frame and alt_ref frames
@@ -349,6 +358,7 @@ typedef struct VP9_COMP {
   int ref_frame_flags;
 
   SPEED_FEATURES sf;
+  SPEED_TUNER speed_tuner;
 
   unsigned int max_mv_magnitude;
   int mv_step_param;
@@ -382,17 +392,22 @@ typedef struct VP9_COMP {
   // encoder thread handles
   VPxWorker *enc_thread_hndl;
   thread_context **enc_thread_ctxt;
+  // thread data of the data parallel pre-pass pipelined with the encoding
+  ThreadData *dp_thread_data;
   VP9LfSync lf_row_sync;
   int max_threads;
-  // Allocate memory to store the encoded superblock index in each row.
-  int *cur_sb_col;
-  // minimum spatial distance (in SB) between encoding threads
-  int sync_range;
-  int entropy_tilecol;
+  VP9EncSync enc_row_sync;
+  VP9RowMTInfo row_mt_info;
+  // Index of the next tile, in raster order, to be packed by the entropy
+  // threads.
+  int entropy_tile;
   pthread_mutex_t entropy_mutex;
   int out_buffer_size;
   uint8_t *out_buffer_tiles[4][1 << 6];
   uint32_t out_bitstream_size[4][1 << 6];
+  // Above partition context of each tile row, so that the tile rows of a tile
+  // column can be packed in parallel.
+  PARTITION_CONTEXT *tile_above_seg_context[4];
 
   fractional_mv_step_fp *find_fractional_mv_step;
   vp9_full_search_fn_t full_search_sad;
@@ -532,10 +547,11 @@ void vp9_remove_compressor(VP9_COMP *cpi);
 void vp9_change_config(VP9_COMP *cpi, const VP9EncoderConfig *oxcf);
 
   // receive a frames worth of data. caller can assume that a copy of this
-  // frame is made and not just a copy of the pointer..
+  // frame is made and not just a copy of the pointer, unless the frame is
+  // handed over with release_source_cb, which is then called with user_priv.
 int vp9_receive_raw_frame(VP9_COMP *cpi, unsigned int frame_flags,
                           YV12_BUFFER_CONFIG *sd, int64_t time_stamp,
-                          int64_t end_time_stamp);
+                          int64_t end_time_stamp, void *user_priv);
 
 int vp9_get_compressed_data(VP9_COMP *cpi, unsigned int *frame_flags,
                             size_t *size, uint8_t *dest,
@@ -621,9 +637,15 @@ static INLINE int allocated_tokens(TileInfo tile) {
 }
 
 int64_t vp9_get_y_sse(const YV12_BUFFER_CONFIG *a, const YV12_BUFFER_CONFIG *b);
+// SSE of the luma rows [row, row + rows) of the frames.
+int64_t vp9_get_y_sse_rows(const YV12_BUFFER_CONFIG *a,
+                           const YV12_BUFFER_CONFIG *b, int row, int rows);
 #if CONFIG_VP9_HIGHBITDEPTH
 int64_t vp9_highbd_get_y_sse(const YV12_BUFFER_CONFIG *a,
                              const YV12_BUFFER_CONFIG *b);
+int64_t vp9_highbd_get_y_sse_rows(const YV12_BUFFER_CONFIG *a,
+                                  const YV12_BUFFER_CONFIG *b,
+                                  int row, int rows);
 #endif  // CONFIG_VP9_HIGHBITDEPTH
 
 void vp9_pre_loopfilter(VP9_COMP *cpi);
@@ -654,6 +676,20 @@ static INLINE int is_one_pass_cbr_svc(const struct VP9_COMP *const cpi) {
   return (cpi->use_svc && cpi->oxcf.pass == 0);
 }
 
+static INLINE int is_row_mt_enabled(const VP9_COMP *const cpi) {
+  return cpi->oxcf.row_mt && !cpi->td.mb.use_gpu;
+}
+
+// The non-RD path loop filters and extends each SB right behind its
+// encoding when the filter level does not depend on the reconstruction.
+// With row based multi-threading, where the tile columns of an SB row are
+// not encoded in order, whole SB rows are filtered once the row below is
+// encoded.
+static INLINE int is_lpf_onfly(const VP9_COMP *const cpi) {
+  return cpi->sf.use_nonrd_pick_mode &&
+         cpi->sf.lpf_pick >= LPF_PICK_FROM_Q;
+}
+
 static INLINE int is_altref_enabled(const VP9_COMP *const cpi) {
   return cpi->oxcf.mode != REALTIME && cpi->oxcf.lag_in_frames > 0 &&
          (cpi->oxcf.enable_auto_arf &&
@@ -8,40 +8,221 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <assert.h>
+#include <limits.h>
+
 #include "./vpx_config.h"
 
 #include "vpx_dsp/vpx_dsp_common.h"
+#include "vpx_mem/vpx_mem.h"
+#include "vpx_ports/vpx_timer.h"
 
 #include "vp9/common/vp9_reconinter.h"
 
 #include "vp9/encoder/vp9_encoder.h"
 #include "vp9/encoder/vp9_encodeframe.h"
 
-// synchronize encoder threads
-void vp9_enc_sync_read(VP9_COMP *cpi, int sb_row, int sb_col) {
+// Bounds of the adaptive spin budget used in vp9_enc_sync_read() before a
+// thread blocks on the row condition variable.
+#define SYNC_SPIN_MIN 16
+#define SYNC_SPIN_INIT 256
+#define SYNC_SPIN_MAX 4096
+
+// Position stored in the sync slot of a row once it is completely done.
+#define SYNC_ROW_DONE INT_MAX
+
+#if CONFIG_MULTITHREAD
+// Returns the sync slot of the SB row at mi_row, and sets the position of the
+// SB at mi_col in that row and the number of SBs of the row. With row based
+// multi-threading every tile column of an SB row is a separate job and has its
+// own slot. Otherwise a thread encodes whole frame rows and the on-the-fly loop
+// filter crosses the tile boundaries, so a slot covers the full frame row.
+static int get_sync_pos(const VP9_COMP *cpi, const TileInfo *tile,
+                        int tile_col, int mi_row, int mi_col,
+                        int *sb_col, int *sb_cols) {
   const VP9_COMMON *const cm = &cpi->common;
-  const volatile int *const top_sb_col = cpi->cur_sb_col + (sb_row - 1);
+  const int sb_row = mi_row >> MI_BLOCK_SIZE_LOG2;
 
-  // Check if the dependencies necessary to encode the current SB are
-  // resolved. If the dependencies are resolved encode else do a busy wait.
-  while (sb_row && !(sb_col & (cpi->sync_range - 1))) {
+  if (is_row_mt_enabled(cpi)) {
+    *sb_col = (mi_col - tile->mi_col_start) >> MI_BLOCK_SIZE_LOG2;
+    *sb_cols = (tile->mi_col_end - tile->mi_col_start +
+                MI_BLOCK_SIZE - 1) >> MI_BLOCK_SIZE_LOG2;
+    return tile_col * cm->sb_rows + sb_row;
+  }
+  *sb_col = mi_col >> MI_BLOCK_SIZE_LOG2;
+  *sb_cols = cm->sb_cols;
+  return sb_row;
+}
+#endif  // CONFIG_MULTITHREAD
+
+#if CONFIG_MULTITHREAD
+// Waits until the row at sync slot 'slot' - 1 has reached the column needed
+// to encode the column 'col' of the row at 'slot'. 'cols' is the number of
+// columns of the rows.
+static void sync_read(VP9EncSync *enc_sync, ThreadData *td, int slot,
+                      int col, int cols) {
+  const int nsync = enc_sync->sync_range;
+
+  // Dependencies are only checked every nsync columns, the row above is
+  // guaranteed to stay at least nsync columns ahead in between.
+  if (!(col & (nsync - 1))) {
+    const int top = slot - 1;
+    const volatile int *const top_sb_col = enc_sync->cur_sb_col + top;
     // top right dependency
-    int idx = sb_col + cpi->sync_range;
+    const int idx = VPXMIN(col + nsync, cols - 1);
+    int spin;
+
+    if (td->sync_spin_limit == 0)
+      td->sync_spin_limit = SYNC_SPIN_INIT;
+
+    // The row above is usually just about to publish the columns we need, so
+    // spin for a while before paying for a sleep/wake-up cycle.
+    for (spin = 0; spin < td->sync_spin_limit; ++spin) {
+      if (*top_sb_col >= idx) {
+        td->sync_spin_limit = VPXMIN(td->sync_spin_limit << 1, SYNC_SPIN_MAX);
+        return;
+      }
+      x86_pause_hint();
+    }
+
+    // Spinning did not pay off: shrink the budget and block until the
+    // thread encoding the row above signals progress.
+    td->sync_spin_limit = VPXMAX(td->sync_spin_limit >> 1, SYNC_SPIN_MIN);
+    {
+      pthread_mutex_t *const mutex = &enc_sync->mutex_[top];
+      struct vpx_usec_timer timer;
+
+      vpx_usec_timer_start(&timer);
+      pthread_mutex_lock(mutex);
+      while (*top_sb_col < idx)
+        pthread_cond_wait(&enc_sync->cond_[top], mutex);
+      pthread_mutex_unlock(mutex);
+      vpx_usec_timer_mark(&timer);
+
+      td->sync_wait_time += vpx_usec_timer_elapsed(&timer);
+      ++td->sync_wait_count;
+    }
+  }
+}
 
-    idx = VPXMIN(idx, (cm->sb_cols - 1));
-    if (*top_sb_col >= idx)
-      break;
-    x86_pause_hint();
-    thread_sleep(0);
+// Publishes that the column 'col' of the row at sync slot 'slot' is done.
+static void sync_write(VP9EncSync *enc_sync, int slot, int col, int cols) {
+  volatile int *const cur_sb_col = enc_sync->cur_sb_col + slot;
+
+  // Readers only ever wait for a multiple of nsync or for the end of the
+  // row, so only those positions need to wake them up. Both the row below and
+  // the thread waiting for the row to be done may be blocked on the slot.
+  if ((col & (enc_sync->sync_range - 1)) && col < cols - 1) {
+    *cur_sb_col = col;
+  } else {
+    pthread_mutex_lock(&enc_sync->mutex_[slot]);
+    *cur_sb_col = col;
+    pthread_cond_broadcast(&enc_sync->cond_[slot]);
+    pthread_mutex_unlock(&enc_sync->mutex_[slot]);
   }
 }
+#endif  // CONFIG_MULTITHREAD
 
 // synchronize encoder threads
-void vp9_enc_sync_write(VP9_COMP *cpi, int sb_row) {
-  int *const cur_sb_col = cpi->cur_sb_col + sb_row;
+void vp9_enc_sync_read(VP9_COMP *cpi, ThreadData *td,
+                       const TileInfo *tile, int tile_col,
+                       int mi_row, int mi_col) {
+#if CONFIG_MULTITHREAD
+  int sb_col, sb_cols;
+  const int slot = get_sync_pos(cpi, tile, tile_col, mi_row, mi_col,
+                                &sb_col, &sb_cols);
+
+  if (mi_row >> MI_BLOCK_SIZE_LOG2)
+    sync_read(&cpi->enc_row_sync, td, slot, sb_col, sb_cols);
+#else
+  (void)cpi;
+  (void)td;
+  (void)tile;
+  (void)tile_col;
+  (void)mi_row;
+  (void)mi_col;
+#endif  // CONFIG_MULTITHREAD
+}
 
-  // update the cur sb col
-  (*cur_sb_col)++;
+// synchronize encoder threads
+void vp9_enc_sync_write(VP9_COMP *cpi, const TileInfo *tile, int tile_col,
+                        int mi_row, int mi_col) {
+#if CONFIG_MULTITHREAD
+  int sb_col, sb_cols;
+  const int slot = get_sync_pos(cpi, tile, tile_col, mi_row, mi_col,
+                                &sb_col, &sb_cols);
+
+  sync_write(&cpi->enc_row_sync, slot, sb_col, sb_cols);
+#else
+  (void)cpi;
+  (void)tile;
+  (void)tile_col;
+  (void)mi_row;
+  (void)mi_col;
+#endif  // CONFIG_MULTITHREAD
+}
+
+int vp9_enc_sync_get_next_job(VP9EncSync *enc_sync, int *row, int *dp) {
+  int ret = 1;
+
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(enc_sync->job_mutex_);
+#endif
+  if (enc_sync->next_dp_row < enc_sync->num_dp_rows &&
+      enc_sync->next_dp_row < enc_sync->next_row + enc_sync->dp_lead) {
+    *row = enc_sync->next_dp_row++;
+    *dp = 1;
+  } else if (enc_sync->next_row < enc_sync->num_rows) {
+    *row = enc_sync->next_row++;
+    *dp = 0;
+  } else {
+    ret = 0;
+  }
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(enc_sync->job_mutex_);
+#endif
+  return ret;
+}
+
+void vp9_enc_sync_row_done(VP9EncSync *enc_sync, int row) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(&enc_sync->mutex_[row]);
+  enc_sync->cur_sb_col[row] = SYNC_ROW_DONE;
+  pthread_cond_broadcast(&enc_sync->cond_[row]);
+  pthread_mutex_unlock(&enc_sync->mutex_[row]);
+#else
+  enc_sync->cur_sb_col[row] = SYNC_ROW_DONE;
+#endif  // CONFIG_MULTITHREAD
+}
+
+void vp9_enc_sync_wait_row_done(VP9EncSync *enc_sync, int row) {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t *const mutex = &enc_sync->mutex_[row];
+
+  pthread_mutex_lock(mutex);
+  while (enc_sync->cur_sb_col[row] != SYNC_ROW_DONE)
+    pthread_cond_wait(&enc_sync->cond_[row], mutex);
+  pthread_mutex_unlock(mutex);
+#else
+  assert(enc_sync->cur_sb_col[row] == SYNC_ROW_DONE);
+  (void)enc_sync;
+  (void)row;
+#endif  // CONFIG_MULTITHREAD
+}
+
+void vp9_enc_sync_get_stats(const VP9_COMP *cpi, uint64_t *wait_time,
+                            unsigned int *wait_count) {
+  int i;
+
+  *wait_time = 0;
+  *wait_count = 0;
+  if (cpi->enc_thread_ctxt == NULL)
+    return;
+  for (i = 0; i < cpi->max_threads; ++i) {
+    const ThreadData *const td = &cpi->enc_thread_ctxt[i]->td;
+    *wait_time += td->sync_wait_time;
+    *wait_count += td->sync_wait_count;
+  }
 }
 
 // Set up nsync by width.
@@ -58,6 +239,309 @@ static int get_sync_range(int width) {
     return 8;
 }
 
+// Allocate memory for encoder row synchronization
+void vp9_enc_sync_alloc(VP9EncSync *enc_sync, VP9_COMMON *cm, int rows,
+                        int width) {
+  enc_sync->rows = rows;
+#if CONFIG_MULTITHREAD
+  {
+    int i;
+
+    CHECK_MEM_ERROR(cm, enc_sync->mutex_,
+                    vpx_malloc(sizeof(*enc_sync->mutex_) * rows));
+    if (enc_sync->mutex_) {
+      for (i = 0; i < rows; ++i) {
+        pthread_mutex_init(&enc_sync->mutex_[i], NULL);
+      }
+    }
+
+    CHECK_MEM_ERROR(cm, enc_sync->cond_,
+                    vpx_malloc(sizeof(*enc_sync->cond_) * rows));
+    if (enc_sync->cond_) {
+      for (i = 0; i < rows; ++i) {
+        pthread_cond_init(&enc_sync->cond_[i], NULL);
+      }
+    }
+
+    CHECK_MEM_ERROR(cm, enc_sync->job_mutex_,
+                    vpx_malloc(sizeof(*enc_sync->job_mutex_)));
+    if (enc_sync->job_mutex_)
+      pthread_mutex_init(enc_sync->job_mutex_, NULL);
+  }
+#endif  // CONFIG_MULTITHREAD
+
+  CHECK_MEM_ERROR(cm, enc_sync->cur_sb_col,
+                  vpx_malloc(sizeof(*enc_sync->cur_sb_col) * rows));
+  vp9_enc_sync_reset(enc_sync);
+
+  // Set up nsync.
+  enc_sync->sync_range = get_sync_range(width);
+}
+
+// Deallocate encoder row synchronization related mutex and data
+void vp9_enc_sync_dealloc(VP9EncSync *enc_sync) {
+  if (enc_sync != NULL) {
+#if CONFIG_MULTITHREAD
+    int i;
+
+    if (enc_sync->mutex_ != NULL) {
+      for (i = 0; i < enc_sync->rows; ++i) {
+        pthread_mutex_destroy(&enc_sync->mutex_[i]);
+      }
+      vpx_free(enc_sync->mutex_);
+    }
+    if (enc_sync->cond_ != NULL) {
+      for (i = 0; i < enc_sync->rows; ++i) {
+        pthread_cond_destroy(&enc_sync->cond_[i]);
+      }
+      vpx_free(enc_sync->cond_);
+    }
+    if (enc_sync->job_mutex_ != NULL) {
+      pthread_mutex_destroy(enc_sync->job_mutex_);
+      vpx_free(enc_sync->job_mutex_);
+    }
+#endif  // CONFIG_MULTITHREAD
+    vpx_free(enc_sync->cur_sb_col);
+    vp9_zero(*enc_sync);
+  }
+}
+
+void vp9_enc_sync_reset(VP9EncSync *enc_sync) {
+  // Initialize cur_sb_col to -1 for all SB rows.
+  memset(enc_sync->cur_sb_col, -1,
+         sizeof(*enc_sync->cur_sb_col) * enc_sync->rows);
+  enc_sync->next_row = 0;
+  enc_sync->next_dp_row = 0;
+}
+
+void vp9_enc_sync_frame_init(VP9_COMP *cpi, int pipeline_dp) {
+  VP9_COMMON *const cm = &cpi->common;
+  VP9EncSync *const enc_sync = &cpi->enc_row_sync;
+  const int dp_slot = cm->sb_rows << cm->log2_tile_cols;
+  const int rows = dp_slot + (pipeline_dp ? cm->sb_rows : 0);
+
+  if (enc_sync->cur_sb_col == NULL || enc_sync->rows < rows) {
+    vp9_enc_sync_dealloc(enc_sync);
+    vp9_enc_sync_alloc(enc_sync, cm, rows, cm->width);
+  } else {
+    vp9_enc_sync_reset(enc_sync);
+  }
+  enc_sync->num_rows = cm->sb_rows;
+  enc_sync->num_dp_rows = pipeline_dp ? cm->sb_rows : 0;
+  enc_sync->dp_slot = dp_slot;
+  enc_sync->dp_lead = cpi->max_threads;
+}
+
+void vp9_enc_sync_jobs_init(VP9_COMP *cpi, int rows) {
+  VP9_COMMON *const cm = &cpi->common;
+  VP9EncSync *const enc_sync = &cpi->enc_row_sync;
+
+  if (enc_sync->cur_sb_col == NULL || enc_sync->rows < rows) {
+    vp9_enc_sync_dealloc(enc_sync);
+    vp9_enc_sync_alloc(enc_sync, cm, rows, cm->width);
+  } else {
+    vp9_enc_sync_reset(enc_sync);
+  }
+  enc_sync->num_rows = rows;
+  enc_sync->num_dp_rows = 0;
+}
+
+void vp9_fp_sync_frame_init(VP9_COMP *cpi) {
+  vp9_enc_sync_jobs_init(cpi, cpi->common.mb_rows);
+}
+
+void vp9_fp_sync_read(VP9_COMP *cpi, ThreadData *td, int mb_row, int mb_col) {
+#if CONFIG_MULTITHREAD
+  if (mb_row)
+    sync_read(&cpi->enc_row_sync, td, mb_row, mb_col, cpi->common.mb_cols);
+#else
+  (void)cpi;
+  (void)td;
+  (void)mb_row;
+  (void)mb_col;
+#endif  // CONFIG_MULTITHREAD
+}
+
+void vp9_fp_sync_write(VP9_COMP *cpi, int mb_row, int mb_col) {
+#if CONFIG_MULTITHREAD
+  sync_write(&cpi->enc_row_sync, mb_row, mb_col, cpi->common.mb_cols);
+#else
+  (void)cpi;
+  (void)mb_row;
+  (void)mb_col;
+#endif  // CONFIG_MULTITHREAD
+}
+
+void vp9_row_mt_frame_init(VP9_COMP *cpi) {
+  VP9_COMMON *const cm = &cpi->common;
+  VP9RowMTInfo *const row_mt_info = &cpi->row_mt_info;
+  const int rows = cm->sb_rows << cm->log2_tile_cols;
+
+  vp9_enc_sync_frame_init(cpi, 0);
+
+#if CONFIG_MULTITHREAD
+  if (row_mt_info->job_mutex_ == NULL) {
+    CHECK_MEM_ERROR(cm, row_mt_info->job_mutex_,
+                    vpx_malloc(sizeof(*row_mt_info->job_mutex_)));
+    pthread_mutex_init(row_mt_info->job_mutex_, NULL);
+  }
+#endif  // CONFIG_MULTITHREAD
+
+  if (row_mt_info->rd_state_rows < rows) {
+    vpx_free(row_mt_info->rd_state);
+    row_mt_info->rd_state = NULL;
+    row_mt_info->rd_state_rows = 0;
+    CHECK_MEM_ERROR(cm, row_mt_info->rd_state,
+                    vpx_malloc(sizeof(*row_mt_info->rd_state) * rows));
+    row_mt_info->rd_state_rows = rows;
+  }
+
+  if (!row_mt_info->base_rd_state_init) {
+    memcpy(row_mt_info->base_rd_state.thresh_freq_fact,
+           cpi->rd.thresh_freq_fact, sizeof(cpi->rd.thresh_freq_fact));
+    memcpy(row_mt_info->base_rd_state.mode_map, cpi->rd.mode_map,
+           sizeof(cpi->rd.mode_map));
+    row_mt_info->base_rd_state_init = 1;
+  }
+  row_mt_info->next_base_rd_state = row_mt_info->base_rd_state;
+
+  if (row_mt_info->sb_rows < cm->sb_rows) {
+    vpx_free(row_mt_info->sb_row_jobs_done);
+    row_mt_info->sb_row_jobs_done = NULL;
+    row_mt_info->sb_rows = 0;
+    CHECK_MEM_ERROR(cm, row_mt_info->sb_row_jobs_done,
+                    vpx_malloc(sizeof(*row_mt_info->sb_row_jobs_done) *
+                               cm->sb_rows));
+    row_mt_info->sb_rows = cm->sb_rows;
+  }
+  memset(row_mt_info->sb_row_jobs_done, 0,
+         sizeof(*row_mt_info->sb_row_jobs_done) * cm->sb_rows);
+  row_mt_info->lf_next_row = 0;
+  row_mt_info->lf_busy = 0;
+
+  row_mt_info->next_job = 0;
+  row_mt_info->num_jobs = rows;
+}
+
+void vp9_row_mt_dealloc(VP9_COMP *cpi) {
+  VP9RowMTInfo *const row_mt_info = &cpi->row_mt_info;
+
+#if CONFIG_MULTITHREAD
+  if (row_mt_info->job_mutex_ != NULL) {
+    pthread_mutex_destroy(row_mt_info->job_mutex_);
+    vpx_free(row_mt_info->job_mutex_);
+  }
+#endif  // CONFIG_MULTITHREAD
+  vpx_free(row_mt_info->rd_state);
+  vpx_free(row_mt_info->sb_row_jobs_done);
+  vp9_zero(*row_mt_info);
+}
+
+int vp9_row_mt_get_next_job(VP9_COMP *cpi, int *mi_row, int *tile_col) {
+  VP9_COMMON *const cm = &cpi->common;
+  VP9RowMTInfo *const row_mt_info = &cpi->row_mt_info;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  int job;
+
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(row_mt_info->job_mutex_);
+#endif
+  job = row_mt_info->next_job;
+  if (job < row_mt_info->num_jobs)
+    ++row_mt_info->next_job;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(row_mt_info->job_mutex_);
+#endif
+
+  if (job >= row_mt_info->num_jobs)
+    return 0;
+
+  // Hand out all tile columns of an SB row before moving to the next row,
+  // so that the row above is always ahead of (or encoded by) an active
+  // thread.
+  *mi_row = (job / tile_cols) << MI_BLOCK_SIZE_LOG2;
+  *tile_col = job % tile_cols;
+  return 1;
+}
+
+// Takes the next SB row to loop filter if it is ready: filtering an SB row
+// changes the bottom pixels of the row above, and the row below uses the
+// unfiltered pixels for intra prediction. The job mutex must be held.
+static int get_next_lf_row(VP9_COMP *cpi, int *lf_mi_row) {
+  const VP9_COMMON *const cm = &cpi->common;
+  VP9RowMTInfo *const row_mt_info = &cpi->row_mt_info;
+  const int tile_cols = 1 << cm->log2_tile_cols;
+  const int sb_row = row_mt_info->lf_next_row;
+
+  if (row_mt_info->lf_busy || sb_row >= cm->sb_rows ||
+      row_mt_info->sb_row_jobs_done[sb_row] < tile_cols ||
+      (sb_row + 1 < cm->sb_rows &&
+       row_mt_info->sb_row_jobs_done[sb_row + 1] < tile_cols))
+    return 0;
+
+  ++row_mt_info->lf_next_row;
+  row_mt_info->lf_busy = 1;
+  *lf_mi_row = sb_row << MI_BLOCK_SIZE_LOG2;
+  return 1;
+}
+
+int vp9_row_mt_job_done(VP9_COMP *cpi, int mi_row, int *lf_mi_row) {
+  VP9RowMTInfo *const row_mt_info = &cpi->row_mt_info;
+  int ready;
+
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(row_mt_info->job_mutex_);
+#endif
+  ++row_mt_info->sb_row_jobs_done[mi_row >> MI_BLOCK_SIZE_LOG2];
+  ready = get_next_lf_row(cpi, lf_mi_row);
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(row_mt_info->job_mutex_);
+#endif
+  return ready;
+}
+
+int vp9_row_mt_lf_row_done(VP9_COMP *cpi, int *lf_mi_row) {
+  VP9RowMTInfo *const row_mt_info = &cpi->row_mt_info;
+  int ready;
+
+#if CONFIG_MULTITHREAD
+  pthread_mutex_lock(row_mt_info->job_mutex_);
+#endif
+  row_mt_info->lf_busy = 0;
+  ready = get_next_lf_row(cpi, lf_mi_row);
+#if CONFIG_MULTITHREAD
+  pthread_mutex_unlock(row_mt_info->job_mutex_);
+#endif
+  return ready;
+}
+
+void vp9_row_mt_load_rd_state(VP9_COMP *cpi, RD_OPT *rd,
+                              int tile_col, int mi_row) {
+  const VP9_COMMON *const cm = &cpi->common;
+  const VP9RowMTInfo *const row_mt_info = &cpi->row_mt_info;
+  const int sb_row = mi_row >> MI_BLOCK_SIZE_LOG2;
+  const RD_ROW_STATE *const state = sb_row ?
+      &row_mt_info->rd_state[tile_col * cm->sb_rows + sb_row - 1] :
+      &row_mt_info->base_rd_state;
+
+  memcpy(rd->thresh_freq_fact, state->thresh_freq_fact,
+         sizeof(state->thresh_freq_fact));
+  memcpy(rd->mode_map, state->mode_map, sizeof(state->mode_map));
+}
+
+void vp9_row_mt_save_rd_state(VP9_COMP *cpi, const RD_OPT *rd,
+                              int tile_col, int mi_row) {
+  const VP9_COMMON *const cm = &cpi->common;
+  VP9RowMTInfo *const row_mt_info = &cpi->row_mt_info;
+  const int sb_row = mi_row >> MI_BLOCK_SIZE_LOG2;
+  RD_ROW_STATE *const state =
+      &row_mt_info->rd_state[tile_col * cm->sb_rows + sb_row];
+
+  memcpy(state->thresh_freq_fact, rd->thresh_freq_fact,
+         sizeof(state->thresh_freq_fact));
+  memcpy(state->mode_map, rd->mode_map, sizeof(state->mode_map));
+}
+
 void vp9_entropy_alloc(VP9_COMP *cpi) {
   VP9_COMMON *const cm = &cpi->common;
 
@@ -103,6 +587,7 @@ void vp9_create_encoding_threads(VP9_COMP *cpi) {
     winterface->init(worker);
     CHECK_MEM_ERROR(cm, cpi->enc_thread_ctxt[i],
                     vpx_memalign(32, sizeof(thread_context)));
+    vp9_zero(*cpi->enc_thread_ctxt[i]);
 
     // Set up pc_tree.
     cpi->enc_thread_ctxt[i]->td.leaf_tree = NULL;
@@ -125,16 +610,46 @@ void vp9_create_encoding_threads(VP9_COMP *cpi) {
     winterface->sync(&cpi->enc_thread_hndl[i]);
     cpi->enc_thread_hndl[i].hook = (VPxWorkerHook) vp9_encoding_thread_process;
   }
-  CHECK_MEM_ERROR(cm, cpi->cur_sb_col,
-                  vpx_malloc(sizeof(*cpi->cur_sb_col) * cm->sb_rows));
-  // init cur sb col
-  memset(cpi->cur_sb_col, -1, (sizeof(*cpi->cur_sb_col) * cm->sb_rows));
-  // set up nsync (currently unused).
-  cpi->sync_range = get_sync_range(cpi->oxcf.width);
-
   vp9_entropy_alloc(cpi);
 }
 
+void vp9_dp_thread_data_alloc(VP9_COMP *cpi) {
+  VP9_COMMON *const cm = &cpi->common;
+  int i;
+
+  if (cpi->dp_thread_data != NULL)
+    return;
+
+  CHECK_MEM_ERROR(cm, cpi->dp_thread_data,
+                  vpx_memalign(32, sizeof(*cpi->dp_thread_data) *
+                               cpi->max_threads));
+  memset(cpi->dp_thread_data, 0,
+         sizeof(*cpi->dp_thread_data) * cpi->max_threads);
+  for (i = 0; i < cpi->max_threads; ++i) {
+    ThreadData *const td = &cpi->dp_thread_data[i];
+
+    vp9_setup_pc_tree(cm, td);
+    CHECK_MEM_ERROR(cm, td->counts, vpx_calloc(1, sizeof(*td->counts)));
+  }
+}
+
+void vp9_dp_thread_data_dealloc(VP9_COMP *cpi) {
+  int i;
+
+  if (cpi->dp_thread_data == NULL)
+    return;
+
+  for (i = 0; i < cpi->max_threads; ++i) {
+    ThreadData *const td = &cpi->dp_thread_data[i];
+
+    vpx_free(td->counts);
+    td->counts = NULL;
+    vp9_free_pc_tree(td);
+  }
+  vpx_free(cpi->dp_thread_data);
+  cpi->dp_thread_data = NULL;
+}
+
 void vp9_accumulate_rd_opt(ThreadData *td, ThreadData *td_t) {
   int i, j, k, l, m, n;
 
@@ -11,6 +11,9 @@
 #ifndef VP9_ENCODER_VP9_ETHREAD_H_
 #define VP9_ENCODER_VP9_ETHREAD_H_
 
+#include "./vpx_config.h"
+#include "vpx_util/vpx_thread.h"
+
 /* Thread management macros */
 #ifdef _WIN32
   /* Win32 */
@@ -34,6 +37,70 @@
 #endif
 
 struct VP9_COMP;
+struct VP9Common;
+struct TileInfo;
+
+// Encoder superblock row synchronization. The progress is tracked for each
+// SB row of each tile column, at index tile_col * sb_rows + sb_row.
+typedef struct VP9EncSyncData {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t *mutex_;
+  pthread_cond_t *cond_;
+  pthread_mutex_t *job_mutex_;
+#endif
+  // Allocate memory to store the last encoded superblock index (relative to
+  // the start of the tile) in each tile row.
+  int *cur_sb_col;
+  // Next SB row to be handed out by vp9_enc_sync_get_next_job() and number of
+  // SB rows of the frame.
+  int next_row;
+  int num_rows;
+  // SB rows of the data parallel pre-pass when it is pipelined with the
+  // encoding, 0 otherwise. A pre-pass row is handed out at most dp_lead rows
+  // ahead of the encoding, and marks its sync slot dp_slot + row as done.
+  int next_dp_row;
+  int num_dp_rows;
+  int dp_lead;
+  int dp_slot;
+  // minimum spatial distance (in SB) between encoding threads. The row
+  // progress is published to waiting threads in batches of this many SBs.
+  int sync_range;
+  int rows;
+} VP9EncSync;
+
+// Adaptive mode search state carried from one SB row to the next.
+typedef struct RD_ROW_STATE {
+  int thresh_freq_fact[BLOCK_SIZES][MAX_MODES];
+  int mode_map[BLOCK_SIZES][MAX_MODES];
+} RD_ROW_STATE;
+
+// Row based multi-threading. The SB rows of all tile columns form a single
+// list of jobs that the encoding threads take from in raster order.
+typedef struct VP9RowMTInfo {
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t *job_mutex_;
+#endif
+  int next_job;
+  int num_jobs;
+
+  // The mode search state an SB row starts from only depends on its position
+  // in the frame, never on the thread that encodes it: each tile row takes
+  // the state of the tile row above after its first SB, the first SB row of
+  // the frame takes base_rd_state. The state at the end of the last SB row
+  // of the first tile column is the base for the next frame.
+  RD_ROW_STATE *rd_state;
+  int rd_state_rows;
+  RD_ROW_STATE base_rd_state;
+  RD_ROW_STATE next_base_rd_state;
+  int base_rd_state_init;
+
+  // On-the-fly loop filter: an SB row is filtered by one thread at a time, in
+  // order, once the row and the row below are encoded in all tile columns.
+  int *sb_row_jobs_done;
+  int sb_rows;
+  int lf_next_row;
+  int lf_busy;
+} VP9RowMTInfo;
 
 typedef struct RD_COUNTS {
   vp9_coeff_count coef_counts[TX_SIZES][PLANE_TYPES];
@@ -51,6 +118,13 @@ typedef struct ThreadData {
   PICK_MODE_CONTEXT *leaf_tree;
   PC_TREE *pc_tree;
   PC_TREE *pc_root;
+
+  // Row synchronization statistics: time (in us) and number of times this
+  // thread blocked waiting for the SB row above, and the current adaptive
+  // spin budget used before blocking.
+  uint64_t sync_wait_time;
+  unsigned int sync_wait_count;
+  int sync_spin_limit;
 } ThreadData;
 
 typedef struct thread_context {
@@ -81,9 +155,84 @@ typedef struct thread_context_gpu {
   int async;
 } thread_context_gpu;
 
-void vp9_enc_sync_read(struct VP9_COMP *cpi, int sb_row, int sb_col);
+// Allocate memory for encoder row synchronization.
+void vp9_enc_sync_alloc(VP9EncSync *enc_sync, struct VP9Common *cm, int rows,
+                        int width);
+
+// Deallocate encoder row synchronization related mutex and data.
+void vp9_enc_sync_dealloc(VP9EncSync *enc_sync);
+
+// Mark all SB rows as not started. Called before each frame.
+void vp9_enc_sync_reset(VP9EncSync *enc_sync);
+
+// Make sure there is a sync slot for every SB row of every tile column of
+// the current frame, and one for every pre-pass SB row if pipeline_dp is set,
+// and mark them all as not started.
+void vp9_enc_sync_frame_init(struct VP9_COMP *cpi, int pipeline_dp);
+
+void vp9_enc_sync_read(struct VP9_COMP *cpi, ThreadData *td,
+                       const struct TileInfo *tile, int tile_col,
+                       int mi_row, int mi_col);
+
+void vp9_enc_sync_write(struct VP9_COMP *cpi, const struct TileInfo *tile,
+                        int tile_col, int mi_row, int mi_col);
+
+// Take the next job of the frame: an SB row to encode in raster order, or
+// (dp set) the pre-pass of an SB row, taken before the encoding of that row.
+// Returns 0 once all the jobs have been handed out. A thread only waits for
+// jobs taken before its own, so the jobs make progress however few of the
+// threads actually run.
+int vp9_enc_sync_get_next_job(VP9EncSync *enc_sync, int *row, int *dp);
+
+// Mark the row at sync slot 'row' as completely done.
+void vp9_enc_sync_row_done(VP9EncSync *enc_sync, int row);
+
+// Wait until the row at sync slot 'row' is marked as done.
+void vp9_enc_sync_wait_row_done(VP9EncSync *enc_sync, int row);
+
+// Sum the row synchronization statistics of all encoding threads.
+void vp9_enc_sync_get_stats(const struct VP9_COMP *cpi, uint64_t *wait_time,
+                            unsigned int *wait_count);
 
-void vp9_enc_sync_write(struct VP9_COMP *cpi, int sb_row);
+// Hand out the rows 0 to rows - 1 through vp9_enc_sync_get_next_job(), with
+// a sync slot for each of them, marked as not started.
+void vp9_enc_sync_jobs_init(struct VP9_COMP *cpi, int rows);
+
+// The first pass encodes macroblock rows, synchronized on the macroblock
+// above right. Hand out every macroblock row of the frame as a job.
+void vp9_fp_sync_frame_init(struct VP9_COMP *cpi);
+
+void vp9_fp_sync_read(struct VP9_COMP *cpi, ThreadData *td,
+                      int mb_row, int mb_col);
+
+void vp9_fp_sync_write(struct VP9_COMP *cpi, int mb_row, int mb_col);
+
+// Set up the job list and the per row state for row based multi-threading.
+void vp9_row_mt_frame_init(struct VP9_COMP *cpi);
+
+void vp9_row_mt_dealloc(struct VP9_COMP *cpi);
+
+// Take the next (SB row, tile column) job. Returns 0 when all the jobs of
+// the frame have been handed out.
+int vp9_row_mt_get_next_job(struct VP9_COMP *cpi, int *mi_row, int *tile_col);
+
+// Mark the job at mi_row as encoded. Returns 1 if an SB row is ready to be
+// loop filtered and sets lf_mi_row to it; the caller then owns the loop filter
+// until vp9_row_mt_lf_row_done() returns 0.
+int vp9_row_mt_job_done(struct VP9_COMP *cpi, int mi_row, int *lf_mi_row);
+
+// Mark the SB row taken for loop filtering as done. Returns 1 and sets
+// lf_mi_row if the next SB row is ready to be filtered.
+int vp9_row_mt_lf_row_done(struct VP9_COMP *cpi, int *lf_mi_row);
+
+// Load the mode search state an SB row of a tile column starts from.
+void vp9_row_mt_load_rd_state(struct VP9_COMP *cpi, RD_OPT *rd,
+                              int tile_col, int mi_row);
+
+// Publish the state of an SB row to the row below, once its first SB is
+// encoded.
+void vp9_row_mt_save_rd_state(struct VP9_COMP *cpi, const RD_OPT *rd,
+                              int tile_col, int mi_row);
 
 void vp9_entropy_alloc(struct VP9_COMP *cpi);
 
@@ -91,6 +240,12 @@ void vp9_entropy_dealloc(struct VP9_COMP *cpi);
 
 void vp9_create_encoding_threads(struct VP9_COMP *cpi);
 
+// Allocate the thread data the pipelined data parallel pre-pass runs with,
+// one per encoding thread, on first use.
+void vp9_dp_thread_data_alloc(struct VP9_COMP *cpi);
+
+void vp9_dp_thread_data_dealloc(struct VP9_COMP *cpi);
+
 void vp9_accumulate_rd_opt(ThreadData *td, ThreadData *td_t);
 
 void vp9_mb_copy(struct VP9_COMP *cpi, struct macroblock *x_dst,
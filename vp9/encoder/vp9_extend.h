@@ -26,6 +26,9 @@ extern "C" {
 void vp9_copy_and_extend_frame(const YV12_BUFFER_CONFIG *src,
                                YV12_BUFFER_CONFIG *dst);
 
+// Extends the borders of frame in place, as vp9_copy_and_extend_frame() does.
+void vp9_extend_frame(YV12_BUFFER_CONFIG *frame);
+
 void vp9_copy_and_extend_frame_with_rect(const YV12_BUFFER_CONFIG *src,
                                          YV12_BUFFER_CONFIG *dst,
                                          int srcy, int srcx,
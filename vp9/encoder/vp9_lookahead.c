@@ -9,9 +9,13 @@
  */
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "./vpx_config.h"
 
+#include "vpx_mem/vpx_mem.h"
+#include "vpx_ports/mem.h"
+
 #include "vp9/common/vp9_common.h"
 
 #include "vp9/encoder/vp9_encoder.h"
@@ -31,6 +35,202 @@ static struct lookahead_entry *pop(struct lookahead_ctx *ctx,
   return buf;
 }
 
+static void free_pyramid(struct lookahead_entry *buf) {
+  int i;
+  for (i = 0; i < LOOKAHEAD_PYRAMID_LEVELS; i++) {
+    vpx_free(buf->pyramid[i].buffer_alloc);
+    memset(&buf->pyramid[i], 0, sizeof(buf->pyramid[i]));
+  }
+  buf->has_pyramid = 0;
+}
+
+static int alloc_pyramid_plane(struct lookahead_plane *plane,
+                               int width, int height, int use_highbitdepth) {
+  const int border = LOOKAHEAD_PYRAMID_BORDER;
+  const int stride = (width + 2 * border + 31) & ~31;
+  const int bytes_per_pixel = use_highbitdepth ? 2 : 1;
+  uint8_t *buf;
+
+  vpx_free(plane->buffer_alloc);
+  plane->buffer_alloc = (uint8_t *)vpx_memalign(32,
+      (size_t)stride * (height + 2 * border) * bytes_per_pixel);
+  if (!plane->buffer_alloc)
+    return 1;
+  buf = plane->buffer_alloc + (border * stride + border) * bytes_per_pixel;
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (use_highbitdepth)
+    buf = CONVERT_TO_BYTEPTR(buf);
+#endif
+  plane->buf = buf;
+  plane->stride = stride;
+  plane->width = width;
+  plane->height = height;
+  return 0;
+}
+
+// Downscales src by 2 with a 2x2 box filter. The right column and bottom row
+// of odd sized sources are read from the extended border.
+static void downscale_plane(const uint8_t *src, int src_stride,
+                            struct lookahead_plane *dst,
+                            int use_highbitdepth) {
+  int r, c;
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (use_highbitdepth) {
+    const uint16_t *src16 = CONVERT_TO_SHORTPTR(src);
+    uint16_t *dst16 = CONVERT_TO_SHORTPTR(dst->buf);
+    for (r = 0; r < dst->height; r++) {
+      for (c = 0; c < dst->width; c++) {
+        const uint16_t *s = src16 + 2 * c;
+        dst16[c] = (s[0] + s[1] + s[src_stride] + s[src_stride + 1] + 2) >> 2;
+      }
+      src16 += 2 * src_stride;
+      dst16 += dst->stride;
+    }
+    return;
+  }
+#else
+  (void)use_highbitdepth;
+#endif
+  {
+    uint8_t *d = dst->buf;
+    for (r = 0; r < dst->height; r++) {
+      for (c = 0; c < dst->width; c++) {
+        const uint8_t *s = src + 2 * c;
+        d[c] = (s[0] + s[1] + s[src_stride] + s[src_stride + 1] + 2) >> 2;
+      }
+      src += 2 * src_stride;
+      d += dst->stride;
+    }
+  }
+}
+
+static void extend_pyramid_plane(struct lookahead_plane *plane,
+                                 int use_highbitdepth) {
+  const int border = LOOKAHEAD_PYRAMID_BORDER;
+  const int bytes_per_pixel = use_highbitdepth ? 2 : 1;
+  const int row_bytes = (plane->width + 2 * border) * bytes_per_pixel;
+  const int stride_bytes = plane->stride * bytes_per_pixel;
+  uint8_t *const top = plane->buffer_alloc + border * stride_bytes;
+  uint8_t *const bottom = top + (plane->height - 1) * stride_bytes;
+  int r;
+
+  // Left and right borders.
+  for (r = 0; r < plane->height; r++) {
+#if CONFIG_VP9_HIGHBITDEPTH
+    if (use_highbitdepth) {
+      uint16_t *const row = (uint16_t *)(top + r * stride_bytes);
+      int c;
+      for (c = 0; c < border; c++) {
+        row[c] = row[border];
+        row[border + plane->width + c] = row[border + plane->width - 1];
+      }
+    } else {
+#endif
+      uint8_t *const row = top + r * stride_bytes;
+      memset(row, row[border], border);
+      memset(row + border + plane->width, row[border + plane->width - 1],
+             border);
+#if CONFIG_VP9_HIGHBITDEPTH
+    }
+#endif
+  }
+
+  // Top and bottom borders.
+  for (r = 0; r < border; r++) {
+    memcpy(plane->buffer_alloc + r * stride_bytes, top, row_bytes);
+    memcpy(bottom + (r + 1) * stride_bytes, bottom, row_bytes);
+  }
+}
+
+// Builds the 1/2 and 1/4 resolution luma planes of buf->img, each from the
+// level above it.
+static int build_pyramid(struct lookahead_entry *buf) {
+  const int use_highbitdepth = (buf->img.flags & YV12_FLAG_HIGHBITDEPTH) != 0;
+  const uint8_t *src = buf->img.y_buffer;
+  int src_stride = buf->img.y_stride;
+  int width = buf->img.y_crop_width;
+  int height = buf->img.y_crop_height;
+  int i;
+
+  buf->has_pyramid = 0;
+  for (i = 0; i < LOOKAHEAD_PYRAMID_LEVELS; i++) {
+    struct lookahead_plane *const plane = &buf->pyramid[i];
+    width = (width + 1) >> 1;
+    height = (height + 1) >> 1;
+    if (plane->buffer_alloc == NULL || plane->width != width ||
+        plane->height != height) {
+      if (alloc_pyramid_plane(plane, width, height, use_highbitdepth))
+        return 1;
+    }
+    downscale_plane(src, src_stride, plane, use_highbitdepth);
+    extend_pyramid_plane(plane, use_highbitdepth);
+    src = plane->buf;
+    src_stride = plane->stride;
+  }
+  buf->has_pyramid = 1;
+  return 0;
+}
+
+// Returns whether src can be referenced in place: its planes must be aligned
+// as those of the lookahead buffers are, and its strides and format must
+// match theirs, as the encoder uses the same offsets in all the sources.
+static int can_reference_frame(const struct lookahead_entry *buf,
+                               const YV12_BUFFER_CONFIG *src,
+                               int use_highbitdepth) {
+  uintptr_t y = (uintptr_t)src->y_buffer;
+  uintptr_t u = (uintptr_t)src->u_buffer;
+  uintptr_t v = (uintptr_t)src->v_buffer;
+
+  if (use_highbitdepth != ((buf->img.flags & YV12_FLAG_HIGHBITDEPTH) != 0) ||
+      src->y_stride != buf->img.y_stride ||
+      src->uv_stride != buf->img.uv_stride)
+    return 0;
+  if (use_highbitdepth) {
+    // Same as CONVERT_TO_SHORTPTR.
+    y <<= 1;
+    u <<= 1;
+    v <<= 1;
+  }
+  return (y & 31) == 0 && ((u | v) & 15) == 0;
+}
+
+// Points buf->img at the planes of src, keeping the buffer of the entry.
+static void reference_frame(struct lookahead_entry *buf,
+                            YV12_BUFFER_CONFIG *src, void *ext_priv) {
+  YV12_BUFFER_CONFIG *const img = &buf->img;
+
+  // Extend the same area as vp9_copy_and_extend_frame() does.
+  vp9_extend_frame(src);
+
+  buf->own_img = *img;
+  img->y_buffer = src->y_buffer;
+  img->u_buffer = src->u_buffer;
+  img->v_buffer = src->v_buffer;
+  img->y_crop_width = src->y_crop_width;
+  img->y_crop_height = src->y_crop_height;
+  img->uv_crop_width = src->uv_crop_width;
+  img->uv_crop_height = src->uv_crop_height;
+  img->y_width = (src->y_crop_width + 7) & ~7;
+  img->y_height = (src->y_crop_height + 7) & ~7;
+  img->uv_width = img->y_width >> src->subsampling_x;
+  img->uv_height = img->y_height >> src->subsampling_y;
+  img->subsampling_x = src->subsampling_x;
+  img->subsampling_y = src->subsampling_y;
+  buf->has_ext_frame = 1;
+  buf->ext_priv = ext_priv;
+}
+
+// Hands the application frame referenced by buf, if any, back to the
+// application.
+static void release_frame(struct lookahead_ctx *ctx,
+                          struct lookahead_entry *buf) {
+  if (buf->has_ext_frame) {
+    buf->img = buf->own_img;
+    buf->has_ext_frame = 0;
+    ctx->release_cb(ctx->release_state, buf->ext_priv);
+    buf->ext_priv = NULL;
+  }
+}
 
 void vp9_lookahead_destroy(struct VP9Common *cm, struct lookahead_ctx *ctx) {
   (void) cm;
@@ -38,13 +238,16 @@ void vp9_lookahead_destroy(struct VP9Common *cm, struct lookahead_ctx *ctx) {
     if (ctx->buf) {
       unsigned int i;
 
-      for (i = 0; i < ctx->max_sz; i++)
+      for (i = 0; i < ctx->max_sz; i++) {
+        release_frame(ctx, &ctx->buf[i]);
 #if CONFIG_GPU_COMPUTE
         if (cm->use_gpu)
           vp9_gpu_free_frame_buffer(cm, &ctx->buf[i].img);
         else
 #endif
         vpx_free_frame_buffer(&ctx->buf[i].img);
+        free_pyramid(&ctx->buf[i]);
+      }
       free(ctx->buf);
     }
     free(ctx);
@@ -77,6 +280,8 @@ struct lookahead_ctx *vp9_lookahead_init(VP9_COMMON *cm,
     void *cb_priv = NULL;
 
     ctx->max_sz = depth;
+    ctx->last_idx = -1;
+    ctx->release_idx = -1;
     ctx->buf = calloc(depth, sizeof(*ctx->buf));
     if (!ctx->buf)
       goto bail;
@@ -123,7 +328,7 @@ int vp9_lookahead_push(struct lookahead_ctx *ctx, YV12_BUFFER_CONFIG *src,
 #if CONFIG_VP9_HIGHBITDEPTH
                        int use_highbitdepth,
 #endif
-                       unsigned int flags) {
+                       unsigned int flags, void *ext_priv) {
   struct lookahead_entry *buf;
 #if USE_PARTIAL_COPY
   int row, col, active_end;
@@ -138,10 +343,28 @@ int vp9_lookahead_push(struct lookahead_ctx *ctx, YV12_BUFFER_CONFIG *src,
   int subsampling_y = src->subsampling_y;
   int larger_dimensions, new_dimensions;
 
-  if (ctx->sz + 1  + MAX_PRE_FRAMES > ctx->max_sz)
+#if !CONFIG_VP9_HIGHBITDEPTH
+  const int use_highbitdepth = 0;
+#endif
+
+  if (ctx->sz + 1  + MAX_PRE_FRAMES > ctx->max_sz) {
+    if (ctx->release_cb)
+      ctx->release_cb(ctx->release_state, ext_priv);
     return 1;
+  }
   ctx->sz++;
   buf = pop(ctx, &ctx->write_idx);
+  // The frame in a reused entry is done with. It may be the one the next pop
+  // would release, which must not release the new frame instead.
+  release_frame(ctx, buf);
+  if (ctx->release_idx == (int)(buf - ctx->buf))
+    ctx->release_idx = -1;
+
+  if (ctx->release_cb && ctx->ref_ext_frames &&
+      can_reference_frame(buf, src, use_highbitdepth)) {
+    reference_frame(buf, src, ext_priv);
+    goto done;
+  }
 
   new_dimensions = width != buf->img.y_crop_width ||
                    height != buf->img.y_crop_height ||
@@ -207,8 +430,11 @@ int vp9_lookahead_push(struct lookahead_ctx *ctx, YV12_BUFFER_CONFIG *src,
                                  use_highbitdepth,
 #endif
                                  VP9_ENC_BORDER_IN_PIXELS,
-                                 VP9_ENC_ALIGNMENT))
-          return 1;
+                                 VP9_ENC_ALIGNMENT)) {
+        if (ctx->release_cb)
+          ctx->release_cb(ctx->release_state, ext_priv);
+        return 1;
+      }
       vpx_free_frame_buffer(&buf->img);
       buf->img = new_img;
     } else if (new_dimensions) {
@@ -224,11 +450,21 @@ int vp9_lookahead_push(struct lookahead_ctx *ctx, YV12_BUFFER_CONFIG *src,
 #if USE_PARTIAL_COPY
   }
 #endif
+  if (ctx->release_cb)
+    ctx->release_cb(ctx->release_state, ext_priv);
 
+ done:
   buf->ts_start = ts_start;
   buf->ts_end = ts_end;
   buf->flags = flags;
 
+  if (ctx->use_pyramid) {
+    if (build_pyramid(buf))
+      return 1;
+  } else {
+    buf->has_pyramid = 0;
+  }
+
   return 0;
 }
 
@@ -240,6 +476,13 @@ struct lookahead_entry *vp9_lookahead_pop(struct lookahead_ctx *ctx,
   if (ctx && ctx->sz && (drain || ctx->sz == ctx->max_sz - MAX_PRE_FRAMES)) {
     buf = pop(ctx, &ctx->read_idx);
     ctx->sz--;
+    // The encoder reads the popped frame and the one popped before it, the
+    // last source, so the frame popped before those is done with, unless a
+    // push has reused its entry already.
+    if (ctx->release_idx >= 0)
+      release_frame(ctx, &ctx->buf[ctx->release_idx]);
+    ctx->release_idx = ctx->last_idx;
+    ctx->last_idx = (int)(buf - ctx->buf);
   }
   return buf;
 }
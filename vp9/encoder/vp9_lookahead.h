@@ -14,10 +14,8 @@
 #include "vpx_scale/yv12config.h"
 #include "vpx/vpx_integer.h"
 
-#if CONFIG_SPATIAL_SVC
 #include "vpx/vp8cx.h"
 #include "vpx/vpx_encoder.h"
-#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -25,11 +23,37 @@ extern "C" {
 
 #define MAX_LAG_BUFFERS 25
 
+// Number of downscaled levels of the lookahead pyramid: 1/2 and 1/4.
+#define LOOKAHEAD_PYRAMID_LEVELS 2
+
+// Border of the pyramid planes, in pixels.
+#define LOOKAHEAD_PYRAMID_BORDER 32
+
+// Downscaled luma plane of a lookahead frame. For high bitdepth frames buf
+// holds a CONVERT_TO_BYTEPTR'd pointer, as the frame buffers do.
+struct lookahead_plane {
+  uint8_t *buffer_alloc;
+  uint8_t *buf;
+  int      stride;
+  int      width;
+  int      height;
+};
+
 struct lookahead_entry {
   YV12_BUFFER_CONFIG  img;
   int64_t             ts_start;
   int64_t             ts_end;
   unsigned int        flags;
+  // Luma of img downscaled by 2 and 4, built on push when the context has
+  // use_pyramid set. Only valid when has_pyramid is set.
+  struct lookahead_plane pyramid[LOOKAHEAD_PYRAMID_LEVELS];
+  int                 has_pyramid;
+  // Set when img references the planes of an application frame, identified
+  // by ext_priv, rather than the buffer of the entry, which is kept in
+  // own_img until the frame is released.
+  int                 has_ext_frame;
+  void               *ext_priv;
+  YV12_BUFFER_CONFIG  own_img;
 };
 
 // The max of past frames we want to keep in the queue.
@@ -41,6 +65,13 @@ struct lookahead_ctx {
   unsigned int read_idx;       /* Read index */
   unsigned int write_idx;      /* Write index */
   struct lookahead_entry *buf; /* Buffer list */
+  int use_pyramid;             /* Build the pyramid of the pushed frames */
+  /* Releases the pushed frames when set, as they belong to the application */
+  vpx_release_source_cb release_cb;
+  void *release_state;
+  int ref_ext_frames;          /* Reference them in place when possible */
+  int last_idx;                /* Entry popped last, or -1 */
+  int release_idx;             /* Entry released by the next pop, or -1 */
 };
 
 /**\brief Initializes the lookahead stage
@@ -69,22 +100,31 @@ void vp9_lookahead_destroy(struct VP9Common *cm, struct lookahead_ctx *ctx);
  * This function will copy the source image into a new framebuffer with
  * the expected stride/border.
  *
+ * If release_cb is set on the context, the source belongs to the
+ * application and is released with ext_priv once it is no longer read. If
+ * ref_ext_frames is set too and its planes are suitably aligned, the source
+ * is referenced in place and its borders are extended instead.
+ *
  * If active_map is non-NULL and there is only one frame in the queue, then copy
  * only active macroblocks.
  *
+ * If use_pyramid is set on the context, the 1/2 and 1/4 resolution luma
+ * planes of the frame are built as well.
+ *
  * \param[in] ctx         Pointer to the lookahead context
  * \param[in] src         Pointer to the image to enqueue
  * \param[in] ts_start    Timestamp for the start of this frame
  * \param[in] ts_end      Timestamp for the end of this frame
  * \param[in] flags       Flags set on this frame
  * \param[in] active_map  Map that specifies which macroblock is active
+ * \param[in] ext_priv    Application handle of the source
  */
 int vp9_lookahead_push(struct lookahead_ctx *ctx, YV12_BUFFER_CONFIG *src,
                        int64_t ts_start, int64_t ts_end,
 #if CONFIG_VP9_HIGHBITDEPTH
                        int use_highbitdepth,
 #endif
-                       unsigned int flags);
+                       unsigned int flags, void *ext_priv);
 
 
 /**\brief Get the next source buffer to encode
@@ -23,6 +23,7 @@
 #include "vp9/common/vp9_reconinter.h"
 
 #include "vp9/encoder/vp9_encoder.h"
+#include "vp9/encoder/vp9_lookahead.h"
 #include "vp9/encoder/vp9_mcomp.h"
 
 // #define NEW_DIAMOND_SEARCH
@@ -945,6 +946,37 @@ static INLINE int is_mv_in(const MACROBLOCK *x, const MV *mv) {
          (mv->row >= x->mv_row_min) && (mv->row <= x->mv_row_max);
 }
 
+#define MAX_PATTERN_SCALES         11
+#define MAX_PATTERN_CANDIDATES      8  // max number of canddiates per scale
+#define PATTERN_CANDIDATES_REF      3  // number of refinement candidates
+
+// Computes the sads of the source block against the reference at {br, bc}
+// offset by candidates[i], or candidates[indices[i]] when indices is not NULL,
+// for i in [0, num). The candidates go through the 4 way sad function in
+// groups of 4, which loads the source rows once for the 4 of them. All the
+// candidates must be within the mv limits.
+static INLINE void calc_candidate_sads(const MACROBLOCK *x,
+                                       const vp9_variance_fn_ptr_t *vfp,
+                                       int br, int bc, const MV *candidates,
+                                       const int *indices, int num,
+                                       unsigned int *sads) {
+  const struct buf_2d *const what = &x->plane[0].src;
+  const struct buf_2d *const in_what = &x->e_mbd.plane[0].pre[0];
+  const uint8_t *addrs[MAX_PATTERN_CANDIDATES];
+  int i;
+
+  assert(num <= MAX_PATTERN_CANDIDATES);
+  for (i = 0; i < num; i++) {
+    const MV *const c = &candidates[indices != NULL ? indices[i] : i];
+    const MV this_mv = {br + c->row, bc + c->col};
+    addrs[i] = get_buf_from_mv(in_what, &this_mv);
+  }
+  for (i = 0; i + 4 <= num; i += 4)
+    vfp->sdx4df(what->buf, what->stride, &addrs[i], in_what->stride, &sads[i]);
+  for (; i < num; i++)
+    sads[i] = vfp->sdf(what->buf, what->stride, addrs[i], in_what->stride);
+}
+
 #define CHECK_BETTER \
   {\
     if (thissad < bestsad) {\
@@ -957,10 +989,6 @@ static INLINE int is_mv_in(const MACROBLOCK *x, const MV *mv) {
     }\
   }
 
-#define MAX_PATTERN_SCALES         11
-#define MAX_PATTERN_CANDIDATES      8  // max number of canddiates per scale
-#define PATTERN_CANDIDATES_REF      3  // number of refinement candidates
-
 // Calculate and return a sad+mvcost list around an integer best pel.
 static INLINE void calc_int_cost_list(const MACROBLOCK *x,
                                       const MV *ref_mv,
@@ -1040,6 +1068,7 @@ static int vp9_pattern_search(const MACROBLOCK *x,
   int br, bc;
   int bestsad = INT_MAX;
   int thissad;
+  unsigned int sads[MAX_PATTERN_CANDIDATES];
   int k = -1;
   const MV fcenter_mv = {center_mv->row >> 3, center_mv->col >> 3};
   int best_init_s = search_param_to_steps[search_param];
@@ -1062,12 +1091,12 @@ static int vp9_pattern_search(const MACROBLOCK *x,
     for (t = 0; t <= s; ++t) {
       int best_site = -1;
       if (check_bounds(x, br, bc, 1 << t)) {
+        calc_candidate_sads(x, vfp, br, bc, candidates[t], NULL,
+                            num_candidates[t], sads);
         for (i = 0; i < num_candidates[t]; i++) {
           const MV this_mv = {br + candidates[t][i].row,
                               bc + candidates[t][i].col};
-          thissad = vfp->sdf(what->buf, what->stride,
-                             get_buf_from_mv(in_what, &this_mv),
-                             in_what->stride);
+          thissad = sads[i];
           CHECK_BETTER
         }
       } else {
@@ -1105,12 +1134,12 @@ static int vp9_pattern_search(const MACROBLOCK *x,
       // No need to search all 6 points the 1st time if initial search was used
       if (!do_init_search || s != best_init_s) {
         if (check_bounds(x, br, bc, 1 << s)) {
+          calc_candidate_sads(x, vfp, br, bc, candidates[s], NULL,
+                              num_candidates[s], sads);
           for (i = 0; i < num_candidates[s]; i++) {
             const MV this_mv = {br + candidates[s][i].row,
                                 bc + candidates[s][i].col};
-            thissad = vfp->sdf(what->buf, what->stride,
-                               get_buf_from_mv(in_what, &this_mv),
-                               in_what->stride);
+            thissad = sads[i];
             CHECK_BETTER
           }
         } else {
@@ -1149,12 +1178,12 @@ static int vp9_pattern_search(const MACROBLOCK *x,
             (k + 2) >= num_candidates[s] ? k + 2 - num_candidates[s] : k + 2;
 
         if (check_bounds(x, br, bc, 1 << s)) {
+          calc_candidate_sads(x, vfp, br, bc, candidates[s],
+                              next_chkpts_indices, num_cand, sads);
           for (i = 0; i < num_cand; i++) {
             const MV this_mv = {br + candidates[s][next_chkpts_indices[i]].row,
                                 bc + candidates[s][next_chkpts_indices[i]].col};
-            thissad = vfp->sdf(what->buf, what->stride,
-                               get_buf_from_mv(in_what, &this_mv),
-                               in_what->stride);
+            thissad = sads[i];
             CHECK_BETTER
           }
         } else {
@@ -1221,6 +1250,7 @@ static int vp9_pattern_search_sad(const MACROBLOCK *x,
   int br, bc;
   int bestsad = INT_MAX;
   int thissad;
+  unsigned int sads[MAX_PATTERN_CANDIDATES];
   int k = -1;
   const MV fcenter_mv = {center_mv->row >> 3, center_mv->col >> 3};
   int best_init_s = search_param_to_steps[search_param];
@@ -1247,12 +1277,12 @@ static int vp9_pattern_search_sad(const MACROBLOCK *x,
     for (t = 0; t <= s; ++t) {
       int best_site = -1;
       if (check_bounds(x, br, bc, 1 << t)) {
+        calc_candidate_sads(x, vfp, br, bc, candidates[t], NULL,
+                            num_candidates[t], sads);
         for (i = 0; i < num_candidates[t]; i++) {
           const MV this_mv = {br + candidates[t][i].row,
                               bc + candidates[t][i].col};
-          thissad = vfp->sdf(what->buf, what->stride,
-                             get_buf_from_mv(in_what, &this_mv),
-                             in_what->stride);
+          thissad = sads[i];
           CHECK_BETTER
         }
       } else {
@@ -1290,12 +1320,12 @@ static int vp9_pattern_search_sad(const MACROBLOCK *x,
     for (; s >= do_sad; s--) {
       if (!do_init_search || s != best_init_s) {
         if (check_bounds(x, br, bc, 1 << s)) {
+          calc_candidate_sads(x, vfp, br, bc, candidates[s], NULL,
+                              num_candidates[s], sads);
           for (i = 0; i < num_candidates[s]; i++) {
             const MV this_mv = {br + candidates[s][i].row,
                                 bc + candidates[s][i].col};
-            thissad = vfp->sdf(what->buf, what->stride,
-                               get_buf_from_mv(in_what, &this_mv),
-                               in_what->stride);
+            thissad = sads[i];
             CHECK_BETTER
           }
         } else {
@@ -1328,12 +1358,13 @@ static int vp9_pattern_search_sad(const MACROBLOCK *x,
         next_chkpts_indices[2] = (k == num_candidates[s] - 1) ? 0 : k + 1;
 
         if (check_bounds(x, br, bc, 1 << s)) {
+          calc_candidate_sads(x, vfp, br, bc, candidates[s],
+                              next_chkpts_indices, PATTERN_CANDIDATES_REF,
+                              sads);
           for (i = 0; i < PATTERN_CANDIDATES_REF; i++) {
             const MV this_mv = {br + candidates[s][next_chkpts_indices[i]].row,
                                 bc + candidates[s][next_chkpts_indices[i]].col};
-            thissad = vfp->sdf(what->buf, what->stride,
-                               get_buf_from_mv(in_what, &this_mv),
-                               in_what->stride);
+            thissad = sads[i];
             CHECK_BETTER
           }
         } else {
@@ -1362,13 +1393,13 @@ static int vp9_pattern_search_sad(const MACROBLOCK *x,
       cost_list[0] = bestsad;
       if (!do_init_search || s != best_init_s) {
         if (check_bounds(x, br, bc, 1 << s)) {
+          calc_candidate_sads(x, vfp, br, bc, candidates[s], NULL,
+                              num_candidates[s], sads);
           for (i = 0; i < num_candidates[s]; i++) {
             const MV this_mv = {br + candidates[s][i].row,
                                 bc + candidates[s][i].col};
             cost_list[i + 1] =
-            thissad = vfp->sdf(what->buf, what->stride,
-                               get_buf_from_mv(in_what, &this_mv),
-                               in_what->stride);
+            thissad = sads[i];
             CHECK_BETTER
           }
         } else {
@@ -1402,13 +1433,14 @@ static int vp9_pattern_search_sad(const MACROBLOCK *x,
         cost_list[0] = bestsad;
 
         if (check_bounds(x, br, bc, 1 << s)) {
+          calc_candidate_sads(x, vfp, br, bc, candidates[s],
+                              next_chkpts_indices, PATTERN_CANDIDATES_REF,
+                              sads);
           for (i = 0; i < PATTERN_CANDIDATES_REF; i++) {
             const MV this_mv = {br + candidates[s][next_chkpts_indices[i]].row,
                                 bc + candidates[s][next_chkpts_indices[i]].col};
             cost_list[next_chkpts_indices[i] + 1] =
-            thissad = vfp->sdf(what->buf, what->stride,
-                               get_buf_from_mv(in_what, &this_mv),
-                               in_what->stride);
+            thissad = sads[i];
             CHECK_BETTER
           }
         } else {
@@ -1447,13 +1479,9 @@ static int vp9_pattern_search_sad(const MACROBLOCK *x,
     if (cost_list[0] == INT_MAX) {
       cost_list[0] = bestsad;
       if (check_bounds(x, br, bc, 1)) {
-        for (i = 0; i < 4; i++) {
-          const MV this_mv = { br + neighbors[i].row,
-                               bc + neighbors[i].col };
-          cost_list[i + 1] = vfp->sdf(what->buf, what->stride,
-                                     get_buf_from_mv(in_what, &this_mv),
-                                     in_what->stride);
-        }
+        calc_candidate_sads(x, vfp, br, bc, neighbors, NULL, 4, sads);
+        for (i = 0; i < 4; i++)
+          cost_list[i + 1] = sads[i];
       } else {
         for (i = 0; i < 4; i++) {
           const MV this_mv = {br + neighbors[i].row,
@@ -1708,16 +1736,33 @@ static int exhuastive_mesh_search(const MACROBLOCK *x,
     for (c = start_col; c <= end_col; c += col_step) {
       // Step > 1 means we are not checking every location in this pass.
       if (step > 1) {
-        const MV mv = {fcenter_mv.row + r, fcenter_mv.col + c};
-        unsigned int sad = fn_ptr->sdf(what->buf, what->stride,
-                           get_buf_from_mv(in_what, &mv), in_what->stride);
-        if (sad < best_sad) {
-          sad += mvsad_err_cost(x, &mv, ref_mv, sad_per_bit);
-          if (sad < best_sad) {
-            best_sad = sad;
-            *best_mv = mv;
+        // 4 sads in a single call when 4 more locations fit in the row.
+        const int num = (c + 3 * col_step <= end_col) ? 4 : 1;
+        unsigned int sads[4];
+        const uint8_t *addrs[4];
+        for (i = 0; i < num; ++i) {
+          const MV mv = {fcenter_mv.row + r, fcenter_mv.col + c + i * col_step};
+          addrs[i] = get_buf_from_mv(in_what, &mv);
+        }
+        if (num == 4)
+          fn_ptr->sdx4df(what->buf, what->stride, addrs, in_what->stride, sads);
+        else
+          sads[0] = fn_ptr->sdf(what->buf, what->stride, addrs[0],
+                                in_what->stride);
+
+        for (i = 0; i < num; ++i) {
+          if (sads[i] < best_sad) {
+            const MV mv = {fcenter_mv.row + r,
+                           fcenter_mv.col + c + i * col_step};
+            const unsigned int sad = sads[i] +
+                mvsad_err_cost(x, &mv, ref_mv, sad_per_bit);
+            if (sad < best_sad) {
+              best_sad = sad;
+              *best_mv = mv;
+            }
           }
         }
+        c += (num - 1) * col_step;
       } else {
         // 4 sads in a single call if we are checking every location
         if (c + 3 <= end_col) {
@@ -2128,6 +2173,95 @@ unsigned int vp9_int_pro_motion_estimation(const VP9_COMP *cpi, MACROBLOCK *x,
   return best_sad;
 }
 
+// Block size and search ranges of the pyramid motion search. The ranges are
+// in pixels of the level searched.
+#define PYRAMID_BLOCK_SIZE    8
+#define PYRAMID_COARSE_RANGE  8
+#define PYRAMID_FINE_RANGE    2
+
+// Search of the block at (row, col) of src in ref over the positions 'step'
+// apart within +/-range of *best_mv, which is updated. The block is kept
+// within the plane borders.
+static void pyramid_search_level(const vp9_variance_fn_ptr_t *fn_ptr,
+                                 const struct lookahead_plane *src,
+                                 const struct lookahead_plane *ref,
+                                 int row, int col, int range, int step,
+                                 MV *best_mv) {
+  const int bs = PYRAMID_BLOCK_SIZE;
+  const int border = LOOKAHEAD_PYRAMID_BORDER;
+  const int row_lo = -border - row;
+  const int row_hi = ref->height + border - bs - row;
+  const int col_lo = -border - col;
+  const int col_hi = ref->width + border - bs - col;
+  const uint8_t *const src_buf = src->buf + row * src->stride + col;
+  const uint8_t *const ref_buf = ref->buf + row * ref->stride + col;
+  const MV center = {clamp(best_mv->row, row_lo, row_hi),
+                     clamp(best_mv->col, col_lo, col_hi)};
+  const int row_min = VPXMAX(center.row - range, row_lo);
+  const int row_max = VPXMIN(center.row + range, row_hi);
+  const int col_min = VPXMAX(center.col - range, col_lo);
+  const int col_max = VPXMIN(center.col + range, col_hi);
+  unsigned int best_sad;
+  int r, c, i;
+
+  // The center wins ties, so that flat areas do not pick up motion.
+  *best_mv = center;
+  best_sad = fn_ptr->sdf(src_buf, src->stride,
+                         ref_buf + center.row * ref->stride + center.col,
+                         ref->stride);
+  for (r = row_min; r <= row_max; r += step) {
+    const uint8_t *const ref_row = ref_buf + r * ref->stride;
+    for (c = col_min; c <= col_max; c += 4 * step) {
+      const int num = VPXMIN(4, (col_max - c) / step + 1);
+      unsigned int sads[4];
+      if (num == 4) {
+        const uint8_t *addrs[4];
+        for (i = 0; i < 4; ++i)
+          addrs[i] = ref_row + c + i * step;
+        fn_ptr->sdx4df(src_buf, src->stride, addrs, ref->stride, sads);
+      } else {
+        for (i = 0; i < num; ++i)
+          sads[i] = fn_ptr->sdf(src_buf, src->stride, ref_row + c + i * step,
+                                ref->stride);
+      }
+      for (i = 0; i < num; ++i) {
+        if (sads[i] < best_sad) {
+          best_sad = sads[i];
+          best_mv->row = r;
+          best_mv->col = c + i * step;
+        }
+      }
+    }
+  }
+}
+
+MV vp9_pyramid_motion_search(const VP9_COMP *cpi,
+                             const struct lookahead_entry *src,
+                             const struct lookahead_entry *ref,
+                             int mb_row, int mb_col) {
+  const vp9_variance_fn_ptr_t *const fn_ptr = &cpi->fn_ptr[BLOCK_8X8];
+  MV mv = {0, 0};
+
+  assert(src->has_pyramid && ref->has_pyramid);
+  assert(PYRAMID_BLOCK_SIZE == 8);
+
+  // The macroblock is 4x4 at 1/4 resolution: match the 8x8 block centered on
+  // it, which is less prone to false matches. Every other position is
+  // checked, then the best one is refined.
+  pyramid_search_level(fn_ptr, &src->pyramid[1], &ref->pyramid[1],
+                       4 * mb_row - 2, 4 * mb_col - 2, PYRAMID_COARSE_RANGE,
+                       2, &mv);
+  pyramid_search_level(fn_ptr, &src->pyramid[1], &ref->pyramid[1],
+                       4 * mb_row - 2, 4 * mb_col - 2, 1, 1, &mv);
+  mv.row *= 2;
+  mv.col *= 2;
+  pyramid_search_level(fn_ptr, &src->pyramid[0], &ref->pyramid[0],
+                       8 * mb_row, 8 * mb_col, PYRAMID_FINE_RANGE, 1, &mv);
+  mv.row *= 2;
+  mv.col *= 2;
+  return mv;
+}
+
 // Runs sequence of diamond searches in smaller steps for RD.
 /* do_refine: If last step (1-away) of n-step search doesn't pick the center
               point as the best match, we will do a final 1-away diamond
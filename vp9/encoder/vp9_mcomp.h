@@ -74,6 +74,16 @@ unsigned int vp9_int_pro_motion_estimation(const struct VP9_COMP *cpi,
                                            BLOCK_SIZE bsize,
                                            int mi_row, int mi_col);
 
+struct lookahead_entry;
+
+// Full pixel motion vector of the 16x16 macroblock at (mb_row, mb_col) of
+// src in ref, from a coarse to fine search of their lookahead pyramids. Both
+// entries must have a pyramid. The mv is not clamped to the mv limits of x.
+MV vp9_pyramid_motion_search(const struct VP9_COMP *cpi,
+                             const struct lookahead_entry *src,
+                             const struct lookahead_entry *ref,
+                             int mb_row, int mb_col);
+
 typedef int (fractional_mv_step_fp) (
     const MACROBLOCK *x,
     MV *bestmv, const MV *ref_mv,
@@ -34,12 +34,167 @@ static int get_max_filter_level(const VP9_COMP *cpi) {
 }
 
 
+// LPF_PICK_FROM_SB_ROWS filters every SB_ROW_SAMPLE_STEP-th SB row in
+// isolation and measures the error of the rows it changes: the SB row and the
+// bottom pixels of the row above. The step must be at least 2 so that the
+// samples do not overlap and can be filtered in parallel.
+#define SB_ROW_SAMPLE_STEP 4
+#define MIN_SB_ROW_SAMPLES 2
+
+typedef struct LFSampleWorkerData {
+  VP9_COMP *cpi;
+  const YV12_BUFFER_CONFIG *sd;
+  struct macroblockd_plane planes[MAX_MB_PLANE];
+  int filt_level;
+  // The SB rows sampled by this worker.
+  int first_sb_row;
+  int sb_row_step;
+  int64_t sse;
+} LFSampleWorkerData;
+
+static int use_sb_row_samples(const VP9_COMMON *cm) {
+  return cm->sb_rows >= SB_ROW_SAMPLE_STEP * MIN_SB_ROW_SAMPLES;
+}
+
+// Sets [*start, *sse_end) to the visible luma rows of the sample at sb_row.
+// Returns the end of the rows the filter may change, which can reach into the
+// alignment padding below the visible frame.
+static int get_sample_rows(const YV12_BUFFER_CONFIG *frame, int sb_row,
+                           int *start, int *sse_end) {
+  const int sb_start = sb_row * MI_BLOCK_SIZE * MI_SIZE;
+  const int end = VPXMIN(sb_start + MI_BLOCK_SIZE * MI_SIZE, frame->y_height);
+
+  *start = VPXMAX(sb_start - MI_SIZE, 0);
+  *sse_end = VPXMIN(end, frame->y_crop_height);
+  return end;
+}
+
+static void copy_y_rows(const YV12_BUFFER_CONFIG *src,
+                        YV12_BUFFER_CONFIG *dst, int start, int end) {
+  int bytes_per_pixel = 1;
+  const uint8_t *src_ptr = src->y_buffer;
+  uint8_t *dst_ptr = dst->y_buffer;
+  int row;
+
+#if CONFIG_VP9_HIGHBITDEPTH
+  if (src->flags & YV12_FLAG_HIGHBITDEPTH) {
+    bytes_per_pixel = 2;
+    src_ptr = (const uint8_t *)CONVERT_TO_SHORTPTR(src->y_buffer);
+    dst_ptr = (uint8_t *)CONVERT_TO_SHORTPTR(dst->y_buffer);
+  }
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+  src_ptr += start * src->y_stride * bytes_per_pixel;
+  dst_ptr += start * dst->y_stride * bytes_per_pixel;
+  for (row = start; row < end; ++row) {
+    memcpy(dst_ptr, src_ptr, src->y_width * bytes_per_pixel);
+    src_ptr += src->y_stride * bytes_per_pixel;
+    dst_ptr += dst->y_stride * bytes_per_pixel;
+  }
+}
+
+static int filter_sb_row_samples(LFSampleWorkerData *const data,
+                                 void *unused) {
+  VP9_COMP *const cpi = data->cpi;
+  VP9_COMMON *const cm = &cpi->common;
+  YV12_BUFFER_CONFIG *const frame = cm->frame_to_show;
+  int sb_row;
+  (void)unused;
+
+  data->sse = 0;
+  for (sb_row = data->first_sb_row; sb_row < cm->sb_rows;
+       sb_row += data->sb_row_step) {
+    const int mi_row = sb_row * MI_BLOCK_SIZE;
+    int start, sse_end, end;
+
+    end = get_sample_rows(frame, sb_row, &start, &sse_end);
+    if (data->filt_level) {
+      vp9_loop_filter_rows(frame, cm, data->planes, mi_row,
+                           mi_row + MI_BLOCK_SIZE, 1);
+    }
+#if CONFIG_VP9_HIGHBITDEPTH
+    if (cm->use_highbitdepth) {
+      data->sse += vp9_highbd_get_y_sse_rows(data->sd, frame, start,
+                                             sse_end - start);
+    } else {
+      data->sse += vp9_get_y_sse_rows(data->sd, frame, start,
+                                      sse_end - start);
+    }
+#else
+    data->sse += vp9_get_y_sse_rows(data->sd, frame, start, sse_end - start);
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+
+    // Re-instate the unfiltered rows
+    if (data->filt_level)
+      copy_y_rows(&cpi->last_frame_uf, frame, start, end);
+  }
+  return 1;
+}
+
+// Filters the sampled SB rows on the encoding threads, each thread takes
+// every num_workers-th sample.
+static int64_t try_filter_sb_rows(const YV12_BUFFER_CONFIG *sd,
+                                  VP9_COMP *const cpi, int filt_level,
+                                  LFSampleWorkerData *const lf_data) {
+  VP9_COMMON *const cm = &cpi->common;
+  const VPxWorkerInterface *const winterface = vpx_get_worker_interface();
+  const int num_samples = cm->sb_rows / SB_ROW_SAMPLE_STEP;
+  const int num_workers = VPXMIN(cpi->max_threads, num_samples);
+  int64_t filt_err = 0;
+  int i;
+
+  if (filt_level) {
+    vp9_loop_filter_frame_init(cm, filt_level);
+  }
+
+  for (i = 0; i < num_workers; ++i) {
+    LFSampleWorkerData *const data = &lf_data[i];
+
+    data->cpi = cpi;
+    data->sd = sd;
+    memcpy(data->planes, cpi->td.mb.e_mbd.plane, sizeof(data->planes));
+    data->filt_level = filt_level;
+    data->first_sb_row = SB_ROW_SAMPLE_STEP / 2 + i * SB_ROW_SAMPLE_STEP;
+    data->sb_row_step = num_workers * SB_ROW_SAMPLE_STEP;
+  }
+
+  if (num_workers > 1) {
+    for (i = 0; i < num_workers; ++i) {
+      VPxWorker *const worker = &cpi->enc_thread_hndl[i];
+
+      winterface->sync(worker);
+      worker->hook = (VPxWorkerHook)filter_sb_row_samples;
+      worker->data1 = &lf_data[i];
+      worker->data2 = NULL;
+
+      if (i == num_workers - 1) {
+        winterface->execute(worker);
+      } else {
+        winterface->launch(worker);
+      }
+    }
+    for (i = 0; i < num_workers; ++i) {
+      winterface->sync(&cpi->enc_thread_hndl[i]);
+    }
+  } else {
+    filter_sb_row_samples(&lf_data[0], NULL);
+  }
+
+  for (i = 0; i < num_workers; ++i)
+    filt_err += lf_data[i].sse;
+  return filt_err;
+}
+
 static int64_t try_filter_frame(const YV12_BUFFER_CONFIG *sd,
                                 VP9_COMP *const cpi,
-                                int filt_level, int partial_frame) {
+                                int filt_level, LPF_PICK_METHOD method,
+                                LFSampleWorkerData *const lf_data) {
   VP9_COMMON *const cm = &cpi->common;
+  const int partial_frame = method == LPF_PICK_FROM_SUBIMAGE;
   int64_t filt_err;
 
+  if (method == LPF_PICK_FROM_SB_ROWS)
+    return try_filter_sb_rows(sd, cpi, filt_level, lf_data);
+
   if (filt_level) {
     vp9_loop_filter_frame_init(cm, filt_level);
   }
@@ -70,8 +225,8 @@ static int64_t try_filter_frame(const YV12_BUFFER_CONFIG *sd,
 }
 
 static int search_filter_level(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
-                               int partial_frame) {
-  const VP9_COMMON *const cm = &cpi->common;
+                               LPF_PICK_METHOD method) {
+  VP9_COMMON *const cm = &cpi->common;
   const struct loopfilter *const lf = &cm->lf;
   const int min_filter_level = 0;
   const int max_filter_level = get_max_filter_level(cpi);
@@ -86,14 +241,28 @@ static int search_filter_level(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
   int filter_step = filt_mid < 16 ? 4 : filt_mid / 4;
   // Sum squared error at each filter level
   int64_t ss_err[MAX_LOOP_FILTER + 1];
+  LFSampleWorkerData *lf_data = NULL;
 
   // Set each entry to -1
   memset(ss_err, 0xFF, sizeof(ss_err));
 
   //  Make a copy of the unfiltered / processed recon buffer
-  vpx_yv12_copy_y(cm->frame_to_show, &cpi->last_frame_uf);
+  if (method == LPF_PICK_FROM_SB_ROWS) {
+    int sb_row;
+    CHECK_MEM_ERROR(cm, lf_data,
+                    vpx_malloc(sizeof(*lf_data) * cpi->max_threads));
+    for (sb_row = SB_ROW_SAMPLE_STEP / 2; sb_row < cm->sb_rows;
+         sb_row += SB_ROW_SAMPLE_STEP) {
+      int start, sse_end;
+      const int end = get_sample_rows(cm->frame_to_show, sb_row, &start,
+                                      &sse_end);
+      copy_y_rows(cm->frame_to_show, &cpi->last_frame_uf, start, end);
+    }
+  } else {
+    vpx_yv12_copy_y(cm->frame_to_show, &cpi->last_frame_uf);
+  }
 
-  best_err = try_filter_frame(sd, cpi, filt_mid, partial_frame);
+  best_err = try_filter_frame(sd, cpi, filt_mid, method, lf_data);
   filt_best = filt_mid;
   ss_err[filt_mid] = best_err;
 
@@ -114,7 +283,8 @@ static int search_filter_level(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
     if (filt_direction <= 0 && filt_low != filt_mid) {
       // Get Low filter error score
       if (ss_err[filt_low] < 0) {
-        ss_err[filt_low] = try_filter_frame(sd, cpi, filt_low, partial_frame);
+        ss_err[filt_low] = try_filter_frame(sd, cpi, filt_low, method,
+                                            lf_data);
       }
       // If value is close to the best so far then bias towards a lower loop
       // filter value.
@@ -130,7 +300,8 @@ static int search_filter_level(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
     // Now look at filt_high
     if (filt_direction >= 0 && filt_high != filt_mid) {
       if (ss_err[filt_high] < 0) {
-        ss_err[filt_high] = try_filter_frame(sd, cpi, filt_high, partial_frame);
+        ss_err[filt_high] = try_filter_frame(sd, cpi, filt_high, method,
+                                             lf_data);
       }
       // Was it better than the previous best?
       if (ss_err[filt_high] < (best_err - bias)) {
@@ -149,6 +320,7 @@ static int search_filter_level(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
     }
   }
 
+  vpx_free(lf_data);
   return filt_best;
 }
 
@@ -192,7 +364,8 @@ void vp9_pick_filter_level(const YV12_BUFFER_CONFIG *sd, VP9_COMP *cpi,
       filt_guess -= 4;
     lf->filter_level = clamp(filt_guess, min_filter_level, max_filter_level);
   } else {
-    lf->filter_level = search_filter_level(sd, cpi,
-                                           method == LPF_PICK_FROM_SUBIMAGE);
+    if (method == LPF_PICK_FROM_SB_ROWS && !use_sb_row_samples(cm))
+      method = LPF_PICK_FROM_FULL_IMAGE;
+    lf->filter_level = search_filter_level(sd, cpi, method);
   }
 }
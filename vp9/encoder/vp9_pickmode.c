@@ -324,6 +324,39 @@ static void check_for_uv_skip(VP9_COMP *cpi, BLOCK_SIZE bsize,
   }
 
 }
+// Models the DC (sse - var) and the AC (var) energy of a block of the plane
+// in one call. The DC is not modeled with skip_dc; its distortion is then its
+// energy.
+static void model_rd_dc_ac(const struct macroblock_plane *p, BLOCK_SIZE bsize,
+                           unsigned int sse, unsigned int var, int skip_dc,
+                           int *out_rate_sum, int64_t *out_dist_sum) {
+  const MODEL_RD_QUANT *mq[2];
+  unsigned int dc_ac_var[2];
+  unsigned int n_log2[2];
+  int rate[2];
+  int64_t dist[2];
+
+  mq[0] = &p->model_rd[0];
+  mq[1] = &p->model_rd[1];
+  dc_ac_var[0] = sse - var;
+  dc_ac_var[1] = var;
+  n_log2[0] = n_log2[1] = num_pels_log2_lookup[bsize];
+  vp9_model_rd_from_var_lapndz_vec(mq + skip_dc, dc_ac_var + skip_dc,
+                                   n_log2 + skip_dc, 2 - skip_dc,
+                                   rate + skip_dc, dist + skip_dc);
+
+  if (!skip_dc) {
+    *out_rate_sum = rate[0] >> 1;
+    *out_dist_sum = dist[0] << 3;
+  } else {
+    *out_rate_sum = 0;
+    *out_dist_sum = (sse - var) << 4;
+  }
+
+  *out_rate_sum += rate[1];
+  *out_dist_sum += dist[1] << 4;
+}
+
 static void model_rd_for_sb_y_large(VP9_COMP *cpi, BLOCK_SIZE bsize,
                                     MACROBLOCK *x, MACROBLOCKD *xd,
                                     int *out_rate_sum, int64_t *out_dist_sum,
@@ -332,8 +365,6 @@ static void model_rd_for_sb_y_large(VP9_COMP *cpi, BLOCK_SIZE bsize,
   // Hence quantizer step is also 8 times. To get effective quantizer
   // we need to divide by 8 before sending to modeling function.
   unsigned int sse;
-  int rate;
-  int64_t dist;
   struct macroblock_plane *const p = &x->plane[0];
   struct macroblockd_plane *const pd = &xd->plane[0];
   const uint32_t dc_quant = pd->dequant[0];
@@ -440,44 +471,7 @@ static void model_rd_for_sb_y_large(VP9_COMP *cpi, BLOCK_SIZE bsize,
     return;
   }
 
-  if (!skip_dc) {
-#if CONFIG_VP9_HIGHBITDEPTH
-    if (xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH) {
-      vp9_model_rd_from_var_lapndz(sse - var, num_pels_log2_lookup[bsize],
-                                   dc_quant >> (xd->bd - 5), &rate, &dist);
-    } else {
-      vp9_model_rd_from_var_lapndz(sse - var, num_pels_log2_lookup[bsize],
-                                   dc_quant >> 3, &rate, &dist);
-    }
-#else
-    vp9_model_rd_from_var_lapndz(sse - var, num_pels_log2_lookup[bsize],
-                                 dc_quant >> 3, &rate, &dist);
-#endif  // CONFIG_VP9_HIGHBITDEPTH
-  }
-
-  if (!skip_dc) {
-    *out_rate_sum = rate >> 1;
-    *out_dist_sum = dist << 3;
-  } else {
-    *out_rate_sum = 0;
-    *out_dist_sum = (sse - var) << 4;
-  }
-
-#if CONFIG_VP9_HIGHBITDEPTH
-  if (xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH) {
-    vp9_model_rd_from_var_lapndz(var, num_pels_log2_lookup[bsize],
-                                 ac_quant >> (xd->bd - 5), &rate, &dist);
-  } else {
-    vp9_model_rd_from_var_lapndz(var, num_pels_log2_lookup[bsize],
-                                 ac_quant >> 3, &rate, &dist);
-  }
-#else
-  vp9_model_rd_from_var_lapndz(var, num_pels_log2_lookup[bsize],
-                               ac_quant >> 3, &rate, &dist);
-#endif  // CONFIG_VP9_HIGHBITDEPTH
-
-  *out_rate_sum += rate;
-  *out_dist_sum += dist << 4;
+  model_rd_dc_ac(p, bsize, sse, var, skip_dc, out_rate_sum, out_dist_sum);
 }
 
 static void model_rd_for_sb_y(VP9_COMP *cpi, BLOCK_SIZE bsize,
@@ -488,14 +482,10 @@ static void model_rd_for_sb_y(VP9_COMP *cpi, BLOCK_SIZE bsize,
   // Hence quantizer step is also 8 times. To get effective quantizer
   // we need to divide by 8 before sending to modeling function.
   unsigned int sse;
-  int rate;
-  int64_t dist;
   struct macroblock_plane *const p = &x->plane[0];
   struct macroblockd_plane *const pd = &xd->plane[0];
   const int64_t dc_thr = p->quant_thred[0] >> 6;
   const int64_t ac_thr = p->quant_thred[1] >> 6;
-  const uint32_t dc_quant = pd->dequant[0];
-  const uint32_t ac_quant = pd->dequant[1];
   unsigned int var = cpi->fn_ptr[bsize].vf(p->src.buf, p->src.stride,
                                            pd->dst.buf, pd->dst.stride, &sse);
   int skip_dc = 0;
@@ -551,44 +541,7 @@ static void model_rd_for_sb_y(VP9_COMP *cpi, BLOCK_SIZE bsize,
     return;
   }
 
-  if (!skip_dc) {
-#if CONFIG_VP9_HIGHBITDEPTH
-    if (xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH) {
-      vp9_model_rd_from_var_lapndz(sse - var, num_pels_log2_lookup[bsize],
-                                   dc_quant >> (xd->bd - 5), &rate, &dist);
-    } else {
-      vp9_model_rd_from_var_lapndz(sse - var, num_pels_log2_lookup[bsize],
-                                   dc_quant >> 3, &rate, &dist);
-    }
-#else
-    vp9_model_rd_from_var_lapndz(sse - var, num_pels_log2_lookup[bsize],
-                                 dc_quant >> 3, &rate, &dist);
-#endif  // CONFIG_VP9_HIGHBITDEPTH
-  }
-
-  if (!skip_dc) {
-    *out_rate_sum = rate >> 1;
-    *out_dist_sum = dist << 3;
-  } else {
-    *out_rate_sum = 0;
-    *out_dist_sum = (sse - var) << 4;
-  }
-
-#if CONFIG_VP9_HIGHBITDEPTH
-  if (xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH) {
-    vp9_model_rd_from_var_lapndz(var, num_pels_log2_lookup[bsize],
-                                 ac_quant >> (xd->bd - 5), &rate, &dist);
-  } else {
-    vp9_model_rd_from_var_lapndz(var, num_pels_log2_lookup[bsize],
-                                 ac_quant >> 3, &rate, &dist);
-  }
-#else
-  vp9_model_rd_from_var_lapndz(var, num_pels_log2_lookup[bsize],
-                               ac_quant >> 3, &rate, &dist);
-#endif  // CONFIG_VP9_HIGHBITDEPTH
-
-  *out_rate_sum += rate;
-  *out_dist_sum += dist << 4;
+  model_rd_dc_ac(p, bsize, sse, var, skip_dc, out_rate_sum, out_dist_sum);
 }
 
 #if CONFIG_VP9_HIGHBITDEPTH
@@ -711,12 +664,13 @@ static void model_rd_for_sb_uv(VP9_COMP *cpi, BLOCK_SIZE plane_bsize,
                                int *out_rate_sum, int64_t *out_dist_sum,
                                unsigned int *var_y, unsigned int *sse_y,
                                int start_plane, int stop_plane) {
-  // Note our transform coeffs are 8 times an orthogonal transform.
-  // Hence quantizer step is also 8 times. To get effective quantizer
-  // we need to divide by 8 before sending to modeling function.
-  unsigned int sse;
-  int rate;
-  int64_t dist;
+  // The DC and AC energies of all the planes are modeled in one call.
+  const MODEL_RD_QUANT *mq[2 * (MAX_MB_PLANE - 1)] = { NULL };
+  unsigned int dc_ac_var[2 * (MAX_MB_PLANE - 1)] = { 0 };
+  unsigned int n_log2[2 * (MAX_MB_PLANE - 1)] = { 0 };
+  int rate[2 * (MAX_MB_PLANE - 1)];
+  int64_t dist[2 * (MAX_MB_PLANE - 1)];
+  int n = 0;
   int i;
 
   *out_rate_sum = 0;
@@ -725,9 +679,8 @@ static void model_rd_for_sb_uv(VP9_COMP *cpi, BLOCK_SIZE plane_bsize,
   for (i = start_plane; i <= stop_plane; ++i) {
     struct macroblock_plane *const p = &x->plane[i];
     struct macroblockd_plane *const pd = &xd->plane[i];
-    const uint32_t dc_quant = pd->dequant[0];
-    const uint32_t ac_quant = pd->dequant[1];
     const BLOCK_SIZE bs = plane_bsize;
+    unsigned int sse;
     unsigned int var;
 
     if (!x->color_sensitivity[i - 1])
@@ -738,37 +691,21 @@ static void model_rd_for_sb_uv(VP9_COMP *cpi, BLOCK_SIZE plane_bsize,
     *var_y += var;
     *sse_y += sse;
 
-  #if CONFIG_VP9_HIGHBITDEPTH
-    if (xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH) {
-      vp9_model_rd_from_var_lapndz(sse - var, num_pels_log2_lookup[bs],
-                                   dc_quant >> (xd->bd - 5), &rate, &dist);
-    } else {
-      vp9_model_rd_from_var_lapndz(sse - var, num_pels_log2_lookup[bs],
-                                   dc_quant >> 3, &rate, &dist);
-    }
-  #else
-    vp9_model_rd_from_var_lapndz(sse - var, num_pels_log2_lookup[bs],
-                                 dc_quant >> 3, &rate, &dist);
-  #endif  // CONFIG_VP9_HIGHBITDEPTH
-
-    *out_rate_sum += rate >> 1;
-    *out_dist_sum += dist << 3;
-
-  #if CONFIG_VP9_HIGHBITDEPTH
-    if (xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH) {
-      vp9_model_rd_from_var_lapndz(var, num_pels_log2_lookup[bs],
-                                   ac_quant >> (xd->bd - 5), &rate, &dist);
-    } else {
-      vp9_model_rd_from_var_lapndz(var, num_pels_log2_lookup[bs],
-                                   ac_quant >> 3, &rate, &dist);
-    }
-  #else
-    vp9_model_rd_from_var_lapndz(var, num_pels_log2_lookup[bs],
-                                 ac_quant >> 3, &rate, &dist);
-  #endif  // CONFIG_VP9_HIGHBITDEPTH
+    mq[n] = &p->model_rd[0];
+    mq[n + 1] = &p->model_rd[1];
+    dc_ac_var[n] = sse - var;
+    dc_ac_var[n + 1] = var;
+    n_log2[n] = n_log2[n + 1] = num_pels_log2_lookup[bs];
+    n += 2;
+  }
+
+  vp9_model_rd_from_var_lapndz_vec(mq, dc_ac_var, n_log2, n, rate, dist);
 
-    *out_rate_sum += rate;
-    *out_dist_sum += dist << 4;
+  for (i = 0; i < n; i += 2) {
+    *out_rate_sum += rate[i] >> 1;
+    *out_dist_sum += dist[i] << 3;
+    *out_rate_sum += rate[i + 1];
+    *out_dist_sum += dist[i + 1] << 4;
   }
 }
 
@@ -1141,10 +1078,6 @@ void vp9_pick_inter_mode_dp(VP9_COMP *cpi, MACROBLOCK *x,
   mi->tx_size = VPXMIN(max_txsize_lookup[bsize],
                        tx_mode_to_biggest_tx_size[cm->tx_mode]);
 
-#if CONFIG_VP9_TEMPORAL_DENOISING
-  vp9_denoiser_reset_frame_stats(ctx);
-#endif
-
   usable_ref_frame = LAST_FRAME;
 
   for (ref_frame = LAST_FRAME; ref_frame <= usable_ref_frame; ++ref_frame) {
@@ -35,6 +35,10 @@ typedef struct {
   DECLARE_ALIGNED(16, int16_t, uv_quant_shift[QINDEX_RANGE][8]);
   DECLARE_ALIGNED(16, int16_t, uv_zbin[QINDEX_RANGE][8]);
   DECLARE_ALIGNED(16, int16_t, uv_round[QINDEX_RANGE][8]);
+
+  // The rate/distortion model of the DC (0) and AC (1) quantizers.
+  MODEL_RD_QUANT y_model_rd[QINDEX_RANGE][2];
+  MODEL_RD_QUANT uv_model_rd[QINDEX_RANGE][2];
 } QUANTS;
 
 void vp9_regular_quantize_b_4x4(MACROBLOCK *x, int plane, int block,
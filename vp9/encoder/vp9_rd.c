@@ -441,6 +441,26 @@ static void model_rd_norm(int xsq_q10, int *r_q10, int *d_q10) {
   *d_q10 = (dist_tab_q10[xq] * b_q10 + dist_tab_q10[xq + 1] * a_q10) >> 10;
 }
 
+// The model is evaluated up to this x^2 in Q10, where it saturates: the rate
+// of model_rd_norm() is 0 and the distortion MODEL_RD_SAT_DIST_Q10.
+static const uint32_t MAX_XSQ_Q10 = 245727;
+#define MODEL_RD_SAT_DIST_Q10 1023
+
+static int model_rd_xsq_q10(unsigned int var, unsigned int n_log2,
+                            unsigned int qstep) {
+  const uint64_t xsq_q10_64 =
+      (((uint64_t)qstep * qstep << (n_log2 + 10)) + (var >> 1)) / var;
+  return (int)VPXMIN(xsq_q10_64, MAX_XSQ_Q10);
+}
+
+static void model_rd_from_xsq(unsigned int var, unsigned int n_log2,
+                              int xsq_q10, int *rate, int64_t *dist) {
+  int d_q10, r_q10;
+  model_rd_norm(xsq_q10, &r_q10, &d_q10);
+  *rate = ROUND_POWER_OF_TWO(r_q10 << n_log2, 10 - VP9_PROB_COST_SHIFT);
+  *dist = (var * (int64_t)d_q10 + 512) >> 10;
+}
+
 void vp9_model_rd_from_var_lapndz(unsigned int var, unsigned int n_log2,
                                   unsigned int qstep, int *rate,
                                   int64_t *dist) {
@@ -454,14 +474,55 @@ void vp9_model_rd_from_var_lapndz(unsigned int var, unsigned int n_log2,
     *rate = 0;
     *dist = 0;
   } else {
-    int d_q10, r_q10;
-    static const uint32_t MAX_XSQ_Q10 = 245727;
-    const uint64_t xsq_q10_64 =
-        (((uint64_t)qstep * qstep << (n_log2 + 10)) + (var >> 1)) / var;
-    const int xsq_q10 = (int)VPXMIN(xsq_q10_64, MAX_XSQ_Q10);
-    model_rd_norm(xsq_q10, &r_q10, &d_q10);
-    *rate = ROUND_POWER_OF_TWO(r_q10 << n_log2, 10 - VP9_PROB_COST_SHIFT);
-    *dist = (var * (int64_t)d_q10 + 512) >> 10;
+    model_rd_from_xsq(var, n_log2, model_rd_xsq_q10(var, n_log2, qstep),
+                      rate, dist);
+  }
+}
+
+void vp9_init_model_rd_quant(MODEL_RD_QUANT *mq, int dequant,
+                             vpx_bit_depth_t bit_depth) {
+  // Note our transform coeffs are 8 times an orthogonal transform.
+  // Hence quantizer step is also 8 times. To get effective quantizer
+  // we need to divide by 8 before sending to modeling function.
+  const unsigned int qstep = dequant >> (bit_depth - 5);
+  int i;
+
+#ifndef NDEBUG
+  {
+    int r_q10, d_q10;
+    model_rd_norm(MAX_XSQ_Q10, &r_q10, &d_q10);
+    assert(r_q10 == 0 && d_q10 == MODEL_RD_SAT_DIST_Q10);
+  }
+#endif
+
+  mq->qstep = qstep;
+  for (i = 0; i < MODEL_RD_PELS_LOG2S; ++i) {
+    const unsigned int n_log2 = i + MODEL_RD_MIN_PELS_LOG2;
+    // x^2 saturates at and below this variance. It only decreases with the
+    // variance there, so search up from the edge of the unrounded ratio.
+    unsigned int var = (unsigned int)(((uint64_t)qstep * qstep <<
+                                       (n_log2 + 10)) / MAX_XSQ_Q10);
+    while (model_rd_xsq_q10(var + 1, n_log2, qstep) == (int)MAX_XSQ_Q10)
+      ++var;
+    mq->sat_var[i] = var;
+  }
+}
+
+void vp9_model_rd_from_var_lapndz_vec(const MODEL_RD_QUANT *const *mq,
+                                      const unsigned int *var,
+                                      const unsigned int *n_log2, int n,
+                                      int *rate, int64_t *dist) {
+  int i;
+  for (i = 0; i < n; ++i) {
+    if (var[i] <= mq[i]->sat_var[n_log2[i] - MODEL_RD_MIN_PELS_LOG2]) {
+      // Also covers var[i] == 0.
+      rate[i] = 0;
+      dist[i] = (var[i] * (int64_t)MODEL_RD_SAT_DIST_Q10 + 512) >> 10;
+    } else {
+      model_rd_from_xsq(var[i], n_log2[i],
+                        model_rd_xsq_q10(var[i], n_log2[i], mq[i]->qstep),
+                        &rate[i], &dist[i]);
+    }
   }
 }
 
@@ -121,6 +121,21 @@ typedef struct RD_COST {
   int64_t rdcost;
 } RD_COST;
 
+// The block sizes of vp9_model_rd_from_var_lapndz(), in log2 of the number of
+// pixels, range from 4x4 to 64x64.
+#define MODEL_RD_MIN_PELS_LOG2 4
+#define MODEL_RD_PELS_LOG2S    9
+
+// The quantizer dependent part of vp9_model_rd_from_var_lapndz() for one
+// quantizer step. These are precomputed per qindex with the quantizers.
+typedef struct MODEL_RD_QUANT {
+  unsigned int qstep;
+  // The largest variance of a block of
+  // 1 << (i + MODEL_RD_MIN_PELS_LOG2) pixels for which the model saturates,
+  // i.e. the rate is 0 and the distortion is the variance.
+  unsigned int sat_var[MODEL_RD_PELS_LOG2S];
+} MODEL_RD_QUANT;
+
 // Reset the rate distortion cost values to maximum (invalid) value.
 void vp9_rd_cost_reset(RD_COST *rd_cost);
 // Initialize the rate distortion cost values to zero.
@@ -143,6 +158,18 @@ void vp9_model_rd_from_var_lapndz(unsigned int var, unsigned int n,
                                   unsigned int qstep, int *rate,
                                   int64_t *dist);
 
+// dequant is the dequantizer of a coefficient at the given bit depth.
+void vp9_init_model_rd_quant(MODEL_RD_QUANT *mq, int dequant,
+                             vpx_bit_depth_t bit_depth);
+
+// Models the rate and distortion of n variances of blocks of 1 << n_log2[i]
+// pixels quantized with mq[i] in one call. It matches
+// vp9_model_rd_from_var_lapndz() but skips the saturated ones.
+void vp9_model_rd_from_var_lapndz_vec(const MODEL_RD_QUANT *const *mq,
+                                      const unsigned int *var,
+                                      const unsigned int *n_log2, int n,
+                                      int *rate, int64_t *dist);
+
 int vp9_get_switchable_rate(const struct VP9_COMP *cpi,
                             const struct macroblock *const x);
 
@@ -175,8 +175,12 @@ static void model_rd_for_sb(VP9_COMP *cpi, BLOCK_SIZE bsize,
   int64_t total_sse = 0;
   int skip_flag = 1;
   const int shift = 6;
-  int rate;
   int64_t dist;
+  const MODEL_RD_QUANT *plane_mq[MAX_MB_PLANE];
+  unsigned int plane_sse[MAX_MB_PLANE];
+  unsigned int plane_n_log2[MAX_MB_PLANE];
+  int plane_rate[MAX_MB_PLANE];
+  int64_t plane_dist[MAX_MB_PLANE];
   const int dequant_shift =
 #if CONFIG_VP9_HIGHBITDEPTH
       (xd->cur_buf->flags & YV12_FLAG_HIGHBITDEPTH) ?
@@ -258,11 +262,18 @@ static void model_rd_for_sb(VP9_COMP *cpi, BLOCK_SIZE bsize,
       rate_sum += rate;
       dist_sum += dist;
     } else {
-      vp9_model_rd_from_var_lapndz(sum_sse, num_pels_log2_lookup[bs],
-                                   pd->dequant[1] >> dequant_shift,
-                                   &rate, &dist);
-      rate_sum += rate;
-      dist_sum += dist;
+      plane_mq[i] = &p->model_rd[1];
+      plane_sse[i] = sum_sse;
+      plane_n_log2[i] = num_pels_log2_lookup[bs];
+    }
+  }
+
+  if (!cpi->sf.simple_model_rd_from_var) {
+    vp9_model_rd_from_var_lapndz_vec(plane_mq, plane_sse, plane_n_log2,
+                                     MAX_MB_PLANE, plane_rate, plane_dist);
+    for (i = 0; i < MAX_MB_PLANE; ++i) {
+      rate_sum += plane_rate[i];
+      dist_sum += plane_dist[i];
     }
   }
 
@@ -76,6 +76,11 @@ static void set_good_speed_feature_framesize_dependent(VP9_COMP *cpi,
     }
   }
 
+  if (speed >= 1 && sf->lpf_pick == LPF_PICK_FROM_FULL_IMAGE &&
+      VPXMIN(cm->width, cm->height) >= 720) {
+    sf->lpf_pick = LPF_PICK_FROM_SB_ROWS;
+  }
+
   if (speed >= 2) {
     if (VPXMIN(cm->width, cm->height) >= 720) {
       sf->disable_split_mask = cm->show_frame ? DISABLE_ALL_SPLIT
@@ -180,6 +185,7 @@ static void set_good_speed_feature(VP9_COMP *cpi, VP9_COMMON *cm,
     sf->comp_inter_joint_search_thresh = BLOCK_SIZES;
     sf->auto_min_max_partition_size = RELAXED_NEIGHBORING_MIN_MAX;
     sf->allow_partition_search_skip = 1;
+    sf->mv.use_lookahead_pyramid = 1;
   }
 
   if (speed >= 3) {
@@ -447,6 +453,143 @@ static void set_rt_speed_feature(VP9_COMP *cpi, SPEED_FEATURES *sf,
   }
 }
 
+// The speed steps of the speed tuner, see vp9_speed_tuner_update(), from the
+// least to the most costly in quality. Each one makes an individual feature
+// at least as fast as it is at the next speed setting that changes it.
+#define RD_SPEED_STEPS 17
+#define NONRD_SPEED_STEPS 6
+
+static void set_rd_speed_steps(VP9_COMP *cpi, SPEED_FEATURES *sf, int level) {
+  const VP9_COMMON *const cm = &cpi->common;
+  int i;
+
+  if (level >= 1)
+    sf->mv.subpel_iters_per_step = VPXMIN(sf->mv.subpel_iters_per_step, 1);
+  if (level >= 2)
+    sf->adaptive_rd_thresh = VPXMAX(sf->adaptive_rd_thresh, 2);
+  if (level >= 3)
+    sf->mode_skip_start = VPXMIN(sf->mode_skip_start, 10);
+  if (level >= 4) {
+    for (i = TX_16X16; i <= TX_32X32; ++i) {
+      sf->intra_y_mode_mask[i] &= INTRA_DC_H_V;
+      sf->intra_uv_mode_mask[i] &= INTRA_DC_H_V;
+    }
+  }
+  if (level >= 5 && !frame_is_intra_only(cm))
+    sf->tx_size_search_method = VPXMAX(sf->tx_size_search_method,
+                                       USE_LARGESTALL);
+  if (level >= 6 && cm->frame_type != KEY_FRAME)
+    sf->mode_search_skip_flags |= FLAG_SKIP_INTRA_DIRMISMATCH |
+                                  FLAG_SKIP_INTRA_BESTINTER |
+                                  FLAG_SKIP_COMP_BESTINTRA |
+                                  FLAG_SKIP_INTRA_LOWVAR;
+  if (level >= 7)
+    sf->disable_filter_search_var_thresh =
+        VPXMAX(sf->disable_filter_search_var_thresh, 100);
+  if (level >= 8)
+    sf->mv.subpel_search_method = VPXMAX(sf->mv.subpel_search_method,
+                                         SUBPEL_TREE_PRUNED);
+  if (level >= 9)
+    sf->adaptive_rd_thresh = VPXMAX(sf->adaptive_rd_thresh, 3);
+  if (level >= 10)
+    sf->mode_skip_start = VPXMIN(sf->mode_skip_start, 6);
+  if (level >= 11 && !frame_is_intra_only(cm))
+    sf->use_square_partition_only = 1;
+  if (level >= 12)
+    sf->mv.subpel_search_method = VPXMAX(sf->mv.subpel_search_method,
+                                         SUBPEL_TREE_PRUNED_MORE);
+  if (level >= 13)
+    sf->optimize_coefficients = 0;
+  if (level >= 14 && sf->mv.search_method == NSTEP)
+    sf->mv.search_method = BIGDIA;
+  if (level >= 15)
+    sf->adaptive_rd_thresh = VPXMAX(sf->adaptive_rd_thresh, 4);
+  if (level >= 16) {
+    for (i = 0; i < TX_SIZES; ++i) {
+      sf->intra_y_mode_mask[i] = INTRA_DC;
+      sf->intra_uv_mode_mask[i] = INTRA_DC;
+    }
+  }
+  if (level >= 17)
+    sf->simple_model_rd_from_var = 1;
+}
+
+static void set_nonrd_speed_steps(SPEED_FEATURES *sf, int level) {
+  if (level >= 1)
+    sf->mv.reduce_first_step_size = 1;
+  if (level >= 2 && sf->partition_search_type == REFERENCE_PARTITION) {
+    sf->partition_search_type = VAR_BASED_PARTITION;
+    sf->skip_encode_sb = 0;
+  }
+  if (level >= 3)
+    sf->adaptive_rd_thresh = VPXMAX(sf->adaptive_rd_thresh, 3);
+  if (level >= 4 && sf->mv.search_method != FAST_DIAMOND) {
+    sf->mv.search_method = FAST_DIAMOND;
+    sf->mv.fullpel_search_step_param =
+        VPXMAX(sf->mv.fullpel_search_step_param, 10);
+  }
+  if (level >= 5)
+    sf->adaptive_rd_thresh = VPXMAX(sf->adaptive_rd_thresh, 4);
+  if (level >= 6)
+    sf->mv.subpel_force_stop = VPXMAX(sf->mv.subpel_force_stop, 2);
+}
+
+static void set_speed_tuner_steps(VP9_COMP *cpi, SPEED_FEATURES *sf) {
+  SPEED_TUNER *const st = &cpi->speed_tuner;
+
+  st->max_level = sf->use_nonrd_pick_mode ? NONRD_SPEED_STEPS
+                                          : RD_SPEED_STEPS;
+  st->level = VPXMIN(st->level, st->max_level);
+  if (sf->use_nonrd_pick_mode)
+    set_nonrd_speed_steps(sf, st->level);
+  else
+    set_rd_speed_steps(cpi, sf, st->level);
+}
+
+// Frames to wait after a level change, before the next one. Giving quality
+// back is slower, to avoid oscillating around the target.
+#define SPEED_TUNER_HOLD_UP   2
+#define SPEED_TUNER_HOLD_DOWN 8
+
+void vp9_speed_tuner_update(VP9_COMP *cpi, int64_t time) {
+  const VP9_COMMON *const cm = &cpi->common;
+  SPEED_TUNER *const st = &cpi->speed_tuner;
+  const int64_t target = cpi->oxcf.target_frame_time;
+
+  // A hidden alt-ref counts against the time of the next shown frame.
+  st->pending_frame_time += time;
+  if (!cm->show_frame)
+    return;
+  time = st->pending_frame_time;
+  st->pending_frame_time = 0;
+
+  st->last_frame_time = time;
+  if (time > target)
+    ++st->frames_over_target;
+
+  // Intra only frames are much slower than the others and do not tell how
+  // fast the next ones will be.
+  if (frame_is_intra_only(cm))
+    return;
+
+  st->avg_frame_time = st->avg_frame_time == 0 ? time :
+      (3 * st->avg_frame_time + time + 2) >> 2;
+
+  if (st->hold > 0) {
+    --st->hold;
+  } else if (st->avg_frame_time > target) {
+    if (st->level < st->max_level) {
+      ++st->level;
+      st->hold = SPEED_TUNER_HOLD_UP;
+    }
+  } else if (4 * st->avg_frame_time < 3 * target) {
+    if (st->level > 0) {
+      --st->level;
+      st->hold = SPEED_TUNER_HOLD_DOWN;
+    }
+  }
+}
+
 void vp9_set_speed_features_framesize_dependent(VP9_COMP *cpi) {
   SPEED_FEATURES *const sf = &cpi->sf;
   const VP9EncoderConfig *const oxcf = &cpi->oxcf;
@@ -495,6 +638,7 @@ void vp9_set_speed_features_framesize_independent(VP9_COMP *cpi) {
   sf->coeff_prob_appx_step = 1;
   sf->mv.auto_mv_step_size = 0;
   sf->mv.fullpel_search_step_param = 6;
+  sf->mv.use_lookahead_pyramid = 0;
   sf->comp_inter_joint_search_thresh = BLOCK_4X4;
   sf->tx_size_search_method = USE_FULL_RD;
   sf->use_lp32x32fdct = 0;
@@ -565,6 +709,9 @@ void vp9_set_speed_features_framesize_independent(VP9_COMP *cpi) {
   else if (oxcf->mode == GOOD)
     set_good_speed_feature(cpi, cm, sf, oxcf->speed);
 
+  if (oxcf->target_frame_time > 0 && oxcf->pass != 1)
+    set_speed_tuner_steps(cpi, sf);
+
   cpi->full_search_sad = vp9_full_search_sad;
   cpi->diamond_search_sad = vp9_diamond_search_sad;
 
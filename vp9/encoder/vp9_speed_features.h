@@ -11,6 +11,8 @@
 #ifndef VP9_ENCODER_VP9_SPEED_FEATURES_H_
 #define VP9_ENCODER_VP9_SPEED_FEATURES_H_
 
+#include "vpx/vpx_integer.h"
+
 #include "vp9/common/vp9_enums.h"
 
 #ifdef __cplusplus
@@ -109,6 +111,8 @@ typedef enum {
   LPF_PICK_FROM_FULL_IMAGE,
   // Try a small portion of the image with different values.
   LPF_PICK_FROM_SUBIMAGE,
+  // Try a sample of the superblock rows with different values.
+  LPF_PICK_FROM_SB_ROWS,
   // Estimate the level based on quantizer and frame type
   LPF_PICK_FROM_Q,
   // Pick 0 to disable LPF if LPF was enabled last frame
@@ -197,6 +201,11 @@ typedef struct MV_SPEED_FEATURES {
 
   // This variable sets the step_param used in full pel motion search.
   int fullpel_search_step_param;
+
+  // Build the 1/2 and 1/4 resolution pyramid of the lookahead frames, and
+  // start the temporal filter motion search from a coarse to fine search of
+  // it rather than from a full range search at full resolution.
+  int use_lookahead_pyramid;
 } MV_SPEED_FEATURES;
 
 #define MAX_MESH_STEP 4
@@ -448,11 +457,33 @@ typedef struct SPEED_FEATURES {
   int short_circuit_flat_blocks;
 } SPEED_FEATURES;
 
+// Holds the encode time of the frames to a target by applying individual
+// speed features on top of the ones of the speed setting.
+typedef struct SPEED_TUNER {
+  // The number of speed steps applied, and available for the current mode
+  // search.
+  int level;
+  int max_level;
+  // Frames to wait for the running average to follow a level change.
+  int hold;
+  // Encode time of the frames in progress, last shown frame and running
+  // average, in microseconds.
+  int64_t pending_frame_time;
+  int64_t last_frame_time;
+  int64_t avg_frame_time;
+  unsigned int frames_over_target;
+} SPEED_TUNER;
+
 struct VP9_COMP;
 
 void vp9_set_speed_features_framesize_independent(struct VP9_COMP *cpi);
 void vp9_set_speed_features_framesize_dependent(struct VP9_COMP *cpi);
 
+// Accounts the time spent to encode a frame, or a part of a frame, against
+// the target frame time and adjusts the speed steps applied to the next
+// frames.
+void vp9_speed_tuner_update(struct VP9_COMP *cpi, int64_t time);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
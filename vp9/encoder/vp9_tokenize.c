@@ -334,21 +334,20 @@ static void set_entropy_context_b(int plane, int block, BLOCK_SIZE plane_bsize,
                    aoff, loff);
 }
 
-static INLINE void add_token(TOKENEXTRA **t, const vpx_prob *context_tree,
+static INLINE void add_token(TOKENEXTRA **t, int context,
                              int16_t token, EXTRABIT extra,
                              unsigned int *counts) {
-  (*t)->context_tree = context_tree;
+  (*t)->context = context;
   (*t)->token = token;
   (*t)->extra = extra;
   (*t)++;
   ++counts[token];
 }
 
-static INLINE void add_token_no_extra(TOKENEXTRA **t,
-                                      const vpx_prob *context_tree,
+static INLINE void add_token_no_extra(TOKENEXTRA **t, int context,
                                       int16_t token,
                                       unsigned int *counts) {
-  (*t)->context_tree = context_tree;
+  (*t)->context = context;
   (*t)->token = token;
   (*t)++;
   ++counts[token];
@@ -384,8 +383,8 @@ static void tokenize_b(int plane, int block, BLOCK_SIZE plane_bsize,
   const int ref = is_inter_block(mi);
   unsigned int (*const counts)[COEFF_CONTEXTS][ENTROPY_TOKENS] =
       td->rd_counts.coef_counts[tx_size][type][ref];
-  vpx_prob (*const coef_probs)[COEFF_CONTEXTS][UNCONSTRAINED_NODES] =
-      cpi->common.fc->coef_probs[tx_size][type][ref];
+  // The token contexts of this block are context + band * COEFF_CONTEXTS + pt.
+  const int context = vp9_get_coef_context(tx_size, type, ref, 0, 0);
   unsigned int (*const eob_branch)[COEFF_CONTEXTS] =
       td->counts->eob_branch[tx_size][type][ref];
   const uint8_t *const band = get_band_translate(tx_size);
@@ -408,8 +407,8 @@ static void tokenize_b(int plane, int block, BLOCK_SIZE plane_bsize,
     ++eob_branch[band[c]][pt];
 
     while (!v) {
-      add_token_no_extra(&t, coef_probs[band[c]][pt], ZERO_TOKEN,
-                         counts[band[c]][pt]);
+      add_token_no_extra(&t, context + band[c] * COEFF_CONTEXTS + pt,
+                         ZERO_TOKEN, counts[band[c]][pt]);
 
       token_cache[scan[c]] = 0;
       ++c;
@@ -419,7 +418,7 @@ static void tokenize_b(int plane, int block, BLOCK_SIZE plane_bsize,
 
     vp9_get_token_extra(v, &token, &extra);
 
-    add_token(&t, coef_probs[band[c]][pt], token, extra,
+    add_token(&t, context + band[c] * COEFF_CONTEXTS + pt, token, extra,
               counts[band[c]][pt]);
 
     token_cache[scan[c]] = vp9_pt_energy_class[token];
@@ -428,8 +427,8 @@ static void tokenize_b(int plane, int block, BLOCK_SIZE plane_bsize,
   }
   if (c < seg_eob) {
     ++eob_branch[band[c]][pt];
-    add_token_no_extra(&t, coef_probs[band[c]][pt], EOB_TOKEN,
-                       counts[band[c]][pt]);
+    add_token_no_extra(&t, context + band[c] * COEFF_CONTEXTS + pt,
+                       EOB_TOKEN, counts[band[c]][pt]);
   }
 
   *tp = t;
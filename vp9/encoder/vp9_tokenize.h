@@ -34,9 +34,12 @@ typedef struct {
   EXTRABIT extra;
 } TOKENVALUE;
 
+// 'context' indexes the model probabilities of the token in the flattened
+// fc->coef_probs, see vp9_get_coef_context(). It is an index rather than a
+// pointer to keep the frame's token buffer small.
 typedef struct {
-  const vpx_prob *context_tree;
-  int16_t token;
+  uint16_t context;
+  uint8_t token;
   EXTRABIT extra;
 } TOKENEXTRA;
 
@@ -49,6 +52,14 @@ extern const vpx_tree_index vp9_coef_tree[];
 extern const vpx_tree_index vp9_coef_con_tree[];
 extern const struct vp9_token vp9_coef_encodings[];
 
+// Returns the index of fc->coef_probs[tx_size][type][ref][band][ctx] among
+// the UNCONSTRAINED_NODES sized probability sets of fc->coef_probs.
+static INLINE int vp9_get_coef_context(TX_SIZE tx_size, PLANE_TYPE type,
+                                       int ref, int band, int ctx) {
+  return (((tx_size * PLANE_TYPES + type) * REF_TYPES + ref) * COEF_BANDS +
+          band) * COEFF_CONTEXTS + ctx;
+}
+
 int vp9_is_skippable_in_plane(MACROBLOCK *x, BLOCK_SIZE bsize, int plane);
 int vp9_has_high_freq_in_plane(MACROBLOCK *x, BLOCK_SIZE bsize, int plane);
 
@@ -0,0 +1,259 @@
+/*
+ *  Copyright (c) 2016 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>  // AVX2
+#include <string.h>
+
+#include "./vpx_config.h"
+#include "./vp9_rtcd.h"
+
+#include "vpx/vpx_integer.h"
+#include "vpx_ports/mem.h"
+#include "vp9/common/vp9_reconinter.h"
+#include "vp9/encoder/vp9_context_tree.h"
+#include "vp9/encoder/vp9_denoiser.h"
+
+// The filter works on 32 pixels at a time: one row segment of 32 or 64 wide
+// blocks, two rows of 16 wide blocks or four rows of 8 wide blocks. 4 wide
+// blocks are packed into a 32 wide buffer first.
+//
+// The adjustments are summed with _mm256_sad_epu8 into 64 bit lanes, so the
+// total matches the C code exactly for every block size.
+
+#define MAX_SMALL_BLOCK_PIXELS (4 * 8)
+
+static INLINE __m256i load_32(const uint8_t *p, int stride, int width) {
+  if (width == 8) {
+    const __m128i r01 = _mm_unpacklo_epi64(
+        _mm_loadl_epi64((const __m128i *)p),
+        _mm_loadl_epi64((const __m128i *)(p + stride)));
+    const __m128i r23 = _mm_unpacklo_epi64(
+        _mm_loadl_epi64((const __m128i *)(p + 2 * stride)),
+        _mm_loadl_epi64((const __m128i *)(p + 3 * stride)));
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(r01), r23, 1);
+  }
+  if (width == 16) {
+    return _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)p)),
+        _mm_loadu_si128((const __m128i *)(p + stride)), 1);
+  }
+  return _mm256_loadu_si256((const __m256i *)p);
+}
+
+static INLINE void store_32(uint8_t *p, int stride, int width, __m256i v) {
+  if (width == 8) {
+    const __m128i r01 = _mm256_castsi256_si128(v);
+    const __m128i r23 = _mm256_extracti128_si256(v, 1);
+    _mm_storel_epi64((__m128i *)p, r01);
+    _mm_storel_epi64((__m128i *)(p + stride), _mm_srli_si128(r01, 8));
+    _mm_storel_epi64((__m128i *)(p + 2 * stride), r23);
+    _mm_storel_epi64((__m128i *)(p + 3 * stride), _mm_srli_si128(r23, 8));
+  } else if (width == 16) {
+    _mm_storeu_si128((__m128i *)p, _mm256_castsi256_si128(v));
+    _mm_storeu_si128((__m128i *)(p + stride), _mm256_extracti128_si256(v, 1));
+  } else {
+    _mm256_storeu_si256((__m256i *)p, v);
+  }
+}
+
+// Returns the sum of the positive minus the sum of the negative adjustments.
+static INLINE int get_sum_diff(__m256i pos_sum, __m256i neg_sum) {
+  const __m256i diff = _mm256_sub_epi64(pos_sum, neg_sum);
+  const __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(diff),
+                                    _mm256_extracti128_si256(diff, 1));
+  return _mm_cvtsi128_si32(sum) + _mm_cvtsi128_si32(_mm_srli_si128(sum, 8));
+}
+
+// Denoises 32 pixels with the strong filter.
+static INLINE __m256i denoiser_32_avx2(__m256i sig, __m256i mc_avg,
+                                       __m256i k_4, __m256i l3,
+                                       __m256i *pos_sum, __m256i *neg_sum) {
+  const __m256i k_0 = _mm256_setzero_si256();
+  const __m256i k_8 = _mm256_set1_epi8(8);
+  const __m256i k_16 = _mm256_set1_epi8(16);
+  // Difference between level 3 and level 2 is 2.
+  const __m256i l32 = _mm256_set1_epi8(2);
+  // Difference between level 2 and level 1 is 1.
+  const __m256i l21 = _mm256_set1_epi8(1);
+  const __m256i pdiff = _mm256_subs_epu8(mc_avg, sig);
+  const __m256i ndiff = _mm256_subs_epu8(sig, mc_avg);
+  // Obtain the sign. FF if diff is negative.
+  const __m256i diff_sign = _mm256_cmpeq_epi8(pdiff, k_0);
+  // Clamp absolute difference to 16 to be used to get mask. Doing this
+  // allows us to use _mm256_cmpgt_epi8, which operates on signed byte.
+  const __m256i clamped_absdiff =
+      _mm256_min_epu8(_mm256_or_si256(pdiff, ndiff), k_16);
+  // Get masks for l2 l1 and l0 adjustments.
+  const __m256i mask2 = _mm256_cmpgt_epi8(k_16, clamped_absdiff);
+  const __m256i mask1 = _mm256_cmpgt_epi8(k_8, clamped_absdiff);
+  const __m256i mask0 = _mm256_cmpgt_epi8(k_4, clamped_absdiff);
+  // Get adjustments for l2, l1, and l0.
+  const __m256i adj2 = _mm256_and_si256(mask2, l32);
+  const __m256i adj1 = _mm256_and_si256(mask1, l21);
+  const __m256i adj0 = _mm256_and_si256(mask0, clamped_absdiff);
+  __m256i adj, padj, nadj;
+
+  // Combine the adjustments and get absolute adjustments.
+  adj = _mm256_sub_epi8(l3, _mm256_add_epi8(adj2, adj1));
+  adj = _mm256_andnot_si256(mask0, adj);
+  adj = _mm256_or_si256(adj, adj0);
+
+  // Restore the sign and get positive and negative adjustments.
+  padj = _mm256_andnot_si256(diff_sign, adj);
+  nadj = _mm256_and_si256(diff_sign, adj);
+  *pos_sum = _mm256_add_epi64(*pos_sum, _mm256_sad_epu8(padj, k_0));
+  *neg_sum = _mm256_add_epi64(*neg_sum, _mm256_sad_epu8(nadj, k_0));
+
+  // Calculate filtered value.
+  return _mm256_subs_epu8(_mm256_adds_epu8(sig, padj), nadj);
+}
+
+// Moves 32 denoised pixels back towards the source by at most k_delta.
+static INLINE __m256i denoiser_adj_32_avx2(__m256i sig, __m256i mc_avg,
+                                           __m256i avg, __m256i k_delta,
+                                           __m256i *pos_sum,
+                                           __m256i *neg_sum) {
+  const __m256i k_0 = _mm256_setzero_si256();
+  const __m256i pdiff = _mm256_subs_epu8(mc_avg, sig);
+  const __m256i ndiff = _mm256_subs_epu8(sig, mc_avg);
+  // Obtain the sign. FF if diff is negative.
+  const __m256i diff_sign = _mm256_cmpeq_epi8(pdiff, k_0);
+  // Clamp absolute difference to delta to get the adjustment.
+  const __m256i adj = _mm256_min_epu8(_mm256_or_si256(pdiff, ndiff), k_delta);
+  // Restore the sign and get positive and negative adjustments.
+  const __m256i padj = _mm256_andnot_si256(diff_sign, adj);
+  const __m256i nadj = _mm256_and_si256(diff_sign, adj);
+  *pos_sum = _mm256_add_epi64(*pos_sum, _mm256_sad_epu8(nadj, k_0));
+  *neg_sum = _mm256_add_epi64(*neg_sum, _mm256_sad_epu8(padj, k_0));
+
+  // Calculate filtered value.
+  return _mm256_adds_epu8(_mm256_subs_epu8(avg, padj), nadj);
+}
+
+// Denoiser for blocks of width 8, 16, 32 or 64.
+static int denoiser_NxM_avx2(const uint8_t *sig, int sig_stride,
+                             const uint8_t *mc_avg, int mc_avg_stride,
+                             uint8_t *avg, int avg_stride,
+                             int width, int height,
+                             int increase_denoising, BLOCK_SIZE bs,
+                             int motion_magnitude) {
+  const int shift_inc = (increase_denoising &&
+                         motion_magnitude <= MOTION_MAGNITUDE_THRESHOLD) ?
+                        1 : 0;
+  const __m256i k_4 = _mm256_set1_epi8(4 + shift_inc);
+  // Modify each level's adjustment according to motion_magnitude.
+  const __m256i l3 = _mm256_set1_epi8(
+      (motion_magnitude <= MOTION_MAGNITUDE_THRESHOLD) ? 7 + shift_inc : 6);
+  const int row_step = (width < 32) ? 32 / width : 1;
+  const int sum_diff_thresh = total_adj_strong_thresh(bs, increase_denoising);
+  __m256i pos_sum = _mm256_setzero_si256();
+  __m256i neg_sum = _mm256_setzero_si256();
+  int r, c, sum_diff, delta;
+
+  for (r = 0; r < height; r += row_step) {
+    for (c = 0; c < width; c += 32) {
+      const __m256i v_sig = load_32(sig + c, sig_stride, width);
+      const __m256i v_mc_avg = load_32(mc_avg + c, mc_avg_stride, width);
+      store_32(avg + c, avg_stride, width,
+               denoiser_32_avx2(v_sig, v_mc_avg, k_4, l3, &pos_sum, &neg_sum));
+    }
+    sig += sig_stride * row_step;
+    mc_avg += mc_avg_stride * row_step;
+    avg += avg_stride * row_step;
+  }
+
+  sum_diff = get_sum_diff(pos_sum, neg_sum);
+  if (abs(sum_diff) <= sum_diff_thresh)
+    return FILTER_BLOCK;
+
+  // Before returning to copy the block (i.e., apply no denoising), check if
+  // we can still apply some (weaker) temporal filtering to this block. The
+  // delta is set by the excess of absolute pixel diff over the threshold.
+  delta = ((abs(sum_diff) - sum_diff_thresh) >> num_pels_log2_lookup[bs]) + 1;
+  // Only apply the adjustment for max delta up to 3.
+  if (delta >= 4)
+    return COPY_BLOCK;
+
+  {
+    const __m256i k_delta = _mm256_set1_epi8(delta);
+    sig -= sig_stride * height;
+    mc_avg -= mc_avg_stride * height;
+    avg -= avg_stride * height;
+    for (r = 0; r < height; r += row_step) {
+      for (c = 0; c < width; c += 32) {
+        const __m256i v_sig = load_32(sig + c, sig_stride, width);
+        const __m256i v_mc_avg = load_32(mc_avg + c, mc_avg_stride, width);
+        const __m256i v_avg = load_32(avg + c, avg_stride, width);
+        store_32(avg + c, avg_stride, width,
+                 denoiser_adj_32_avx2(v_sig, v_mc_avg, v_avg, k_delta,
+                                      &pos_sum, &neg_sum));
+      }
+      sig += sig_stride * row_step;
+      mc_avg += mc_avg_stride * row_step;
+      avg += avg_stride * row_step;
+    }
+  }
+
+  sum_diff = get_sum_diff(pos_sum, neg_sum);
+  return abs(sum_diff) <= sum_diff_thresh ? FILTER_BLOCK : COPY_BLOCK;
+}
+
+// Denoiser for 4xM blocks. The rows are packed into a contiguous buffer,
+// padded with zeros to 32 pixels, which the filter sees as a 32x1 block. The
+// zero padding makes no adjustment.
+static int denoiser_4xM_avx2(const uint8_t *sig, int sig_stride,
+                               const uint8_t *mc_avg, int mc_avg_stride,
+                               uint8_t *avg, int avg_stride,
+                               int width, int height,
+                               int increase_denoising, BLOCK_SIZE bs,
+                               int motion_magnitude) {
+  DECLARE_ALIGNED(32, uint8_t, sig_buf[MAX_SMALL_BLOCK_PIXELS]);
+  DECLARE_ALIGNED(32, uint8_t, mc_avg_buf[MAX_SMALL_BLOCK_PIXELS]);
+  DECLARE_ALIGNED(32, uint8_t, avg_buf[MAX_SMALL_BLOCK_PIXELS]);
+  const int num_pels = width * height;
+  int r, decision;
+
+  for (r = 0; r < height; ++r) {
+    memcpy(sig_buf + r * width, sig + r * sig_stride, width);
+    memcpy(mc_avg_buf + r * width, mc_avg + r * mc_avg_stride, width);
+  }
+  memset(sig_buf + num_pels, 0, MAX_SMALL_BLOCK_PIXELS - num_pels);
+  memset(mc_avg_buf + num_pels, 0, MAX_SMALL_BLOCK_PIXELS - num_pels);
+
+  decision = denoiser_NxM_avx2(sig_buf, 32, mc_avg_buf, 32, avg_buf, 32,
+                               32, 1, increase_denoising, bs,
+                               motion_magnitude);
+
+  for (r = 0; r < height; ++r)
+    memcpy(avg + r * avg_stride, avg_buf + r * width, width);
+  return decision;
+}
+
+int vp9_denoiser_filter_avx2(const uint8_t *sig, int sig_stride,
+                             const uint8_t *mc_avg,
+                             int mc_avg_stride,
+                             uint8_t *avg, int avg_stride,
+                             int increase_denoising,
+                             BLOCK_SIZE bs,
+                             int motion_magnitude) {
+  const int width = 4 << b_width_log2_lookup[bs];
+  const int height = 4 << b_height_log2_lookup[bs];
+
+  if (bs >= BLOCK_SIZES)
+    return COPY_BLOCK;
+  if (width == 4) {
+    return denoiser_4xM_avx2(sig, sig_stride, mc_avg, mc_avg_stride,
+                               avg, avg_stride, width, height,
+                               increase_denoising, bs, motion_magnitude);
+  }
+  return denoiser_NxM_avx2(sig, sig_stride, mc_avg, mc_avg_stride,
+                           avg, avg_stride, width, height,
+                           increase_denoising, bs, motion_magnitude);
+}
@@ -0,0 +1,196 @@
+/*
+ *  Copyright (c) 2016 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>  // AVX2
+#include <string.h>
+
+#include "./vp9_rtcd.h"
+#include "vpx/vpx_integer.h"
+#include "vpx_ports/mem.h"
+
+// The filter weighs every pixel with the sum of the squared differences of
+// its 3x3 neighbourhood, clipped to the block:
+//   modifier = min(16, (3 * sum / n + rounding) >> strength)
+// where n is the number of neighbours, 4 in the corners, 6 on the edges and 9
+// inside. The sums are computed with 16 bit saturating adds and capped at
+// MAX_SUM: above it the modifier is 16 for any strength <= MAX_STRENGTH, so
+// 3 * sum / n can be computed with a 16 bit multiply-high:
+//   n = 9: sum * 0x5556 >> 16, exact for sum <= 16383
+//   n = 6: sum * 0x8000 >> 16
+//   n = 4: sum * 0xc000 >> 16
+#define MUL_9 ((int16_t)0x5556)
+#define MUL_6 ((int16_t)0x8000)
+#define MUL_4 ((int16_t)0xc000)
+#define MAX_SUM 16383
+#define MAX_STRENGTH 8
+#define MAX_WIDTH 16
+#define MAX_HEIGHT 16
+
+// Squared differences, with a zero border of one pixel.
+typedef uint16_t SqDiffBuffer[MAX_HEIGHT + 2][MAX_WIDTH + 2];
+// Horizontal sums of 3 squared differences, with a zero row above and below.
+typedef uint16_t RowSumBuffer[MAX_HEIGHT + 2][MAX_WIDTH];
+
+static INLINE __m128i load_sq_diff_8(const uint8_t *a, const uint8_t *b) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i a_16 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)a),
+                                         zero);
+  const __m128i b_16 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)b),
+                                         zero);
+  const __m128i diff = _mm_sub_epi16(a_16, b_16);
+  return _mm_mullo_epi16(diff, diff);
+}
+
+// Computes the squared differences of the block and the sums of 3 horizontal
+// neighbours: hsum[i + 1][j] = sq[i][j] + sq[i][j + 1] + sq[i][j + 2], where
+// sq[i][j + 1] is the squared difference of the pixel at (i, j).
+static INLINE void get_sq_diff_row_sums(const uint8_t *frame1,
+                                        unsigned int stride,
+                                        const uint8_t *frame2,
+                                        unsigned int block_width,
+                                        unsigned int block_height,
+                                        SqDiffBuffer sq, RowSumBuffer hsum) {
+  unsigned int i, j;
+
+  for (i = 0; i < block_height; ++i) {
+    for (j = 0; j < block_width; j += 8) {
+      _mm_storeu_si128((__m128i *)&sq[i][j + 1],
+                       load_sq_diff_8(frame1 + j, frame2 + j));
+    }
+    sq[i][0] = 0;
+    sq[i][block_width + 1] = 0;
+    frame1 += stride;
+    frame2 += block_width;
+  }
+
+  for (i = 0; i < block_height; ++i) {
+    for (j = 0; j < block_width; j += 8) {
+      const __m128i left = _mm_loadu_si128((const __m128i *)&sq[i][j]);
+      const __m128i mid = _mm_loadu_si128((const __m128i *)&sq[i][j + 1]);
+      const __m128i right = _mm_loadu_si128((const __m128i *)&sq[i][j + 2]);
+      _mm_store_si128((__m128i *)&hsum[i + 1][j],
+                       _mm_adds_epu16(_mm_adds_epu16(left, mid), right));
+    }
+  }
+  memset(hsum[0], 0, sizeof(hsum[0]));
+  memset(hsum[block_height + 1], 0, sizeof(hsum[0]));
+}
+
+// Adds the modifiers of 16 pixels to the count and accumulator.
+static INLINE void accumulate_16(__m256i modifier, __m256i pixels,
+                                 unsigned int *accumulator, uint16_t *count) {
+  const __m256i weighted = _mm256_mullo_epi16(modifier, pixels);
+  const __m256i acc_lo = _mm256_loadu_si256((const __m256i *)accumulator);
+  const __m256i acc_hi = _mm256_loadu_si256((const __m256i *)
+                                            (accumulator + 8));
+  const __m256i cnt = _mm256_loadu_si256((const __m256i *)count);
+
+  _mm256_storeu_si256((__m256i *)count, _mm256_add_epi16(cnt, modifier));
+  _mm256_storeu_si256((__m256i *)accumulator,
+      _mm256_add_epi32(acc_lo, _mm256_cvtepu16_epi32(
+          _mm256_castsi256_si128(weighted))));
+  _mm256_storeu_si256((__m256i *)(accumulator + 8),
+      _mm256_add_epi32(acc_hi, _mm256_cvtepu16_epi32(
+          _mm256_extracti128_si256(weighted, 1))));
+}
+
+static INLINE __m256i get_modifier(__m256i sum, __m256i mul,
+                                   __m256i rounding, __m128i shift,
+                                   __m256i weight) {
+  const __m256i sixteen = _mm256_set1_epi16(16);
+  __m256i modifier;
+
+  sum = _mm256_min_epu16(sum, _mm256_set1_epi16(MAX_SUM));
+  modifier = _mm256_mulhi_epu16(sum, mul);
+  modifier = _mm256_srl_epi16(_mm256_adds_epu16(modifier, rounding), shift);
+  modifier = _mm256_min_epu16(modifier, sixteen);
+  return _mm256_mullo_epi16(_mm256_sub_epi16(sixteen, modifier), weight);
+}
+
+void vp9_temporal_filter_apply_avx2(uint8_t *frame1,
+                                    unsigned int stride,
+                                    uint8_t *frame2,
+                                    unsigned int block_width,
+                                    unsigned int block_height,
+                                    int strength,
+                                    int filter_weight,
+                                    unsigned int *accumulator,
+                                    uint16_t *count) {
+  DECLARE_ALIGNED(32, SqDiffBuffer, sq);
+  DECLARE_ALIGNED(32, RowSumBuffer, hsum);
+  const __m256i rounding =
+      _mm256_set1_epi16(strength > 0 ? 1 << (strength - 1) : 0);
+  const __m128i shift = _mm_cvtsi32_si128(strength);
+  const __m256i weight = _mm256_set1_epi16(filter_weight);
+  unsigned int i;
+
+  if ((block_width != 16 && block_width != 8) || block_height < 2 ||
+      block_height > MAX_HEIGHT || (block_width == 8 && (block_height & 1)) ||
+      strength > MAX_STRENGTH) {
+    vp9_temporal_filter_apply_c(frame1, stride, frame2, block_width,
+                                block_height, strength, filter_weight,
+                                accumulator, count);
+    return;
+  }
+
+  get_sq_diff_row_sums(frame1, stride, frame2, block_width, block_height,
+                       sq, hsum);
+
+  if (block_width == 16) {
+    // Multipliers of the first and last rows, and of the other rows.
+    const __m256i mul_edge = _mm256_setr_epi16(
+        MUL_4, MUL_6, MUL_6, MUL_6, MUL_6, MUL_6, MUL_6, MUL_6,
+        MUL_6, MUL_6, MUL_6, MUL_6, MUL_6, MUL_6, MUL_6, MUL_4);
+    const __m256i mul_mid = _mm256_setr_epi16(
+        MUL_6, MUL_9, MUL_9, MUL_9, MUL_9, MUL_9, MUL_9, MUL_9,
+        MUL_9, MUL_9, MUL_9, MUL_9, MUL_9, MUL_9, MUL_9, MUL_6);
+
+    for (i = 0; i < block_height; ++i) {
+      const __m256i mul = (i == 0 || i == block_height - 1) ? mul_edge
+                                                             : mul_mid;
+      const __m256i sum = _mm256_adds_epu16(
+          _mm256_adds_epu16(_mm256_load_si256((const __m256i *)hsum[i]),
+                            _mm256_load_si256((const __m256i *)hsum[i + 1])),
+          _mm256_load_si256((const __m256i *)hsum[i + 2]));
+      const __m256i pixels = _mm256_cvtepu8_epi16(
+          _mm_loadu_si128((const __m128i *)(frame2 + i * 16)));
+
+      accumulate_16(get_modifier(sum, mul, rounding, shift, weight), pixels,
+                    accumulator + i * 16, count + i * 16);
+    }
+  } else {
+    // Two rows of 8 pixels at a time.
+    const __m128i mul_edge_8 = _mm_setr_epi16(
+        MUL_4, MUL_6, MUL_6, MUL_6, MUL_6, MUL_6, MUL_6, MUL_4);
+    const __m128i mul_mid_8 = _mm_setr_epi16(
+        MUL_6, MUL_9, MUL_9, MUL_9, MUL_9, MUL_9, MUL_9, MUL_6);
+    for (i = 0; i < block_height; i += 2) {
+      const __m128i mul0 = (i == 0) ? mul_edge_8 : mul_mid_8;
+      const __m128i mul1 = (i + 2 == block_height) ? mul_edge_8 : mul_mid_8;
+      const __m128i hsum1 = _mm_load_si128((const __m128i *)hsum[i + 1]);
+      const __m128i hsum2 = _mm_load_si128((const __m128i *)hsum[i + 2]);
+      const __m128i sum0 = _mm_adds_epu16(
+          _mm_adds_epu16(_mm_load_si128((const __m128i *)hsum[i]), hsum1),
+          hsum2);
+      const __m128i sum1 = _mm_adds_epu16(
+          _mm_adds_epu16(hsum1, hsum2),
+          _mm_load_si128((const __m128i *)hsum[i + 3]));
+      const __m256i sum = _mm256_inserti128_si256(
+          _mm256_castsi128_si256(sum0), sum1, 1);
+      const __m256i mul = _mm256_inserti128_si256(
+          _mm256_castsi128_si256(mul0), mul1, 1);
+      const __m256i pixels = _mm256_cvtepu8_epi16(
+          _mm_loadu_si128((const __m128i *)(frame2 + i * 8)));
+
+      accumulate_16(get_modifier(sum, mul, rounding, shift, weight), pixels,
+                    accumulator + i * 8, count + i * 8);
+    }
+  }
+}
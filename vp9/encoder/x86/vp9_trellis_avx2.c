@@ -0,0 +1,80 @@
+/*
+ *  Copyright (c) 2016 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>  // AVX2
+
+#include "./vp9_rtcd.h"
+#include "vpx/vpx_integer.h"
+
+static INLINE __m256i load_tran_low(const tran_low_t *p) {
+#if CONFIG_VP9_HIGHBITDEPTH
+  return _mm256_loadu_si256((const __m256i *)p);
+#else
+  return _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)p));
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+}
+
+static INLINE void store_tran_low(__m256i v, tran_low_t *p) {
+#if CONFIG_VP9_HIGHBITDEPTH
+  _mm256_storeu_si256((__m256i *)p, v);
+#else
+  _mm_storeu_si128((__m128i *)p,
+                   _mm_packs_epi32(_mm256_castsi256_si128(v),
+                                   _mm256_extracti128_si256(v, 1)));
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+}
+
+// Evaluates 8 coefficients at a time in 32-bit lanes. n_coeffs is a multiple
+// of 8.
+void vp9_trellis_candidates_avx2(const tran_low_t *coeff,
+                                 const tran_low_t *qcoeff,
+                                 const tran_low_t *dqcoeff,
+                                 intptr_t n_coeffs, const int16_t *dequant,
+                                 int mul, int shift, int *dist,
+                                 int *dist_down, tran_low_t *qcoeff_down) {
+  const __m256i mul_v = _mm256_set1_epi32(mul);
+  const __m128i shift_v = _mm_cvtsi32_si128(shift);
+  const __m256i one = _mm256_set1_epi32(1);
+  // The first coefficient uses the DC dequantizer.
+  __m256i dq = _mm256_setr_epi32(dequant[0], dequant[1], dequant[1],
+                                 dequant[1], dequant[1], dequant[1],
+                                 dequant[1], dequant[1]);
+  intptr_t i;
+
+  for (i = 0; i < n_coeffs; i += 8) {
+    const __m256i c = load_tran_low(coeff + i);
+    const __m256i x = load_tran_low(qcoeff + i);
+    const __m256i dqc = load_tran_low(dqcoeff + i);
+    const __m256i dx = _mm256_sra_epi32(
+        _mm256_mullo_epi32(mul_v, _mm256_sub_epi32(dqc, c)), shift_v);
+    const __m256i d2 = _mm256_mullo_epi32(dx, dx);
+
+    const __m256i abs_x_dq = _mm256_mullo_epi32(_mm256_abs_epi32(x), dq);
+    const __m256i abs_c_mul = _mm256_mullo_epi32(_mm256_abs_epi32(c), mul_v);
+    const __m256i down = _mm256_and_si256(
+        _mm256_cmpgt_epi32(abs_x_dq, abs_c_mul),
+        _mm256_cmpgt_epi32(_mm256_add_epi32(abs_c_mul, dq), abs_x_dq));
+
+    const __m256i sz = _mm256_srai_epi32(x, 31);
+    const __m256i step = _mm256_xor_si256(
+        _mm256_add_epi32(_mm256_sra_epi32(dq, shift_v), sz), sz);
+    const __m256i dx_down = _mm256_sub_epi32(dx, step);
+    const __m256i d2_down = _mm256_mullo_epi32(dx_down, dx_down);
+    const __m256i x_down =
+        _mm256_sub_epi32(x, _mm256_add_epi32(_mm256_add_epi32(sz, sz), one));
+
+    _mm256_storeu_si256((__m256i *)(dist + i), d2);
+    _mm256_storeu_si256((__m256i *)(dist_down + i),
+                        _mm256_blendv_epi8(d2, d2_down, down));
+    store_tran_low(_mm256_blendv_epi8(x, x_down, down), qcoeff_down + i);
+
+    dq = _mm256_set1_epi32(dequant[1]);
+  }
+}
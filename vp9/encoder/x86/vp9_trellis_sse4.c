@@ -0,0 +1,76 @@
+/*
+ *  Copyright (c) 2016 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <smmintrin.h>  // SSE4.1
+
+#include "./vp9_rtcd.h"
+#include "vpx/vpx_integer.h"
+
+static INLINE __m128i load_tran_low(const tran_low_t *p) {
+#if CONFIG_VP9_HIGHBITDEPTH
+  return _mm_loadu_si128((const __m128i *)p);
+#else
+  return _mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i *)p));
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+}
+
+static INLINE void store_tran_low(__m128i v, tran_low_t *p) {
+#if CONFIG_VP9_HIGHBITDEPTH
+  _mm_storeu_si128((__m128i *)p, v);
+#else
+  _mm_storel_epi64((__m128i *)p, _mm_packs_epi32(v, v));
+#endif  // CONFIG_VP9_HIGHBITDEPTH
+}
+
+// Evaluates 4 coefficients at a time in 32-bit lanes. n_coeffs is a multiple
+// of 4.
+void vp9_trellis_candidates_sse4_1(const tran_low_t *coeff,
+                                   const tran_low_t *qcoeff,
+                                   const tran_low_t *dqcoeff,
+                                   intptr_t n_coeffs, const int16_t *dequant,
+                                   int mul, int shift, int *dist,
+                                   int *dist_down, tran_low_t *qcoeff_down) {
+  const __m128i mul_v = _mm_set1_epi32(mul);
+  const __m128i shift_v = _mm_cvtsi32_si128(shift);
+  const __m128i one = _mm_set1_epi32(1);
+  // The first coefficient uses the DC dequantizer.
+  __m128i dq = _mm_setr_epi32(dequant[0], dequant[1], dequant[1], dequant[1]);
+  intptr_t i;
+
+  for (i = 0; i < n_coeffs; i += 4) {
+    const __m128i c = load_tran_low(coeff + i);
+    const __m128i x = load_tran_low(qcoeff + i);
+    const __m128i dqc = load_tran_low(dqcoeff + i);
+    const __m128i dx = _mm_sra_epi32(
+        _mm_mullo_epi32(mul_v, _mm_sub_epi32(dqc, c)), shift_v);
+    const __m128i d2 = _mm_mullo_epi32(dx, dx);
+
+    const __m128i abs_x_dq = _mm_mullo_epi32(_mm_abs_epi32(x), dq);
+    const __m128i abs_c_mul = _mm_mullo_epi32(_mm_abs_epi32(c), mul_v);
+    const __m128i down = _mm_and_si128(
+        _mm_cmpgt_epi32(abs_x_dq, abs_c_mul),
+        _mm_cmplt_epi32(abs_x_dq, _mm_add_epi32(abs_c_mul, dq)));
+
+    const __m128i sz = _mm_srai_epi32(x, 31);
+    const __m128i step = _mm_xor_si128(
+        _mm_add_epi32(_mm_sra_epi32(dq, shift_v), sz), sz);
+    const __m128i dx_down = _mm_sub_epi32(dx, step);
+    const __m128i d2_down = _mm_mullo_epi32(dx_down, dx_down);
+    const __m128i x_down =
+        _mm_sub_epi32(x, _mm_add_epi32(_mm_add_epi32(sz, sz), one));
+
+    _mm_storeu_si128((__m128i *)(dist + i), d2);
+    _mm_storeu_si128((__m128i *)(dist_down + i),
+                     _mm_blendv_epi8(d2, d2_down, down));
+    store_tran_low(_mm_blendv_epi8(x, x_down, down), qcoeff_down + i);
+
+    dq = _mm_set1_epi32(dequant[1]);
+  }
+}
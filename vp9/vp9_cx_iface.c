@@ -49,6 +49,8 @@ struct vp9_extracfg {
   vpx_color_range_t           color_range;
   int                         render_width;
   int                         render_height;
+  unsigned int                row_mt;
+  unsigned int                target_frame_time;
 };
 
 static struct vp9_extracfg default_extra_cfg = {
@@ -78,6 +80,8 @@ static struct vp9_extracfg default_extra_cfg = {
   0,                          // color range
   0,                          // render width
   0,                          // render height
+  0,                          // row_mt
+  0,                          // target_frame_time
 };
 
 struct vpx_codec_alg_priv {
@@ -246,6 +250,7 @@ static vpx_codec_err_t validate_config(vpx_codec_alg_priv_t *ctx,
   RANGE_CHECK_HI(extra_cfg, noise_sensitivity, 6);
   RANGE_CHECK(extra_cfg, tile_columns, 0, 6);
   RANGE_CHECK(extra_cfg, tile_rows, 0, 2);
+  RANGE_CHECK_BOOL(extra_cfg, row_mt);
   RANGE_CHECK_HI(extra_cfg, sharpness, 7);
   RANGE_CHECK(extra_cfg, arnr_max_frames, 0, 15);
   RANGE_CHECK_HI(extra_cfg, arnr_strength, 6);
@@ -393,6 +398,8 @@ static vpx_codec_err_t set_encoder_config(
   int sl, tl;
   oxcf->profile = cfg->g_profile;
   oxcf->max_threads = (int)cfg->g_threads;
+  oxcf->row_mt = extra_cfg->row_mt;
+  oxcf->target_frame_time = extra_cfg->target_frame_time;
   oxcf->width   = cfg->g_w;
   oxcf->height  = cfg->g_h;
   oxcf->bit_depth = cfg->g_bit_depth;
@@ -678,6 +685,20 @@ static vpx_codec_err_t ctrl_set_tile_rows(vpx_codec_alg_priv_t *ctx,
   return update_extra_cfg(ctx, &extra_cfg);
 }
 
+static vpx_codec_err_t ctrl_set_row_mt(vpx_codec_alg_priv_t *ctx,
+                                       va_list args) {
+  struct vp9_extracfg extra_cfg = ctx->extra_cfg;
+  extra_cfg.row_mt = CAST(VP9E_SET_ROW_MT, args);
+  return update_extra_cfg(ctx, &extra_cfg);
+}
+
+static vpx_codec_err_t ctrl_set_target_frame_time(vpx_codec_alg_priv_t *ctx,
+                                                  va_list args) {
+  struct vp9_extracfg extra_cfg = ctx->extra_cfg;
+  extra_cfg.target_frame_time = CAST(VP9E_SET_TARGET_FRAME_TIME, args);
+  return update_extra_cfg(ctx, &extra_cfg);
+}
+
 static vpx_codec_err_t ctrl_set_arnr_max_frames(vpx_codec_alg_priv_t *ctx,
                                                 va_list args) {
   struct vp9_extracfg extra_cfg = ctx->extra_cfg;
@@ -1051,7 +1072,8 @@ static vpx_codec_err_t encoder_encode(vpx_codec_alg_priv_t  *ctx,
       // Store the original flags in to the frame buffer. Will extract the
       // key frame flag when we actually encode this frame.
       if (vp9_receive_raw_frame(cpi, flags | ctx->next_frame_flags,
-                                &sd, dst_time_stamp, dst_end_time_stamp)) {
+                                &sd, dst_time_stamp, dst_end_time_stamp,
+                                img->user_priv)) {
         res = update_error_state(ctx, &cpi->common.error);
       }
       ctx->next_frame_flags = 0;
@@ -1395,6 +1417,35 @@ static vpx_codec_err_t ctrl_get_svc_layer_id(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_OK;
 }
 
+static vpx_codec_err_t ctrl_get_frame_time_stats(vpx_codec_alg_priv_t *ctx,
+                                                 va_list args) {
+  vpx_frame_time_stats_t *const data = va_arg(args, vpx_frame_time_stats_t *);
+  const SPEED_TUNER *const st = &ctx->cpi->speed_tuner;
+
+  if (data == NULL)
+    return VPX_CODEC_INVALID_PARAM;
+
+  data->target_frame_time = ctx->cpi->oxcf.target_frame_time;
+  data->last_frame_time = (unsigned int)st->last_frame_time;
+  data->avg_frame_time = (unsigned int)st->avg_frame_time;
+  data->frames_over_target = st->frames_over_target;
+  data->speed_level = st->level;
+  data->max_speed_level = st->max_level;
+  return VPX_CODEC_OK;
+}
+
+static vpx_codec_err_t ctrl_get_thread_sync_stats(vpx_codec_alg_priv_t *ctx,
+                                                  va_list args) {
+  vpx_thread_sync_stats_t *const data =
+      va_arg(args, vpx_thread_sync_stats_t *);
+
+  if (data == NULL)
+    return VPX_CODEC_INVALID_PARAM;
+
+  vp9_enc_sync_get_stats(ctx->cpi, &data->wait_time, &data->wait_count);
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_err_t ctrl_set_svc_parameters(vpx_codec_alg_priv_t *ctx,
                                                va_list args) {
   VP9_COMP *const cpi = ctx->cpi;
@@ -1473,6 +1524,19 @@ static vpx_codec_err_t ctrl_set_render_size(vpx_codec_alg_priv_t *ctx,
   return update_extra_cfg(ctx, &extra_cfg);
 }
 
+static vpx_codec_err_t ctrl_set_source_release_cb(vpx_codec_alg_priv_t *ctx,
+                                                  va_list args) {
+  VP9_COMP *const cpi = ctx->cpi;
+  vpx_source_release_init *init = va_arg(args, vpx_source_release_init *);
+  // The frames in the lookahead must be released with the callback that was
+  // set when they were received.
+  if (cpi->lookahead != NULL)
+    return VPX_CODEC_ERROR;
+  cpi->release_source_cb = init ? init->release_cb : NULL;
+  cpi->release_source_state = init ? init->release_state : NULL;
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   {VP8_COPY_REFERENCE,                ctrl_copy_reference},
 
@@ -1488,6 +1552,7 @@ static vpx_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   {VP8E_SET_STATIC_THRESHOLD,         ctrl_set_static_thresh},
   {VP9E_SET_TILE_COLUMNS,             ctrl_set_tile_columns},
   {VP9E_SET_TILE_ROWS,                ctrl_set_tile_rows},
+  {VP9E_SET_ROW_MT,                   ctrl_set_row_mt},
   {VP8E_SET_ARNR_MAXFRAMES,           ctrl_set_arnr_max_frames},
   {VP8E_SET_ARNR_STRENGTH,            ctrl_set_arnr_strength},
   {VP8E_SET_ARNR_TYPE,                ctrl_set_arnr_type},
@@ -1512,6 +1577,8 @@ static vpx_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   {VP9E_SET_MAX_GF_INTERVAL,          ctrl_set_max_gf_interval},
   {VP9E_SET_SVC_REF_FRAME_CONFIG,     ctrl_set_svc_ref_frame_config},
   {VP9E_SET_RENDER_SIZE,              ctrl_set_render_size},
+  {VP9E_SET_SOURCE_RELEASE_CB,        ctrl_set_source_release_cb},
+  {VP9E_SET_TARGET_FRAME_TIME,        ctrl_set_target_frame_time},
 
   // Getters
   {VP8E_GET_LAST_QUANTIZER,           ctrl_get_quantizer},
@@ -1519,6 +1586,8 @@ static vpx_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   {VP9_GET_REFERENCE,                 ctrl_get_reference},
   {VP9E_GET_SVC_LAYER_ID,             ctrl_get_svc_layer_id},
   {VP9E_GET_ACTIVEMAP,                ctrl_get_active_map},
+  {VP9E_GET_FRAME_TIME_STATS,         ctrl_get_frame_time_stats},
+  {VP9E_GET_THREAD_SYNC_STATS,        ctrl_get_thread_sync_stats},
 
   { -1, NULL},
 };
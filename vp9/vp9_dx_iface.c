@@ -8,6 +8,7 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <assert.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -48,6 +49,7 @@ static vpx_codec_err_t decoder_init(vpx_codec_ctx_t *ctx,
     ctx->priv->init_flags = ctx->init_flags;
     priv->si.sz = sizeof(priv->si);
     priv->flushed = 0;
+    priv->cur_input_ref = -1;
     // Only do frame parallel decode when threads > 1.
     priv->frame_parallel_decode =
         (ctx->config.dec && (ctx->config.dec->threads > 1) &&
@@ -61,6 +63,46 @@ static vpx_codec_err_t decoder_init(vpx_codec_ctx_t *ctx,
   return VPX_CODEC_OK;
 }
 
+// Takes a reference on an input buffer, and returns its index.
+static int acquire_input_buffer(vpx_codec_alg_priv_t *ctx,
+                                const uint8_t *data) {
+  int i, free_ref = -1;
+  for (i = 0; i < MAX_DECODE_THREADS + 1; ++i) {
+    input_buffer_ref *const ref = &ctx->input_refs[i];
+    if (ref->ref_count > 0 && ref->data == data) {
+      ++ref->ref_count;
+      return i;
+    }
+    if (ref->ref_count == 0 && free_ref < 0)
+      free_ref = i;
+  }
+  // Every worker holds at most one reference, so there is always a free one.
+  assert(free_ref >= 0);
+  ctx->input_refs[free_ref].data = data;
+  ctx->input_refs[free_ref].ref_count = 1;
+  return free_ref;
+}
+
+// Drops a reference on an input buffer, and hands the buffer back to the
+// application with the last one.
+static void release_input_buffer(vpx_codec_alg_priv_t *ctx, int idx) {
+  input_buffer_ref *const ref = &ctx->input_refs[idx];
+  assert(ref->ref_count > 0);
+  if (--ref->ref_count == 0) {
+    ctx->release_input_cb(ctx->release_input_state, ref->data);
+    ref->data = NULL;
+  }
+}
+
+// Drops the input buffer reference of a worker that is done with its frame.
+static void release_worker_input(vpx_codec_alg_priv_t *ctx,
+                                 FrameWorkerData *const frame_worker_data) {
+  if (frame_worker_data->input_ref >= 0) {
+    release_input_buffer(ctx, frame_worker_data->input_ref);
+    frame_worker_data->input_ref = -1;
+  }
+}
+
 static vpx_codec_err_t decoder_destroy(vpx_codec_alg_priv_t *ctx) {
   if (ctx->frame_workers != NULL) {
     int i;
@@ -69,6 +111,7 @@ static vpx_codec_err_t decoder_destroy(vpx_codec_alg_priv_t *ctx) {
       FrameWorkerData *const frame_worker_data =
           (FrameWorkerData *)worker->data1;
       vpx_get_worker_interface()->end(worker);
+      release_worker_input(ctx, frame_worker_data);
       vp9_remove_common(&frame_worker_data->pbi->common);
 #if CONFIG_VP9_POSTPROC
       vp9_free_postproc_buffers(&frame_worker_data->pbi->common);
@@ -366,6 +409,7 @@ static vpx_codec_err_t init_decoder(vpx_codec_alg_priv_t *ctx) {
     frame_worker_data->worker_id = i;
     frame_worker_data->scratch_buffer = NULL;
     frame_worker_data->scratch_buffer_size = 0;
+    frame_worker_data->input_ref = -1;
     frame_worker_data->frame_context_ready = 0;
     frame_worker_data->received_frame = 0;
 #if CONFIG_MULTITHREAD
@@ -385,6 +429,7 @@ static vpx_codec_err_t init_decoder(vpx_codec_alg_priv_t *ctx) {
         (ctx->frame_parallel_decode == 0) ? ctx->cfg.threads : 0;
 
     frame_worker_data->pbi->inv_tile_order = ctx->invert_tile_order;
+    frame_worker_data->pbi->row_mt = ctx->row_mt;
     frame_worker_data->pbi->frame_parallel_decode = ctx->frame_parallel_decode;
     frame_worker_data->pbi->common.frame_parallel_decode =
         ctx->frame_parallel_decode;
@@ -468,26 +513,36 @@ static vpx_codec_err_t decode_one(vpx_codec_alg_priv_t *ctx,
           &ctx->frame_workers[ctx->last_submit_worker_id]);
 
     frame_worker_data->pbi->ready_for_new_data = 0;
-    // Copy the compressed data into worker's internal buffer.
-    // TODO(hkuang): Will all the workers allocate the same size
-    // as the size of the first intra frame be better? This will
-    // avoid too many deallocate and allocate.
-    if (frame_worker_data->scratch_buffer_size < data_sz) {
-      frame_worker_data->scratch_buffer =
-          (uint8_t *)vpx_realloc(frame_worker_data->scratch_buffer, data_sz);
-      if (frame_worker_data->scratch_buffer == NULL) {
-        set_error_detail(ctx, "Failed to reallocate scratch buffer");
-        return VPX_CODEC_MEM_ERROR;
+    if (ctx->cur_input_ref >= 0) {
+      // The application handed the buffer over: read it in place and keep a
+      // reference on it until the worker is synced.
+      ++ctx->input_refs[ctx->cur_input_ref].ref_count;
+      frame_worker_data->input_ref = ctx->cur_input_ref;
+      frame_worker_data->data = *data;
+    } else {
+      // Copy the compressed data into worker's internal buffer. The buffer
+      // grows by at least half of its size, so that it settles after a few
+      // frames rather than being reallocated for every larger frame.
+      if (frame_worker_data->scratch_buffer_size < data_sz) {
+        const size_t new_size =
+            VPXMAX(data_sz, frame_worker_data->scratch_buffer_size * 3 / 2);
+        vpx_free(frame_worker_data->scratch_buffer);
+        frame_worker_data->scratch_buffer = (uint8_t *)vpx_malloc(new_size);
+        if (frame_worker_data->scratch_buffer == NULL) {
+          frame_worker_data->scratch_buffer_size = 0;
+          set_error_detail(ctx, "Failed to allocate scratch buffer");
+          return VPX_CODEC_MEM_ERROR;
+        }
+        frame_worker_data->scratch_buffer_size = new_size;
       }
-      frame_worker_data->scratch_buffer_size = data_sz;
+      memcpy(frame_worker_data->scratch_buffer, *data, data_sz);
+      frame_worker_data->data = frame_worker_data->scratch_buffer;
     }
     frame_worker_data->data_size = data_sz;
-    memcpy(frame_worker_data->scratch_buffer, *data, data_sz);
 
     frame_worker_data->frame_decoded = 0;
     frame_worker_data->frame_context_ready = 0;
     frame_worker_data->received_frame = 1;
-    frame_worker_data->data = frame_worker_data->scratch_buffer;
     frame_worker_data->user_priv = user_priv;
 
     if (ctx->next_submit_worker_id != ctx->last_submit_worker_id)
@@ -515,6 +570,7 @@ static void wait_worker_and_cache_frame(vpx_codec_alg_priv_t *ctx) {
   // TODO(hkuang): Add worker error handling here.
   winterface->sync(worker);
   frame_worker_data->received_frame = 0;
+  release_worker_input(ctx, frame_worker_data);
   ++ctx->available_threads;
 
   check_resync(ctx, frame_worker_data->pbi);
@@ -533,9 +589,9 @@ static void wait_worker_and_cache_frame(vpx_codec_alg_priv_t *ctx) {
   }
 }
 
-static vpx_codec_err_t decoder_decode(vpx_codec_alg_priv_t *ctx,
-                                      const uint8_t *data, unsigned int data_sz,
-                                      void *user_priv, long deadline) {
+static vpx_codec_err_t decode_data(vpx_codec_alg_priv_t *ctx,
+                                   const uint8_t *data, unsigned int data_sz,
+                                   void *user_priv, long deadline) {
   const uint8_t *data_start = data;
   const uint8_t * const data_end = data + data_sz;
   vpx_codec_err_t res;
@@ -659,6 +715,24 @@ static vpx_codec_err_t decoder_decode(vpx_codec_alg_priv_t *ctx,
   return res;
 }
 
+static vpx_codec_err_t decoder_decode(vpx_codec_alg_priv_t *ctx,
+                                      const uint8_t *data, unsigned int data_sz,
+                                      void *user_priv, long deadline) {
+  vpx_codec_err_t res;
+
+  if (ctx->release_input_cb == NULL || data == NULL)
+    return decode_data(ctx, data, data_sz, user_priv, deadline);
+
+  // Hold a reference on the buffer for the duration of the call. The frame
+  // workers that read it in place take their own, so it is released here only
+  // if no frame of it is still being decoded.
+  ctx->cur_input_ref = acquire_input_buffer(ctx, data);
+  res = decode_data(ctx, data, data_sz, user_priv, deadline);
+  release_input_buffer(ctx, ctx->cur_input_ref);
+  ctx->cur_input_ref = -1;
+  return res;
+}
+
 static void release_last_output_frame(vpx_codec_alg_priv_t *ctx) {
   RefCntBuffer *const frame_bufs = ctx->buffer_pool->frame_bufs;
   // Decrease reference count of last output frame in frame parallel mode.
@@ -714,6 +788,7 @@ static vpx_image_t *decoder_get_frame(vpx_codec_alg_priv_t *ctx,
         if (frame_worker_data->received_frame == 1) {
           ++ctx->available_threads;
           frame_worker_data->received_frame = 0;
+          release_worker_input(ctx, frame_worker_data);
           check_resync(ctx, frame_worker_data->pbi);
         }
         if (vp9_get_raw_frame(frame_worker_data->pbi, &sd, &flags) == 0) {
@@ -731,6 +806,7 @@ static vpx_image_t *decoder_get_frame(vpx_codec_alg_priv_t *ctx,
       } else {
         // Decoding failed. Release the worker thread.
         frame_worker_data->received_frame = 0;
+        release_worker_input(ctx, frame_worker_data);
         ++ctx->available_threads;
         ctx->need_resync = 1;
         if (ctx->flushed != 1)
@@ -991,6 +1067,18 @@ static vpx_codec_err_t ctrl_set_decryptor(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_OK;
 }
 
+static vpx_codec_err_t ctrl_set_input_release_cb(vpx_codec_alg_priv_t *ctx,
+                                                 va_list args) {
+  vpx_input_release_init *init = va_arg(args, vpx_input_release_init *);
+  // The buffers in flight must be released with the callback that was set
+  // when they were submitted.
+  if (ctx->frame_workers != NULL)
+    return VPX_CODEC_ERROR;
+  ctx->release_input_cb = init ? init->release_cb : NULL;
+  ctx->release_input_state = init ? init->release_state : NULL;
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_err_t ctrl_set_byte_alignment(vpx_codec_alg_priv_t *ctx,
                                                va_list args) {
   const int legacy_byte_alignment = 0;
@@ -1027,6 +1115,19 @@ static vpx_codec_err_t ctrl_set_skip_loop_filter(vpx_codec_alg_priv_t *ctx,
   return VPX_CODEC_OK;
 }
 
+static vpx_codec_err_t ctrl_set_row_mt(vpx_codec_alg_priv_t *ctx,
+                                       va_list args) {
+  ctx->row_mt = va_arg(args, int);
+
+  if (ctx->frame_workers) {
+    VPxWorker *const worker = ctx->frame_workers;
+    FrameWorkerData *const frame_worker_data = (FrameWorkerData *)worker->data1;
+    frame_worker_data->pbi->row_mt = ctx->row_mt;
+  }
+
+  return VPX_CODEC_OK;
+}
+
 static vpx_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   {VP8_COPY_REFERENCE,            ctrl_copy_reference},
 
@@ -1041,6 +1142,8 @@ static vpx_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   {VPXD_SET_DECRYPTOR,            ctrl_set_decryptor},
   {VP9_SET_BYTE_ALIGNMENT,        ctrl_set_byte_alignment},
   {VP9_SET_SKIP_LOOP_FILTER,      ctrl_set_skip_loop_filter},
+  {VP9D_SET_ROW_MT,               ctrl_set_row_mt},
+  {VP9D_SET_INPUT_RELEASE_CB,     ctrl_set_input_release_cb},
 
   // Getters
   {VP8D_GET_LAST_REF_UPDATES,     ctrl_get_last_ref_updates},
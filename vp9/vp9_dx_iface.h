@@ -24,6 +24,13 @@ typedef struct cache_frame {
   vpx_image_t img;
 } cache_frame;
 
+// A buffer passed to decoder_decode() that is read in place by the frame
+// workers, with the number of references held on it.
+typedef struct input_buffer_ref {
+  const uint8_t *data;
+  int ref_count;
+} input_buffer_ref;
+
 struct vpx_codec_alg_priv {
   vpx_codec_priv_t        base;
   vpx_codec_dec_cfg_t     cfg;
@@ -39,6 +46,7 @@ struct vpx_codec_alg_priv {
   int                     last_show_frame;  // Index of last output frame.
   int                     byte_alignment;
   int                     skip_loop_filter;
+  int                     row_mt;
 
   // Frame parallel related.
   int                     frame_parallel_decode;  // frame-based threading.
@@ -53,6 +61,9 @@ struct vpx_codec_alg_priv {
   int                     frame_cache_read;
   int                     num_cache_frames;
   int                     need_resync;      // wait for key/intra-only frame
+  // Input buffers in use: one per frame worker, plus the one being decoded.
+  input_buffer_ref        input_refs[MAX_DECODE_THREADS + 1];
+  int                     cur_input_ref;    // Reference of the current input.
   // BufferPool that holds all reference frames. Shared by all the FrameWorkers.
   BufferPool              *buffer_pool;
 
@@ -60,6 +71,10 @@ struct vpx_codec_alg_priv {
   void *ext_priv;  // Private data associated with the external frame buffers.
   vpx_get_frame_buffer_cb_fn_t get_ext_fb_cb;
   vpx_release_frame_buffer_cb_fn_t release_ext_fb_cb;
+
+  // Release function of the input buffers, when they are not copied.
+  vpx_release_input_cb    release_input_cb;
+  void                    *release_input_state;
 };
 
 #endif  // VP9_VP9_DX_IFACE_H_
@@ -554,8 +554,126 @@ enum vp8e_enc_control_id {
    * Supported in codecs: VP9
    */
   VP9E_SET_RENDER_SIZE,
+
+  /*!\brief Codec control function to enable/disable row based
+   * multi-threading.
+   *
+   * When enabled, the superblock rows of all tiles are distributed to the
+   * encoder threads through a shared job queue, so the number of threads
+   * that can be used is no longer limited by the number of tile columns.
+   * The encoded bitstream does not depend on the number of threads.
+   *
+   * 0 : off, 1 : on
+   *
+   * By default, the value is 0, i.e. row based multi-threading is disabled.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_SET_ROW_MT,
+
+  /*!\brief Codec control function to hand the source frames over to the
+   * encoder instead of having them copied.
+   *
+   * Takes a #vpx_source_release_init, which contains a release callback and
+   * its state. When set, the encoder takes ownership of the images that
+   * vpx_codec_encode() accepts, and calls the callback with their user_priv
+   * once it no longer reads them, at the latest when it is destroyed.
+   *
+   * Images laid out as the encoder buffers are used in place: their luma and
+   * chroma planes must be aligned to 32 and 16 bytes, and surrounded by
+   * #VP9E_SOURCE_BORDER writable pixels (scaled by the chroma subsampling),
+   * their luma stride in pixels must be the width rounded up to a multiple of
+   * 8, plus twice the border, rounded up to a multiple of 32, and their chroma
+   * stride the luma stride scaled by the chroma subsampling. The encoder
+   * extends their borders and may filter their pixels. Other images are
+   * copied and released right away.
+   *
+   * The control must be set before the first frame is encoded; a NULL
+   * callback restores the default copying behavior.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_SET_SOURCE_RELEASE_CB,
+
+  /*!\brief Codec control function to set the target encode time of a frame.
+   *
+   * In microseconds. The encoder measures the time it takes to encode each
+   * frame and applies individual speed features on top of the ones of the
+   * cpu_used setting, or removes them, to hold the frames to this time. The
+   * cpu_used setting is then the best quality the encoder may use. The time
+   * of a hidden alt-ref frame counts against the next shown frame.
+   *
+   * By default, the value is 0, i.e. the speed features only follow
+   * cpu_used.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_SET_TARGET_FRAME_TIME,
+
+  /*!\brief Codec control function to get the frame encode time statistics.
+   *
+   * Takes a #vpx_frame_time_stats_t. See #VP9E_SET_TARGET_FRAME_TIME.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_GET_FRAME_TIME_STATS,
+
+  /*!\brief Codec control function to get the row synchronization statistics
+   * of the encoding threads.
+   *
+   * Takes a #vpx_thread_sync_stats_t. The statistics add up over all the
+   * frames encoded so far.
+   *
+   * Supported in codecs: VP9
+   */
+  VP9E_GET_THREAD_SYNC_STATS,
 };
 
+/*!\brief Border that the source frames handed over with
+ * #VP9E_SET_SOURCE_RELEASE_CB need around their planes, in luma pixels.
+ */
+#define VP9E_SOURCE_BORDER 160
+
+/*!\brief Release a source frame handed over with #VP9E_SET_SOURCE_RELEASE_CB.
+ *
+ * user_priv is the user_priv of the image passed to vpx_codec_encode().
+ */
+typedef void (*vpx_release_source_cb)(void *release_state, void *user_priv);
+
+/*!\brief Structure to hold the source release state
+ *
+ * Defines a structure to hold the source release state and access function.
+ */
+typedef struct vpx_source_release_init {
+  vpx_release_source_cb release_cb;  /**< Release callback. */
+  void *release_state;               /**< Release state. */
+} vpx_source_release_init;
+
+/*!\brief Frame encode time statistics
+ *
+ * Reported by #VP9E_GET_FRAME_TIME_STATS. Times are in microseconds.
+ */
+typedef struct vpx_frame_time_stats {
+  unsigned int target_frame_time;   /**< Target encode time of a frame. */
+  unsigned int last_frame_time;     /**< Encode time of the last frame. */
+  unsigned int avg_frame_time;      /**< Running average of the times. */
+  unsigned int frames_over_target;  /**< Frames that took longer. */
+  int speed_level;      /**< Speed steps applied on top of cpu_used. */
+  int max_speed_level;  /**< Speed steps available. */
+} vpx_frame_time_stats_t;
+
+/*!\brief Encoding thread synchronization statistics
+ *
+ * Reported by #VP9E_GET_THREAD_SYNC_STATS, summed over all encoding threads.
+ * A thread blocks once spinning for the superblock row above it has not
+ * paid off, the time it spends blocked is left to other threads and
+ * processes.
+ */
+typedef struct vpx_thread_sync_stats {
+  uint64_t wait_time;       /**< Time blocked, in microseconds. */
+  unsigned int wait_count;  /**< Number of times a thread blocked. */
+} vpx_thread_sync_stats_t;
+
 /*!\brief vpx 1-D scaling mode
  *
  * This set of constants define 1-D vpx scaling modes
@@ -809,6 +927,21 @@ VPX_CTRL_USE_TYPE(VP9E_SET_SVC_REF_FRAME_CONFIG, vpx_svc_ref_frame_config_t *)
 VPX_CTRL_USE_TYPE(VP9E_SET_RENDER_SIZE, int *)
 #define VPX_CTRL_VP9E_SET_RENDER_SIZE
 
+VPX_CTRL_USE_TYPE(VP9E_SET_ROW_MT, unsigned int)
+#define VPX_CTRL_VP9E_SET_ROW_MT
+
+VPX_CTRL_USE_TYPE(VP9E_SET_SOURCE_RELEASE_CB, vpx_source_release_init *)
+#define VPX_CTRL_VP9E_SET_SOURCE_RELEASE_CB
+
+VPX_CTRL_USE_TYPE(VP9E_SET_TARGET_FRAME_TIME, unsigned int)
+#define VPX_CTRL_VP9E_SET_TARGET_FRAME_TIME
+
+VPX_CTRL_USE_TYPE(VP9E_GET_FRAME_TIME_STATS, vpx_frame_time_stats_t *)
+#define VPX_CTRL_VP9E_GET_FRAME_TIME_STATS
+
+VPX_CTRL_USE_TYPE(VP9E_GET_THREAD_SYNC_STATS, vpx_thread_sync_stats_t *)
+#define VPX_CTRL_VP9E_GET_THREAD_SYNC_STATS
+
 /*!\endcond */
 /*! @} - end defgroup vp8_encoder */
 #ifdef __cplusplus
@@ -121,6 +121,27 @@ enum vp8_dec_control_id {
    */
   VP9_SET_SKIP_LOOP_FILTER,
 
+  /** control function to enable row based multi-threading. Valid values are
+   * integers. When nonzero and more than one thread is available, the decoder
+   * parses each superblock row serially and reconstructs the rows in parallel
+   * as a wavefront, so that streams with a single tile column can use more
+   * than one core. The output does not depend on this setting. The default
+   * value is 0.
+   */
+  VP9D_SET_ROW_MT,
+
+  /** control function to hand the compressed data over to the decoder
+   * instead of having it copied. Takes a vpx_input_release_init, which
+   * contains a release callback and its state. When set, the frame parallel
+   * decoder reads every frame from the buffer passed to vpx_codec_decode()
+   * rather than from a copy, and calls the release callback exactly once per
+   * buffer when no worker reads it anymore, which may be after
+   * vpx_codec_decode() has returned. The caller must keep the buffer alive
+   * and unchanged until then. The control must be set before the first frame
+   * is decoded; a NULL callback restores the default copying behavior.
+   */
+  VP9D_SET_INPUT_RELEASE_CB,
+
   VP8_DECODER_CTRL_ID_MAX
 };
 
@@ -146,6 +167,24 @@ typedef struct vpx_decrypt_init {
  */
 typedef vpx_decrypt_init vp8_decrypt_init;
 
+/** Release a buffer passed to vpx_codec_decode(), using the release_state
+ *  passed in VP9D_SET_INPUT_RELEASE_CB.
+ */
+typedef void (*vpx_release_input_cb)(void *release_state,
+                                     const unsigned char *data);
+
+/*!\brief Structure to hold the input release state
+ *
+ * Defines a structure to hold the input release state and access function.
+ */
+typedef struct vpx_input_release_init {
+    /*! Release callback. */
+    vpx_release_input_cb release_cb;
+
+    /*! Release state. */
+    void *release_state;
+} vpx_input_release_init;
+
 
 /*!\cond */
 /*!\brief VP8 decoder control function parameter type
@@ -174,6 +213,10 @@ VPX_CTRL_USE_TYPE(VP9D_GET_FRAME_SIZE,          int *)
 #define VPX_CTRL_VP9D_GET_FRAME_SIZE
 VPX_CTRL_USE_TYPE(VP9_INVERT_TILE_DECODE_ORDER, int)
 #define VPX_CTRL_VP9_INVERT_TILE_DECODE_ORDER
+VPX_CTRL_USE_TYPE(VP9D_SET_ROW_MT,              int)
+#define VPX_CTRL_VP9D_SET_ROW_MT
+VPX_CTRL_USE_TYPE(VP9D_SET_INPUT_RELEASE_CB,    vpx_input_release_init *)
+#define VPX_CTRL_VP9D_SET_INPUT_RELEASE_CB
 
 /*!\endcond */
 /*! @} - end defgroup vp8_decoder */
@@ -67,6 +67,7 @@ typedef size_t uintptr_t;
 /* VS2010 defines stdint.h, but not inttypes.h */
 #if defined(_MSC_VER) && _MSC_VER < 1800
 #define PRId64 "I64d"
+#define PRIu64 "I64u"
 #else
 #include <inttypes.h>
 #endif
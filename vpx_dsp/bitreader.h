@@ -73,36 +73,60 @@ static INLINE int vpx_reader_has_error(vpx_reader *r) {
   return r->count > BD_VALUE_SIZE && r->count < LOTS_OF_BITS;
 }
 
-static INLINE int vpx_read(vpx_reader *r, int prob) {
-  unsigned int bit = 0;
-  BD_VALUE value;
+// Returns the shift that brings 'range', which is in [1, 255], back to
+// [128, 255]. Counting the leading zeros keeps the vpx_norm[] load off the
+// dependency chain between consecutive bools.
+static INLINE int vpx_reader_norm(unsigned int range) {
+#if defined(__GNUC__)
+  return __builtin_clz(range) - 24;
+#else
+  return vpx_norm[range];
+#endif
+}
+
+// Reads a bool like vpx_read(), with the reader state held by the caller in
+// 'value', 'count' and 'range'. This lets a run of symbols, such as a whole
+// coefficient token, be decoded from registers; 'r' is only synchronized
+// around a refill.
+static INLINE int vpx_read_bool(vpx_reader *r, int prob, BD_VALUE *value,
+                                int *count, unsigned int *range) {
+  const unsigned int split = (*range * prob + (256 - prob)) >> CHAR_BIT;
   BD_VALUE bigsplit;
-  int count;
-  unsigned int range;
-  unsigned int split = (r->range * prob + (256 - prob)) >> CHAR_BIT;
+  int bit = 0;
+  int shift;
 
-  if (r->count < 0)
+  if (*count < 0) {
+    r->value = *value;
+    r->count = *count;
     vpx_reader_fill(r);
-
-  value = r->value;
-  count = r->count;
+    *value = r->value;
+    *count = r->count;
+  }
 
   bigsplit = (BD_VALUE)split << (BD_VALUE_SIZE - CHAR_BIT);
 
-  range = split;
-
-  if (value >= bigsplit) {
-    range = r->range - split;
-    value = value - bigsplit;
+  if (*value >= bigsplit) {
+    *range = *range - split;
+    *value = *value - bigsplit;
     bit = 1;
+  } else {
+    *range = split;
   }
 
-  {
-    register int shift = vpx_norm[range];
-    range <<= shift;
-    value <<= shift;
-    count -= shift;
-  }
+  shift = vpx_reader_norm(*range);
+  *range <<= shift;
+  *value <<= shift;
+  *count -= shift;
+
+  return bit;
+}
+
+static INLINE int vpx_read(vpx_reader *r, int prob) {
+  BD_VALUE value = r->value;
+  int count = r->count;
+  unsigned int range = r->range;
+  const int bit = vpx_read_bool(r, prob, &value, &count, &range);
+
   r->value = value;
   r->count = count;
   r->range = range;
@@ -0,0 +1,187 @@
+/*
+ *  Copyright (c) 2016 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <immintrin.h>  // AVX2
+
+#include "./vpx_dsp_rtcd.h"
+#include "vpx_ports/mem.h"
+
+// Loads the next 16 pixels of a block: 16 pixels of one row, or 8 pixels of
+// 2 rows or 4 pixels of 4 rows when the block is narrower.
+static INLINE __m256i highbd_load(const uint16_t *p, int stride, int width) {
+  if (width == 8) {
+    return _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128((__m128i const *) (p))),
+        _mm_loadu_si128((__m128i const *) (p + stride)), 1);
+  } else if (width == 4) {
+    const __m128i lo =
+        _mm_unpacklo_epi64(_mm_loadl_epi64((__m128i const *) (p)),
+                           _mm_loadl_epi64((__m128i const *) (p + stride)));
+    const __m128i hi =
+        _mm_unpacklo_epi64(_mm_loadl_epi64((__m128i const *) (p + 2 * stride)),
+                           _mm_loadl_epi64((__m128i const *) (p + 3 * stride)));
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+  }
+  return _mm256_loadu_si256((__m256i const *) (p));
+}
+
+// Bilinear interpolation between the pixels of a and b with the taps f0 and
+// f1, which add up to 8. The sum fits in 16 bits for 12 bit pixels.
+static INLINE __m256i highbd_filter(__m256i a, __m256i b,
+                                    __m256i f0, __m256i f1) {
+  const __m256i sum = _mm256_add_epi16(_mm256_mullo_epi16(a, f0),
+                                       _mm256_mullo_epi16(b, f1));
+  return _mm256_srli_epi16(_mm256_add_epi16(sum, _mm256_set1_epi16(4)), 3);
+}
+
+static INLINE __m256i highbd_filter_x(const uint16_t *p, int stride, int width,
+                                      int x_offset, __m256i f0, __m256i f1) {
+  const __m256i src_reg = highbd_load(p, stride, width);
+  if (x_offset == 0)
+    return src_reg;
+  return highbd_filter(src_reg, highbd_load(p + 1, stride, width), f0, f1);
+}
+
+// Sums the differences and the squared differences of the bilinear filtered
+// src, averaged with sec unless it is NULL, and dst. The squares are added up
+// in 32 bits per column of 16 pixels, at most 64 rows of 12 bit pixels.
+static void highbd_sub_pixel_variance(const uint16_t *src, int src_stride,
+                                      int x_offset, int y_offset,
+                                      const uint16_t *dst, int dst_stride,
+                                      const uint16_t *sec, int width,
+                                      int height, uint64_t *sse,
+                                      int64_t *sum) {
+  const __m256i xf0 = _mm256_set1_epi16(8 - x_offset);
+  const __m256i xf1 = _mm256_set1_epi16(x_offset);
+  const __m256i yf0 = _mm256_set1_epi16(8 - y_offset);
+  const __m256i yf1 = _mm256_set1_epi16(y_offset);
+  const __m256i ones = _mm256_set1_epi16(1);
+  const __m256i zero = _mm256_setzero_si256();
+  const int rows = width < 16 ? 16 / width : 1;
+  const int cols = width < 16 ? width : 16;
+  __m256i sum_reg = _mm256_setzero_si256();
+  __m256i sse64_reg = _mm256_setzero_si256();
+  __m128i sse128;
+  int i, j;
+
+  for (j = 0; j < width; j += cols) {
+    const uint16_t *s = src + j;
+    const uint16_t *d = dst + j;
+    const uint16_t *p = sec != NULL ? sec + j : NULL;
+    __m256i sse_reg = _mm256_setzero_si256();
+    __m256i src_reg = highbd_filter_x(s, src_stride, width, x_offset,
+                                      xf0, xf1);
+
+    for (i = 0; i < height; i += rows) {
+      __m256i pred_reg = src_reg, diff;
+      s += rows * src_stride;
+      if (y_offset) {
+        // A single row per register is carried over as the row above the
+        // next one, narrower blocks filter the rows below again.
+        const __m256i src_next_reg =
+            highbd_filter_x(s - (rows - 1) * src_stride, src_stride, width,
+                            x_offset, xf0, xf1);
+        pred_reg = highbd_filter(src_reg, src_next_reg, yf0, yf1);
+        if (rows == 1)
+          src_reg = src_next_reg;
+        else if (i + rows < height)
+          src_reg = highbd_filter_x(s, src_stride, width, x_offset, xf0, xf1);
+      } else if (i + rows < height) {
+        src_reg = highbd_filter_x(s, src_stride, width, x_offset, xf0, xf1);
+      }
+
+      if (p != NULL) {
+        pred_reg = _mm256_avg_epu16(pred_reg, highbd_load(p, width, width));
+        p += rows * width;
+      }
+
+      diff = _mm256_sub_epi16(pred_reg, highbd_load(d, dst_stride, width));
+      sum_reg = _mm256_add_epi32(sum_reg, _mm256_madd_epi16(diff, ones));
+      sse_reg = _mm256_add_epi32(sse_reg, _mm256_madd_epi16(diff, diff));
+      d += rows * dst_stride;
+    }
+
+    sse64_reg = _mm256_add_epi64(sse64_reg,
+                                 _mm256_unpacklo_epi32(sse_reg, zero));
+    sse64_reg = _mm256_add_epi64(sse64_reg,
+                                 _mm256_unpackhi_epi32(sse_reg, zero));
+  }
+
+  sse128 = _mm_add_epi64(_mm256_castsi256_si128(sse64_reg),
+                         _mm256_extracti128_si256(sse64_reg, 1));
+  sse128 = _mm_add_epi64(sse128, _mm_srli_si128(sse128, 8));
+  _mm_storel_epi64((__m128i *) (sse), sse128);
+
+  {
+    __m128i sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum_reg),
+                                   _mm256_extracti128_si256(sum_reg, 1));
+    sum128 = _mm_add_epi32(sum128, _mm_srli_si128(sum128, 8));
+    sum128 = _mm_add_epi32(sum128, _mm_srli_si128(sum128, 4));
+    *sum = _mm_cvtsi128_si32(sum128);
+  }
+}
+
+// Rounds the sums of 10 and 12 bit pixels like the C code.
+static INLINE uint32_t highbd_variance(uint64_t sse_long, int64_t sum_long,
+                                       int bd, int w, int h, uint32_t *sse) {
+  const int shift = (bd - 8) * 2;
+  const int sum = bd == 8 ? (int)sum_long :
+      (int)ROUND_POWER_OF_TWO(sum_long, shift / 2);
+  *sse = bd == 8 ? (uint32_t)sse_long :
+      (uint32_t)ROUND_POWER_OF_TWO(sse_long, shift);
+  return *sse - (((int64_t)sum * sum) / (w * h));
+}
+
+#define FN(w, h, bd) \
+uint32_t vpx_highbd_##bd##_sub_pixel_variance##w##x##h##_avx2( \
+    const uint8_t *src8, int src_stride, int x_offset, int y_offset, \
+    const uint8_t *dst8, int dst_stride, uint32_t *sse_ptr) { \
+  uint64_t sse; \
+  int64_t sum; \
+  highbd_sub_pixel_variance(CONVERT_TO_SHORTPTR(src8), src_stride, \
+                            x_offset, y_offset, CONVERT_TO_SHORTPTR(dst8), \
+                            dst_stride, NULL, w, h, &sse, &sum); \
+  return highbd_variance(sse, sum, bd, w, h, sse_ptr); \
+} \
+\
+uint32_t vpx_highbd_##bd##_sub_pixel_avg_variance##w##x##h##_avx2( \
+    const uint8_t *src8, int src_stride, int x_offset, int y_offset, \
+    const uint8_t *dst8, int dst_stride, uint32_t *sse_ptr, \
+    const uint8_t *sec8) { \
+  uint64_t sse; \
+  int64_t sum; \
+  highbd_sub_pixel_variance(CONVERT_TO_SHORTPTR(src8), src_stride, \
+                            x_offset, y_offset, CONVERT_TO_SHORTPTR(dst8), \
+                            dst_stride, CONVERT_TO_SHORTPTR(sec8), w, h, \
+                            &sse, &sum); \
+  return highbd_variance(sse, sum, bd, w, h, sse_ptr); \
+}
+
+#define FNS(bd) \
+FN(64, 64, bd); \
+FN(64, 32, bd); \
+FN(32, 64, bd); \
+FN(32, 32, bd); \
+FN(32, 16, bd); \
+FN(16, 32, bd); \
+FN(16, 16, bd); \
+FN(16, 8, bd); \
+FN(8, 16, bd); \
+FN(8, 8, bd); \
+FN(8, 4, bd); \
+FN(4, 8, bd); \
+FN(4, 4, bd);
+
+FNS(8);
+FNS(10);
+FNS(12);
+
+#undef FNS
+#undef FN
@@ -109,75 +109,138 @@ unsigned int vpx_sub_pixel_avg_variance32xh_avx2(const uint8_t *src,
                                                  int height,
                                                  unsigned int *sseptr);
 
-unsigned int vpx_sub_pixel_variance64x64_avx2(const uint8_t *src,
-                                              int src_stride,
-                                              int x_offset,
-                                              int y_offset,
-                                              const uint8_t *dst,
-                                              int dst_stride,
-                                              unsigned int *sse) {
-  unsigned int sse1;
-  const int se1 = vpx_sub_pixel_variance32xh_avx2(src, src_stride, x_offset,
-                                                  y_offset, dst, dst_stride,
-                                                  64, &sse1);
-  unsigned int sse2;
-  const int se2 = vpx_sub_pixel_variance32xh_avx2(src + 32, src_stride,
-                                                  x_offset, y_offset,
-                                                  dst + 32, dst_stride,
-                                                  64, &sse2);
-  const int se = se1 + se2;
-  *sse = sse1 + sse2;
-  return *sse - (((int64_t)se * se) >> 12);
-}
+unsigned int vpx_sub_pixel_variance16xh_avx2(const uint8_t *src, int src_stride,
+                                             int x_offset, int y_offset,
+                                             const uint8_t *dst, int dst_stride,
+                                             int height,
+                                             unsigned int *sse);
 
-unsigned int vpx_sub_pixel_variance32x32_avx2(const uint8_t *src,
-                                              int src_stride,
-                                              int x_offset,
-                                              int y_offset,
-                                              const uint8_t *dst,
-                                              int dst_stride,
-                                              unsigned int *sse) {
-  const int se = vpx_sub_pixel_variance32xh_avx2(src, src_stride, x_offset,
-                                                 y_offset, dst, dst_stride,
-                                                 32, sse);
-  return *sse - (((int64_t)se * se) >> 10);
-}
+unsigned int vpx_sub_pixel_avg_variance16xh_avx2(const uint8_t *src,
+                                                 int src_stride,
+                                                 int x_offset,
+                                                 int y_offset,
+                                                 const uint8_t *dst,
+                                                 int dst_stride,
+                                                 const uint8_t *sec,
+                                                 int sec_stride,
+                                                 int height,
+                                                 unsigned int *sseptr);
 
-unsigned int vpx_sub_pixel_avg_variance64x64_avx2(const uint8_t *src,
-                                                  int src_stride,
-                                                  int x_offset,
-                                                  int y_offset,
-                                                  const uint8_t *dst,
-                                                  int dst_stride,
-                                                  unsigned int *sse,
-                                                  const uint8_t *sec) {
-  unsigned int sse1;
-  const int se1 = vpx_sub_pixel_avg_variance32xh_avx2(src, src_stride, x_offset,
-                                                      y_offset, dst, dst_stride,
-                                                      sec, 64, 64, &sse1);
-  unsigned int sse2;
-  const int se2 =
-    vpx_sub_pixel_avg_variance32xh_avx2(src + 32, src_stride, x_offset,
-                                        y_offset, dst + 32, dst_stride,
-                                        sec + 32, 64, 64, &sse2);
-  const int se = se1 + se2;
-
-  *sse = sse1 + sse2;
-
-  return *sse - (((int64_t)se * se) >> 12);
+unsigned int vpx_sub_pixel_variance8xh_avx2(const uint8_t *src, int src_stride,
+                                            int x_offset, int y_offset,
+                                            const uint8_t *dst, int dst_stride,
+                                            int height,
+                                            unsigned int *sse);
+
+unsigned int vpx_sub_pixel_avg_variance8xh_avx2(const uint8_t *src,
+                                                int src_stride,
+                                                int x_offset,
+                                                int y_offset,
+                                                const uint8_t *dst,
+                                                int dst_stride,
+                                                const uint8_t *sec,
+                                                int sec_stride,
+                                                int height,
+                                                unsigned int *sseptr);
+
+unsigned int vpx_sub_pixel_variance4xh_avx2(const uint8_t *src, int src_stride,
+                                            int x_offset, int y_offset,
+                                            const uint8_t *dst, int dst_stride,
+                                            int height,
+                                            unsigned int *sse);
+
+unsigned int vpx_sub_pixel_avg_variance4xh_avx2(const uint8_t *src,
+                                                int src_stride,
+                                                int x_offset,
+                                                int y_offset,
+                                                const uint8_t *dst,
+                                                int dst_stride,
+                                                const uint8_t *sec,
+                                                int sec_stride,
+                                                int height,
+                                                unsigned int *sseptr);
+
+// Blocks wider than the wf wide kernel are processed in wf wide columns.
+#define FN(w, h, wf, wlog2, hlog2, cast) \
+unsigned int vpx_sub_pixel_variance##w##x##h##_avx2(const uint8_t *src, \
+                                                    int src_stride, \
+                                                    int x_offset, \
+                                                    int y_offset, \
+                                                    const uint8_t *dst, \
+                                                    int dst_stride, \
+                                                    unsigned int *sse_ptr) { \
+  unsigned int sse; \
+  int se = vpx_sub_pixel_variance##wf##xh_avx2(src, src_stride, x_offset, \
+                                               y_offset, dst, dst_stride, \
+                                               h, &sse); \
+  if (w > wf) { \
+    unsigned int sse2; \
+    const int se2 = vpx_sub_pixel_variance##wf##xh_avx2(src + wf, src_stride, \
+                                                        x_offset, y_offset, \
+                                                        dst + wf, dst_stride, \
+                                                        h, &sse2); \
+    se += se2; \
+    sse += sse2; \
+  } \
+  *sse_ptr = sse; \
+  return sse - ((cast se * se) >> (wlog2 + hlog2)); \
 }
 
-unsigned int vpx_sub_pixel_avg_variance32x32_avx2(const uint8_t *src,
-                                                  int src_stride,
-                                                  int x_offset,
-                                                  int y_offset,
-                                                  const uint8_t *dst,
-                                                  int dst_stride,
-                                                  unsigned int *sse,
-                                                  const uint8_t *sec) {
-  // Process 32 elements in parallel.
-  const int se = vpx_sub_pixel_avg_variance32xh_avx2(src, src_stride, x_offset,
-                                                     y_offset, dst, dst_stride,
-                                                     sec, 32, 32, sse);
-  return *sse - (((int64_t)se * se) >> 10);
+FN(64, 64, 32, 6, 6, (int64_t));
+FN(64, 32, 32, 6, 5, (int64_t));
+FN(32, 64, 32, 5, 6, (int64_t));
+FN(32, 32, 32, 5, 5, (int64_t));
+FN(32, 16, 32, 5, 4, (int64_t));
+FN(16, 32, 16, 4, 5, (int64_t));
+FN(16, 16, 16, 4, 4, (uint32_t));
+FN(16,  8, 16, 4, 3, (uint32_t));
+FN(8,  16,  8, 3, 4, (uint32_t));
+FN(8,   8,  8, 3, 3, (uint32_t));
+FN(8,   4,  8, 3, 2, (uint32_t));
+FN(4,   8,  4, 2, 3, (uint32_t));
+FN(4,   4,  4, 2, 2, (uint32_t));
+
+#undef FN
+
+#define FN(w, h, wf, wlog2, hlog2, cast) \
+unsigned int vpx_sub_pixel_avg_variance##w##x##h##_avx2(const uint8_t *src, \
+                                                        int src_stride, \
+                                                        int x_offset, \
+                                                        int y_offset, \
+                                                        const uint8_t *dst, \
+                                                        int dst_stride, \
+                                                        unsigned int *sseptr, \
+                                                        const uint8_t *sec) { \
+  unsigned int sse; \
+  int se = vpx_sub_pixel_avg_variance##wf##xh_avx2(src, src_stride, x_offset, \
+                                                   y_offset, dst, dst_stride, \
+                                                   sec, w, h, &sse); \
+  if (w > wf) { \
+    unsigned int sse2; \
+    const int se2 = \
+        vpx_sub_pixel_avg_variance##wf##xh_avx2(src + wf, src_stride, \
+                                                x_offset, y_offset, \
+                                                dst + wf, dst_stride, \
+                                                sec + wf, w, h, &sse2); \
+    se += se2; \
+    sse += sse2; \
+  } \
+  *sseptr = sse; \
+  return sse - ((cast se * se) >> (wlog2 + hlog2)); \
 }
+
+FN(64, 64, 32, 6, 6, (int64_t));
+FN(64, 32, 32, 6, 5, (int64_t));
+FN(32, 64, 32, 5, 6, (int64_t));
+FN(32, 32, 32, 5, 5, (int64_t));
+FN(32, 16, 32, 5, 4, (int64_t));
+FN(16, 32, 16, 4, 5, (int64_t));
+FN(16, 16, 16, 4, 4, (uint32_t));
+FN(16,  8, 16, 4, 3, (uint32_t));
+FN(8,  16,  8, 3, 4, (uint32_t));
+FN(8,   8,  8, 3, 3, (uint32_t));
+FN(8,   4,  8, 3, 2, (uint32_t));
+FN(4,   8,  4, 2, 3, (uint32_t));
+FN(4,   4,  4, 2, 2, (uint32_t));
+
+#undef FN
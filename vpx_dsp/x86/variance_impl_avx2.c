@@ -725,3 +725,287 @@ unsigned int vpx_sub_pixel_avg_variance32xh_avx2(const uint8_t *src,
   CALC_SUM_AND_SSE
   return sum;
 }
+
+// Loads 16 pixels of the rows at p0 and p1 into the low and the high lane.
+static INLINE __m256i load_16x2(const uint8_t *p0, const uint8_t *p1) {
+  const __m256i lo = _mm256_castsi128_si256(
+      _mm_loadu_si128((__m128i const *) (p0)));
+  return _mm256_inserti128_si256(lo,
+                                 _mm_loadu_si128((__m128i const *) (p1)), 1);
+}
+
+// Bilinear interpolation between the pixels of a and b.
+static INLINE __m256i filter_16x2(__m256i a, __m256i b, __m256i filter) {
+  const __m256i pw8 = _mm256_set1_epi16(8);
+  __m256i exp_src_lo = _mm256_unpacklo_epi8(a, b);
+  __m256i exp_src_hi = _mm256_unpackhi_epi8(a, b);
+  FILTER_SRC(filter)
+  return _mm256_packus_epi16(exp_src_lo, exp_src_hi);
+}
+
+// Horizontally filtered 16 pixels of the rows at p0 and p1.
+static INLINE __m256i filter_x_16x2(const uint8_t *p0, const uint8_t *p1,
+                                    int x_offset, __m256i filter) {
+  const __m256i src_reg = load_16x2(p0, p1);
+  __m256i src_next_reg;
+  if (x_offset == 0)
+    return src_reg;
+  src_next_reg = load_16x2(p0 + 1, p1 + 1);
+  if (x_offset == 8)
+    return _mm256_avg_epu8(src_reg, src_next_reg);
+  return filter_16x2(src_reg, src_next_reg, filter);
+}
+
+static INLINE int hadd_epi32_avx2(__m256i reg) {
+  __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(reg),
+                              _mm256_extractf128_si256(reg, 1));
+  sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 8));
+  sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 4));
+  return _mm_cvtsi128_si32(sum);
+}
+
+// Processes two rows of 16 pixels per 256 bit register, the height must be
+// even. The prediction is averaged with sec unless it is NULL.
+static int sub_pixel_variance16xh(const uint8_t *src, int src_stride,
+                                  int x_offset, int y_offset,
+                                  const uint8_t *dst, int dst_stride,
+                                  const uint8_t *sec, int sec_stride,
+                                  int height, unsigned int *sse) {
+  const __m256i xfilter = _mm256_load_si256((__m256i const *)
+                          (bilinear_filters_avx2 + (x_offset << 5)));
+  const __m256i yfilter = _mm256_load_si256((__m256i const *)
+                          (bilinear_filters_avx2 + (y_offset << 5)));
+  const __m256i zero_reg = _mm256_setzero_si256();
+  __m256i sum_reg = _mm256_setzero_si256();
+  __m256i sse_reg = _mm256_setzero_si256();
+  __m256i src_reg = filter_x_16x2(src, src + src_stride, x_offset, xfilter);
+  int i;
+
+  for (i = 0; i < height; i += 2) {
+    __m256i pred_reg, dst_reg, exp_src_lo, exp_src_hi;
+
+    if (y_offset == 0) {
+      pred_reg = src_reg;
+      src += 2 * src_stride;
+      if (i + 2 < height)
+        src_reg = filter_x_16x2(src, src + src_stride, x_offset, xfilter);
+    } else {
+      // The rows below the current two rows. The last row of the block only
+      // has one row below it.
+      const uint8_t *const next = src + 2 * src_stride;
+      const __m256i src_next2_reg =
+          filter_x_16x2(next, i + 2 < height ? next + src_stride : next,
+                        x_offset, xfilter);
+      const __m256i src_next_reg =
+          _mm256_permute2x128_si256(src_reg, src_next2_reg, 0x21);
+
+      if (y_offset == 8)
+        pred_reg = _mm256_avg_epu8(src_reg, src_next_reg);
+      else
+        pred_reg = filter_16x2(src_reg, src_next_reg, yfilter);
+      src_reg = src_next2_reg;
+      src = next;
+    }
+
+    if (sec != NULL) {
+      pred_reg = _mm256_avg_epu8(pred_reg, load_16x2(sec, sec + sec_stride));
+      sec += 2 * sec_stride;
+    }
+
+    dst_reg = load_16x2(dst, dst + dst_stride);
+    exp_src_lo = _mm256_sub_epi16(_mm256_unpacklo_epi8(pred_reg, zero_reg),
+                                  _mm256_unpacklo_epi8(dst_reg, zero_reg));
+    exp_src_hi = _mm256_sub_epi16(_mm256_unpackhi_epi8(pred_reg, zero_reg),
+                                  _mm256_unpackhi_epi8(dst_reg, zero_reg));
+    sum_reg = _mm256_add_epi16(sum_reg,
+                               _mm256_add_epi16(exp_src_lo, exp_src_hi));
+    sse_reg = _mm256_add_epi32(sse_reg,
+                               _mm256_madd_epi16(exp_src_lo, exp_src_lo));
+    sse_reg = _mm256_add_epi32(sse_reg,
+                               _mm256_madd_epi16(exp_src_hi, exp_src_hi));
+    dst += 2 * dst_stride;
+  }
+
+  *sse = hadd_epi32_avx2(sse_reg);
+  return hadd_epi32_avx2(_mm256_madd_epi16(sum_reg, _mm256_set1_epi16(1)));
+}
+
+unsigned int vpx_sub_pixel_variance16xh_avx2(const uint8_t *src,
+                                             int src_stride,
+                                             int x_offset,
+                                             int y_offset,
+                                             const uint8_t *dst,
+                                             int dst_stride,
+                                             int height,
+                                             unsigned int *sse) {
+  return sub_pixel_variance16xh(src, src_stride, x_offset, y_offset,
+                                dst, dst_stride, NULL, 0, height, sse);
+}
+
+unsigned int vpx_sub_pixel_avg_variance16xh_avx2(const uint8_t *src,
+                                                 int src_stride,
+                                                 int x_offset,
+                                                 int y_offset,
+                                                 const uint8_t *dst,
+                                                 int dst_stride,
+                                                 const uint8_t *sec,
+                                                 int sec_stride,
+                                                 int height,
+                                                 unsigned int *sse) {
+  return sub_pixel_variance16xh(src, src_stride, x_offset, y_offset,
+                                dst, dst_stride, sec, sec_stride, height, sse);
+}
+
+// Loads the next rows of a 8 or 4 pixel wide block, 4 rows of 8 pixels or 8
+// rows of 4 pixels, the first half of the rows into the low lane. A 4x4 block
+// only fills the low lane, its rows are loaded into both lanes.
+static INLINE __m256i load_narrow(const uint8_t *p, int stride, int width,
+                                  int height) {
+  __m128i lo, hi;
+  if (width == 8) {
+    lo = _mm_unpacklo_epi64(_mm_loadl_epi64((__m128i const *) (p)),
+                            _mm_loadl_epi64((__m128i const *) (p + stride)));
+    p += 2 * stride;
+    hi = _mm_unpacklo_epi64(_mm_loadl_epi64((__m128i const *) (p)),
+                            _mm_loadl_epi64((__m128i const *) (p + stride)));
+  } else {
+    lo = _mm_setr_epi32(*(const int *) (p), *(const int *) (p + stride),
+                        *(const int *) (p + 2 * stride),
+                        *(const int *) (p + 3 * stride));
+    if (height > 4) {
+      p += 4 * stride;
+      hi = _mm_setr_epi32(*(const int *) (p), *(const int *) (p + stride),
+                          *(const int *) (p + 2 * stride),
+                          *(const int *) (p + 3 * stride));
+    } else {
+      hi = lo;
+    }
+  }
+  return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+}
+
+// Horizontally filtered next rows of a 8 or 4 pixel wide block.
+static INLINE __m256i filter_x_narrow(const uint8_t *p, int stride,
+                                      int width, int height,
+                                      int x_offset, __m256i filter) {
+  const __m256i src_reg = load_narrow(p, stride, width, height);
+  if (x_offset == 0)
+    return src_reg;
+  return filter_16x2(src_reg, load_narrow(p + 1, stride, width, height),
+                     filter);
+}
+
+// Processes 4 rows of 8 pixels or 8 rows of 4 pixels per 256 bit register. The
+// rows below are filtered horizontally again rather than shuffled across the
+// lanes. The prediction is averaged with sec unless it is NULL.
+static int sub_pixel_variance_narrow(const uint8_t *src, int src_stride,
+                                     int x_offset, int y_offset,
+                                     const uint8_t *dst, int dst_stride,
+                                     const uint8_t *sec, int sec_stride,
+                                     int width, int height,
+                                     unsigned int *sse) {
+  const __m256i xfilter = _mm256_load_si256((__m256i const *)
+                          (bilinear_filters_avx2 + (x_offset << 5)));
+  const __m256i yfilter = _mm256_load_si256((__m256i const *)
+                          (bilinear_filters_avx2 + (y_offset << 5)));
+  const __m256i zero_reg = _mm256_setzero_si256();
+  // Drops the high lane of a 4x4 block, which repeats the low lane.
+  const __m256i mask = width == 4 && height == 4 ?
+      _mm256_setr_epi64x(-1, -1, 0, 0) : _mm256_set1_epi8(-1);
+  const int rows = width == 8 || height == 4 ? 4 : 8;
+  __m256i sum_reg = _mm256_setzero_si256();
+  __m256i sse_reg = _mm256_setzero_si256();
+  int i;
+
+  for (i = 0; i < height; i += rows) {
+    __m256i pred_reg = filter_x_narrow(src, src_stride, width, height,
+                                       x_offset, xfilter);
+    __m256i dst_reg, exp_src_lo, exp_src_hi;
+
+    if (y_offset) {
+      const __m256i src_next_reg =
+          filter_x_narrow(src + src_stride, src_stride, width, height,
+                          x_offset, xfilter);
+      pred_reg = filter_16x2(pred_reg, src_next_reg, yfilter);
+    }
+
+    if (sec != NULL) {
+      pred_reg = _mm256_avg_epu8(pred_reg,
+                                 load_narrow(sec, sec_stride, width, height));
+      sec += rows * sec_stride;
+    }
+
+    dst_reg = load_narrow(dst, dst_stride, width, height);
+    exp_src_lo = _mm256_sub_epi16(_mm256_unpacklo_epi8(pred_reg, zero_reg),
+                                  _mm256_unpacklo_epi8(dst_reg, zero_reg));
+    exp_src_hi = _mm256_sub_epi16(_mm256_unpackhi_epi8(pred_reg, zero_reg),
+                                  _mm256_unpackhi_epi8(dst_reg, zero_reg));
+    exp_src_lo = _mm256_and_si256(exp_src_lo, mask);
+    exp_src_hi = _mm256_and_si256(exp_src_hi, mask);
+    sum_reg = _mm256_add_epi16(sum_reg,
+                               _mm256_add_epi16(exp_src_lo, exp_src_hi));
+    sse_reg = _mm256_add_epi32(sse_reg,
+                               _mm256_madd_epi16(exp_src_lo, exp_src_lo));
+    sse_reg = _mm256_add_epi32(sse_reg,
+                               _mm256_madd_epi16(exp_src_hi, exp_src_hi));
+    src += rows * src_stride;
+    dst += rows * dst_stride;
+  }
+
+  *sse = hadd_epi32_avx2(sse_reg);
+  return hadd_epi32_avx2(_mm256_madd_epi16(sum_reg, _mm256_set1_epi16(1)));
+}
+
+unsigned int vpx_sub_pixel_variance8xh_avx2(const uint8_t *src,
+                                            int src_stride,
+                                            int x_offset,
+                                            int y_offset,
+                                            const uint8_t *dst,
+                                            int dst_stride,
+                                            int height,
+                                            unsigned int *sse) {
+  return sub_pixel_variance_narrow(src, src_stride, x_offset, y_offset,
+                                   dst, dst_stride, NULL, 0, 8, height, sse);
+}
+
+unsigned int vpx_sub_pixel_avg_variance8xh_avx2(const uint8_t *src,
+                                                int src_stride,
+                                                int x_offset,
+                                                int y_offset,
+                                                const uint8_t *dst,
+                                                int dst_stride,
+                                                const uint8_t *sec,
+                                                int sec_stride,
+                                                int height,
+                                                unsigned int *sse) {
+  return sub_pixel_variance_narrow(src, src_stride, x_offset, y_offset,
+                                   dst, dst_stride, sec, sec_stride, 8, height,
+                                   sse);
+}
+
+unsigned int vpx_sub_pixel_variance4xh_avx2(const uint8_t *src,
+                                            int src_stride,
+                                            int x_offset,
+                                            int y_offset,
+                                            const uint8_t *dst,
+                                            int dst_stride,
+                                            int height,
+                                            unsigned int *sse) {
+  return sub_pixel_variance_narrow(src, src_stride, x_offset, y_offset,
+                                   dst, dst_stride, NULL, 0, 4, height, sse);
+}
+
+unsigned int vpx_sub_pixel_avg_variance4xh_avx2(const uint8_t *src,
+                                                int src_stride,
+                                                int x_offset,
+                                                int y_offset,
+                                                const uint8_t *dst,
+                                                int dst_stride,
+                                                const uint8_t *sec,
+                                                int sec_stride,
+                                                int height,
+                                                unsigned int *sse) {
+  return sub_pixel_variance_narrow(src, src_stride, x_offset, y_offset,
+                                   dst, dst_stride, sec, sec_stride, 4, height,
+                                   sse);
+}
@@ -0,0 +1,273 @@
+/*
+ *  Copyright (c) 2016 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <assert.h>
+#include <string.h>   // for memset()
+
+#include "./vpx_thread_pool.h"
+#include "vpx_mem/vpx_mem.h"
+
+// State of a worker hook in the pool.
+typedef enum {
+  TASK_IDLE = 0,  // not launched, or finished
+  TASK_QUEUED,    // waiting in the queue for a thread
+  TASK_RUNNING    // picked up by a pool thread
+} PoolTaskStatus;
+
+// Pool side state of a worker, stored in its impl_ pointer.
+typedef struct PoolTask {
+  VPxWorker *worker;
+  struct PoolTask *next;
+  PoolTaskStatus status;
+#if CONFIG_MULTITHREAD
+  pthread_cond_t done_;  // signaled when a running hook returns
+#endif
+} PoolTask;
+
+#if CONFIG_MULTITHREAD
+
+static struct {
+  pthread_mutex_t mutex_;
+  pthread_cond_t work_;  // signaled when a task is queued, or on shutdown
+  pthread_t threads_[VPX_THREAD_POOL_MAX_THREADS];
+  int num_threads;
+  int shutdown;
+  PoolTask *head;
+  PoolTask *tail;
+} g_pool;
+
+static PoolTask *get_task(VPxWorker *const worker) {
+  return (PoolTask*)worker->impl_;
+}
+
+static void execute(VPxWorker *const worker);  // Forward declaration.
+
+// Runs the hook of a task taken off the queue, then wakes up its sync(). The
+// pool mutex is held on entry and on exit.
+static void run_task(PoolTask *const task) {
+  task->status = TASK_RUNNING;
+  pthread_mutex_unlock(&g_pool.mutex_);
+  execute(task->worker);
+  pthread_mutex_lock(&g_pool.mutex_);
+  task->status = TASK_IDLE;
+  task->worker->status_ = OK;
+  pthread_cond_signal(&task->done_);
+}
+
+static THREADFN thread_loop(void *ptr) {
+  (void)ptr;
+  pthread_mutex_lock(&g_pool.mutex_);
+  while (1) {
+    PoolTask *task;
+    while (g_pool.head == NULL && !g_pool.shutdown) {
+      pthread_cond_wait(&g_pool.work_, &g_pool.mutex_);
+    }
+    if (g_pool.head == NULL) break;  // shutdown with an empty queue
+    task = g_pool.head;
+    g_pool.head = task->next;
+    if (g_pool.head == NULL) g_pool.tail = NULL;
+    task->next = NULL;
+    run_task(task);
+  }
+  pthread_mutex_unlock(&g_pool.mutex_);
+  return THREAD_RETURN(NULL);
+}
+
+// Removes a queued task from the queue. The pool mutex must be held.
+static void unqueue_task(PoolTask *const task) {
+  PoolTask *prev = NULL;
+  PoolTask *cur = g_pool.head;
+  while (cur != task) {
+    prev = cur;
+    cur = cur->next;
+  }
+  assert(cur != NULL);
+  if (prev == NULL) {
+    g_pool.head = task->next;
+  } else {
+    prev->next = task->next;
+  }
+  if (g_pool.tail == task) g_pool.tail = prev;
+  task->next = NULL;
+}
+
+int vpx_thread_pool_init(int num_threads) {
+  int i;
+  if (g_pool.num_threads > 0 || num_threads <= 0) return 0;
+  num_threads = num_threads < VPX_THREAD_POOL_MAX_THREADS ?
+      num_threads : VPX_THREAD_POOL_MAX_THREADS;
+
+  memset(&g_pool, 0, sizeof(g_pool));
+  if (pthread_mutex_init(&g_pool.mutex_, NULL)) return 0;
+  if (pthread_cond_init(&g_pool.work_, NULL)) {
+    pthread_mutex_destroy(&g_pool.mutex_);
+    return 0;
+  }
+  for (i = 0; i < num_threads; ++i) {
+    if (pthread_create(&g_pool.threads_[i], NULL, thread_loop, NULL)) break;
+  }
+  g_pool.num_threads = i;
+  if (i < num_threads) {
+    if (i > 0) {
+      vpx_thread_pool_end();
+    } else {
+      pthread_cond_destroy(&g_pool.work_);
+      pthread_mutex_destroy(&g_pool.mutex_);
+    }
+    return 0;
+  }
+  return 1;
+}
+
+void vpx_thread_pool_end(void) {
+  int i;
+  if (g_pool.num_threads == 0) return;
+
+  pthread_mutex_lock(&g_pool.mutex_);
+  g_pool.shutdown = 1;
+  // The win32 condition variable wrapper lacks a broadcast.
+  for (i = 0; i < g_pool.num_threads; ++i) {
+    pthread_cond_signal(&g_pool.work_);
+  }
+  pthread_mutex_unlock(&g_pool.mutex_);
+
+  for (i = 0; i < g_pool.num_threads; ++i) {
+    pthread_join(g_pool.threads_[i], NULL);
+  }
+  assert(g_pool.head == NULL);
+  pthread_cond_destroy(&g_pool.work_);
+  pthread_mutex_destroy(&g_pool.mutex_);
+  memset(&g_pool, 0, sizeof(g_pool));
+}
+
+int vpx_thread_pool_get_num_threads(void) {
+  return g_pool.num_threads;
+}
+
+#else
+
+int vpx_thread_pool_init(int num_threads) {
+  (void)num_threads;
+  return 0;
+}
+
+void vpx_thread_pool_end(void) {
+}
+
+int vpx_thread_pool_get_num_threads(void) {
+  return 0;
+}
+
+#endif  // CONFIG_MULTITHREAD
+
+//------------------------------------------------------------------------------
+
+static void init(VPxWorker *const worker) {
+  memset(worker, 0, sizeof(*worker));
+  worker->status_ = NOT_OK;
+}
+
+static int sync(VPxWorker *const worker) {
+#if CONFIG_MULTITHREAD
+  PoolTask *const task = get_task(worker);
+  if (task != NULL) {
+    pthread_mutex_lock(&g_pool.mutex_);
+    if (task->status == TASK_QUEUED) {
+      // Not picked up yet: run it on this thread rather than wait for one.
+      unqueue_task(task);
+      run_task(task);
+    }
+    while (task->status != TASK_IDLE) {
+      pthread_cond_wait(&task->done_, &g_pool.mutex_);
+    }
+    pthread_mutex_unlock(&g_pool.mutex_);
+  }
+#endif
+  assert(worker->status_ <= OK);
+  return !worker->had_error;
+}
+
+static int reset(VPxWorker *const worker) {
+  int ok = 1;
+  worker->had_error = 0;
+  if (worker->status_ < OK) {
+#if CONFIG_MULTITHREAD
+    PoolTask *const task = (PoolTask*)vpx_calloc(1, sizeof(*task));
+    if (task == NULL) {
+      return 0;
+    }
+    if (pthread_cond_init(&task->done_, NULL)) {
+      vpx_free(task);
+      return 0;
+    }
+    task->worker = worker;
+    worker->impl_ = (VPxWorkerImpl*)task;
+#endif
+    worker->status_ = OK;
+  } else if (worker->status_ > OK) {
+    ok = sync(worker);
+  }
+  assert(!ok || (worker->status_ == OK));
+  return ok;
+}
+
+static void execute(VPxWorker *const worker) {
+  if (worker->hook != NULL) {
+    worker->had_error |= !worker->hook(worker->data1, worker->data2);
+  }
+}
+
+static void launch(VPxWorker *const worker) {
+#if CONFIG_MULTITHREAD
+  PoolTask *const task = get_task(worker);
+  if (task == NULL || g_pool.num_threads == 0) {
+    execute(worker);
+    return;
+  }
+  // Wait for the previous job, as the default interface does.
+  sync(worker);
+  pthread_mutex_lock(&g_pool.mutex_);
+  worker->status_ = WORK;
+  task->status = TASK_QUEUED;
+  if (g_pool.tail == NULL) {
+    g_pool.head = task;
+  } else {
+    g_pool.tail->next = task;
+  }
+  g_pool.tail = task;
+  pthread_cond_signal(&g_pool.work_);
+  pthread_mutex_unlock(&g_pool.mutex_);
+#else
+  execute(worker);
+#endif
+}
+
+static void end(VPxWorker *const worker) {
+#if CONFIG_MULTITHREAD
+  PoolTask *const task = get_task(worker);
+  if (task != NULL) {
+    sync(worker);
+    pthread_cond_destroy(&task->done_);
+    vpx_free(task);
+    worker->impl_ = NULL;
+  }
+#endif
+  worker->status_ = NOT_OK;
+}
+
+//------------------------------------------------------------------------------
+
+static const VPxWorkerInterface g_pool_interface = {
+  init, reset, sync, launch, execute, end
+};
+
+const VPxWorkerInterface *vpx_get_thread_pool_interface(void) {
+  return &g_pool_interface;
+}
@@ -0,0 +1,57 @@
+/*
+ *  Copyright (c) 2016 The WebM project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Process-wide thread pool backing the VPxWorkerInterface.
+//
+// By default every VPxWorker owns a thread, so each codec instance creates its
+// own set of threads. When the pool interface is installed with
+//   vpx_thread_pool_init(num_threads);
+//   vpx_set_worker_interface(vpx_get_thread_pool_interface());
+// workers no longer own a thread: launch() queues the worker's hook and the
+// pool threads run the queued hooks of all the codec instances of the process.
+//
+// The queued hooks are started in the order they were launched, and sync()
+// runs the hook of a worker that has not been picked up yet on the calling
+// thread. Hooks that wait on the progress of hooks launched before them, e.g.
+// the row based loop filter, therefore do not need as many pool threads as
+// there are workers.
+
+#ifndef VPX_UTIL_VPX_THREAD_POOL_H_
+#define VPX_UTIL_VPX_THREAD_POOL_H_
+
+#include "./vpx_thread.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Maximum number of threads in the pool.
+#define VPX_THREAD_POOL_MAX_THREADS 64
+
+// Starts the pool with 'num_threads' threads, capped at
+// VPX_THREAD_POOL_MAX_THREADS. Must be called before the pool interface is
+// installed, and is not thread-safe. Returns false in case of error.
+int vpx_thread_pool_init(int num_threads);
+
+// Stops and joins the pool threads. The default interface must have been
+// reinstalled and all the pool workers ended beforehand.
+void vpx_thread_pool_end(void);
+
+// Returns the number of threads in the pool, 0 if it is not running.
+int vpx_thread_pool_get_num_threads(void);
+
+// Retrieve the thread worker interface that runs the hooks on the pool.
+const VPxWorkerInterface *vpx_get_thread_pool_interface(void);
+
+#ifdef __cplusplus
+}    // extern "C"
+#endif
+
+#endif  // VPX_UTIL_VPX_THREAD_POOL_H_
@@ -77,6 +77,8 @@ static const arg_def_t threadsarg = ARG_DEF(
     "t", "threads", 1, "Max threads to use");
 static const arg_def_t frameparallelarg = ARG_DEF(
     NULL, "frame-parallel", 0, "Frame parallel decode");
+static const arg_def_t rowmtarg = ARG_DEF(
+    NULL, "row-mt", 0, "Row based multi-threaded decode (VP9)");
 static const arg_def_t verbosearg = ARG_DEF(
     "v", "verbose", 0, "Show version string");
 static const arg_def_t error_concealment = ARG_DEF(
@@ -97,7 +99,7 @@ static const arg_def_t outbitdeptharg = ARG_DEF(
 static const arg_def_t *all_args[] = {
   &codecarg, &use_yv12, &use_i420, &flipuvarg, &rawvideo, &noblitarg,
   &progressarg, &limitarg, &skiparg, &postprocarg, &summaryarg, &outputfile,
-  &threadsarg, &frameparallelarg, &verbosearg, &scalearg, &fb_arg,
+  &threadsarg, &frameparallelarg, &rowmtarg, &verbosearg, &scalearg, &fb_arg,
   &md5arg, &error_concealment, &continuearg,
 #if CONFIG_VP9_HIGHBITDEPTH
   &outbitdeptharg,
@@ -206,69 +208,113 @@ void usage_exit(void) {
   exit(EXIT_FAILURE);
 }
 
+// Returns the size of a raw frame from its header, or 0 if it is corrupt.
+static size_t raw_frame_size(const uint8_t *raw_hdr) {
+  const size_t kCorruptFrameThreshold = 256 * 1024 * 1024;
+  const size_t kFrameTooSmallThreshold = 256 * 1024;
+  size_t frame_size = mem_get_le32(raw_hdr);
+
+  if (frame_size > kCorruptFrameThreshold) {
+    warn("Read invalid frame size (%u)\n", (unsigned int)frame_size);
+    frame_size = 0;
+  }
+
+  if (frame_size < kFrameTooSmallThreshold) {
+    warn("Warning: Read invalid frame size (%u) - not a raw file?\n",
+         (unsigned int)frame_size);
+  }
+
+  return frame_size;
+}
+
 static int raw_read_frame(FILE *infile, uint8_t **buffer,
                           size_t *bytes_read, size_t *buffer_size) {
-  char raw_hdr[RAW_FRAME_HDR_SZ];
+  uint8_t raw_hdr[RAW_FRAME_HDR_SZ];
   size_t frame_size = 0;
 
   if (fread(raw_hdr, RAW_FRAME_HDR_SZ, 1, infile) != 1) {
     if (!feof(infile))
       warn("Failed to read RAW frame size\n");
-  } else {
-    const size_t kCorruptFrameThreshold = 256 * 1024 * 1024;
-    const size_t kFrameTooSmallThreshold = 256 * 1024;
-    frame_size = mem_get_le32(raw_hdr);
+    return 1;
+  }
 
-    if (frame_size > kCorruptFrameThreshold) {
-      warn("Read invalid frame size (%u)\n", (unsigned int)frame_size);
-      frame_size = 0;
-    }
+  frame_size = raw_frame_size(raw_hdr);
 
-    if (frame_size < kFrameTooSmallThreshold) {
-      warn("Warning: Read invalid frame size (%u) - not a raw file?\n",
-           (unsigned int)frame_size);
+  if (frame_size > *buffer_size) {
+    uint8_t *new_buf = realloc(*buffer, 2 * frame_size);
+    if (new_buf) {
+      *buffer = new_buf;
+      *buffer_size = 2 * frame_size;
+    } else {
+      warn("Failed to allocate compressed data buffer\n");
+      frame_size = 0;
     }
+  }
 
-    if (frame_size > *buffer_size) {
-      uint8_t *new_buf = realloc(*buffer, 2 * frame_size);
-      if (new_buf) {
-        *buffer = new_buf;
-        *buffer_size = 2 * frame_size;
-      } else {
-        warn("Failed to allocate compressed data buffer\n");
-        frame_size = 0;
-      }
-    }
+  if (fread(*buffer, 1, frame_size, infile) != frame_size) {
+    warn("Failed to read full frame\n");
+    return 1;
   }
+  *bytes_read = frame_size;
 
-  if (!feof(infile)) {
-    if (fread(*buffer, 1, frame_size, infile) != frame_size) {
-      warn("Failed to read full frame\n");
-      return 1;
-    }
-    *bytes_read = frame_size;
+  return 0;
+}
+
+static int raw_read_frame_mapped(struct VpxInputMap *map,
+                                 const uint8_t **buffer, size_t *bytes_read) {
+  const uint8_t *const raw_hdr = vpx_input_map_read(map, RAW_FRAME_HDR_SZ);
+  size_t frame_size;
+
+  if (raw_hdr == NULL)
+    return 1;
+
+  frame_size = raw_frame_size(raw_hdr);
+  *buffer = vpx_input_map_read(map, frame_size);
+  if (*buffer == NULL) {
+    warn("Failed to read full frame\n");
+    return 1;
   }
 
+  *bytes_read = frame_size;
   return 0;
 }
 
-static int read_frame(struct VpxDecInputContext *input, uint8_t **buf,
-                      size_t *bytes_in_buffer, size_t *buffer_size) {
+// Sets |*frame| to the next frame of the input. Mapped inputs point it into
+// the mapping; the others read it into |*buf|, which is (re)allocated as
+// needed.
+static int read_frame(struct VpxDecInputContext *input, const uint8_t **frame,
+                      uint8_t **buf, size_t *bytes_in_buffer,
+                      size_t *buffer_size) {
+  struct VpxInputMap *const map = &input->vpx_input_ctx->map;
+  int status;
+
   switch (input->vpx_input_ctx->file_type) {
 #if CONFIG_WEBM_IO
     case FILE_TYPE_WEBM:
-      return webm_read_frame(input->webm_ctx,
-                             buf, bytes_in_buffer, buffer_size);
+      if (map->data)
+        return webm_read_frame_mapped(input->webm_ctx, frame, bytes_in_buffer);
+      status = webm_read_frame(input->webm_ctx,
+                               buf, bytes_in_buffer, buffer_size);
+      break;
 #endif
     case FILE_TYPE_RAW:
-      return raw_read_frame(input->vpx_input_ctx->file,
-                            buf, bytes_in_buffer, buffer_size);
+      if (map->data)
+        return raw_read_frame_mapped(map, frame, bytes_in_buffer);
+      status = raw_read_frame(input->vpx_input_ctx->file,
+                              buf, bytes_in_buffer, buffer_size);
+      break;
     case FILE_TYPE_IVF:
-      return ivf_read_frame(input->vpx_input_ctx->file,
-                            buf, bytes_in_buffer, buffer_size);
+      if (map->data)
+        return ivf_read_frame_mapped(map, frame, bytes_in_buffer);
+      status = ivf_read_frame(input->vpx_input_ctx->file,
+                              buf, bytes_in_buffer, buffer_size);
+      break;
     default:
       return 1;
   }
+
+  *frame = *buf;
+  return status;
 }
 
 static void update_image_md5(const vpx_image_t *img, const int planes[3],
@@ -542,10 +588,12 @@ static int main_loop(int argc, const char **argv_) {
   char                  *fn = NULL;
   int                    i;
   uint8_t               *buf = NULL;
+  const uint8_t         *frame_data = NULL;
   size_t                 bytes_in_buffer = 0, buffer_size = 0;
   FILE                  *infile;
   int                    frame_in = 0, frame_out = 0, flipuv = 0, noblit = 0;
   int                    do_md5 = 0, progress = 0, frame_parallel = 0;
+  int                    row_mt = 0;
   int                    stop_after = 0, postproc = 0, summary = 0, quiet = 1;
   int                    arg_skip = 0;
   int                    ec_enabled = 0;
@@ -596,6 +644,7 @@ static int main_loop(int argc, const char **argv_) {
   memset(&(webm_ctx), 0, sizeof(webm_ctx));
   input.webm_ctx = &webm_ctx;
 #endif
+  memset(&vpx_input_ctx, 0, sizeof(vpx_input_ctx));
   input.vpx_input_ctx = &vpx_input_ctx;
 
   /* Parse command line */
@@ -645,6 +694,10 @@ static int main_loop(int argc, const char **argv_) {
 #if CONFIG_VP9_DECODER || CONFIG_VP10_DECODER
     else if (arg_match(&arg, &frameparallelarg, argi))
       frame_parallel = 1;
+#endif
+#if CONFIG_VP9_DECODER
+    else if (arg_match(&arg, &rowmtarg, argi))
+      row_mt = 1;
 #endif
     else if (arg_match(&arg, &verbosearg, argi))
       quiet = 0;
@@ -742,6 +795,8 @@ static int main_loop(int argc, const char **argv_) {
   }
 #endif
   input.vpx_input_ctx->file = infile;
+  /* Regular files are mapped, so that the frames can be decoded in place. */
+  vpx_input_map(input.vpx_input_ctx);
   if (file_is_ivf(input.vpx_input_ctx))
     input.vpx_input_ctx->file_type = FILE_TYPE_IVF;
 #if CONFIG_WEBM_IO
@@ -810,6 +865,16 @@ static int main_loop(int argc, const char **argv_) {
   if (!quiet)
     fprintf(stderr, "%s\n", decoder.name);
 
+#if CONFIG_VP9_DECODER
+  if (row_mt && interface->fourcc != VP9_FOURCC) {
+    warn("--row-mt is only supported by VP9, ignored.\n");
+  } else if (row_mt && vpx_codec_control(&decoder, VP9D_SET_ROW_MT, 1)) {
+    fprintf(stderr, "Failed to enable row based multi-threading: %s\n",
+            vpx_codec_error(&decoder));
+    return EXIT_FAILURE;
+  }
+#endif
+
 #if CONFIG_VP8_DECODER
   if (vp8_pp_cfg.post_proc_flag
       && vpx_codec_control(&decoder, VP8_SET_POSTPROC, &vp8_pp_cfg)) {
@@ -855,7 +920,8 @@ static int main_loop(int argc, const char **argv_) {
   if (arg_skip)
     fprintf(stderr, "Skipping first %d frames.\n", arg_skip);
   while (arg_skip) {
-    if (read_frame(&input, &buf, &bytes_in_buffer, &buffer_size))
+    if (read_frame(&input, &frame_data, &buf, &bytes_in_buffer,
+                   &buffer_size))
       break;
     arg_skip--;
   }
@@ -885,14 +951,15 @@ static int main_loop(int argc, const char **argv_) {
 
     frame_avail = 0;
     if (!stop_after || frame_in < stop_after) {
-      if (!read_frame(&input, &buf, &bytes_in_buffer, &buffer_size)) {
+      if (!read_frame(&input, &frame_data, &buf, &bytes_in_buffer,
+                      &buffer_size)) {
         frame_avail = 1;
         frame_in++;
 
         vpx_usec_timer_start(&timer);
 
-        if (vpx_codec_decode(&decoder, buf, (unsigned int)bytes_in_buffer,
-                             NULL, 0)) {
+        if (vpx_codec_decode(&decoder, frame_data,
+                             (unsigned int)bytes_in_buffer, NULL, 0)) {
           const char *detail = vpx_codec_error_detail(&decoder);
           warn("Failed to decode frame %d: %s",
                frame_in, vpx_codec_error(&decoder));
@@ -1131,6 +1198,7 @@ fail:
   }
   free(ext_fb_list.ext_fb);
 
+  vpx_input_unmap(input.vpx_input_ctx);
   fclose(infile);
   free(argv);
 
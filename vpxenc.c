@@ -42,6 +42,7 @@
 #include "vpx/vpx_integer.h"
 #include "vpx_ports/mem_ops.h"
 #include "vpx_ports/vpx_timer.h"
+#include "vpx_util/vpx_thread.h"
 #include "./rate_hist.h"
 #include "./vpxstats.h"
 #include "./warnings.h"
@@ -105,8 +106,16 @@ static int read_frame(struct VpxInputContext *input_ctx, vpx_image_t *img) {
   int shortread = 0;
 
   if (input_ctx->file_type == FILE_TYPE_Y4M) {
-    if (y4m_input_fetch_frame(y4m, f, img) < 1)
+    struct VpxInputMap *const map = &input_ctx->map;
+    if (map->data) {
+      const uint8_t *buf = map->data + map->pos;
+      if (y4m_input_fetch_frame_mapped(y4m, &buf, map->data + map->size,
+                                       img) < 1)
+        return 0;
+      map->pos = buf - map->data;
+    } else if (y4m_input_fetch_frame(y4m, f, img) < 1) {
       return 0;
+    }
   } else {
     shortread = read_yuv_frame(input_ctx, img);
   }
@@ -405,6 +414,13 @@ static const arg_def_t min_gf_interval = ARG_DEF(
 static const arg_def_t max_gf_interval = ARG_DEF(
     NULL, "max-gf-interval", 1,
     "max gf/arf frame interval (default 0, indicating in-built behavior)");
+static const arg_def_t row_mt = ARG_DEF(
+    NULL, "row-mt", 1,
+    "Enable row based multi-threading (0: off (default), 1: on)");
+static const arg_def_t target_frame_time = ARG_DEF(
+    NULL, "target-frame-time", 1,
+    "Tune the speed features to encode a frame in this time, in us "
+    "(default 0: off)");
 
 static const struct arg_enum_list color_space_enum[] = {
   { "unknown", VPX_CS_UNKNOWN },
@@ -456,7 +472,7 @@ static const arg_def_t *vp9_args[] = {
   &gf_cbr_boost_pct, &lossless,
   &frame_parallel_decoding, &aq_mode, &frame_periodic_boost,
   &noise_sens, &tune_content, &input_color_space,
-  &min_gf_interval, &max_gf_interval,
+  &min_gf_interval, &max_gf_interval, &row_mt, &target_frame_time,
 #if CONFIG_VP9_HIGHBITDEPTH
   &bitdeptharg, &inbitdeptharg,
 #endif  // CONFIG_VP9_HIGHBITDEPTH
@@ -472,7 +488,8 @@ static const int vp9_arg_ctrl_map[] = {
   VP9E_SET_LOSSLESS, VP9E_SET_FRAME_PARALLEL_DECODING, VP9E_SET_AQ_MODE,
   VP9E_SET_FRAME_PERIODIC_BOOST, VP9E_SET_NOISE_SENSITIVITY,
   VP9E_SET_TUNE_CONTENT, VP9E_SET_COLOR_SPACE,
-  VP9E_SET_MIN_GF_INTERVAL, VP9E_SET_MAX_GF_INTERVAL,
+  VP9E_SET_MIN_GF_INTERVAL, VP9E_SET_MAX_GF_INTERVAL, VP9E_SET_ROW_MT,
+  VP9E_SET_TARGET_FRAME_TIME,
   0
 };
 #endif
@@ -782,10 +799,10 @@ static int compare_img(const vpx_image_t *const img1,
 
 
 #define NELEMENTS(x) (sizeof(x)/sizeof(x[0]))
-#if CONFIG_VP10_ENCODER
-#define ARG_CTRL_CNT_MAX NELEMENTS(vp10_arg_ctrl_map)
-#elif CONFIG_VP9_ENCODER
+#if CONFIG_VP9_ENCODER
 #define ARG_CTRL_CNT_MAX NELEMENTS(vp9_arg_ctrl_map)
+#elif CONFIG_VP10_ENCODER
+#define ARG_CTRL_CNT_MAX NELEMENTS(vp10_arg_ctrl_map)
 #else
 #define ARG_CTRL_CNT_MAX NELEMENTS(vp8_arg_ctrl_map)
 #endif
@@ -1011,6 +1028,10 @@ static void open_input_file(struct VpxInputContext *input) {
       input->framerate.denominator = input->y4m.fps_d;
       input->fmt = input->y4m.vpx_fmt;
       input->bit_depth = input->y4m.bit_depth;
+      /* Read the frames from a mapping of the file when possible, so that
+       * the ones needing no conversion can be encoded in place.
+       */
+      vpx_input_map(input);
     } else
       fatal("Unsupported Y4M stream.");
   } else if (input->detect.buf_read == 4 && fourcc_is_ivf(input->detect.buf)) {
@@ -1022,11 +1043,249 @@ static void open_input_file(struct VpxInputContext *input) {
 
 
 static void close_input_file(struct VpxInputContext *input) {
+  vpx_input_unmap(input);
   fclose(input->file);
   if (input->file_type == FILE_TYPE_Y4M)
     y4m_input_close(&input->y4m);
 }
 
+
+/* Input frames are read ahead of the encoder into a small ring, by a
+ * reader thread when threads are available. The file is only touched by
+ * that thread while it runs.
+ */
+#define INPUT_QUEUE_SIZE 4
+
+struct input_frame {
+  vpx_image_t               img;    /* the image handed to the encoder */
+  vpx_image_t               buf;    /* storage owned by this entry */
+  int                       buf_allocated;
+  int64_t                   pos;    /* input position after the frame */
+};
+
+struct input_reader {
+  struct VpxInputContext   *input;
+  int                       limit;  /* frames to read, 0 for all */
+  int                       frames_read;
+  struct input_frame        frames[INPUT_QUEUE_SIZE];
+  int                       head;   /* next frame for the encoder */
+  int                       count;  /* frames ready for the encoder */
+  int                       done;
+  uint64_t                  read_time;
+  uint64_t                  wait_time;
+#if CONFIG_MULTITHREAD
+  int                       threaded;
+  pthread_mutex_t           mutex;
+  pthread_cond_t            cond;
+  pthread_t                 thread;
+#endif
+};
+
+
+static void copy_image(const vpx_image_t *src, vpx_image_t *dst) {
+  const int bytes_per_sample = (src->fmt & VPX_IMG_FMT_HIGHBITDEPTH) ? 2 : 1;
+  int plane;
+
+  for (plane = 0; plane < 3; ++plane) {
+    const unsigned char *s = src->planes[plane];
+    unsigned char *d = dst->planes[plane];
+    const int w = vpx_img_plane_width(src, plane) * bytes_per_sample;
+    const int h = vpx_img_plane_height(src, plane);
+    int y;
+
+    for (y = 0; y < h; ++y) {
+      memcpy(d, s, w);
+      s += src->stride[plane];
+      d += dst->stride[plane];
+    }
+  }
+}
+
+
+static int image_in_input_map(const struct VpxInputMap *map,
+                              const vpx_image_t *img) {
+  return map->data && img->planes[VPX_PLANE_Y] >= map->data &&
+         img->planes[VPX_PLANE_Y] < map->data + map->size;
+}
+
+
+/* Reads the next input frame into an entry of the ring. Returns 0 at the
+ * end of the input or of the frame limit.
+ */
+static int read_input_frame(struct input_reader *reader,
+                            struct input_frame *frame) {
+  struct VpxInputContext *const input = reader->input;
+  struct vpx_usec_timer timer;
+  int frame_avail;
+
+  if (reader->limit && reader->frames_read >= reader->limit)
+    return 0;
+
+  vpx_usec_timer_start(&timer);
+  if (input->file_type == FILE_TYPE_Y4M) {
+    /* Frames used in place from the mapping stay valid, but the Y4M reader
+     * reuses its own buffer for the other ones.
+     */
+    frame_avail = read_frame(input, &frame->img);
+    if (frame_avail && !image_in_input_map(&input->map, &frame->img)) {
+      if (!frame->buf_allocated) {
+        if (!vpx_img_alloc(&frame->buf, frame->img.fmt, frame->img.d_w,
+                           frame->img.d_h, 32))
+          fatal("Failed to allocate input frame");
+        frame->buf_allocated = 1;
+      }
+      copy_image(&frame->img, &frame->buf);
+      frame->img = frame->buf;
+    }
+  } else {
+    frame_avail = read_frame(input, &frame->buf);
+    frame->img = frame->buf;
+  }
+  frame->pos = vpx_input_tell(input);
+  vpx_usec_timer_mark(&timer);
+  reader->read_time += vpx_usec_timer_elapsed(&timer);
+
+  if (frame_avail)
+    reader->frames_read++;
+  return frame_avail;
+}
+
+
+#if CONFIG_MULTITHREAD
+static THREADFN input_reader_thread(void *arg) {
+  struct input_reader *const reader = (struct input_reader *)arg;
+  int frame_avail;
+
+  do {
+    struct input_frame *frame;
+
+    pthread_mutex_lock(&reader->mutex);
+    while (reader->count == INPUT_QUEUE_SIZE)
+      pthread_cond_wait(&reader->cond, &reader->mutex);
+    frame = &reader->frames[(reader->head + reader->count) % INPUT_QUEUE_SIZE];
+    pthread_mutex_unlock(&reader->mutex);
+
+    frame_avail = read_input_frame(reader, frame);
+
+    pthread_mutex_lock(&reader->mutex);
+    if (frame_avail)
+      reader->count++;
+    else
+      reader->done = 1;
+    pthread_cond_signal(&reader->cond);
+    pthread_mutex_unlock(&reader->mutex);
+  } while (frame_avail);
+
+  return THREAD_RETURN(NULL);
+}
+#endif
+
+
+static void start_input_reader(struct input_reader *reader,
+                               struct VpxInputContext *input, int limit) {
+  int i;
+
+  memset(reader, 0, sizeof(*reader));
+  reader->input = input;
+  reader->limit = limit;
+
+  /* Raw frames are read into preallocated images. */
+  if (input->file_type != FILE_TYPE_Y4M) {
+    for (i = 0; i < INPUT_QUEUE_SIZE; i++) {
+      if (!vpx_img_alloc(&reader->frames[i].buf, input->fmt, input->width,
+                         input->height, 32))
+        fatal("Failed to allocate input frame");
+      reader->frames[i].buf_allocated = 1;
+    }
+  }
+
+#if CONFIG_MULTITHREAD
+  if (pthread_mutex_init(&reader->mutex, NULL))
+    return;
+  if (pthread_cond_init(&reader->cond, NULL)) {
+    pthread_mutex_destroy(&reader->mutex);
+    return;
+  }
+  reader->threaded = !pthread_create(&reader->thread, NULL,
+                                     input_reader_thread, reader);
+  if (!reader->threaded) {
+    pthread_cond_destroy(&reader->cond);
+    pthread_mutex_destroy(&reader->mutex);
+  }
+#endif
+}
+
+
+/* Returns the next frame to encode, or NULL at the end of the input. The
+ * frame stays valid until release_input_frame().
+ */
+static vpx_image_t *next_input_frame(struct input_reader *reader,
+                                     int64_t *pos) {
+  struct input_frame *const frame = &reader->frames[reader->head];
+
+#if CONFIG_MULTITHREAD
+  if (reader->threaded) {
+    struct vpx_usec_timer timer;
+    int frame_avail;
+
+    vpx_usec_timer_start(&timer);
+    pthread_mutex_lock(&reader->mutex);
+    while (!reader->count && !reader->done)
+      pthread_cond_wait(&reader->cond, &reader->mutex);
+    frame_avail = reader->count > 0;
+    pthread_mutex_unlock(&reader->mutex);
+    vpx_usec_timer_mark(&timer);
+    reader->wait_time += vpx_usec_timer_elapsed(&timer);
+
+    if (!frame_avail)
+      return NULL;
+  } else if (!read_input_frame(reader, frame)) {
+    return NULL;
+  }
+#else
+  if (!read_input_frame(reader, frame))
+    return NULL;
+#endif
+
+  *pos = frame->pos;
+  return &frame->img;
+}
+
+
+static void release_input_frame(struct input_reader *reader) {
+#if CONFIG_MULTITHREAD
+  if (reader->threaded) {
+    pthread_mutex_lock(&reader->mutex);
+    reader->head = (reader->head + 1) % INPUT_QUEUE_SIZE;
+    reader->count--;
+    pthread_cond_signal(&reader->cond);
+    pthread_mutex_unlock(&reader->mutex);
+  }
+#else
+  (void)reader;
+#endif
+}
+
+
+/* Must only be called once next_input_frame() returned NULL. */
+static void stop_input_reader(struct input_reader *reader) {
+  int i;
+
+#if CONFIG_MULTITHREAD
+  if (reader->threaded) {
+    pthread_join(reader->thread, NULL);
+    pthread_cond_destroy(&reader->cond);
+    pthread_mutex_destroy(&reader->mutex);
+  }
+#endif
+
+  for (i = 0; i < INPUT_QUEUE_SIZE; i++) {
+    if (reader->frames[i].buf_allocated)
+      vpx_img_free(&reader->frames[i].buf);
+  }
+}
+
+
 static struct stream_state *new_stream(struct VpxEncoderConfig *global,
                                        struct stream_state *prev) {
   struct stream_state *stream;
@@ -1690,8 +1949,201 @@ static void update_quantizer_histogram(struct stream_state *stream) {
 }
 
 
+static void write_frame_packet(struct stream_state *stream,
+                               const vpx_codec_cx_pkt_t *pkt) {
+  static size_t fsize = 0;
+  static int64_t ivf_header_pos = 0;
+
+#if CONFIG_WEBM_IO
+  if (stream->config.write_webm) {
+    write_webm_block(&stream->ebml, &stream->config.cfg, pkt);
+  }
+#endif
+  if (!stream->config.write_webm) {
+    if (pkt->data.frame.partition_id <= 0) {
+      ivf_header_pos = ftello(stream->file);
+      fsize = pkt->data.frame.sz;
+
+      ivf_write_frame_header(stream->file, pkt->data.frame.pts, fsize);
+    } else {
+      fsize += pkt->data.frame.sz;
+
+      if (!(pkt->data.frame.flags & VPX_FRAME_IS_FRAGMENT)) {
+        const int64_t currpos = ftello(stream->file);
+        fseeko(stream->file, ivf_header_pos, SEEK_SET);
+        ivf_write_frame_size(stream->file, fsize);
+        fseeko(stream->file, currpos, SEEK_SET);
+      }
+    }
+
+    (void) fwrite(pkt->data.frame.buf, 1, pkt->data.frame.sz,
+                  stream->file);
+  }
+}
+
+
+/* Frame packets are copied into a bounded queue and written out by a
+ * writer thread when threads are available, so that the encoder does not
+ * wait on the output files. The output files are only touched by that
+ * thread while it runs.
+ */
+#define OUTPUT_QUEUE_SIZE 16
+
+struct output_packet {
+  struct stream_state      *stream;
+  vpx_codec_cx_pkt_t        pkt;
+  uint8_t                  *buf;
+  size_t                    buf_size;
+};
+
+struct output_writer {
+  struct output_packet      packets[OUTPUT_QUEUE_SIZE];
+  int                       head;   /* next packet to write */
+  int                       count;  /* packets waiting to be written */
+  int                       done;
+  uint64_t                  write_time;
+  uint64_t                  wait_time;
+#if CONFIG_MULTITHREAD
+  int                       threaded;
+  pthread_mutex_t           mutex;
+  pthread_cond_t            cond;
+  pthread_t                 thread;
+#endif
+};
+
+
+static void write_output_packet(struct output_writer *writer,
+                                struct stream_state *stream,
+                                const vpx_codec_cx_pkt_t *pkt) {
+  struct vpx_usec_timer timer;
+
+  vpx_usec_timer_start(&timer);
+  write_frame_packet(stream, pkt);
+  vpx_usec_timer_mark(&timer);
+  writer->write_time += vpx_usec_timer_elapsed(&timer);
+}
+
+
+#if CONFIG_MULTITHREAD
+static THREADFN output_writer_thread(void *arg) {
+  struct output_writer *const writer = (struct output_writer *)arg;
+
+  pthread_mutex_lock(&writer->mutex);
+  while (1) {
+    struct output_packet *packet;
+
+    while (!writer->count && !writer->done)
+      pthread_cond_wait(&writer->cond, &writer->mutex);
+    if (!writer->count)
+      break;
+    packet = &writer->packets[writer->head];
+    pthread_mutex_unlock(&writer->mutex);
+
+    write_output_packet(writer, packet->stream, &packet->pkt);
+
+    pthread_mutex_lock(&writer->mutex);
+    writer->head = (writer->head + 1) % OUTPUT_QUEUE_SIZE;
+    writer->count--;
+    pthread_cond_signal(&writer->cond);
+  }
+  pthread_mutex_unlock(&writer->mutex);
+
+  return THREAD_RETURN(NULL);
+}
+#endif
+
+
+static void start_output_writer(struct output_writer *writer) {
+  memset(writer, 0, sizeof(*writer));
+
+#if CONFIG_MULTITHREAD
+  if (pthread_mutex_init(&writer->mutex, NULL))
+    return;
+  if (pthread_cond_init(&writer->cond, NULL)) {
+    pthread_mutex_destroy(&writer->mutex);
+    return;
+  }
+  writer->threaded = !pthread_create(&writer->thread, NULL,
+                                     output_writer_thread, writer);
+  if (!writer->threaded) {
+    pthread_cond_destroy(&writer->cond);
+    pthread_mutex_destroy(&writer->mutex);
+  }
+#endif
+}
+
+
+/* Queues a frame packet for writing. The packet data is copied, as it is
+ * only valid until the next call to the encoder.
+ */
+static void queue_output_packet(struct output_writer *writer,
+                                struct stream_state *stream,
+                                const vpx_codec_cx_pkt_t *pkt) {
+#if CONFIG_MULTITHREAD
+  if (writer->threaded) {
+    struct output_packet *packet;
+    struct vpx_usec_timer timer;
+
+    vpx_usec_timer_start(&timer);
+    pthread_mutex_lock(&writer->mutex);
+    while (writer->count == OUTPUT_QUEUE_SIZE)
+      pthread_cond_wait(&writer->cond, &writer->mutex);
+    packet = &writer->packets[(writer->head + writer->count) %
+                              OUTPUT_QUEUE_SIZE];
+    pthread_mutex_unlock(&writer->mutex);
+    vpx_usec_timer_mark(&timer);
+    writer->wait_time += vpx_usec_timer_elapsed(&timer);
+
+    if (pkt->data.frame.sz > packet->buf_size) {
+      uint8_t *const buf = (uint8_t *)realloc(packet->buf,
+                                              pkt->data.frame.sz);
+      if (!buf)
+        fatal("Failed to allocate output packet");
+      packet->buf = buf;
+      packet->buf_size = pkt->data.frame.sz;
+    }
+    memcpy(packet->buf, pkt->data.frame.buf, pkt->data.frame.sz);
+    packet->stream = stream;
+    packet->pkt = *pkt;
+    packet->pkt.data.frame.buf = packet->buf;
+
+    pthread_mutex_lock(&writer->mutex);
+    writer->count++;
+    pthread_cond_signal(&writer->cond);
+    pthread_mutex_unlock(&writer->mutex);
+    return;
+  }
+#endif
+  write_output_packet(writer, stream, pkt);
+}
+
+
+/* Writes out the queued packets. Must be called before the output files are
+ * closed.
+ */
+static void stop_output_writer(struct output_writer *writer) {
+  int i;
+
+#if CONFIG_MULTITHREAD
+  if (writer->threaded) {
+    pthread_mutex_lock(&writer->mutex);
+    writer->done = 1;
+    pthread_cond_signal(&writer->cond);
+    pthread_mutex_unlock(&writer->mutex);
+    pthread_join(writer->thread, NULL);
+    pthread_cond_destroy(&writer->cond);
+    pthread_mutex_destroy(&writer->mutex);
+  }
+#endif
+
+  for (i = 0; i < OUTPUT_QUEUE_SIZE; i++)
+    free(writer->packets[i].buf);
+}
+
+
 static void get_cx_data(struct stream_state *stream,
                         struct VpxEncoderConfig *global,
+                        struct output_writer *writer,
                         int *got_data) {
   const vpx_codec_cx_pkt_t *pkt;
   const struct vpx_codec_enc_cfg *cfg = &stream->config.cfg;
@@ -1699,9 +2151,6 @@ static void get_cx_data(struct stream_state *stream,
 
   *got_data = 0;
   while ((pkt = vpx_codec_get_cx_data(&stream->encoder, &iter))) {
-    static size_t fsize = 0;
-    static int64_t ivf_header_pos = 0;
-
     switch (pkt->kind) {
       case VPX_CODEC_CX_FRAME_PKT:
         if (!(pkt->data.frame.flags & VPX_FRAME_IS_FRAGMENT)) {
@@ -1711,31 +2160,7 @@ static void get_cx_data(struct stream_state *stream,
           fprintf(stderr, " %6luF", (unsigned long)pkt->data.frame.sz);
 
         update_rate_histogram(stream->rate_hist, cfg, pkt);
-#if CONFIG_WEBM_IO
-        if (stream->config.write_webm) {
-          write_webm_block(&stream->ebml, cfg, pkt);
-        }
-#endif
-        if (!stream->config.write_webm) {
-          if (pkt->data.frame.partition_id <= 0) {
-            ivf_header_pos = ftello(stream->file);
-            fsize = pkt->data.frame.sz;
-
-            ivf_write_frame_header(stream->file, pkt->data.frame.pts, fsize);
-          } else {
-            fsize += pkt->data.frame.sz;
-
-            if (!(pkt->data.frame.flags & VPX_FRAME_IS_FRAGMENT)) {
-              const int64_t currpos = ftello(stream->file);
-              fseeko(stream->file, ivf_header_pos, SEEK_SET);
-              ivf_write_frame_size(stream->file, fsize);
-              fseeko(stream->file, currpos, SEEK_SET);
-            }
-          }
-
-          (void) fwrite(pkt->data.frame.buf, 1, pkt->data.frame.sz,
-                        stream->file);
-        }
+        queue_output_packet(writer, stream, pkt);
         stream->nbytes += pkt->data.raw.sz;
 
         *got_data = 1;
@@ -1810,6 +2235,19 @@ static void show_psnr(struct stream_state  *stream, double peak) {
 }
 
 
+#if CONFIG_VP9_ENCODER
+static void show_thread_sync_stats(struct stream_state *stream) {
+  vpx_thread_sync_stats_t stats;
+
+  if (vpx_codec_control(&stream->encoder, VP9E_GET_THREAD_SYNC_STATS, &stats))
+    return;
+  fprintf(stderr, "Stream %d threads blocked %u times, %"PRIu64" us in total, "
+          "on the row above\n", stream->index, stats.wait_count,
+          stats.wait_time);
+}
+#endif
+
+
 static float usec_to_fps(uint64_t usec, unsigned int frames) {
   return (float)(usec > 0 ? frames * 1000000.0 / (float)usec : 0);
 }
@@ -1917,7 +2355,7 @@ static void print_time(const char *label, int64_t etl) {
 
 int main(int argc, const char **argv_) {
   int pass;
-  vpx_image_t raw;
+  vpx_image_t *raw = NULL;
 #if CONFIG_VP9_HIGHBITDEPTH
   vpx_image_t raw_shift;
   int allocated_raw_shift = 0;
@@ -2009,6 +2447,9 @@ int main(int argc, const char **argv_) {
     int64_t estimated_time_left = -1;
     int64_t average_rate = -1;
     int64_t lagged_count = 0;
+    int64_t input_pos = 0;
+    struct input_reader reader;
+    struct output_writer writer;
 
     open_input_file(&input);
 
@@ -2088,14 +2529,6 @@ int main(int argc, const char **argv_) {
       FOREACH_STREAM(show_stream_config(stream, &global, &input));
 
     if (pass == (global.pass ? global.pass - 1 : 0)) {
-      if (input.file_type == FILE_TYPE_Y4M)
-        /*The Y4M reader does its own allocation.
-          Just initialize this here to avoid problems if we never read any
-           frames.*/
-        memset(&raw, 0, sizeof(raw));
-      else
-        vpx_img_alloc(&raw, input.fmt, input.width, input.height, 32);
-
       FOREACH_STREAM(stream->rate_hist =
                          init_rate_histogram(&stream->config.cfg,
                                              &global.framerate));
@@ -2127,6 +2560,9 @@ int main(int argc, const char **argv_) {
     }
 #endif
 
+    start_input_reader(&reader, &input, global.limit);
+    start_output_writer(&writer);
+
     frame_avail = 1;
     got_data = 0;
 
@@ -2134,7 +2570,8 @@ int main(int argc, const char **argv_) {
       struct vpx_usec_timer timer;
 
       if (!global.limit || frames_in < global.limit) {
-        frame_avail = read_frame(&input, &raw);
+        raw = next_input_frame(&reader, &input_pos);
+        frame_avail = raw != NULL;
 
         if (frame_avail)
           frames_in++;
@@ -2166,42 +2603,43 @@ int main(int argc, const char **argv_) {
       if (frames_in > global.skip_frames) {
 #if CONFIG_VP9_HIGHBITDEPTH
         vpx_image_t *frame_to_encode;
-        if (input_shift || (use_16bit_internal && input.bit_depth == 8)) {
+        if (!frame_avail) {
+          frame_to_encode = NULL;
+        } else if (input_shift ||
+                   (use_16bit_internal && input.bit_depth == 8)) {
           assert(use_16bit_internal);
           // Input bit depth and stream bit depth do not match, so up
           // shift frame to stream bit depth
           if (!allocated_raw_shift) {
-            vpx_img_alloc(&raw_shift, raw.fmt | VPX_IMG_FMT_HIGHBITDEPTH,
+            vpx_img_alloc(&raw_shift, raw->fmt | VPX_IMG_FMT_HIGHBITDEPTH,
                           input.width, input.height, 32);
             allocated_raw_shift = 1;
           }
-          vpx_img_upshift(&raw_shift, &raw, input_shift);
+          vpx_img_upshift(&raw_shift, raw, input_shift);
           frame_to_encode = &raw_shift;
         } else {
-          frame_to_encode = &raw;
+          frame_to_encode = raw;
         }
         vpx_usec_timer_start(&timer);
         if (use_16bit_internal) {
-          assert(frame_to_encode->fmt & VPX_IMG_FMT_HIGHBITDEPTH);
+          assert(!frame_to_encode ||
+                 (frame_to_encode->fmt & VPX_IMG_FMT_HIGHBITDEPTH));
           FOREACH_STREAM({
             if (stream->config.use_16bit_internal)
-              encode_frame(stream, &global,
-                           frame_avail ? frame_to_encode : NULL,
-                           frames_in);
+              encode_frame(stream, &global, frame_to_encode, frames_in);
             else
               assert(0);
           });
         } else {
-          assert((frame_to_encode->fmt & VPX_IMG_FMT_HIGHBITDEPTH) == 0);
-          FOREACH_STREAM(encode_frame(stream, &global,
-                                      frame_avail ? frame_to_encode : NULL,
+          assert(!frame_to_encode ||
+                 (frame_to_encode->fmt & VPX_IMG_FMT_HIGHBITDEPTH) == 0);
+          FOREACH_STREAM(encode_frame(stream, &global, frame_to_encode,
                                       frames_in));
         }
 #else
         vpx_usec_timer_start(&timer);
         FOREACH_STREAM(encode_frame(stream, &global,
-                                    frame_avail ? &raw : NULL,
-                                    frames_in));
+                                    frame_avail ? raw : NULL, frames_in));
 #endif
         vpx_usec_timer_mark(&timer);
         cx_time += vpx_usec_timer_elapsed(&timer);
@@ -2209,11 +2647,11 @@ int main(int argc, const char **argv_) {
         FOREACH_STREAM(update_quantizer_histogram(stream));
 
         got_data = 0;
-        FOREACH_STREAM(get_cx_data(stream, &global, &got_data));
+        FOREACH_STREAM(get_cx_data(stream, &global, &writer, &got_data));
 
         if (!got_data && input.length && streams != NULL &&
             !streams->frames_out) {
-          lagged_count = global.limit ? seen_frames : ftello(input.file);
+          lagged_count = global.limit ? seen_frames : input_pos;
         } else if (input.length) {
           int64_t remaining;
           int64_t rate;
@@ -2225,7 +2663,6 @@ int main(int argc, const char **argv_) {
             remaining = 1000 * (global.limit - global.skip_frames
                                 - seen_frames + lagged_count);
           } else {
-            const int64_t input_pos = ftello(input.file);
             const int64_t input_pos_lagged = input_pos - lagged_count;
             const int64_t limit = input.length;
 
@@ -2243,11 +2680,17 @@ int main(int argc, const char **argv_) {
           FOREACH_STREAM(test_decode(stream, global.test_decode, global.codec));
       }
 
+      if (frame_avail)
+        release_input_frame(&reader);
+
       fflush(stdout);
       if (!global.quiet)
         fprintf(stderr, "\033[K");
     }
 
+    stop_input_reader(&reader);
+    stop_output_writer(&writer);
+
     if (stream_cnt > 1)
       fprintf(stderr, "\n");
 
@@ -2266,6 +2709,19 @@ int main(int argc, const char **argv_) {
           usec_to_fps(stream->cx_time, seen_frames)));
     }
 
+    if (global.verbose) {
+      fprintf(stderr,
+              "Pass %d/%d read %"PRId64" us, write %"PRId64" us, encoder "
+              "waited %"PRId64" us for input and %"PRId64" us for output\n",
+              pass + 1, global.passes, (int64_t)reader.read_time,
+              (int64_t)writer.write_time, (int64_t)reader.wait_time,
+              (int64_t)writer.wait_time);
+#if CONFIG_VP9_ENCODER
+      if (global.codec->fourcc == VP9_FOURCC)
+        FOREACH_STREAM(show_thread_sync_stats(stream));
+#endif
+    }
+
     if (global.show_psnr) {
       if (global.codec->fourcc == VP9_FOURCC) {
         FOREACH_STREAM(
@@ -2329,7 +2785,6 @@ int main(int argc, const char **argv_) {
   if (allocated_raw_shift)
     vpx_img_free(&raw_shift);
 #endif
-  vpx_img_free(&raw);
   free(argv);
   free(streams);
   return res ? EXIT_FAILURE : EXIT_SUCCESS;
@@ -18,11 +18,50 @@
 
 namespace {
 
+// Reads the input from its memory mapping instead of through stdio.
+class MappedMkvReader : public mkvparser::IMkvReader {
+ public:
+  MappedMkvReader(const uint8_t *data, size_t size)
+      : data_(data), size_(size) {}
+  virtual ~MappedMkvReader() {}
+
+  virtual int Read(long long pos, long len,  // NOLINT
+                   unsigned char *buf) {
+    if (pos < 0 || len < 0)
+      return -1;
+    if (len == 0)
+      return 0;
+    if (static_cast<unsigned long long>(pos) >= size_ ||
+        static_cast<unsigned long long>(len) > size_ - pos)
+      return -1;
+    memcpy(buf, data_ + pos, len);
+    return 0;
+  }
+
+  virtual int Length(long long *total, long long *available) {  // NOLINT
+    if (total != NULL)
+      *total = size_;
+    if (available != NULL)
+      *available = size_;
+    return 0;
+  }
+
+ private:
+  const uint8_t *const data_;
+  const size_t size_;
+};
+
 void reset(struct WebmInputContext *const webm_ctx) {
   if (webm_ctx->reader != NULL) {
-    mkvparser::MkvReader *const reader =
-        reinterpret_cast<mkvparser::MkvReader*>(webm_ctx->reader);
-    delete reader;
+    if (webm_ctx->map_data != NULL) {
+      MappedMkvReader *const reader =
+          reinterpret_cast<MappedMkvReader*>(webm_ctx->reader);
+      delete reader;
+    } else {
+      mkvparser::MkvReader *const reader =
+          reinterpret_cast<mkvparser::MkvReader*>(webm_ctx->reader);
+      delete reader;
+    }
   }
   if (webm_ctx->segment != NULL) {
     mkvparser::Segment *const segment =
@@ -33,6 +72,8 @@ void reset(struct WebmInputContext *const webm_ctx) {
     delete[] webm_ctx->buffer;
   }
   webm_ctx->reader = NULL;
+  webm_ctx->map_data = NULL;
+  webm_ctx->map_size = 0;
   webm_ctx->segment = NULL;
   webm_ctx->buffer = NULL;
   webm_ctx->cluster = NULL;
@@ -57,11 +98,81 @@ void rewind_and_reset(struct WebmInputContext *const webm_ctx,
   reset(webm_ctx);
 }
 
+// Moves on to the next frame of the video track. Returns as webm_read_frame().
+int next_frame(struct WebmInputContext *const webm_ctx,
+               const mkvparser::Block::Frame **frame) {
+  // This check is needed for frame parallel decoding, in which case this
+  // function could be called even after it has reached end of input stream.
+  if (webm_ctx->reached_eos) {
+    return 1;
+  }
+  mkvparser::Segment *const segment =
+      reinterpret_cast<mkvparser::Segment*>(webm_ctx->segment);
+  const mkvparser::Cluster* cluster =
+      reinterpret_cast<const mkvparser::Cluster*>(webm_ctx->cluster);
+  const mkvparser::Block *block =
+      reinterpret_cast<const mkvparser::Block*>(webm_ctx->block);
+  const mkvparser::BlockEntry *block_entry =
+      reinterpret_cast<const mkvparser::BlockEntry*>(webm_ctx->block_entry);
+  bool block_entry_eos = false;
+  do {
+    long status = 0;
+    bool get_new_block = false;
+    if (block_entry == NULL && !block_entry_eos) {
+      status = cluster->GetFirst(block_entry);
+      get_new_block = true;
+    } else if (block_entry_eos || block_entry->EOS()) {
+      cluster = segment->GetNext(cluster);
+      if (cluster == NULL || cluster->EOS()) {
+        webm_ctx->reached_eos = 1;
+        return 1;
+      }
+      status = cluster->GetFirst(block_entry);
+      block_entry_eos = false;
+      get_new_block = true;
+    } else if (block == NULL ||
+               webm_ctx->block_frame_index == block->GetFrameCount() ||
+               block->GetTrackNumber() != webm_ctx->video_track_index) {
+      status = cluster->GetNext(block_entry, block_entry);
+      if (block_entry == NULL || block_entry->EOS()) {
+        block_entry_eos = true;
+        continue;
+      }
+      get_new_block = true;
+    }
+    if (status) {
+      return -1;
+    }
+    if (get_new_block) {
+      block = block_entry->GetBlock();
+      webm_ctx->block_frame_index = 0;
+    }
+  } while (block->GetTrackNumber() != webm_ctx->video_track_index ||
+           block_entry_eos);
+
+  webm_ctx->cluster = cluster;
+  webm_ctx->block_entry = block_entry;
+  webm_ctx->block = block;
+
+  *frame = &block->GetFrame(webm_ctx->block_frame_index);
+  ++webm_ctx->block_frame_index;
+  webm_ctx->timestamp_ns = block->GetTime(cluster);
+  webm_ctx->is_key_frame = block->IsKey();
+  return 0;
+}
+
 }  // namespace
 
 int file_is_webm(struct WebmInputContext *webm_ctx,
                  struct VpxInputContext *vpx_ctx) {
-  mkvparser::MkvReader *const reader = new mkvparser::MkvReader(vpx_ctx->file);
+  mkvparser::IMkvReader *reader;
+  if (vpx_ctx->map.data != NULL) {
+    reader = new MappedMkvReader(vpx_ctx->map.data, vpx_ctx->map.size);
+    webm_ctx->map_data = vpx_ctx->map.data;
+    webm_ctx->map_size = vpx_ctx->map.size;
+  } else {
+    reader = new mkvparser::MkvReader(vpx_ctx->file);
+  }
   webm_ctx->reader = reader;
   webm_ctx->reached_eos = 0;
 
@@ -124,89 +235,59 @@ int webm_read_frame(struct WebmInputContext *webm_ctx,
                     uint8_t **buffer,
                     size_t *bytes_in_buffer,
                     size_t *buffer_size) {
-  // This check is needed for frame parallel decoding, in which case this
-  // function could be called even after it has reached end of input stream.
-  if (webm_ctx->reached_eos) {
-    return 1;
+  const mkvparser::Block::Frame *frame;
+  const int status = next_frame(webm_ctx, &frame);
+  if (status) {
+    if (status > 0)
+      *bytes_in_buffer = 0;
+    return status;
   }
-  mkvparser::Segment *const segment =
-      reinterpret_cast<mkvparser::Segment*>(webm_ctx->segment);
-  const mkvparser::Cluster* cluster =
-      reinterpret_cast<const mkvparser::Cluster*>(webm_ctx->cluster);
-  const mkvparser::Block *block =
-      reinterpret_cast<const mkvparser::Block*>(webm_ctx->block);
-  const mkvparser::BlockEntry *block_entry =
-      reinterpret_cast<const mkvparser::BlockEntry*>(webm_ctx->block_entry);
-  bool block_entry_eos = false;
-  do {
-    long status = 0;
-    bool get_new_block = false;
-    if (block_entry == NULL && !block_entry_eos) {
-      status = cluster->GetFirst(block_entry);
-      get_new_block = true;
-    } else if (block_entry_eos || block_entry->EOS()) {
-      cluster = segment->GetNext(cluster);
-      if (cluster == NULL || cluster->EOS()) {
-        *bytes_in_buffer = 0;
-        webm_ctx->reached_eos = 1;
-        return 1;
-      }
-      status = cluster->GetFirst(block_entry);
-      block_entry_eos = false;
-      get_new_block = true;
-    } else if (block == NULL ||
-               webm_ctx->block_frame_index == block->GetFrameCount() ||
-               block->GetTrackNumber() != webm_ctx->video_track_index) {
-      status = cluster->GetNext(block_entry, block_entry);
-      if (block_entry == NULL || block_entry->EOS()) {
-        block_entry_eos = true;
-        continue;
-      }
-      get_new_block = true;
-    }
-    if (status) {
-      return -1;
-    }
-    if (get_new_block) {
-      block = block_entry->GetBlock();
-      webm_ctx->block_frame_index = 0;
-    }
-  } while (block->GetTrackNumber() != webm_ctx->video_track_index ||
-           block_entry_eos);
-
-  webm_ctx->cluster = cluster;
-  webm_ctx->block_entry = block_entry;
-  webm_ctx->block = block;
 
-  const mkvparser::Block::Frame& frame =
-      block->GetFrame(webm_ctx->block_frame_index);
-  ++webm_ctx->block_frame_index;
-  if (frame.len > static_cast<long>(*buffer_size)) {
+  if (frame->len > static_cast<long>(*buffer_size)) {
     delete[] *buffer;
-    *buffer = new uint8_t[frame.len];
+    *buffer = new uint8_t[frame->len];
     if (*buffer == NULL) {
       return -1;
     }
-    *buffer_size = frame.len;
+    *buffer_size = frame->len;
     webm_ctx->buffer = *buffer;
   }
-  *bytes_in_buffer = frame.len;
-  webm_ctx->timestamp_ns = block->GetTime(cluster);
-  webm_ctx->is_key_frame = block->IsKey();
+  *bytes_in_buffer = frame->len;
+
+  mkvparser::IMkvReader *const reader =
+      reinterpret_cast<mkvparser::IMkvReader*>(webm_ctx->reader);
+  return frame->Read(reader, *buffer) ? -1 : 0;
+}
 
-  mkvparser::MkvReader *const reader =
-      reinterpret_cast<mkvparser::MkvReader*>(webm_ctx->reader);
-  return frame.Read(reader, *buffer) ? -1 : 0;
+int webm_read_frame_mapped(struct WebmInputContext *webm_ctx,
+                           const uint8_t **buffer,
+                           size_t *bytes_in_buffer) {
+  const mkvparser::Block::Frame *frame;
+  const int status = next_frame(webm_ctx, &frame);
+  if (status) {
+    if (status > 0)
+      *bytes_in_buffer = 0;
+    return status;
+  }
+
+  // The block is not read through the reader, so check that the frame lies
+  // within the mapping.
+  if (frame->pos < 0 || frame->len < 0 ||
+      frame->pos + frame->len > static_cast<long long>(webm_ctx->map_size))
+    return -1;
+
+  *buffer = webm_ctx->map_data + frame->pos;
+  *bytes_in_buffer = frame->len;
+  return 0;
 }
 
 int webm_guess_framerate(struct WebmInputContext *webm_ctx,
                          struct VpxInputContext *vpx_ctx) {
   uint32_t i = 0;
-  uint8_t *buffer = NULL;
-  size_t bytes_in_buffer = 0;
-  size_t buffer_size = 0;
+  // Only the timestamps are needed, so the frames aren't read.
+  const mkvparser::Block::Frame *frame;
   while (webm_ctx->timestamp_ns < 1000000000 && i < 50) {
-    if (webm_read_frame(webm_ctx, &buffer, &bytes_in_buffer, &buffer_size)) {
+    if (next_frame(webm_ctx, &frame)) {
       break;
     }
     ++i;
@@ -214,7 +295,6 @@ int webm_guess_framerate(struct WebmInputContext *webm_ctx,
   vpx_ctx->framerate.numerator = (i - 1) * 1000000;
   vpx_ctx->framerate.denominator =
       static_cast<int>(webm_ctx->timestamp_ns / 1000);
-  delete[] buffer;
 
   get_first_cluster(webm_ctx);
   webm_ctx->block = NULL;
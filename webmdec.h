@@ -20,6 +20,10 @@ struct VpxInputContext;
 
 struct WebmInputContext {
   void *reader;
+  // Start and size of the memory mapped input when it is read through the
+  // mapping.
+  const uint8_t *map_data;
+  size_t map_size;
   void *segment;
   uint8_t *buffer;
   const void *cluster;
@@ -60,6 +64,13 @@ int webm_read_frame(struct WebmInputContext *webm_ctx,
                     size_t *bytes_in_buffer,
                     size_t *buffer_size);
 
+// Same as webm_read_frame(), for inputs mapped with vpx_input_map() before
+// file_is_webm(). |*buffer| is set to point into the mapping, so nothing is
+// copied.
+int webm_read_frame_mapped(struct WebmInputContext *webm_ctx,
+                           const uint8_t **buffer,
+                           size_t *bytes_in_buffer);
+
 // Guesses the frame rate of the input file based on the container timestamps.
 int webm_guess_framerate(struct WebmInputContext *webm_ctx,
                          struct VpxInputContext *vpx_ctx);
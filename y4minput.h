@@ -66,6 +66,11 @@ int y4m_input_open(y4m_input *_y4m, FILE *_fin, char *_skip, int _nskip,
                    int only_420);
 void y4m_input_close(y4m_input *_y4m);
 int y4m_input_fetch_frame(y4m_input *_y4m, FILE *_fin, vpx_image_t *img);
+/*Same as y4m_input_fetch_frame(), reading the frame from the memory between
+   *_buf and _end and advancing *_buf past it. Frames that need no conversion
+   are not copied: the planes of img point into that memory.*/
+int y4m_input_fetch_frame_mapped(y4m_input *_y4m, const unsigned char **_buf,
+                                 const unsigned char *_end, vpx_image_t *img);
 
 #ifdef __cplusplus
 }  // extern "C"